@@ -7,6 +7,7 @@
 
 #include "fsl_adapter_imu_common.h"
 #include "fsl_adapter_imu.h"
+#include "fsl_adapter_imu_rx_poll.h"
 #if defined(IMU_GDMA_ENABLE) && (IMU_GDMA_ENABLE == 1)
 #include "fsl_gdma.h"
 #endif
@@ -84,6 +85,17 @@ static uint8_t imumc_init_flag = 0;
  */
 static uint8_t imu_task_flag = 0;
 
+#if (IMU_RX_FREE_BATCH == 0U) || (IMU_RX_FREE_BATCH > IMU_PAYLOAD_SIZE)
+#error "IMU_RX_FREE_BATCH must be 1 to IMU_PAYLOAD_SIZE"
+#endif
+
+/*! RX buffers handled but not yet returned to the peer, for each IMU link */
+static uint32_t imuRxFreeBuf[kIMU_LinkMax][IMU_RX_FREE_BATCH];
+static uint8_t imuRxFreeCnt[kIMU_LinkMax];
+
+/*! Polls left before the RX interrupt of each IMU link is unmasked again */
+static uint8_t imuRxHoldoff[kIMU_LinkMax];
+
 #ifndef CPU2
 /*! Sleep flag address between CPU1 and CPU3 or CPU2 and CPU3 */
 #define IMU_SLEEP_FLAG13 0x4138248C
@@ -137,6 +149,8 @@ OSA_EVENT_HANDLE_DEFINE(ImuQ23FlagsRef);
 
 OSA_EVENT_HANDLE_DEFINE(imumcQFlagsRef);
 
+void HAL_ImumcSetEvent(uint32_t Event);
+
 #if defined(IMU_GDMA_ENABLE) && (IMU_GDMA_ENABLE == 1)
 static gdma_handle_t gdmaHandle;
 OSA_SEMAPHORE_HANDLE_DEFINE(gdmaSemHandle);
@@ -752,6 +766,42 @@ static hal_imumc_status_t HAL_ImuFreeRxBuf(hal_imu_handle_t *imuHandle, uint8_t
     return imumcStatus;
 }
 
+static hal_imumc_status_t HAL_ImuFlushFreeRxBuf(hal_imu_handle_t *imuHandle)
+{
+    uint8_t count = imuRxFreeCnt[imuHandle->imuLink];
+
+    if (count == 0U)
+    {
+        return kStatus_HAL_ImumcSuccess;
+    }
+
+    imuRxFreeCnt[imuHandle->imuLink] = 0U;
+    return HAL_ImuFreeRxBuf(imuHandle, (uint8_t *)&imuRxFreeBuf[imuHandle->imuLink][0], count);
+}
+
+/*! Queue the buffers of a handled RX data message, they are returned a batch at a time */
+static hal_imumc_status_t HAL_ImuQueueFreeRxBuf(hal_imu_handle_t *imuHandle, volatile uint32_t *rxBuf, uint8_t length)
+{
+    hal_imumc_status_t imumcStatus = kStatus_HAL_ImumcSuccess;
+    uint8_t *count                 = &imuRxFreeCnt[imuHandle->imuLink];
+    uint8_t i;
+
+    for (i = 0U; i < length; i++)
+    {
+        imuRxFreeBuf[imuHandle->imuLink][*count] = rxBuf[i];
+        (*count)++;
+        if (*count == IMU_RX_FREE_BATCH)
+        {
+            if (kStatus_HAL_ImumcSuccess != HAL_ImuFlushFreeRxBuf(imuHandle))
+            {
+                imumcStatus = kStatus_HAL_ImumcError;
+            }
+        }
+    }
+
+    return imumcStatus;
+}
+
 hal_imumc_status_t HAL_ImuSendCommand(uint8_t imuLink, uint8_t *cmdBuf, uint32_t length)
 {
     hal_imumc_status_t imumcStatus = kStatus_HAL_ImumcSuccess;
@@ -1187,9 +1237,12 @@ hal_imumc_status_t HAL_ImuReceive(uint8_t imuLink)
     hal_imu_handle_t *imuHandle = NULL;
     imu_msg_type_t msg_type     = IMU_MSG_MAX;
     bool isUnlockMsgReqd        = FALSE;
+    bool isRxBudgetSpent        = FALSE;
+    uint32_t rxCount            = 0U;
     hal_imumc_state_t *ept;
     struct imumc_std_msg *imumc_msg;
     hal_imumc_status_t imumcStatus = kStatus_HAL_ImumcSuccess;
+    hal_imumc_status_t flushStatus;
 
     assert((uint8_t)kIMU_LinkMax > imuLink);
     imuHandle = &imuHandleCh[imuLink];
@@ -1205,6 +1258,11 @@ hal_imumc_status_t HAL_ImuReceive(uint8_t imuLink)
 #endif
             break;
         }
+        else if ((IMU_RX_BUDGET != 0U) && (rxCount >= IMU_RX_BUDGET))
+        {
+            isRxBudgetSpent = TRUE;
+            break;
+        }
         else
         {
 #ifndef CPU2
@@ -1268,7 +1326,8 @@ hal_imumc_status_t HAL_ImuReceive(uint8_t imuLink)
                         imumcStatus = imuHandle->imuHandler[IMU_MSG_RX_DATA]((IMU_Msg_t *)pMsg, pMsg->Hdr.length);
                     }
                     pMsg        = &localImuMsgRx;
-                    imumcStatus = HAL_ImuFreeRxBuf(imuHandle, (uint8_t *)&pMsg->PayloadPtr[0], pMsg->Hdr.length);
+                    imumcStatus = HAL_ImuQueueFreeRxBuf(imuHandle, &pMsg->PayloadPtr[0], pMsg->Hdr.length);
+                    rxCount++;
                     break;
                 case IMU_MSG_IMUMC:
                     imumc_msg = (struct imumc_std_msg *)&pMsg->PayloadPtr[0];
@@ -1296,11 +1355,26 @@ hal_imumc_status_t HAL_ImuReceive(uint8_t imuLink)
         }
     }
 
+    flushStatus = HAL_ImuFlushFreeRxBuf(imuHandle);
+    assert(kStatus_HAL_ImumcSuccess == flushStatus);
+    if (kStatus_HAL_ImumcSuccess != flushStatus)
+    {
+        imumcStatus = flushStatus;
+    }
+
     if (isUnlockMsgReqd)
     {
         (void)HAL_ImuSendUnlock(imuHandle);
     }
 
+    if (HAL_ImuRxHoldoffStep(&imuRxHoldoff[imuHandle->imuLink], IMU_RX_HOLDOFF_MAX, isRxBudgetSpent))
+    {
+        /* Keep the interrupt masked, poll again once the tasks consuming the RX data ran */
+        HAL_ImumcSetEvent(1U << imuHandle->imuLink);
+        OSA_TaskYield();
+        return (hal_imumc_status_t)imumcStatus;
+    }
+
     (void)os_InterruptMaskSet(IMULINKID_TO_IRQID((imu_link_t)imuHandle->imuLink));
     return (hal_imumc_status_t)imumcStatus;
 }
@@ -1941,6 +2015,9 @@ void WL_MCI_WAKEUP0_DriverIRQHandler(void)
     irq_num = IRQ_IMU_CPU13;
 #endif
 
+    /* The exit is traced by portYIELD_FROM_ISR, if the handler wakes a task */
+    traceISR_ENTER();
+
     /* Mask IMU ICU interrupt */
     (void)os_InterruptMaskClear(irq_num);
 
@@ -1964,6 +2041,9 @@ void BLE_MCI_WAKEUP0_DriverIRQHandler(void)
     irq_num = IRQ_IMU_CPU23;
 #endif
 
+    /* The exit is traced by portYIELD_FROM_ISR, if the handler wakes a task */
+    traceISR_ENTER();
+
     /* Mask IMU ICU interrupt */
     (void)os_InterruptMaskClear(irq_num);
 
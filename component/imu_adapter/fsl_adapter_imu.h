@@ -307,6 +307,20 @@ hal_imumc_status_t HAL_ImumcExitLowpower(hal_imumc_handle_t handle);
 /*! @brief IMU message payload size. */
 #define IMU_PAYLOAD_SIZE (8U)
 
+/*! @brief RX data messages handled per wakeup of the IMU task. When the budget is
+ *  spent the RX interrupt stays masked and the task polls again after the other
+ *  ready tasks ran, 0 means no budget. */
+#ifndef IMU_RX_BUDGET
+#define IMU_RX_BUDGET (16U)
+#endif
+
+/*! @brief RX buffers returned to the peer in one message. The pending buffers are
+ *  also returned when the RX FIFO is empty, so they wait only under load. 1 returns
+ *  the buffers of every RX data message on its own. */
+#ifndef IMU_RX_FREE_BATCH
+#define IMU_RX_FREE_BATCH IMU_PAYLOAD_SIZE
+#endif
+
 #define IMUMC_EVENT_ENDPOINT_QUERY_RSP (1U << 0U)
 
 #ifndef IMUMC_TXQ13_BUFSIZE
@@ -0,0 +1,51 @@
+/*
+ * fsl_adapter_imu_rx_poll.h
+ * Adaptive interrupt holdoff of the IMU RX poll loop
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __FSL_ADAPTER_IMU_RX_POLL_H__
+#define __FSL_ADAPTER_IMU_RX_POLL_H__
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*! @brief Polls the IMU task keeps the RX interrupt masked after the RX FIFO drained.
+ *  Each wakeup that spends the RX budget adds one poll, each poll that finds the FIFO
+ *  empty takes one away, so the holdoff follows the load and is 0 when the link idles.
+ *  0 unmasks the interrupt as soon as the FIFO is empty. */
+#ifndef IMU_RX_HOLDOFF_MAX
+#define IMU_RX_HOLDOFF_MAX (4U)
+#endif
+
+/*!
+ * @brief Updates the RX holdoff of a link at the end of a poll.
+ *
+ * @param holdoff       Holdoff of the link, in polls.
+ * @param holdoffMax    Largest holdoff, IMU_RX_HOLDOFF_MAX.
+ * @param budgetSpent   TRUE when the poll stopped on the RX budget, FALSE when the FIFO was empty.
+ * @retval TRUE  Keep the RX interrupt masked and poll again.
+ * @retval FALSE Unmask the RX interrupt.
+ */
+static inline bool HAL_ImuRxHoldoffStep(uint8_t *holdoff, uint8_t holdoffMax, bool budgetSpent)
+{
+    if (budgetSpent)
+    {
+        if (*holdoff < holdoffMax)
+        {
+            (*holdoff)++;
+        }
+        return true;
+    }
+
+    if (*holdoff > 0U)
+    {
+        (*holdoff)--;
+        return true;
+    }
+
+    return false;
+}
+
+#endif /* __FSL_ADAPTER_IMU_RX_POLL_H__ */
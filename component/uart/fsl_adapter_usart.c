@@ -11,6 +11,10 @@
 
 #include "fsl_adapter_uart.h"
 
+#if defined(SDK_OS_FREE_RTOS)
+#include "FreeRTOS.h"
+#endif
+
 #if (defined(HAL_UART_DMA_ENABLE) && (HAL_UART_DMA_ENABLE > 0U))
 #include "fsl_component_timer_manager.h"
 #include "fsl_usart_dma.h"
@@ -265,6 +269,10 @@ static void HAL_UartInterruptHandle(USART_Type *base, void *handle)
 
 static void HAL_UartInterruptHandle_Wrapper(void *base, void *handle)
 {
+#if defined(SDK_OS_FREE_RTOS)
+    /* The exit is traced by portYIELD_FROM_ISR, if the callback wakes a task */
+    traceISR_ENTER();
+#endif
     HAL_UartInterruptHandle((USART_Type *)base, handle);
 }
 #endif
@@ -8,6 +8,7 @@
 #define _WPL_H_
 
 #include "stdbool.h"
+#include "stdint.h"
 
 #define WPL_WIFI_SSID_LENGTH      32U
 #define WPL_WIFI_PASSWORD_MIN_LEN 8U
@@ -18,8 +19,15 @@
 #define WPL_WIFI_AP_IP_ADDR "192.168.1.1"
 #endif /* WPL_WIFI_AP_IP_ADDR */
 
+/* Called with false when the STA link or its address is lost, with true when it is back */
 typedef void (*linkLostCb_t)(bool linkState);
 
+/* Called for every network found by WPL_Scan, and with channel 0 once the scan is complete */
+typedef void (*scanResultCb_t)(int channel, int rssi_dbm);
+
+/* Called when the STA DHCP lease returned by WPL_GetDhcpLease changed */
+typedef void (*dhcpLeaseCb_t)(void);
+
 typedef enum _wpl_ret
 {
     WPLRET_SUCCESS,
@@ -33,6 +41,16 @@ typedef enum _wpl_ret
     WPLRET_BAD_PARAM,
 } wpl_ret_t;
 
+/* DHCP lease of the STA interface, addresses in network byte order */
+typedef struct _wpl_dhcp_lease
+{
+    uint32_t address;
+    uint32_t netmask;
+    uint32_t gateway;
+    uint32_t server;     /* DHCP server which granted the lease */
+    uint32_t lease_time; /* seconds */
+} wpl_dhcp_lease_t;
+
 typedef enum _wpl_security
 {
     /* Used when the user only knows SSID and password. This option should be used
@@ -107,6 +125,47 @@ wpl_ret_t WPL_Stop_AP(void);
  */
 char *WPL_Scan(void);
 
+/**
+ * @brief  Register a function observing the results of WPL_Scan.
+ *         It is called from the Wi-Fi driver context for every network found (channel, signal strength),
+ *         and once with channel 0 when the scan is complete.
+ *
+ * @param  callbackFunction Observer, NULL to unregister.
+ */
+void WPL_SetScanResultCallback(scanResultCb_t callbackFunction);
+
+/**
+ * @brief  Set the DHCP lease the next WPL_Join confirms with the server instead of discovering one.
+ *         The leased address is used while the server confirms it; if the server refuses it,
+ *         a new lease is discovered. Reconnections reuse the last lease without this call,
+ *         it restores a lease saved before a reset.
+ *
+ * @param  lease Lease of an earlier session on the network about to be joined, NULL to discover a new lease.
+ *
+ * @return WPLRET_SUCCESS Lease set.
+ */
+wpl_ret_t WPL_SetDhcpLease(const wpl_dhcp_lease_t *lease);
+
+/**
+ * @brief  Get the DHCP lease of the last successful WPL_Join, to be saved for the next session.
+ *
+ * @param  lease Lease.
+ *
+ * @return WPLRET_SUCCESS Lease returned.
+ * @return WPLRET_NOT_FOUND No lease.
+ */
+wpl_ret_t WPL_GetDhcpLease(wpl_dhcp_lease_t *lease);
+
+/**
+ * @brief  Register a function told when the STA DHCP lease changed, so that it can be saved again.
+ *         This happens when the server confirms or grants a lease, including a new address after the
+ *         server refused the one used since WPL_Join. Renewals of the same lease are not reported.
+ *         It is called from the TCP/IP thread, it must not block.
+ *
+ * @param  callbackFunction Observer, NULL to unregister.
+ */
+void WPL_SetDhcpLeaseCallback(dhcpLeaseCb_t callbackFunction);
+
 /**
  * @brief  Create and save a new STA (Station) network profile.
  *         This STA network profile can be used in future (WPL_RemoveNetwork / WPL_Join) calls based on its label.
@@ -176,4 +235,34 @@ wpl_ret_t WPL_Leave(void);
  */
 wpl_ret_t WPL_GetIP(char *ip, int client);
 
+/**
+ * @brief  Check if an individual TWT (Target Wake Time) agreement can be negotiated.
+ *
+ * @return true if the STA interface is connected and both the AP and the Wi-Fi firmware support TWT.
+ */
+bool WPL_TwtSupported(void);
+
+/**
+ * @brief  Request an individual TWT agreement with the AP the STA interface is connected to.
+ *         Between the service periods the radio sleeps and the AP buffers the downlink traffic.
+ *         WPL_TwtSetup should be called only after WPL_Join was successfully performed.
+ *
+ * @param  interval_us Time between the starts of two service periods.
+ * @param  wake_duration_us Length of a service period, rounded up to 256 us units (at most 65280 us).
+ * @param  flow_id TWT flow identifier (0 - 7).
+ *
+ * @return WPLRET_SUCCESS The agreement was accepted by the AP.
+ *         WPLRET_FAIL TWT is not supported or the AP rejected the agreement.
+ */
+wpl_ret_t WPL_TwtSetup(uint32_t interval_us, uint32_t wake_duration_us, uint8_t flow_id);
+
+/**
+ * @brief  Tear down an individual TWT agreement set up by WPL_TwtSetup.
+ *
+ * @param  flow_id TWT flow identifier of the agreement.
+ *
+ * @return WPLRET_SUCCESS The agreement was torn down.
+ */
+wpl_ret_t WPL_TwtTeardown(uint8_t flow_id);
+
 #endif /* _WPL_H_ */
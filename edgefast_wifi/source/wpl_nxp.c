@@ -75,9 +75,11 @@ typedef enum _wpl_state
  ******************************************************************************/
 static wpl_state_t s_wplState            = WPL_NOT_INITIALIZED;
 static bool s_wplStaConnected            = false;
+static bool s_wplStaAddrLost             = false;
 static bool s_wplUapActivated            = false;
 static EventGroupHandle_t s_wplSyncEvent = NULL;
 static linkLostCb_t s_linkLostCb         = NULL;
+static scanResultCb_t s_scanResultCb     = NULL;
 static char *ssids_json                  = NULL;
 
 /*******************************************************************************
@@ -160,8 +162,23 @@ int wlan_event_callback(enum wlan_event_reason reason, void *data)
             break;
 
         case WLAN_REASON_ADDRESS_SUCCESS:
+            /* DHCP bound again after the address was lost */
+            if (s_wplStaAddrLost)
+            {
+                s_wplStaAddrLost = false;
+                if (s_wplStaConnected)
+                {
+                    s_linkLostCb(true);
+                }
+            }
             break;
         case WLAN_REASON_ADDRESS_FAILED:
+            /* The lease was refused or could not be renewed, the address is gone */
+            s_wplStaAddrLost = true;
+            if (s_wplStaConnected)
+            {
+                s_linkLostCb(false);
+            }
             break;
         case WLAN_REASON_LINK_LOST:
             if (s_wplStaConnected)
@@ -538,6 +555,11 @@ static int WLP_process_results(unsigned int count)
             PRINTF("     RSSI          : %ddBm\r\n", -(int)scan_result.rssi);
             PRINTF("     Channel       : %d\r\n", (int)scan_result.channel);
 
+            if (s_scanResultCb != NULL)
+            {
+                s_scanResultCb((int)scan_result.channel, -(int)scan_result.rssi);
+            }
+
             char security[40];
             security[0] = '\0';
 
@@ -593,6 +615,11 @@ static int WLP_process_results(unsigned int count)
     /* End of JSON "]}" */
     (void)strcpy(ssids_json + ssids_json_idx, "]}");
 
+    if (s_scanResultCb != NULL)
+    {
+        s_scanResultCb(0, 0);
+    }
+
     (void)xEventGroupSetBits(s_wplSyncEvent, EVENT_BIT(WPL_EVENT_SCAN_DONE));
     return WM_SUCCESS;
 }
@@ -638,6 +665,71 @@ char *WPL_Scan(void)
     return NULL;
 }
 
+void WPL_SetScanResultCallback(scanResultCb_t callbackFunction)
+{
+    s_scanResultCb = callbackFunction;
+}
+
+wpl_ret_t WPL_SetDhcpLease(const wpl_dhcp_lease_t *lease)
+{
+#if LWIP_DHCP_INIT_REBOOT
+    net_dhcp_lease_t net_lease;
+
+    if (lease == NULL)
+    {
+        (void)net_dhcp_lease_set(NULL);
+        return WPLRET_SUCCESS;
+    }
+
+    net_lease.address    = lease->address;
+    net_lease.netmask    = lease->netmask;
+    net_lease.gw         = lease->gateway;
+    net_lease.server     = lease->server;
+    net_lease.lease_time = lease->lease_time;
+    (void)net_dhcp_lease_set(&net_lease);
+    return WPLRET_SUCCESS;
+#else
+    (void)lease;
+    return WPLRET_FAIL;
+#endif
+}
+
+wpl_ret_t WPL_GetDhcpLease(wpl_dhcp_lease_t *lease)
+{
+#if LWIP_DHCP_INIT_REBOOT
+    net_dhcp_lease_t net_lease;
+
+    if (lease == NULL)
+    {
+        return WPLRET_BAD_PARAM;
+    }
+
+    if (net_dhcp_lease_get(&net_lease) != WM_SUCCESS)
+    {
+        return WPLRET_NOT_FOUND;
+    }
+
+    lease->address    = net_lease.address;
+    lease->netmask    = net_lease.netmask;
+    lease->gateway    = net_lease.gw;
+    lease->server     = net_lease.server;
+    lease->lease_time = net_lease.lease_time;
+    return WPLRET_SUCCESS;
+#else
+    (void)lease;
+    return WPLRET_NOT_FOUND;
+#endif
+}
+
+void WPL_SetDhcpLeaseCallback(dhcpLeaseCb_t callbackFunction)
+{
+#if LWIP_DHCP_INIT_REBOOT
+    net_dhcp_lease_set_callback(callbackFunction);
+#else
+    (void)callbackFunction;
+#endif
+}
+
 wpl_ret_t WPL_AddNetworkWithSecurity(const char *ssid, const char *password, const char *label, wpl_security_t security)
 {
     wpl_ret_t status = WPLRET_SUCCESS;
@@ -774,6 +866,7 @@ wpl_ret_t WPL_Join(char *label)
     if (status == WPLRET_SUCCESS)
     {
         (void)xEventGroupClearBits(s_wplSyncEvent, WPL_SYNC_CONNECT_GROUP);
+        s_wplStaAddrLost = false;
 
         ret = wlan_connect(label);
         if (ret != WM_SUCCESS)
@@ -914,3 +1007,96 @@ wpl_ret_t WPL_GetIP(char *ip, int client)
 
     return status;
 }
+
+#if CONFIG_11AX_TWT
+/* The wake interval is sent as mantissa * 2^exponent us */
+static void WPL_TwtEncodeInterval(uint32_t interval_us, uint16_t *mantissa, uint8_t *exponent)
+{
+    uint8_t exp = 0U;
+
+    while (interval_us > UINT16_MAX)
+    {
+        interval_us >>= 1;
+        exp++;
+    }
+    *mantissa = (uint16_t)interval_us;
+    *exponent = exp;
+}
+#endif /* CONFIG_11AX_TWT */
+
+bool WPL_TwtSupported(void)
+{
+#if CONFIG_11AX_TWT
+    return s_wplStaConnected && wlan_is_twt_supported();
+#else
+    return false;
+#endif
+}
+
+wpl_ret_t WPL_TwtSetup(uint32_t interval_us, uint32_t wake_duration_us, uint8_t flow_id)
+{
+#if CONFIG_11AX_TWT
+    wlan_twt_setup_config_t twt_setup;
+    uint32_t wake_units = (wake_duration_us + 255U) / 256U;
+    uint16_t mantissa;
+    uint8_t exponent;
+
+    if ((s_wplState != WPL_STARTED) || (s_wplStaConnected == false))
+    {
+        return WPLRET_NOT_CONNECTED;
+    }
+
+    if ((flow_id > 7U) || (wake_units == 0U) || (wake_units > UINT8_MAX) || (interval_us <= wake_units * 256U))
+    {
+        return WPLRET_BAD_PARAM;
+    }
+
+    if (!wlan_is_twt_supported())
+    {
+        return WPLRET_FAIL;
+    }
+
+    /* Start from the driver defaults: individual, implicit, unannounced */
+    twt_setup                     = *wlan_get_twt_setup_cfg();
+    twt_setup.twt_wakeup_duration = (uint8_t)wake_units;
+    twt_setup.flow_identifier     = flow_id;
+    WPL_TwtEncodeInterval(interval_us, &mantissa, &exponent);
+    twt_setup.twt_mantissa = mantissa;
+    twt_setup.twt_exponent = exponent;
+
+    if (wlan_set_twt_setup_cfg(&twt_setup) != WM_SUCCESS)
+    {
+        return WPLRET_FAIL;
+    }
+    return WPLRET_SUCCESS;
+#else
+    (void)interval_us;
+    (void)wake_duration_us;
+    (void)flow_id;
+    return WPLRET_FAIL;
+#endif
+}
+
+wpl_ret_t WPL_TwtTeardown(uint8_t flow_id)
+{
+#if CONFIG_11AX_TWT
+    wlan_twt_teardown_config_t teardown;
+
+    if ((s_wplState != WPL_STARTED) || (s_wplStaConnected == false))
+    {
+        return WPLRET_NOT_CONNECTED;
+    }
+
+    teardown                 = *wlan_get_twt_teardown_cfg();
+    teardown.flow_identifier = flow_id;
+
+    if (wlan_set_twt_teardown_cfg(&teardown) != WM_SUCCESS)
+    {
+        return WPLRET_FAIL;
+    }
+    return WPLRET_SUCCESS;
+#else
+    (void)flow_id;
+    return WPLRET_FAIL;
+#endif
+}
@@ -29,10 +29,55 @@
  * Author: Adam Dunkels <adam@sics.se>
  *
  */
+
 #ifndef __PERF_H__
 #define __PERF_H__
 
-#define PERF_START   /* null definition */
-#define PERF_STOP(x) /* null definition */
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Cycle count statistics of code sections enclosed in PERF_START/PERF_STOP
+ * (only included when LWIP_PERF is enabled). Each PERF_STOP name gets an entry
+ * with number of runs and min/max/average cycles, printed by lwip_perf_dump()
+ * one per line as:
+ *   perf,<name>,<count>,<min>,<max>,<avg>
+ *
+ * PERF_START declares the start cycle count, as lwIP core expects (udp_input
+ * has two PERF_STOP for one PERF_START). A return or goto past PERF_STOP drops
+ * that run, so outside the core keep each pair in its own block with the
+ * section straight-line between them:
+ *   {
+ *       PERF_START;
+ *       ...
+ *       PERF_STOP("name");
+ *   }
+ */
+
+/* Number of distinct PERF_STOP names which can be recorded */
+#ifndef LWIP_PERF_MAX_ENTRIES
+#define LWIP_PERF_MAX_ENTRIES 16
+#endif
+
+/* Expected average cycles of a measured section, see lwip_perf_compare() */
+typedef struct lwip_perf_baseline
+{
+    const char *name;
+    uint32_t avg;
+} lwip_perf_baseline_t;
+
+uint32_t lwip_perf_cycles(void);
+void lwip_perf_record(const char *name, uint32_t cycles);
+void lwip_perf_reset(void);
+void lwip_perf_dump(void);
+/* Stores the current average of up to count sections into baseline, to be
+ * compared later with lwip_perf_compare(). Returns number of them. */
+size_t lwip_perf_snapshot(lwip_perf_baseline_t *baseline, size_t count);
+/* Prints a "perf-regression" line for each baseline entry whose measured
+ * average exceeds it by more than tolerance percent. Returns number of them. */
+int lwip_perf_compare(const lwip_perf_baseline_t *baseline, size_t count, uint32_t tolerance);
+
+#define PERF_START   uint32_t lwip_perf_start = lwip_perf_cycles()
+#define PERF_STOP(x) lwip_perf_record((x), lwip_perf_cycles() - lwip_perf_start)
 
-#endif               /* __PERF_H__ */
+#endif /* __PERF_H__ */
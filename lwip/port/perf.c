@@ -0,0 +1,180 @@
+/*
+ * perf.c
+ * Cycle count statistics for PERF_START/PERF_STOP (LWIP_PERF).
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "lwip/opt.h"
+
+#if LWIP_PERF
+
+#include "lwip/def.h"
+#include "lwip/sys.h"
+#include "arch/perf.h"
+
+#include <string.h>
+
+#ifndef LWIP_PERF_GET_CYCLES
+#include "fsl_common.h"
+#endif
+
+typedef struct lwip_perf_entry
+{
+    const char *name;
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t total;
+} lwip_perf_entry_t;
+
+static lwip_perf_entry_t lwip_perf_entries[LWIP_PERF_MAX_ENTRIES];
+static uint32_t lwip_perf_dropped;
+
+uint32_t lwip_perf_cycles(void)
+{
+#ifdef LWIP_PERF_GET_CYCLES
+    return LWIP_PERF_GET_CYCLES();
+#else
+    static bool enabled = false;
+
+    if (!enabled)
+    {
+        MSDK_EnableCpuCycleCounter();
+        enabled = true;
+    }
+    return MSDK_GetCpuCycleCount();
+#endif
+}
+
+static lwip_perf_entry_t *lwip_perf_find(const char *name)
+{
+    int i;
+
+    for (i = 0; i < LWIP_PERF_MAX_ENTRIES; i++)
+    {
+        lwip_perf_entry_t *entry = &lwip_perf_entries[i];
+
+        if (entry->name == NULL)
+        {
+            return NULL;
+        }
+        /* The same literal may have several copies */
+        if ((entry->name == name) || (strcmp(entry->name, name) == 0))
+        {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+void lwip_perf_record(const char *name, uint32_t cycles)
+{
+    lwip_perf_entry_t *entry;
+    int i;
+    SYS_ARCH_DECL_PROTECT(old_level);
+
+    SYS_ARCH_PROTECT(old_level);
+    entry = lwip_perf_find(name);
+    if (entry == NULL)
+    {
+        for (i = 0; (i < LWIP_PERF_MAX_ENTRIES) && (lwip_perf_entries[i].name != NULL); i++)
+        {
+        }
+        if (i == LWIP_PERF_MAX_ENTRIES)
+        {
+            lwip_perf_dropped++;
+            SYS_ARCH_UNPROTECT(old_level);
+            return;
+        }
+        entry       = &lwip_perf_entries[i];
+        entry->name = name;
+        entry->min  = UINT32_MAX;
+    }
+
+    entry->count++;
+    entry->total += cycles;
+    if (cycles < entry->min)
+    {
+        entry->min = cycles;
+    }
+    if (cycles > entry->max)
+    {
+        entry->max = cycles;
+    }
+    SYS_ARCH_UNPROTECT(old_level);
+}
+
+void lwip_perf_reset(void)
+{
+    SYS_ARCH_DECL_PROTECT(old_level);
+
+    SYS_ARCH_PROTECT(old_level);
+    memset(lwip_perf_entries, 0, sizeof(lwip_perf_entries));
+    lwip_perf_dropped = 0;
+    SYS_ARCH_UNPROTECT(old_level);
+}
+
+static uint32_t lwip_perf_avg(const lwip_perf_entry_t *entry)
+{
+    return (entry->count != 0) ? (uint32_t)(entry->total / entry->count) : 0;
+}
+
+void lwip_perf_dump(void)
+{
+    int i;
+
+    for (i = 0; (i < LWIP_PERF_MAX_ENTRIES) && (lwip_perf_entries[i].name != NULL); i++)
+    {
+        const lwip_perf_entry_t *entry = &lwip_perf_entries[i];
+
+        LWIP_PLATFORM_DIAG(("perf,%s,%u,%u,%u,%u\r\n", entry->name, (unsigned int)entry->count,
+                            (unsigned int)entry->min, (unsigned int)entry->max, (unsigned int)lwip_perf_avg(entry)));
+    }
+    if (lwip_perf_dropped != 0)
+    {
+        LWIP_PLATFORM_DIAG(("perf-dropped,%u\r\n", (unsigned int)lwip_perf_dropped));
+    }
+}
+
+size_t lwip_perf_snapshot(lwip_perf_baseline_t *baseline, size_t count)
+{
+    size_t i;
+    SYS_ARCH_DECL_PROTECT(old_level);
+
+    SYS_ARCH_PROTECT(old_level);
+    for (i = 0; (i < count) && (i < LWIP_PERF_MAX_ENTRIES) && (lwip_perf_entries[i].name != NULL); i++)
+    {
+        baseline[i].name = lwip_perf_entries[i].name;
+        baseline[i].avg  = lwip_perf_avg(&lwip_perf_entries[i]);
+    }
+    SYS_ARCH_UNPROTECT(old_level);
+    return i;
+}
+
+int lwip_perf_compare(const lwip_perf_baseline_t *baseline, size_t count, uint32_t tolerance)
+{
+    int regressions = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++)
+    {
+        const lwip_perf_entry_t *entry = lwip_perf_find(baseline[i].name);
+        uint32_t avg;
+
+        if ((entry == NULL) || (entry->count == 0))
+        {
+            continue;
+        }
+        avg = lwip_perf_avg(entry);
+        if ((uint64_t)avg * 100U > (uint64_t)baseline[i].avg * (100U + tolerance))
+        {
+            LWIP_PLATFORM_DIAG(("perf-regression,%s,%u,%u\r\n", baseline[i].name, (unsigned int)baseline[i].avg,
+                                (unsigned int)avg));
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+#endif /* LWIP_PERF */
@@ -96,6 +96,28 @@ void HTTPSRV_release(uint32_t server_h)
     }
 }
 
+/*
+** Function for flushing the authentication cache
+**
+** IN:
+**      uint32_t       server_h - server handle
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      none
+*/
+void HTTPSRV_auth_flush(uint32_t server_h)
+{
+    HTTPSRV_STRUCT *server = (void *)server_h;
+
+    if (server)
+    {
+        httpsrv_auth_cache_flush(server);
+    }
+}
+
 /*
 ** Write data to client from CGI script
 **
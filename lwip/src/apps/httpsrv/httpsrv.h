@@ -273,6 +273,12 @@ uint32_t HTTPSRV_cgi_write(HTTPSRV_CGI_RES_STRUCT *response);
 uint32_t HTTPSRV_cgi_read(uint32_t ses_handle, char *buffer, uint32_t length);
 uint32_t HTTPSRV_ssi_write(uint32_t ses_handle, char *data, uint32_t length);
 
+/*
+** Forget cached credential verifications. Call after changing the users of
+** an authentication realm.
+*/
+void HTTPSRV_auth_flush(uint32_t server_h);
+
 #ifdef __cplusplus
 }
 #endif
@@ -77,6 +77,29 @@
 #define HTTPSRV_CFG_MAX_SCRIPT_LN (32)
 #endif
 
+/* Number of verified Basic auth credentials remembered by the server.
+ * Zero disables the cache. */
+#ifndef HTTPSRV_CFG_AUTH_CACHE_SIZE
+#define HTTPSRV_CFG_AUTH_CACHE_SIZE (4)
+#endif
+
+/* Maximal length of cached credentials (base64 part of the Authorization
+ * header). Longer credentials are verified on every request. */
+#ifndef HTTPSRV_CFG_AUTH_CACHE_KEY_LEN
+#define HTTPSRV_CFG_AUTH_CACHE_KEY_LEN (64)
+#endif
+
+/* Lifetime of a cached credential verification in milliseconds */
+#ifndef HTTPSRV_CFG_AUTH_CACHE_TIMEOUT
+#define HTTPSRV_CFG_AUTH_CACHE_TIMEOUT (300000)
+#endif
+
+/* Maximal number of byte ranges in a request for a static file. Requests
+ * with more ranges get the whole file. Zero disables range requests. */
+#ifndef HTTPSRV_CFG_MAX_RANGES
+#define HTTPSRV_CFG_MAX_RANGES (4)
+#endif
+
 #ifndef HTTPSRV_CFG_KEEPALIVE_ENABLED
 #define HTTPSRV_CFG_KEEPALIVE_ENABLED (0)
 #endif
@@ -91,6 +114,53 @@
 #define HTTPSRV_CFG_SES_TIMEOUT (20000)
 #endif
 
+/* Admission control. When all sessions are busy, new connections are answered
+ * with "503 Service Unavailable" instead of waiting in the listen backlog. */
+#ifndef HTTPSRV_CFG_ADMISSION_ENABLED
+#define HTTPSRV_CFG_ADMISSION_ENABLED (0)
+#endif
+
+/* Time in milliseconds a new connection waits for a session before it is
+ * rejected. At least the keep-alive timeout, so that a browser opening a new
+ * connection while its others sit in keep-alive gets served, not rejected. */
+#ifndef HTTPSRV_CFG_ADMISSION_WAIT
+#define HTTPSRV_CFG_ADMISSION_WAIT (HTTPSRV_CFG_KEEPALIVE_TIMEOUT)
+#endif
+
+/* Retry-After value (seconds) sent with 503 responses */
+#ifndef HTTPSRV_CFG_RETRY_AFTER
+#define HTTPSRV_CFG_RETRY_AFTER (1)
+#endif
+
+/* Maximal number of sessions of one client address, further connections of the
+ * client get 503. Browsers open up to six connections to a host. Zero means no limit. */
+#ifndef HTTPSRV_CFG_MAX_SES_PER_CLIENT
+#define HTTPSRV_CFG_MAX_SES_PER_CLIENT (6)
+#endif
+
+/* Number of sessions kept for priority requests (CGI scripts and
+ * HTTPSRV_CFG_PRIORITY_PATH), so that the status of the device can be read
+ * while static pages take the other sessions. Other requests get 503 in these
+ * sessions. None are kept when there are only two sessions. */
+#ifndef HTTPSRV_CFG_PRIORITY_SES
+#if HTTPSRV_CFG_DEFAULT_SES_CNT > 2
+#define HTTPSRV_CFG_PRIORITY_SES (1)
+#else
+#define HTTPSRV_CFG_PRIORITY_SES (0)
+#endif
+#endif
+
+/* Path prefix of priority requests (e.g. device status pages) */
+#ifndef HTTPSRV_CFG_PRIORITY_PATH
+#define HTTPSRV_CFG_PRIORITY_PATH "/status"
+#endif
+
+/* When a connection is rejected, sessions still waiting for a complete
+ * request for longer than this (milliseconds) are closed to make room. */
+#ifndef HTTPSRV_CFG_IDLE_RECLAIM_TIMEOUT
+#define HTTPSRV_CFG_IDLE_RECLAIM_TIMEOUT (2000)
+#endif
+
 /* Socket OPT_SEND_TIMEOUT option value */
 #ifndef HTTPSRV_CFG_SEND_TIMEOUT
 #define HTTPSRV_CFG_SEND_TIMEOUT (0)
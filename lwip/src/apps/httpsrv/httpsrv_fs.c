@@ -14,6 +14,8 @@
  */
 #include "httpsrv_fs.h"
 #include "httpsrv_port.h"
+#include "lwip/opt.h"
+#include "lwip/def.h"
 
 static int32_t httpsrv_fs_cmp(char *, char *);
 static const HTTPSRV_FS_DIR_ENTRY *httpsrv_fs_open_file(char *, int32_t *);
@@ -55,7 +57,11 @@ HTTPSRV_FS_FILE_PTR HTTPSRV_FS_open(
 
     if (open_name_ptr && (*open_name_ptr != '\0'))
     {
-        entry = httpsrv_fs_open_file(open_name_ptr, &error_code);
+        {
+            PERF_START;
+            entry = httpsrv_fs_open_file(open_name_ptr, &error_code);
+            PERF_STOP("httpsrv_fs_lookup");
+        }
         if (entry && (error_code == HTTPSRV_FS_OK))
         {
             fd_ptr = httpsrv_mem_alloc(sizeof(HTTPSRV_FS_FILE));
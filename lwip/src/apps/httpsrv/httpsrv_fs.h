@@ -80,6 +80,22 @@
 #define HTTPSRV_FS_IO_SEEK_CUR (2) /* Seek from current location */
 #define HTTPSRV_FS_IO_SEEK_END (3) /* Seek from end */
 
+/*
+** Span of a precompiled server side include template, generated at build time
+** by tools/httpsrv_ssi_compile.py. The server sends SIZE bytes of file data at
+** OFFSET as they are, then calls entry SSI_INDEX of the server's SSI link table
+** with PARAM (the text after ':'). SSI_INDEX is -1 for no call (last span or
+** unknown function). The SSI names given to the compiler must be in the same
+** order as the SSI link table.
+*/
+typedef struct httpsrv_fs_ssi_span
+{
+    uint32_t OFFSET;
+    uint32_t SIZE;
+    int32_t SSI_INDEX;
+    const char *PARAM;
+} HTTPSRV_FS_SSI_SPAN;
+
 /*
 ** HTTP_SRV directory entry information
 */
@@ -89,6 +105,9 @@ typedef struct httpsrv_fs_dir_entry
     uint32_t FLAGS;
     unsigned char *DATA;
     uint32_t SIZE;
+    const HTTPSRV_FS_SSI_SPAN *SSI; /* Precompiled SSI template, NULL if none */
+    uint32_t SSI_COUNT;             /* Number of spans in SSI */
+    uint32_t ETAG;                  /* FNV-1a hash of the file data, computed with the image; 0 if not */
 } HTTPSRV_FS_DIR_ENTRY, *HTTPSRV_FS_DIR_ENTRY_PTR;
 
 /* FILE STRUCTURE */
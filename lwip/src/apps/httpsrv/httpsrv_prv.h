@@ -19,6 +19,7 @@
 #include <stdio.h>
 
 #include "lwip/sys.h"
+#include "lwip/sockets.h"
 
 #define HTTPSRV_PRODUCT_STRING      "HTTPSRV/0.1 - NXP Embedded Web Server v0.1"
 #define HTTPSRV_PROTOCOL_STRING     "HTTP/1.1"
@@ -28,6 +29,10 @@
 #define HTTPSRV_SES_BUF_SIZE_PRV    (HTTPSRV_CFG_SES_BUFFER_SIZE)
 #define HTTPSRV_TMP_BUFFER_SIZE     (128)
 #define HTTPSRV_PLUGIN_NUM_MESSAGES (5)
+#define HTTPSRV_REALM_BUCKETS       (16) /* Realm index groups, plus one for paths shorter than two characters */
+#define HTTPSRV_ETAG_LEN            (20) /* "xxxxxxxx-xxxxxxxx" with quotes and terminator */
+#define HTTPSRV_RANGE_BOUNDARY      "HTTPSRV_BYTERANGES"
+#define HTTPSRV_RANGE_SUFFIX        (0xFFFFFFFFU) /* Range start of "bytes=-N" (last N bytes) */
 
 #define HTTPSRV_FLAG_PROCESS_HEADER     (1 << 0) /* Flag for indication of header processing */
 #define HTTPSRV_FLAG_HAS_HOST           (1 << 1) /* Flag determining if request header has "host" field */
@@ -38,6 +43,7 @@
 #define HTTPSRV_FLAG_KEEP_ALIVE_ENABLED (1 << 6) /* Keep-alive enabled/disabled for session */
 #define HTTPSRV_FLAG_HAS_CONTENT_LENGTH (1 << 7) /* Flag signalizing presence of Content-Length in request. */
 #define HTTPSRV_FLAG_HEADER_SENT        (1 << 8) /* Flag signalizing if response header was sent. */
+#define HTTPSRV_FLAG_ACCEPT_RANGES      (1 << 9) /* Response is a static file which may be requested by ranges */
 
 /*
 **  Wildcard typedef for CGI/SSI callback prototype
@@ -104,6 +110,17 @@ typedef enum httpsrv_upgrade_prot
     HTTPSRV_TLS_PROTOCOL
 } HTTPSRV_UPGRADE_PROT;
 
+#if HTTPSRV_CFG_MAX_RANGES
+/*
+ * Byte range of a static file (inclusive)
+ */
+typedef struct httpsrv_range
+{
+    uint32_t start; /* First byte, HTTPSRV_RANGE_SUFFIX for a suffix range */
+    uint32_t end;   /* Last byte, suffix length for a suffix range */
+} HTTPSRV_RANGE;
+#endif
+
 /*
  * HTTP request parameters
  */
@@ -118,6 +135,16 @@ typedef struct httpsrv_req_struct
     char *query;                     /* Data send in URL */
     HTTPSRV_AUTH_USER_STRUCT auth;   /* Authentication credentials received from client */
     HTTPSRV_UPGRADE_PROT upgrade_to; /* Protocol to upgrade to. Zero = no upgrade. */
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    bool auth_cached;                /* auth points into the user table, nothing to free */
+    uint32_t auth_hash;              /* Hash of auth_key */
+    char auth_key[HTTPSRV_CFG_AUTH_CACHE_KEY_LEN]; /* Base64 credentials, empty if too long */
+#endif
+#if HTTPSRV_CFG_MAX_RANGES
+    uint32_t range_cnt;                            /* Number of requested ranges, zero for whole file */
+    HTTPSRV_RANGE range[HTTPSRV_CFG_MAX_RANGES];   /* Requested ranges */
+    char if_range[HTTPSRV_ETAG_LEN];               /* If-Range validator, empty if not present */
+#endif
 } HTTPSRV_REQ_STRUCT;
 
 /*
@@ -131,6 +158,11 @@ typedef struct httpsrv_res_struct
     const HTTPSRV_AUTH_REALM_STRUCT *auth_realm; /* Authentication realm */
     int content_type;                            /* Content type */
     char script_buffer[3];                       /* Buffer for script tag search. */
+    uint32_t ssi_span;                           /* Next span of a precompiled SSI template. */
+#if HTTPSRV_CFG_MAX_RANGES
+    uint32_t range;                              /* Range being sent */
+    bool range_started;                          /* Part header of the range was sent */
+#endif
 } HTTPSRV_RES_STRUCT;
 
 /*
@@ -142,6 +174,26 @@ typedef struct httpsrv_buffer
     char *data;      /* Buffer data */
 } HTTPSRV_BUFF_STRUCT;
 
+/*
+ * Admission state of a session slot
+ */
+#define HTTPSRV_ADM_FREE (0) /* Slot unused */
+#define HTTPSRV_ADM_IDLE (1) /* Waiting for a complete request */
+#define HTTPSRV_ADM_BUSY (2) /* Processing a request */
+
+/*
+ * Admission control slot, one per session. Shared by the server task, which
+ * reads it to limit and reclaim sessions, and the session task, which owns it.
+ */
+typedef struct httpsrv_adm_slot
+{
+    struct sockaddr_storage peer; /* Client address */
+    volatile uint32_t time;       /* Start of the current idle period */
+    volatile uint8_t state;       /* HTTPSRV_ADM_FREE/IDLE/BUSY */
+    volatile uint8_t reclaim;     /* Set by server task: close the session if it is still idle */
+    volatile uint8_t priority;    /* Session serves priority requests only */
+} HTTPSRV_ADM_SLOT;
+
 /*
  * Session process function prototype
  */
@@ -172,6 +224,9 @@ typedef struct httpsrv_session_struct
     httpsrv_tls_sock_t tls_sock;
 #endif
     uint32_t flags; /* Session flags */
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    HTTPSRV_ADM_SLOT *adm; /* Admission control slot */
+#endif
 
 } HTTPSRV_SESSION_STRUCT;
 
@@ -188,12 +243,28 @@ typedef struct httpsrv_plugin_msg
 } HTTPSRV_PLUGIN_MSG;
 #endif
 
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+/*
+** Credentials verified for a realm.
+*/
+typedef struct httpsrv_auth_cache_entry
+{
+    uint32_t hash;                          /* Hash of key, zero for an unused entry */
+    uint32_t cred_hash;                     /* Hash of the user's name and password when verified */
+    uint32_t time;                          /* Time of verification */
+    const HTTPSRV_AUTH_REALM_STRUCT *realm; /* Realm the credentials are valid for */
+    const HTTPSRV_AUTH_USER_STRUCT *user;   /* Matching entry of the realm's user table */
+    char key[HTTPSRV_CFG_AUTH_CACHE_KEY_LEN]; /* Base64 credentials from the Authorization header */
+} HTTPSRV_AUTH_CACHE_ENTRY;
+#endif
+
 /*
 ** HTTP server main structure.
 */
 typedef struct httpsrv_struct
 {
     HTTPSRV_PARAM_STRUCT params;               /* Server parameters */
+    uint32_t ssi_cnt;                          /* Number of entries in params.ssi_lnk_tbl */
     volatile int sock;                         /* Listening socket */
     HTTPSRV_SESSION_STRUCT *volatile *session; /* Array of pointers to sessions */
     volatile uint32_t valid;                   /* Any value different than HTTPSRV_VALID means session is invalid */
@@ -201,6 +272,16 @@ typedef struct httpsrv_struct
     void *script_msgq;                         /* Message queue for CGI */
     sys_sem_t ses_cnt;                         /* Session counter */
     sys_sem_t finished;        /* Server finished, field is used after httpsrv_destroy_server is called */
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    HTTPSRV_ADM_SLOT *adm;     /* Admission slots, indexed like session */
+#endif
+    const HTTPSRV_AUTH_REALM_STRUCT **realm_index;       /* Realms grouped by their first two path characters */
+    uint16_t realm_group[HTTPSRV_REALM_BUCKETS + 2];     /* Start of each group in realm_index */
+    uint8_t realm_first[32];                             /* First characters of the realm paths, one bit each */
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    sys_mutex_t auth_lock;                               /* Protects auth_cache */
+    HTTPSRV_AUTH_CACHE_ENTRY auth_cache[HTTPSRV_CFG_AUTH_CACHE_SIZE];
+#endif
 #if HTTPSRV_CFG_WOLFSSL_ENABLE || HTTPSRV_CFG_MBEDTLS_ENABLE
     httpsrv_tls_ctx_t tls_ctx; /* TLS context */
 #endif
@@ -158,6 +158,43 @@ void httpsrv_call_ssi(HTTPSRV_SSI_CALLBACK_FN function,
     function(&ssi_param);
 }
 
+/*
+** Function for SSI calling from a precompiled template
+**
+** IN:
+**      HTTPSRV_STRUCT* server - server structure (SSI link table).
+**
+**      HTTPSRV_SESSION_STRUCT* session - session requesting script.
+**
+**      int32_t index - index of the function in the SSI link table.
+**
+**      const char* param - SSI command parameter.
+** OUT:
+**      none
+**
+** Return Value:
+**      none
+*/
+void httpsrv_call_ssi_index(HTTPSRV_STRUCT *server,
+                            HTTPSRV_SESSION_STRUCT *session,
+                            int32_t index,
+                            const char *param)
+{
+    HTTPSRV_SSI_PARAM_STRUCT ssi_param;
+
+    /* Template compiled against a different table - ignore the call. */
+    if ((index < 0) || ((uint32_t)index >= server->ssi_cnt))
+    {
+        return;
+    }
+
+    ssi_param.ses_handle = (uint32_t)session;
+    ssi_param.com_param  = (char *)((param != NULL) ? param : "");
+
+    server->params.ssi_lnk_tbl[index].callback(&ssi_param);
+    httpsrv_ses_flush(session);
+}
+
 /*
 ** Task for CGI/SSI handling.
 */
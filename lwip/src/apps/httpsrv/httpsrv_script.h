@@ -20,6 +20,10 @@ void httpsrv_detach_script(HTTPSRV_DET_TASK_PARAM *task_params);
 HTTPSRV_FN_CALLBACK httpsrv_find_callback(HTTPSRV_FN_LINK_STRUCT *table, char *name);
 void httpsrv_call_cgi(HTTPSRV_CGI_CALLBACK_FN function, HTTPSRV_SESSION_STRUCT *session, char *name);
 void httpsrv_call_ssi(HTTPSRV_SSI_CALLBACK_FN function, HTTPSRV_SESSION_STRUCT *session, char *name);
+void httpsrv_call_ssi_index(HTTPSRV_STRUCT *server,
+                            HTTPSRV_SESSION_STRUCT *session,
+                            int32_t index,
+                            const char *param);
 void httpsrv_process_cgi(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, char *cgi_name);
 void httpsrv_script_handler(HTTPSRV_STRUCT *server,
                             HTTPSRV_SESSION_STRUCT *session,
@@ -217,7 +217,9 @@ void SHA1_Update(SHA1_CTX *context, const uint8_t *data, const size_t len)
 /* Add padding and return the message digest. */
 void SHA1_Final(SHA1_CTX *context, uint8_t digest[SHA1_DIGEST_SIZE])
 {
+    static const uint8_t padding[64] = {0x80};
     uint32_t i;
+    uint32_t pad_len;
     uint8_t finalcount[8];
 
     for (i = 0; i < 8; i++)
@@ -225,10 +227,21 @@ void SHA1_Final(SHA1_CTX *context, uint8_t digest[SHA1_DIGEST_SIZE])
         finalcount[i] =
             (unsigned char)((context->count[(i >= 4 ? 0 : 1)] >> ((3 - (i & 3)) * 8)) & 255); /* Endian independent */
     }
-    SHA1_Update(context, (uint8_t *)"\200", 1);
-    while ((context->count[0] & 504) != 448)
+    /* 0x80 and zeros up to 56 bytes mod 64, added in one or two updates */
+    pad_len = 64 - ((context->count[0] >> 3) & 63);
+    if (pad_len < 9)
     {
-        SHA1_Update(context, (uint8_t *)"\0", 1);
+        pad_len += 64;
+    }
+    pad_len -= 8;
+    if (pad_len > sizeof(padding))
+    {
+        SHA1_Update(context, padding, sizeof(padding));
+        SHA1_Update(context, &padding[1], pad_len - sizeof(padding));
+    }
+    else
+    {
+        SHA1_Update(context, padding, pad_len);
     }
     SHA1_Update(context, finalcount, 8); /* Should cause a SHA1_Transform() */
     for (i = 0; i < SHA1_DIGEST_SIZE; i++)
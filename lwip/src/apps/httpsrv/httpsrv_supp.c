@@ -135,7 +135,16 @@ static const HTTPSRV_CONTENT_TABLE_ROW content_tbl[] = {
     /* Following row MUST have length set to zero so we have proper array termination */
     {0, "", HTTPSRV_CONTENT_TYPE_OCTETSTREAM, false}};
 
+#define HTTPSRV_HASH_INIT (2166136261U) /* FNV-1a offset basis */
+
 static uint32_t httpsrv_sendextstr(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, uint32_t length);
+static int32_t httpsrv_sendtemplate(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session);
+#if HTTPSRV_CFG_MAX_RANGES
+static void httpsrv_etag(const HTTPSRV_FS_DIR_ENTRY *entry, char *etag);
+static void httpsrv_range_parse(HTTPSRV_SESSION_STRUCT *session, char *spec);
+static int32_t httpsrv_range_prepare(HTTPSRV_SESSION_STRUCT *session, const HTTPSRV_FS_DIR_ENTRY *entry);
+static HTTPSRV_SES_STATE httpsrv_sendranges(HTTPSRV_SESSION_STRUCT *session);
+#endif
 static void httpsrv_print(HTTPSRV_SESSION_STRUCT *session, char *format, ...);
 static char *httpsrv_get_table_str(HTTPSRV_TABLE_ROW *table, const int32_t id);
 static int httpsrv_get_table_int(HTTPSRV_TABLE_ROW *table, char *str);
@@ -143,6 +152,15 @@ static void httpsrv_process_file_type(char *extension, HTTPSRV_SESSION_STRUCT *s
 static int32_t httpsrv_set_params(HTTPSRV_STRUCT *server, HTTPSRV_PARAM_STRUCT *params);
 static int32_t httpsrv_init_socket(HTTPSRV_STRUCT *server);
 static int httpsrv_basic_auth(char *auth_string, char **user_ptr, char **pass_ptr);
+static int32_t httpsrv_realm_index_init(HTTPSRV_STRUCT *server);
+static uint32_t httpsrv_hash(const char *str, uint32_t hash);
+static const HTTPSRV_AUTH_USER_STRUCT *httpsrv_find_user(const HTTPSRV_AUTH_REALM_STRUCT *realm,
+                                                         const HTTPSRV_AUTH_USER_STRUCT *user);
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+static const HTTPSRV_AUTH_USER_STRUCT *httpsrv_auth_cache_find(HTTPSRV_STRUCT *server,
+                                                               HTTPSRV_SESSION_STRUCT *session,
+                                                               const HTTPSRV_AUTH_REALM_STRUCT *realm);
+#endif
 #if HTTPSRV_CFG_WEBSOCKET_ENABLED
 static void *httpsrv_ws_alloc(HTTPSRV_SESSION_STRUCT *session);
 #endif
@@ -239,12 +257,33 @@ HTTPSRV_STRUCT *httpsrv_create_server(HTTPSRV_PARAM_STRUCT *params)
         goto EXIT;
     }
 
+    error = httpsrv_realm_index_init(server);
+    if (error != HTTPSRV_OK)
+    {
+        goto EXIT;
+    }
+
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    if (sys_mutex_new(&server->auth_lock) != ERR_OK)
+    {
+        goto EXIT;
+    }
+#endif
+
     error = sys_sem_new(&server->ses_cnt, server->params.max_ses);
     if (error != ERR_OK)
     {
         goto EXIT;
     }
 
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    server->adm = httpsrv_mem_alloc_zero(sizeof(HTTPSRV_ADM_SLOT) * server->params.max_ses);
+    if (server->adm == NULL)
+    {
+        goto EXIT;
+    }
+#endif
+
     /* Allocate space for session pointers */
     server->session = httpsrv_mem_alloc_zero(sizeof(HTTPSRV_SESSION_STRUCT *) * server->params.max_ses);
     if (server->session == NULL)
@@ -321,6 +360,27 @@ void httpsrv_destroy_server(HTTPSRV_STRUCT *server)
             sys_sem_free(&server->ses_cnt);
         }
 
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+        if (server->adm)
+        {
+            httpsrv_mem_free(server->adm);
+            server->adm = NULL;
+        }
+#endif
+
+        if (server->realm_index)
+        {
+            httpsrv_mem_free((void *)server->realm_index);
+            server->realm_index = NULL;
+        }
+
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+        if (sys_mutex_valid(&server->auth_lock))
+        {
+            sys_mutex_free(&server->auth_lock);
+        }
+#endif
+
         /* server->finished is deallocated later */
 
 #if HTTPSRV_CFG_WOLFSSL_ENABLE || HTTPSRV_CFG_MBEDTLS_ENABLE
@@ -490,7 +550,14 @@ static int32_t httpsrv_set_params(HTTPSRV_STRUCT *server, HTTPSRV_PARAM_STRUCT *
         if (params->cgi_lnk_tbl)
             server->params.cgi_lnk_tbl = params->cgi_lnk_tbl;
         if (params->ssi_lnk_tbl)
+        {
             server->params.ssi_lnk_tbl = params->ssi_lnk_tbl;
+            /* Precompiled templates refer to SSI functions by index. */
+            while (server->params.ssi_lnk_tbl[server->ssi_cnt].callback != NULL)
+            {
+                server->ssi_cnt++;
+            }
+        }
         if (params->task_prio)
             server->params.task_prio = params->task_prio;
         if (params->auth_table)
@@ -549,15 +616,14 @@ static int32_t httpsrv_set_params(HTTPSRV_STRUCT *server, HTTPSRV_PARAM_STRUCT *
 /*
  * Accept connection from client.
  */
-int httpsrv_accept(int sock)
+int httpsrv_accept(int sock, struct sockaddr_storage *peer)
 {
-    struct sockaddr remote_addr;
     socklen_t length;
 
-    memset(&remote_addr, 0, sizeof(remote_addr));
-    length = sizeof(remote_addr);
+    memset(peer, 0, sizeof(*peer));
+    length = sizeof(*peer);
 
-    return (lwip_accept(sock, &remote_addr, &length));
+    return (lwip_accept(sock, (struct sockaddr *)peer, &length));
 }
 
 /*
@@ -574,6 +640,167 @@ void httpsrv_abort(int sock)
     lwip_close(sock);
 }
 
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+#if HTTPSRV_CFG_MAX_SES_PER_CLIENT
+/*
+ * Compare client addresses (port is ignored).
+ */
+static bool httpsrv_peer_equal(const struct sockaddr_storage *a, const struct sockaddr_storage *b)
+{
+    if (a->ss_family != b->ss_family)
+    {
+        return (false);
+    }
+#if LWIP_IPV6
+    if (a->ss_family == AF_INET6)
+    {
+        return (memcmp(&((const struct sockaddr_in6 *)a)->sin6_addr, &((const struct sockaddr_in6 *)b)->sin6_addr,
+                       sizeof(struct in6_addr)) == 0);
+    }
+#endif
+#if LWIP_IPV4
+    if (a->ss_family == AF_INET)
+    {
+        return (((const struct sockaddr_in *)a)->sin_addr.s_addr == ((const struct sockaddr_in *)b)->sin_addr.s_addr);
+    }
+#endif
+    return (false);
+}
+#endif /* HTTPSRV_CFG_MAX_SES_PER_CLIENT */
+
+/*
+ * Answer connection with "503 Service Unavailable" and close it. Nothing is
+ * sent on TLS servers, the handshake would take longer than the request.
+ */
+static void httpsrv_reject(HTTPSRV_STRUCT *server, int sock)
+{
+    char response[HTTPSRV_TMP_BUFFER_SIZE];
+    int length;
+
+    LWIP_UNUSED_ARG(server);
+
+#if HTTPSRV_CFG_WOLFSSL_ENABLE || HTTPSRV_CFG_MBEDTLS_ENABLE
+    if (server->tls_ctx == NULL)
+#endif
+    {
+        length = snprintf(response, sizeof(response),
+                          HTTPSRV_PROTOCOL_STRING
+                          " 503 Service Unavailable\r\nRetry-After: %d\r\nConnection: close\r\nContent-Length: 0\r\n\r\n",
+                          HTTPSRV_CFG_RETRY_AFTER);
+        lwip_send(sock, response, length, MSG_DONTWAIT);
+    }
+    lwip_shutdown(sock, SHUT_WR);
+    lwip_close(sock);
+}
+
+/*
+ * Ask idle sessions which have not received a complete request in time to close.
+ */
+static void httpsrv_adm_reclaim(HTTPSRV_STRUCT *server)
+{
+    uint32_t time_now = sys_now();
+    uint32_t n;
+
+    for (n = 0; n < server->params.max_ses; n++)
+    {
+        HTTPSRV_ADM_SLOT *slot = &server->adm[n];
+
+        if ((slot->state == HTTPSRV_ADM_IDLE) && ((time_now - slot->time) > HTTPSRV_CFG_IDLE_RECLAIM_TIMEOUT))
+        {
+            slot->reclaim = 1;
+        }
+    }
+}
+
+/*
+** Decide if accepted connection gets a session
+**
+** IN:
+**      HTTPSRV_STRUCT*                  server - server structure.
+**      int                              sock - accepted socket.
+**      const struct sockaddr_storage*   peer - client address.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      bool - true if the session counter was taken for the connection. If false,
+**             connection was rejected and the socket is closed.
+*/
+bool httpsrv_admit(HTTPSRV_STRUCT *server, int sock, const struct sockaddr_storage *peer)
+{
+#if HTTPSRV_CFG_MAX_SES_PER_CLIENT
+    uint32_t count = 0;
+    uint32_t n;
+
+    for (n = 0; n < server->params.max_ses; n++)
+    {
+        if ((server->adm[n].state != HTTPSRV_ADM_FREE) && httpsrv_peer_equal(&server->adm[n].peer, peer))
+        {
+            count++;
+        }
+    }
+    if (count >= HTTPSRV_CFG_MAX_SES_PER_CLIENT)
+    {
+        httpsrv_reject(server, sock);
+        return (false);
+    }
+#else
+    LWIP_UNUSED_ARG(peer);
+#endif
+
+    if (sys_arch_sem_wait(&server->ses_cnt, HTTPSRV_CFG_ADMISSION_WAIT) == SYS_ARCH_TIMEOUT)
+    {
+        /* Saturated. Let the client retry while slow sessions are reclaimed. */
+        httpsrv_adm_reclaim(server);
+        httpsrv_reject(server, sock);
+        return (false);
+    }
+    return (true);
+}
+
+/*
+ * Occupy admission slot of a new session.
+ */
+void httpsrv_adm_open(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, uint32_t index,
+                      const struct sockaddr_storage *peer)
+{
+    HTTPSRV_ADM_SLOT *slot = &server->adm[index];
+    uint32_t free_cnt      = 0;
+    uint32_t n;
+
+    for (n = 0; n < server->params.max_ses; n++)
+    {
+        if ((n != index) && (server->adm[n].state == HTTPSRV_ADM_FREE))
+        {
+            free_cnt++;
+        }
+    }
+
+    memcpy(&slot->peer, peer, sizeof(slot->peer));
+    slot->time     = sys_now();
+    slot->reclaim  = 0;
+    slot->priority = (free_cnt < HTTPSRV_CFG_PRIORITY_SES);
+    slot->state    = HTTPSRV_ADM_IDLE;
+    session->adm   = slot;
+}
+
+/*
+ * Check if request belongs to a priority route (CGI script or status path).
+ */
+bool httpsrv_req_priority(const char *path)
+{
+    size_t length   = strcspn(path, "?");
+    size_t prio_len = sizeof(HTTPSRV_CFG_PRIORITY_PATH) - 1;
+
+    if ((length >= 4) && (lwip_strnicmp(path + length - 4, ".cgi", 4) == 0))
+    {
+        return (true);
+    }
+    return ((prio_len != 0) && (length >= prio_len) && (strncmp(path, HTTPSRV_CFG_PRIORITY_PATH, prio_len) == 0));
+}
+#endif /* HTTPSRV_CFG_ADMISSION_ENABLED */
+
 /*
  * Receive data from socket.
  */
@@ -682,13 +909,50 @@ void httpsrv_sendhdr(HTTPSRV_SESSION_STRUCT *session, int32_t content_len, bool
     {
         httpsrv_print(session, "WWW-Authenticate: Basic realm=\"%s\"\r\n", session->response.auth_realm->name);
     }
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    else if (session->response.status_code == HTTPSRV_CODE_SERVICE_UNAVAILABLE)
+    {
+        httpsrv_print(session, "Retry-After: %d\r\n", HTTPSRV_CFG_RETRY_AFTER);
+    }
+#endif
 
     /* If there will be entity body send content type */
     if (has_entity)
     {
-        httpsrv_print(session, "Content-Type: %s\r\n",
-                      httpsrv_get_table_str((HTTPSRV_TABLE_ROW *)content_type, session->response.content_type));
+#if HTTPSRV_CFG_MAX_RANGES
+        if ((session->response.status_code == HTTPSRV_CODE_PARTIAL_CONTENT) && (session->request.range_cnt > 1))
+        {
+            httpsrv_print(session, "Content-Type: multipart/byteranges; boundary=" HTTPSRV_RANGE_BOUNDARY "\r\n");
+        }
+        else
+#endif
+        {
+            httpsrv_print(session, "Content-Type: %s\r\n",
+                          httpsrv_get_table_str((HTTPSRV_TABLE_ROW *)content_type, session->response.content_type));
+        }
+    }
+
+#if HTTPSRV_CFG_MAX_RANGES
+    if (session->flags & HTTPSRV_FLAG_ACCEPT_RANGES)
+    {
+        char etag[HTTPSRV_ETAG_LEN];
+
+        httpsrv_etag(session->response.file->DEV_DATA_PTR, etag);
+        httpsrv_print(session, "Accept-Ranges: bytes\r\nETag: %s\r\n", etag);
+
+        if ((session->response.status_code == HTTPSRV_CODE_PARTIAL_CONTENT) && (session->request.range_cnt == 1))
+        {
+            httpsrv_print(session, "Content-Range: bytes %u-%u/%u\r\n", (unsigned int)session->request.range[0].start,
+                          (unsigned int)session->request.range[0].end,
+                          (unsigned int)HTTPSRV_FS_size(session->response.file));
+        }
+        else if (session->response.status_code == HTTPSRV_CODE_RANGE_NOT_SATISFIABLE)
+        {
+            httpsrv_print(session, "Content-Range: bytes */%u\r\n",
+                          (unsigned int)HTTPSRV_FS_size(session->response.file));
+        }
     }
+#endif
 
     if (session->response.status_code != HTTPSRV_CODE_UPGRADE)
     {
@@ -848,14 +1112,16 @@ HTTPSRV_SES_STATE httpsrv_sendfile(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUC
     int length;
     char *buffer;
     HTTPSRV_SES_STATE retval;
+    const HTTPSRV_FS_DIR_ENTRY *entry;
 
     buffer = session->buffer.data;
+    entry  = session->response.file->DEV_DATA_PTR;
 
     ext = strrchr(session->request.path, '.');
     httpsrv_process_file_type(ext, session);
 
     /* Check if file has server side includes */
-    if ((0 == lwip_stricmp(ext, ".shtml")) || (0 == lwip_stricmp(ext, ".shtm")))
+    if ((entry->SSI != NULL) || (0 == lwip_stricmp(ext, ".shtml")) || (0 == lwip_stricmp(ext, ".shtm")))
     {
         /*
          * Disable keep-alive for this session otherwise we would have to
@@ -863,7 +1129,15 @@ HTTPSRV_SES_STATE httpsrv_sendfile(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUC
          */
         session->flags &= ~HTTPSRV_FLAG_IS_KEEP_ALIVE;
         httpsrv_sendhdr(session, 0, 1);
+    }
 
+    if (entry->SSI != NULL)
+    {
+        /* Precompiled template - no scanning for script tokens. */
+        length = httpsrv_sendtemplate(server, session);
+    }
+    else if ((0 == lwip_stricmp(ext, ".shtml")) || (0 == lwip_stricmp(ext, ".shtm")))
+    {
         HTTPSRV_FS_fseek(session->response.file, session->response.length, HTTPSRV_FS_IO_SEEK_SET);
 
         length = HTTPSRV_FS_read(session->response.file, buffer + session->buffer.offset,
@@ -880,6 +1154,32 @@ HTTPSRV_SES_STATE httpsrv_sendfile(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUC
     }
     else
     {
+#if HTTPSRV_CFG_MAX_RANGES
+        if (!(session->flags & HTTPSRV_FLAG_HEADER_SENT))
+        {
+            session->flags |= HTTPSRV_FLAG_ACCEPT_RANGES;
+            if (session->request.range_cnt != 0)
+            {
+                length = httpsrv_range_prepare(session, entry);
+                if (length < 0)
+                {
+                    session->response.status_code = HTTPSRV_CODE_RANGE_NOT_SATISFIABLE;
+                    session->flags &= ~HTTPSRV_FLAG_IS_KEEP_ALIVE;
+                    httpsrv_sendhdr(session, 0, 0);
+                    return (HTTPSRV_SES_END_REQ);
+                }
+                if (length > 0)
+                {
+                    session->response.status_code = HTTPSRV_CODE_PARTIAL_CONTENT;
+                    httpsrv_sendhdr(session, length, 1);
+                }
+            }
+        }
+        if (session->response.status_code == HTTPSRV_CODE_PARTIAL_CONTENT)
+        {
+            return (httpsrv_sendranges(session));
+        }
+#endif
         httpsrv_sendhdr(session, HTTPSRV_FS_size(session->response.file), 1);
         HTTPSRV_FS_fseek(session->response.file, session->response.length, HTTPSRV_FS_IO_SEEK_SET);
 
@@ -909,6 +1209,347 @@ HTTPSRV_SES_STATE httpsrv_sendfile(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUC
     return (retval);
 }
 
+/*
+** Send next part of a precompiled SSI template (dynamic web pages): a chunk
+** of literal data, or the SSI call which ends the current span. Literal data
+** go from the file image to the socket without passing the session buffer,
+** only the buffered header and SSI output are flushed before them.
+**
+** IN:
+**      HTTPSRV_STRUCT         *server - server structure.
+**      HTTPSRV_SESSION_STRUCT *session - session for sending.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      int32_t - positive if there is more to send, 0 when done, -1 on error.
+*/
+static int32_t httpsrv_sendtemplate(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session)
+{
+    const HTTPSRV_FS_DIR_ENTRY *entry = session->response.file->DEV_DATA_PTR;
+    const HTTPSRV_FS_SSI_SPAN *span;
+    uint32_t position;
+    uint32_t end;
+    int32_t length;
+
+    if (session->response.ssi_span >= entry->SSI_COUNT)
+    {
+        httpsrv_ses_flush(session);
+        return (0);
+    }
+
+    span     = &entry->SSI[session->response.ssi_span];
+    end      = span->OFFSET + span->SIZE;
+    position = (uint32_t)session->response.length;
+
+    /* Skip the script token which ended the previous span. */
+    if (position < span->OFFSET)
+    {
+        position = span->OFFSET;
+    }
+
+    if (position < end)
+    {
+        if (httpsrv_ses_flush(session) == -1)
+        {
+            return (-1);
+        }
+        length = httpsrv_send(session, (const char *)entry->DATA + position,
+                              LWIP_MIN(end - position, HTTPSRV_SES_BUF_SIZE_PRV), 0);
+        if (length > 0)
+        {
+            session->response.length = (int32_t)(position + length);
+        }
+        return (length);
+    }
+
+    httpsrv_call_ssi_index(server, session, span->SSI_INDEX, span->PARAM);
+    session->response.ssi_span++;
+    return (1);
+}
+
+#if HTTPSRV_CFG_MAX_RANGES
+/*
+** Entity tag of a file, derived from its content so that it changes with the
+** file, not with its place in a new image. The FNV-1a hash is normally
+** precomputed with the file system image (ETAG of the directory entry),
+** otherwise it is computed here.
+*/
+static void httpsrv_etag(const HTTPSRV_FS_DIR_ENTRY *entry, char *etag)
+{
+    uint32_t hash = entry->ETAG;
+    uint32_t i;
+
+    if (hash == 0)
+    {
+        hash = 0x811c9dc5U;
+        for (i = 0; i < entry->SIZE; i++)
+        {
+            hash = (hash ^ entry->DATA[i]) * 0x01000193U;
+        }
+    }
+    snprintf(etag, HTTPSRV_ETAG_LEN, "\"%08x-%x\"", (unsigned int)hash, (unsigned int)entry->SIZE);
+}
+
+/*
+** Parse value of the Range header field. Unsupported or malformed
+** specifications are ignored, the whole file is sent then.
+**
+** IN:
+**      HTTPSRV_SESSION_STRUCT *session - session with the request.
+**      char                   *spec - field value.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      none
+*/
+static void httpsrv_range_parse(HTTPSRV_SESSION_STRUCT *session, char *spec)
+{
+    HTTPSRV_RANGE range;
+    uint32_t cnt = 0;
+    char *end;
+
+    session->request.range_cnt = 0;
+    if (strncmp(spec, "bytes=", 6) != 0)
+    {
+        return;
+    }
+    spec += 6;
+
+    while (1)
+    {
+        while ((*spec == ' ') || (*spec == '\t'))
+        {
+            spec++;
+        }
+        if (*spec == '-')
+        {
+            /* Suffix range: last N bytes */
+            if (!isdigit((unsigned char)spec[1]))
+            {
+                return;
+            }
+            range.start = HTTPSRV_RANGE_SUFFIX;
+            range.end   = strtoul(spec + 1, &end, 10);
+        }
+        else
+        {
+            if (!isdigit((unsigned char)*spec))
+            {
+                return;
+            }
+            range.start = strtoul(spec, &end, 10);
+            if ((*end != '-') || (range.start == HTTPSRV_RANGE_SUFFIX))
+            {
+                return;
+            }
+            spec = end + 1;
+            if (isdigit((unsigned char)*spec))
+            {
+                range.end = strtoul(spec, &end, 10);
+                if (range.end < range.start)
+                {
+                    return;
+                }
+            }
+            else
+            {
+                /* Open range: up to the end of file */
+                range.end = UINT32_MAX;
+                end       = spec;
+            }
+        }
+
+        if (cnt == HTTPSRV_CFG_MAX_RANGES)
+        {
+            return;
+        }
+        session->request.range[cnt++] = range;
+
+        spec = end;
+        while ((*spec == ' ') || (*spec == '\t'))
+        {
+            spec++;
+        }
+        if (*spec == '\0')
+        {
+            break;
+        }
+        if (*spec != ',')
+        {
+            return;
+        }
+        spec++;
+    }
+    session->request.range_cnt = cnt;
+}
+
+/*
+** Format part header of a multipart/byteranges response.
+*/
+static int httpsrv_range_part(HTTPSRV_SESSION_STRUCT *session, const HTTPSRV_RANGE *range, char *dst, size_t size)
+{
+    return (snprintf(dst, size, "\r\n--" HTTPSRV_RANGE_BOUNDARY "\r\nContent-Type: %s\r\nContent-Range: bytes %u-%u/%u\r\n\r\n",
+                     httpsrv_get_table_str((HTTPSRV_TABLE_ROW *)content_type, session->response.content_type),
+                     (unsigned int)range->start, (unsigned int)range->end,
+                     (unsigned int)HTTPSRV_FS_size(session->response.file)));
+}
+
+/*
+** Check If-Range and resolve requested ranges against the file size.
+**
+** IN:
+**      HTTPSRV_SESSION_STRUCT     *session - session with the request.
+**      const HTTPSRV_FS_DIR_ENTRY *entry - requested file.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      int32_t - length of the partial response body, 0 if the whole file is to be
+**                sent, -1 if no range is satisfiable.
+*/
+static int32_t httpsrv_range_prepare(HTTPSRV_SESSION_STRUCT *session, const HTTPSRV_FS_DIR_ENTRY *entry)
+{
+    uint32_t size = HTTPSRV_FS_size(session->response.file);
+    int32_t length;
+    uint32_t cnt;
+    uint32_t i;
+
+    /* If-Range: ranges apply to the current version of the file only */
+    if (session->request.if_range[0] != '\0')
+    {
+        char etag[HTTPSRV_ETAG_LEN];
+
+        httpsrv_etag(entry, etag);
+        if (strcmp(session->request.if_range, etag) != 0)
+        {
+            session->request.range_cnt = 0;
+            return (0);
+        }
+    }
+
+    cnt = 0;
+    for (i = 0; i < session->request.range_cnt; i++)
+    {
+        HTTPSRV_RANGE range = session->request.range[i];
+
+        if (range.start == HTTPSRV_RANGE_SUFFIX)
+        {
+            if ((range.end == 0) || (size == 0))
+            {
+                continue;
+            }
+            range.start = (range.end < size) ? (size - range.end) : 0;
+            range.end   = size - 1;
+        }
+        else
+        {
+            if (range.start >= size)
+            {
+                continue;
+            }
+            if (range.end >= size)
+            {
+                range.end = size - 1;
+            }
+        }
+        session->request.range[cnt++] = range;
+    }
+
+    session->request.range_cnt = cnt;
+    if (cnt == 0)
+    {
+        return (-1);
+    }
+    if (cnt == 1)
+    {
+        return ((int32_t)(session->request.range[0].end - session->request.range[0].start + 1));
+    }
+
+    length = sizeof("\r\n--" HTTPSRV_RANGE_BOUNDARY "--\r\n") - 1;
+    for (i = 0; i < cnt; i++)
+    {
+        length += httpsrv_range_part(session, &session->request.range[i], NULL, 0);
+        length += session->request.range[i].end - session->request.range[i].start + 1;
+    }
+    return (length);
+}
+
+/*
+** Send next part of a partial response. File data are sent directly from the
+** file system image.
+**
+** IN:
+**      HTTPSRV_SESSION_STRUCT *session - session for sending.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      HTTPSRV_SES_STATE - HTTPSRV_SES_RESP if there is more to send, HTTPSRV_SES_END_REQ otherwise.
+*/
+static HTTPSRV_SES_STATE httpsrv_sendranges(HTTPSRV_SESSION_STRUCT *session)
+{
+    const HTTPSRV_FS_DIR_ENTRY *entry = session->response.file->DEV_DATA_PTR;
+    const HTTPSRV_RANGE *range;
+    bool multipart = (session->request.range_cnt > 1);
+    uint32_t position;
+    int32_t length;
+
+    if (session->response.range >= session->request.range_cnt)
+    {
+        if (multipart)
+        {
+            httpsrv_print(session, "\r\n--" HTTPSRV_RANGE_BOUNDARY "--\r\n");
+        }
+        httpsrv_ses_flush(session);
+        return (HTTPSRV_SES_END_REQ);
+    }
+
+    range = &session->request.range[session->response.range];
+    if (!session->response.range_started)
+    {
+        if (multipart)
+        {
+            length = httpsrv_range_part(session, range, NULL, 0);
+            if (HTTPSRV_SES_BUF_SIZE_PRV - session->buffer.offset <= length)
+            {
+                httpsrv_ses_flush(session);
+            }
+            session->buffer.offset += httpsrv_range_part(session, range, session->buffer.data + session->buffer.offset,
+                                                         HTTPSRV_SES_BUF_SIZE_PRV - session->buffer.offset);
+        }
+        session->response.length        = (int32_t)range->start;
+        session->response.range_started = true;
+    }
+
+    position = (uint32_t)session->response.length;
+    if (position > range->end)
+    {
+        session->response.range++;
+        session->response.range_started = false;
+        return (HTTPSRV_SES_RESP);
+    }
+
+    if (httpsrv_ses_flush(session) == -1)
+    {
+        return (HTTPSRV_SES_END_REQ);
+    }
+    length = httpsrv_send(session, (const char *)entry->DATA + position,
+                          LWIP_MIN(range->end - position + 1, HTTPSRV_SES_BUF_SIZE_PRV), 0);
+    if (length <= 0)
+    {
+        return (HTTPSRV_SES_END_REQ);
+    }
+    session->response.length += length;
+    return (HTTPSRV_SES_RESP);
+}
+#endif /* HTTPSRV_CFG_MAX_RANGES */
+
 /*
 ** Send extended string to socket (dynamic web pages).
 **
@@ -999,7 +1640,8 @@ static uint32_t httpsrv_sendextstr(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUC
 
         if ((name_length > 1) && (name_length < HTTPSRV_CFG_MAX_SCRIPT_LN))
         {
-            snprintf(fname, name_length + 1, "%s", src);
+            /* The buffer is not terminated, copy the name only */
+            memcpy(fname, src, name_length);
             /* Wait until SSI is processed. */
             httpsrv_script_handler(server, session, HTTPSRV_SSI_CALLBACK, fname);
             memset(session->response.script_buffer, 0, sizeof(session->response.script_buffer));
@@ -1248,6 +1890,11 @@ int32_t httpsrv_req_line(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session
     char *uri_end   = NULL;
     uint32_t written;
 
+#if HTTPSRV_CFG_MAX_RANGES
+    session->request.range_cnt   = 0;
+    session->request.if_range[0] = '\0';
+#endif
+
     if (strncmp(buffer, "GET ", 4) == 0)
     {
         session->request.method = HTTPSRV_REQ_GET;
@@ -1315,7 +1962,7 @@ int32_t httpsrv_req_line(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session
 ** Return Value:
 **      none
 */
-int32_t httpsrv_req_hdr(HTTPSRV_SESSION_STRUCT *session, char *buffer)
+int32_t httpsrv_req_hdr(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, char *buffer)
 {
     char *param_ptr = NULL;
     int32_t retval;
@@ -1366,6 +2013,25 @@ int32_t httpsrv_req_hdr(HTTPSRV_SESSION_STRUCT *session, char *buffer)
         session->request.content_length = (uint32_t)value;
         session->flags |= HTTPSRV_FLAG_HAS_CONTENT_LENGTH;
     }
+#if HTTPSRV_CFG_MAX_RANGES
+    else if (strncmp(buffer, "Range: ", 7) == 0)
+    {
+        httpsrv_range_parse(session, buffer + 7);
+    }
+    else if (strncmp(buffer, "If-Range: ", 10) == 0)
+    {
+        param_ptr = buffer + 10;
+        if (strlen(param_ptr) < sizeof(session->request.if_range))
+        {
+            strcpy(session->request.if_range, param_ptr);
+        }
+        else
+        {
+            /* Cannot be our entity tag */
+            strcpy(session->request.if_range, "-");
+        }
+    }
+#endif
     else if (strncmp(buffer, "Content-Type: ", 14) == 0)
     {
         param_ptr = buffer + 14;
@@ -1401,9 +2067,29 @@ int32_t httpsrv_req_hdr(HTTPSRV_SESSION_STRUCT *session, char *buffer)
             char *user;
             char *pass;
 
+            param_ptr += 6;
+            httpsrv_req_auth_free(session);
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+            /* Credentials verified before need no decoding. */
+            if (strlen(param_ptr) < sizeof(session->request.auth_key))
+            {
+                const HTTPSRV_AUTH_USER_STRUCT *known;
+
+                strcpy(session->request.auth_key, param_ptr);
+                session->request.auth_hash = httpsrv_hash(session->request.auth_key, HTTPSRV_HASH_INIT);
+                known                      = httpsrv_auth_cache_find(server, session, NULL);
+                if (known != NULL)
+                {
+                    session->request.auth.user_id  = known->user_id;
+                    session->request.auth.password = known->password;
+                    session->request.auth_cached   = true;
+                    goto EXIT;
+                }
+            }
+#endif
             user = NULL;
             pass = NULL;
-            if (httpsrv_basic_auth(param_ptr + 6, &user, &pass) == HTTPSRV_OK)
+            if (httpsrv_basic_auth(param_ptr, &user, &pass) == HTTPSRV_OK)
             {
                 session->request.auth.user_id  = user;
                 session->request.auth.password = pass;
@@ -1466,6 +2152,100 @@ EXIT:
     return (retval);
 }
 
+/*
+** Index group of a realm path, from its first two characters
+*/
+static uint32_t httpsrv_realm_group(const char *path)
+{
+    if ((path[0] == '\0') || (path[1] == '\0'))
+    {
+        return (HTTPSRV_REALM_BUCKETS);
+    }
+    return ((((uint8_t)path[0] * 31U) + (uint8_t)path[1]) % HTTPSRV_REALM_BUCKETS);
+}
+
+/*
+** Find the realm of one index group whose path starts at str. Realms that are
+** not before best in the realm table are skipped.
+*/
+static const HTTPSRV_AUTH_REALM_STRUCT *httpsrv_realm_match(HTTPSRV_STRUCT *server,
+                                                            uint32_t group,
+                                                            const char *str,
+                                                            const HTTPSRV_AUTH_REALM_STRUCT *best)
+{
+    uint32_t i;
+
+    for (i = server->realm_group[group]; i < server->realm_group[group + 1]; i++)
+    {
+        const HTTPSRV_AUTH_REALM_STRUCT *realm = server->realm_index[i];
+        const char *s                          = str;
+        const char *r                          = realm->path;
+
+        if ((best != NULL) && (realm >= best))
+        {
+            /* Groups keep table order. */
+            break;
+        }
+        while ((*r != '\0') && (*s == *r))
+        {
+            s++;
+            r++;
+        }
+        if (*r == '\0')
+        {
+            return (realm);
+        }
+    }
+    return (best);
+}
+
+/*
+** Build the realm index: pointers to the realms of the authentication table,
+** grouped by httpsrv_realm_group() of their path, in table order.
+*/
+static int32_t httpsrv_realm_index_init(HTTPSRV_STRUCT *server)
+{
+    const HTTPSRV_AUTH_REALM_STRUCT *table = server->params.auth_table;
+    uint16_t next[HTTPSRV_REALM_BUCKETS + 1];
+    uint32_t count;
+    uint32_t i;
+
+    memset(server->realm_group, 0, sizeof(server->realm_group));
+    memset(server->realm_first, 0, sizeof(server->realm_first));
+    if (table == NULL)
+    {
+        return (HTTPSRV_OK);
+    }
+
+    for (count = 0; table[count].path != NULL; count++)
+    {
+        uint8_t first = (uint8_t)table[count].path[0];
+
+        server->realm_group[httpsrv_realm_group(table[count].path) + 1]++;
+        server->realm_first[first / 8U] |= (uint8_t)(1U << (first % 8U));
+    }
+    if (count == 0)
+    {
+        return (HTTPSRV_OK);
+    }
+    for (i = 1; i < HTTPSRV_REALM_BUCKETS + 2; i++)
+    {
+        server->realm_group[i] += server->realm_group[i - 1];
+    }
+
+    server->realm_index = httpsrv_mem_alloc(sizeof(*server->realm_index) * count);
+    if (server->realm_index == NULL)
+    {
+        return (HTTPSRV_ERR);
+    }
+    memcpy(next, server->realm_group, sizeof(next));
+    for (i = 0; i < count; i++)
+    {
+        server->realm_index[next[httpsrv_realm_group(table[i].path)]++] = &table[i];
+    }
+    return (HTTPSRV_OK);
+}
+
 /*
 ** Get realm for requested path
 **
@@ -1481,21 +2261,42 @@ EXIT:
 */
 const HTTPSRV_AUTH_REALM_STRUCT *httpsrv_req_realm(HTTPSRV_STRUCT *server, char *path)
 {
-    const HTTPSRV_AUTH_REALM_STRUCT *table;
-
-    table = server->params.auth_table;
+    const HTTPSRV_AUTH_REALM_STRUCT *retval = NULL;
+    const char *p;
 
-    if (table == NULL)
+    if (server->realm_index == NULL)
     {
         return (NULL);
     }
 
-    while ((table->path != NULL) && (strstr(path, table->path) == NULL))
+    /*
+     * A realm applies if its path occurs anywhere in the request path and the
+     * first matching realm of the table wins. Positions whose character starts
+     * no realm path are skipped, at the others only the realms indexed under
+     * the next two characters (and the few shorter ones) are compared.
+     */
+    for (p = path;; p++)
     {
-        table++;
+        if ((server->realm_first[(uint8_t)*p / 8U] & (1U << ((uint8_t)*p % 8U))) == 0)
+        {
+            if (*p == '\0')
+            {
+                break;
+            }
+            continue;
+        }
+        retval = httpsrv_realm_match(server, HTTPSRV_REALM_BUCKETS, p, retval);
+        if ((p[0] != '\0') && (p[1] != '\0'))
+        {
+            retval = httpsrv_realm_match(server, httpsrv_realm_group(p), p, retval);
+        }
+        if ((*p == '\0') || (retval == server->params.auth_table))
+        {
+            break;
+        }
     }
 
-    return (table->path ? table : NULL);
+    return (retval);
 }
 
 /* Get query string */
@@ -1581,12 +2382,21 @@ uint32_t httpsrv_req_check(HTTPSRV_SESSION_STRUCT *session)
 **      int - 1 if user is successfully authenticated, zero otherwise.
 */
 int httpsrv_check_auth(const HTTPSRV_AUTH_REALM_STRUCT *realm, const HTTPSRV_AUTH_USER_STRUCT *user)
+{
+    return (httpsrv_find_user(realm, user) != NULL);
+}
+
+/*
+** Find the realm's user table entry matching the given credentials.
+*/
+static const HTTPSRV_AUTH_USER_STRUCT *httpsrv_find_user(const HTTPSRV_AUTH_REALM_STRUCT *realm,
+                                                         const HTTPSRV_AUTH_USER_STRUCT *user)
 {
     const HTTPSRV_AUTH_USER_STRUCT *users = NULL;
 
-    if ((realm == NULL) || (user == NULL))
+    if ((realm == NULL) || (user == NULL) || (user->user_id == NULL) || (user->password == NULL))
     {
-        return (0);
+        return (NULL);
     }
 
     users = realm->users;
@@ -1595,11 +2405,189 @@ int httpsrv_check_auth(const HTTPSRV_AUTH_REALM_STRUCT *realm, const HTTPSRV_AUT
     {
         if (!strcmp(users->user_id, user->user_id) && !strcmp(users->password, user->password))
         {
-            return (1);
+            return (users);
         }
         users++;
     }
-    return (0);
+    return (NULL);
+}
+
+/*
+** FNV-1a hash of a string, continuing from hash.
+*/
+static uint32_t httpsrv_hash(const char *str, uint32_t hash)
+{
+    while (*str != '\0')
+    {
+        hash = (hash ^ (uint8_t)*str++) * 16777619U;
+    }
+    return (hash);
+}
+
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+/* Hash of a user table entry, to notice changes of the table. */
+static uint32_t httpsrv_user_hash(const HTTPSRV_AUTH_USER_STRUCT *user)
+{
+    return (httpsrv_hash(user->password, httpsrv_hash(user->user_id, HTTPSRV_HASH_INIT) ^ ':'));
+}
+
+/* Cache entry holds a valid verification of the session's credentials. */
+static bool httpsrv_auth_cache_valid(const HTTPSRV_AUTH_CACHE_ENTRY *entry, HTTPSRV_SESSION_STRUCT *session)
+{
+    return ((entry->hash != 0) && (entry->hash == session->request.auth_hash) &&
+            ((uint32_t)(sys_now() - entry->time) < HTTPSRV_CFG_AUTH_CACHE_TIMEOUT) &&
+            (strcmp(entry->key, session->request.auth_key) == 0) &&
+            (entry->user->user_id != NULL) && (entry->cred_hash == httpsrv_user_hash(entry->user)));
+}
+
+/*
+** Look up the session's credentials in the authentication cache.
+**
+** IN:
+**      HTTPSRV_STRUCT*                  server - server structure.
+**      HTTPSRV_SESSION_STRUCT*          session - session with auth_key set.
+**      const HTTPSRV_AUTH_REALM_STRUCT* realm - realm to check, NULL for any.
+**
+** Return Value:
+**      const HTTPSRV_AUTH_USER_STRUCT* - user table entry if verified before, NULL otherwise.
+*/
+static const HTTPSRV_AUTH_USER_STRUCT *httpsrv_auth_cache_find(HTTPSRV_STRUCT *server,
+                                                               HTTPSRV_SESSION_STRUCT *session,
+                                                               const HTTPSRV_AUTH_REALM_STRUCT *realm)
+{
+    const HTTPSRV_AUTH_USER_STRUCT *retval = NULL;
+    uint32_t i;
+
+    sys_mutex_lock(&server->auth_lock);
+    for (i = 0; i < HTTPSRV_CFG_AUTH_CACHE_SIZE; i++)
+    {
+        HTTPSRV_AUTH_CACHE_ENTRY *entry = &server->auth_cache[i];
+
+        if (((realm == NULL) || (entry->realm == realm)) && httpsrv_auth_cache_valid(entry, session))
+        {
+            retval = entry->user;
+            break;
+        }
+    }
+    sys_mutex_unlock(&server->auth_lock);
+    return (retval);
+}
+
+/*
+** Remember credentials verified for a realm, replacing the oldest entry.
+*/
+static void httpsrv_auth_cache_add(HTTPSRV_STRUCT *server,
+                                   HTTPSRV_SESSION_STRUCT *session,
+                                   const HTTPSRV_AUTH_REALM_STRUCT *realm,
+                                   const HTTPSRV_AUTH_USER_STRUCT *user)
+{
+    HTTPSRV_AUTH_CACHE_ENTRY *entry;
+    uint32_t now = sys_now();
+    uint32_t i;
+
+    sys_mutex_lock(&server->auth_lock);
+    entry = &server->auth_cache[0];
+    for (i = 0; i < HTTPSRV_CFG_AUTH_CACHE_SIZE; i++)
+    {
+        if (server->auth_cache[i].hash == 0)
+        {
+            entry = &server->auth_cache[i];
+            break;
+        }
+        if ((uint32_t)(now - server->auth_cache[i].time) > (uint32_t)(now - entry->time))
+        {
+            entry = &server->auth_cache[i];
+        }
+    }
+    entry->hash      = session->request.auth_hash;
+    entry->cred_hash = httpsrv_user_hash(user);
+    entry->time      = now;
+    entry->realm     = realm;
+    entry->user      = user;
+    strcpy(entry->key, session->request.auth_key);
+    sys_mutex_unlock(&server->auth_lock);
+}
+#endif /* HTTPSRV_CFG_AUTH_CACHE_SIZE */
+
+/*
+** Check credentials of the request against a realm
+**
+** IN:
+**      HTTPSRV_STRUCT*                  server - server structure.
+**      HTTPSRV_SESSION_STRUCT*          session - session with the request.
+**      const HTTPSRV_AUTH_REALM_STRUCT* realm - realm of the requested path.
+**
+** OUT:
+**      none
+**
+** Return Value:
+**      int - 1 if user is successfully authenticated, zero otherwise.
+*/
+int httpsrv_req_auth(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, const HTTPSRV_AUTH_REALM_STRUCT *realm)
+{
+    const HTTPSRV_AUTH_USER_STRUCT *user;
+
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    /* Credentials the header lookup did not find are not cached for any realm. */
+    if (session->request.auth_cached)
+    {
+        if (httpsrv_auth_cache_find(server, session, realm) != NULL)
+        {
+            return (1);
+        }
+    }
+#endif
+
+    user = httpsrv_find_user(realm, &session->request.auth);
+    if (user == NULL)
+    {
+        return (0);
+    }
+
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    if (session->request.auth_key[0] != '\0')
+    {
+        httpsrv_auth_cache_add(server, session, realm, user);
+    }
+#endif
+    return (1);
+}
+
+/*
+** Release credentials received with the request.
+*/
+void httpsrv_req_auth_free(HTTPSRV_SESSION_STRUCT *session)
+{
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    if (session->request.auth_cached)
+    {
+        /* Pointing to the user table */
+        session->request.auth.user_id = NULL;
+    }
+    session->request.auth_cached = false;
+    session->request.auth_hash   = 0;
+    session->request.auth_key[0] = '\0';
+#endif
+    if (session->request.auth.user_id != NULL)
+    {
+        httpsrv_mem_free(session->request.auth.user_id);
+    }
+    session->request.auth.user_id  = NULL;
+    session->request.auth.password = NULL;
+}
+
+/*
+** Forget all verified credentials.
+*/
+void httpsrv_auth_cache_flush(HTTPSRV_STRUCT *server)
+{
+#if HTTPSRV_CFG_AUTH_CACHE_SIZE
+    sys_mutex_lock(&server->auth_lock);
+    memset(server->auth_cache, 0, sizeof(server->auth_cache));
+    sys_mutex_unlock(&server->auth_lock);
+#else
+    LWIP_UNUSED_ARG(server);
+#endif
 }
 
 /*
@@ -1739,7 +2727,7 @@ char *httpsrv_path_create(const char *root, char *filename)
     if (path != NULL)
     {
         memcpy(path, root, root_length);
-        if ((root[root_length - 1] != '\\') && (filename[0] != '\\'))
+        if (((root_length == 0) || (root[root_length - 1] != '\\')) && (filename[0] != '\\'))
         {
             path[root_length] = '\\';
             root_length++;
@@ -32,12 +32,15 @@ void httpsrv_sendhdr(HTTPSRV_SESSION_STRUCT *session, int32_t content_len, bool
 HTTPSRV_SES_STATE httpsrv_sendfile(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session);
 void httpsrv_send_err_page(HTTPSRV_SESSION_STRUCT *session, const char *title, const char *text);
 
-int32_t httpsrv_req_hdr(HTTPSRV_SESSION_STRUCT *session, char *buffer);
+int32_t httpsrv_req_hdr(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, char *buffer);
 int32_t httpsrv_req_line(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, char *buffer);
 uint32_t httpsrv_req_check(HTTPSRV_SESSION_STRUCT *session);
 
 const HTTPSRV_AUTH_REALM_STRUCT *httpsrv_req_realm(HTTPSRV_STRUCT *server, char *path);
 int httpsrv_check_auth(const HTTPSRV_AUTH_REALM_STRUCT *realm, const HTTPSRV_AUTH_USER_STRUCT *user);
+int httpsrv_req_auth(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, const HTTPSRV_AUTH_REALM_STRUCT *realm);
+void httpsrv_req_auth_free(HTTPSRV_SESSION_STRUCT *session);
+void httpsrv_auth_cache_flush(HTTPSRV_STRUCT *server);
 void httpsrv_destroy_server(HTTPSRV_STRUCT *server);
 HTTPSRV_STRUCT *httpsrv_create_server(HTTPSRV_PARAM_STRUCT *params);
 #if HTTPSRV_CFG_WEBSOCKET_ENABLED
@@ -47,8 +50,14 @@ int httpsrv_recv(HTTPSRV_SESSION_STRUCT *session, char *buffer, size_t length, i
 int httpsrv_send(HTTPSRV_SESSION_STRUCT *session, const char *buffer, size_t length, int flags);
 char *httpsrv_get_query(char *src);
 int httpsrv_wait_for_conn(HTTPSRV_STRUCT *server);
-int httpsrv_accept(int sock);
+int httpsrv_accept(int sock, struct sockaddr_storage *peer);
 void httpsrv_abort(int sock);
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+bool httpsrv_admit(HTTPSRV_STRUCT *server, int sock, const struct sockaddr_storage *peer);
+void httpsrv_adm_open(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, uint32_t index,
+                      const struct sockaddr_storage *peer);
+bool httpsrv_req_priority(const char *path);
+#endif
 
 void *httpsrv_mem_alloc_zero(size_t xSize);
 void httpsrv_url_decode(char *url);
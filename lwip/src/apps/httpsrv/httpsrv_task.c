@@ -47,9 +47,12 @@ void httpsrv_server_task(void *arg)
         int i;
         int error;
         int new_sock;
+        struct sockaddr_storage peer;
 
+#if !HTTPSRV_CFG_ADMISSION_ENABLED
         /* limit number of opened sessions */
         sys_arch_sem_wait(&server->ses_cnt, 0);
+#endif
 
         /* Get socket with incoming connection (IPv4 or IPv6) */
         int connsock = httpsrv_wait_for_conn(server);
@@ -63,14 +66,23 @@ void httpsrv_server_task(void *arg)
         }
         else
         {
-            new_sock = httpsrv_accept(server->sock);
+            new_sock = httpsrv_accept(server->sock, &peer);
             if (new_sock < 0)
             {
+#if !HTTPSRV_CFG_ADMISSION_ENABLED
                 sys_sem_signal(&server->ses_cnt);
+#endif
                 /* We probably run out of sockets. Wait some time then try again to prevent session tasks resource
                  * starvation */
                 sys_msleep(100);
             }
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+            /* Take session counter or reject the client with 503 */
+            else if (!httpsrv_admit(server, new_sock, &peer))
+            {
+                taskYIELD();
+            }
+#endif
             else
             {
 #if ((defined(HTTPSRV_CFG_SEND_TIMEOUT) && (HTTPSRV_CFG_SEND_TIMEOUT != 0)) || \
@@ -137,6 +149,13 @@ void httpsrv_server_task(void *arg)
                                 }
 
                                 server->session[i] = session;
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+                                httpsrv_adm_open(server, session, i, &peer);
+                                if (session->adm->priority)
+                                {
+                                    session->flags &= ~HTTPSRV_FLAG_KEEP_ALIVE_ENABLED;
+                                }
+#endif
 
                                 ses_param->server    = server;
                                 ses_param->session_p = &server->session[i];
@@ -155,6 +174,9 @@ void httpsrv_server_task(void *arg)
                                     httpsrv_ses_close(session);
                                     httpsrv_ses_free(session);
                                     server->session[i] = NULL;
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+                                    server->adm[i].state = HTTPSRV_ADM_FREE;
+#endif
                                     sys_sem_signal(&server->ses_cnt);
                                     httpsrv_mem_free(ses_param);
                                 }
@@ -206,6 +228,9 @@ static void httpsrv_session_task(void *arg)
     HTTPSRV_SES_TASK_PARAM *ses_param = (HTTPSRV_SES_TASK_PARAM *)arg;
     HTTPSRV_STRUCT *server            = ses_param->server;
     HTTPSRV_SESSION_STRUCT *session   = *ses_param->session_p;
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    HTTPSRV_ADM_SLOT *slot = session->adm;
+#endif
 
     while (session->valid)
     {
@@ -216,6 +241,9 @@ static void httpsrv_session_task(void *arg)
     httpsrv_ses_close(session);
     httpsrv_ses_free(session);
     *ses_param->session_p = NULL;
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    slot->state = HTTPSRV_ADM_FREE;
+#endif
 
     /* Cleanup and end task */
     httpsrv_mem_free(ses_param);
@@ -310,10 +338,7 @@ static void httpsrv_ses_free(HTTPSRV_SESSION_STRUCT *session)
         {
             httpsrv_mem_free(session->request.path);
         }
-        if (session->request.auth.user_id)
-        {
-            httpsrv_mem_free(session->request.auth.user_id);
-        }
+        httpsrv_req_auth_free(session);
         if (session->buffer.data)
         {
             httpsrv_mem_free(session->buffer.data);
@@ -444,6 +469,13 @@ void httpsrv_http_process(void *server_ptr, void *session_ptr)
         }
         session->state = HTTPSRV_SES_CLOSE;
     }
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    /* Server is saturated and this session is slow to send its request */
+    else if (session->adm->reclaim && (session->state == HTTPSRV_SES_WAIT_REQ))
+    {
+        session->state = HTTPSRV_SES_CLOSE;
+    }
+#endif
 
     switch (session->state)
     {
@@ -470,6 +502,12 @@ void httpsrv_http_process(void *server_ptr, void *session_ptr)
                     session->state = HTTPSRV_SES_PROCESS_REQ;
                 }
             }
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+            if (session->state != HTTPSRV_SES_WAIT_REQ)
+            {
+                session->adm->state = HTTPSRV_ADM_BUSY;
+            }
+#endif
             break;
         case HTTPSRV_SES_PROCESS_REQ:
             httpsrv_ses_set_state(session, httpsrv_req_do(server, session));
@@ -495,15 +533,15 @@ void httpsrv_http_process(void *server_ptr, void *session_ptr)
                     session->response.file = NULL;
                 }
                 memset(&session->response, 0, sizeof(session->response));
-                if (session->request.auth.user_id != NULL)
-                {
-                    httpsrv_mem_free(session->request.auth.user_id);
-                }
-                session->request.auth.user_id  = NULL;
-                session->request.auth.password = NULL;
+                httpsrv_req_auth_free(session);
                 session->time                  = sys_now();
                 session->timeout               = HTTPSRV_CFG_KEEPALIVE_TIMEOUT;
                 session->flags                 = HTTPSRV_FLAG_IS_KEEP_ALIVE | HTTPSRV_FLAG_PROCESS_HEADER;
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+                session->adm->time    = session->time;
+                session->adm->reclaim = 0;
+                session->adm->state   = HTTPSRV_ADM_IDLE;
+#endif
             }
             break;
         case HTTPSRV_SES_CLOSE:
@@ -562,6 +600,7 @@ static int httpsrv_req_read(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *sess
     while (1)
     {
         uint32_t max_length;
+        int parsed;
 
         max_length = (session->buffer.data + HTTPSRV_SES_BUF_SIZE_PRV) - line_start;
         line_end   = memchr(line_start, (int)'\n', max_length);
@@ -589,23 +628,23 @@ static int httpsrv_req_read(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *sess
             break;
         }
 
-        if (session->request.lines == 1)
         {
-            if (httpsrv_req_line(server, session, line_start) != HTTPSRV_OK)
+            PERF_START;
+            if (session->request.lines == 1)
             {
-                session->buffer.offset = 0;
-                retval                 = HTTPSRV_FAIL;
-                goto EXIT;
+                parsed = httpsrv_req_line(server, session, line_start);
             }
-        }
-        else
-        {
-            if (httpsrv_req_hdr(session, line_start) != HTTPSRV_OK)
+            else
             {
-                session->buffer.offset = 0;
-                retval                 = HTTPSRV_FAIL;
-                goto EXIT;
+                parsed = httpsrv_req_hdr(server, session, line_start);
             }
+            PERF_STOP("httpsrv_req_parse");
+        }
+        if (parsed != HTTPSRV_OK)
+        {
+            session->buffer.offset = 0;
+            retval                 = HTTPSRV_FAIL;
+            goto EXIT;
         }
         /* Set start of next line after end of current line */
         line_start = line_end + 1;
@@ -673,19 +712,23 @@ static HTTPSRV_SES_STATE httpsrv_req_do(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_
 
     retval = HTTPSRV_SES_RESP;
 
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    /* Sessions reserved for priority requests serve nothing else */
+    if (session->adm->priority && !httpsrv_req_priority(session->request.path))
+    {
+        session->response.status_code = HTTPSRV_CODE_SERVICE_UNAVAILABLE;
+        goto EXIT;
+    }
+#endif
+
     /* Check authentication */
     session->response.auth_realm = httpsrv_req_realm(server, session->request.path);
     if (session->response.auth_realm != NULL)
     {
-        if (!httpsrv_check_auth(session->response.auth_realm, &session->request.auth))
+        if (!httpsrv_req_auth(server, session, session->response.auth_realm))
         {
             session->response.status_code = HTTPSRV_CODE_UNAUTHORIZED;
-            if (session->request.auth.user_id != NULL)
-            {
-                httpsrv_mem_free(session->request.auth.user_id);
-                session->request.auth.user_id  = NULL;
-                session->request.auth.password = NULL;
-            }
+            httpsrv_req_auth_free(session);
             goto EXIT;
         }
     }
@@ -797,6 +840,7 @@ static HTTPSRV_SES_STATE httpsrv_response(HTTPSRV_STRUCT *server, HTTPSRV_SESSIO
 #endif
             break;
         case HTTPSRV_CODE_OK:
+        case HTTPSRV_CODE_PARTIAL_CONTENT: /* set by httpsrv_sendfile() for range requests */
             if (session->request.method == HTTPSRV_REQ_HEAD)
             {
                 httpsrv_sendhdr(session, HTTPSRV_FS_size(session->response.file), 0);
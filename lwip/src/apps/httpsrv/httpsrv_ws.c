@@ -80,11 +80,15 @@ void ws_handshake(WS_HANDSHAKE_STRUCT *handshake)
     char sha1_sum[SHA1_DIGEST_SIZE];
 
     /* Get SHA-1 of key and WebSocket GUID and encode it in base64 */
-    SHA1_Init(&sha1_context);
-    SHA1_Update(&sha1_context, (uint8_t *)handshake->key, WS_KEY_LENGTH);
-    SHA1_Update(&sha1_context, (uint8_t *)guid, WS_GUID_LENGTH);
-    SHA1_Final(&sha1_context, (uint8_t *)sha1_sum);
-    base64_encode_binary(sha1_sum, handshake->accept, SHA1_DIGEST_SIZE);
+    {
+        PERF_START;
+        SHA1_Init(&sha1_context);
+        SHA1_Update(&sha1_context, (uint8_t *)handshake->key, WS_KEY_LENGTH);
+        SHA1_Update(&sha1_context, (uint8_t *)guid, WS_GUID_LENGTH);
+        SHA1_Final(&sha1_context, (uint8_t *)sha1_sum);
+        base64_encode_binary(sha1_sum, handshake->accept, SHA1_DIGEST_SIZE);
+        PERF_STOP("httpsrv_ws_accept");
+    }
 }
 
 /*
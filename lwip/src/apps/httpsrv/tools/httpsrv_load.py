@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+#
+# httpsrv_load.py
+# Slow client load generator for the HTTPSRV admission control
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+"""Open many slow connections to an HTTPSRV server and probe it meanwhile.
+
+Each slow connection sends its request line a few bytes at a time and never
+finishes the request, like a stalled or abandoned browser. While they are
+open, probe requests are sent for a priority route (a CGI script) and for a
+static page. The summary shows what admission control did with the slow
+connections and how the probes were served:
+
+- slow connections answered "503 Service Unavailable" at once: rejected on
+  saturation or on the per client limit (HTTPSRV_CFG_MAX_SES_PER_CLIENT);
+- slow connections closed without an answer: idle sessions reclaimed
+  (HTTPSRV_CFG_IDLE_RECLAIM_TIMEOUT) or timed out (HTTPSRV_CFG_SES_TIMEOUT);
+- status code, Retry-After and latency of each probe.
+
+Without admission control the probes wait in the listen backlog until the
+session timeout frees a session.
+
+Usage:
+    httpsrv_load.py [--port 80] [--slow 16] [--drip 1.0] [--duration 30]
+                    [--probe /status.cgi] [--probe /index.html]
+                    [--bind ADDR ...] HOST
+
+--bind spreads the slow connections over several local addresses, so the per
+client limit does not reject all of them.
+"""
+
+import argparse
+import socket
+import threading
+import time
+
+REQUEST = b"GET /index.html HTTP/1.1\r\nHost: device\r\nUser-Agent: httpsrv_load\r\n"
+
+
+class SlowResult:
+    def __init__(self):
+        self.outcome = "open"  # open, refused, 503, other, closed
+        self.status = None
+        self.lifetime = 0.0
+
+
+def parse_status(data):
+    """Return (status code, Retry-After) of a response head, or (None, None)."""
+    head = data.split(b"\r\n\r\n", 1)[0].decode("latin-1", "replace")
+    lines = head.split("\r\n")
+    parts = lines[0].split(" ")
+    if len(parts) < 2 or not parts[0].startswith("HTTP/") or not parts[1].isdigit():
+        return None, None
+    retry = None
+    for line in lines[1:]:
+        name, _, value = line.partition(":")
+        if name.strip().lower() == "retry-after":
+            retry = value.strip()
+    return int(parts[1]), retry
+
+
+def slow_client(args, bind, result, stop):
+    start = time.monotonic()
+    try:
+        sock = socket.create_connection((args.host, args.port), timeout=args.timeout,
+                                        source_address=(bind, 0) if bind else None)
+    except OSError:
+        result.outcome = "refused"
+        return
+    sock.settimeout(args.drip)
+    sent = 0
+    data = b""
+    try:
+        while not stop.is_set():
+            # Never send the final empty line, the request stays incomplete
+            if sent < len(REQUEST):
+                sock.sendall(REQUEST[sent:sent + args.chunk])
+                sent += args.chunk
+            try:
+                chunk = sock.recv(1024)
+            except socket.timeout:
+                continue
+            if not chunk:
+                break
+            data += chunk
+        if data:
+            result.status, _ = parse_status(data)
+            result.outcome = "503" if result.status == 503 else "other"
+        elif not stop.is_set():
+            result.outcome = "closed"
+    except OSError:
+        result.outcome = "closed"
+    finally:
+        result.lifetime = time.monotonic() - start
+        sock.close()
+
+
+def probe(args, path):
+    start = time.monotonic()
+    try:
+        with socket.create_connection((args.host, args.port), timeout=args.timeout) as sock:
+            sock.sendall(("GET %s HTTP/1.1\r\nHost: device\r\nConnection: close\r\n\r\n" % path).encode())
+            data = b""
+            while b"\r\n\r\n" not in data:
+                chunk = sock.recv(1024)
+                if not chunk:
+                    break
+                data += chunk
+    except OSError as err:
+        return None, None, time.monotonic() - start, str(err)
+    status, retry = parse_status(data)
+    return status, retry, time.monotonic() - start, None
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("host")
+    parser.add_argument("--port", type=int, default=80)
+    parser.add_argument("--slow", type=int, default=16, help="slow connections to open")
+    parser.add_argument("--chunk", type=int, default=2, help="bytes sent per drip")
+    parser.add_argument("--drip", type=float, default=1.0, help="seconds between drips")
+    parser.add_argument("--duration", type=float, default=30.0, help="seconds to keep the load")
+    parser.add_argument("--interval", type=float, default=2.0, help="seconds between probe rounds")
+    parser.add_argument("--timeout", type=float, default=10.0, help="connect and probe timeout")
+    parser.add_argument("--probe", action="append", help="probe path, repeatable")
+    parser.add_argument("--bind", action="append", help="local address of slow connections, repeatable")
+    args = parser.parse_args()
+    probes = args.probe or ["/status.cgi", "/index.html"]
+    binds = args.bind or [None]
+
+    stop = threading.Event()
+    results = [SlowResult() for _ in range(args.slow)]
+    threads = []
+    for i, result in enumerate(results):
+        thread = threading.Thread(target=slow_client, args=(args, binds[i % len(binds)], result, stop))
+        thread.start()
+        threads.append(thread)
+        time.sleep(0.02)
+
+    stats = {path: [] for path in probes}
+    end = time.monotonic() + args.duration
+    while time.monotonic() < end:
+        for path in probes:
+            status, retry, latency, err = probe(args, path)
+            stats[path].append((status, retry, latency, err))
+            print("%7.1fs %-16s %s%s %6.0f ms" % (args.duration - (end - time.monotonic()), path,
+                                                   status if status else err,
+                                                   " Retry-After: %s" % retry if retry else "", latency * 1000))
+        time.sleep(args.interval)
+
+    stop.set()
+    for thread in threads:
+        thread.join()
+
+    print("\nslow connections: %d" % len(results))
+    for outcome in ("503", "closed", "other", "refused", "open"):
+        hit = [r for r in results if r.outcome == outcome]
+        if hit:
+            print("  %-8s %3d  mean lifetime %6.1f s" % (outcome, len(hit), sum(r.lifetime for r in hit) / len(hit)))
+    for path, rows in stats.items():
+        served = [r for r in rows if r[0] is not None and r[0] != 503]
+        busy = [r for r in rows if r[0] == 503]
+        failed = [r for r in rows if r[0] is None]
+        latency = sorted(r[2] for r in served)
+        print("probe %-16s served %3d  503 %3d  failed %3d  median %s" %
+              (path, len(served), len(busy), len(failed),
+               "%.0f ms" % (latency[len(latency) // 2] * 1000) if latency else "-"))
+
+
+if __name__ == "__main__":
+    main()
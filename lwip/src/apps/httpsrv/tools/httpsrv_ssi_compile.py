@@ -0,0 +1,190 @@
+#!/usr/bin/env python3
+#
+# httpsrv_ssi_compile.py
+# HTTPSRV file system image generator with precompiled SSI templates
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+"""Generate the HTTPSRV file system image (httpsrv_fs_data.c).
+
+Every file below the root directory is emitted as a file data array, with a
+HTTPSRV_FS_DIR_ENTRY line in httpsrv_fs_data[] carrying the FNV-1a hash of the
+file the server uses as ETag. Server side include templates (.shtml, .shtm)
+are compiled as well: a HTTPSRV_FS_SSI_SPAN array describes their literal
+spans and SSI calls, so the server sends them without scanning for script
+tokens at run time.
+
+Script tokens are parsed exactly like httpsrv_sendextstr() does: "<%" followed
+by the function name, optionally ":parameter", up to one of the characters
+' ', ';', '%', '<', '>', CR, LF, TAB, FF. A terminating "%>" is consumed
+as a whole, any other terminator as a single character.
+
+Usage:
+    httpsrv_ssi_compile.py [--ssi name1,name2,...] -o httpsrv_fs_data.c ROOT
+
+Regenerate the image with it whenever a file below ROOT changes. The --ssi
+list gives the SSI function names in the order of the server's SSI link table
+(HTTPSRV_PARAM_STRUCT.ssi_lnk_tbl); it is needed only if there are templates.
+"""
+
+import argparse
+import os
+import re
+import sys
+
+TOKEN = b"<%"
+STOP = b" ;%<>\r\n\t\f"
+BYTES_PER_LINE = 10
+TEMPLATES = (".shtml", ".shtm")
+
+HEADER = """/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/* Generated by lwip/src/apps/httpsrv/tools/httpsrv_ssi_compile.py, do not edit */
+
+#include <httpsrv_fs.h>
+
+extern const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[];
+
+"""
+
+
+def c_ident(path):
+    return "httpsrv_fs_" + re.sub(r"[^0-9A-Za-z]", "_", path)
+
+
+def c_string(text):
+    out = '"'
+    for ch in text:
+        if ch in '"\\':
+            out += "\\" + ch
+        elif 0x20 <= ord(ch) < 0x7F:
+            out += ch
+        else:
+            out += "\\%03o" % ord(ch)
+    return out + '"'
+
+
+def fnv1a(data):
+    """32-bit FNV-1a hash, as httpsrv_etag() computes it."""
+    value = 0x811c9dc5
+    for b in data:
+        value = ((value ^ b) * 0x01000193) & 0xffffffff
+    return value
+
+
+def compile_template(data, ssi_names, max_name, path):
+    """Split data into (offset, size, ssi_index, param) spans."""
+    spans = []
+    start = 0
+    pos = data.find(TOKEN)
+    while pos >= 0:
+        name_start = pos + len(TOKEN)
+        name_end = name_start
+        while name_end < len(data) and data[name_end] not in STOP:
+            name_end += 1
+        if data[name_end:name_end + 2] == b"%>":
+            term = 2
+        elif name_end < len(data):
+            term = 1
+        else:
+            term = 0
+
+        name = data[name_start:name_end].decode("latin-1")
+        index = -1
+        param = ""
+        if 1 < len(name) < max_name:
+            fn_name, _, param = name.partition(":")
+            if fn_name in ssi_names:
+                index = ssi_names.index(fn_name)
+            else:
+                sys.stderr.write("%s: unknown SSI function '%s' at offset %d\n" % (path, fn_name, pos))
+        spans.append((start, pos - start, index, param))
+
+        start = name_end + term
+        pos = data.find(TOKEN, start)
+
+    spans.append((start, len(data) - start, -1, ""))
+    return spans
+
+
+def emit_file(out, path, data, spans):
+    ident = c_ident(path)
+
+    out.write("static const unsigned char %s[] = {\n" % ident)
+    out.write("\t/* %s */\n" % path)
+    for i in range(0, len(data), BYTES_PER_LINE):
+        chunk = data[i:i + BYTES_PER_LINE]
+        sep = "," if i + BYTES_PER_LINE < len(data) else ""
+        out.write("\t" + ", ".join("0x%02x" % b for b in chunk) + sep + "\n")
+    out.write("};\n\n")
+
+    if spans is None:
+        return
+
+    out.write("static const HTTPSRV_FS_SSI_SPAN %s_ssi[] = {\n" % ident)
+    for offset, size, index, param in spans:
+        param_c = c_string(param) if index >= 0 and param else "0"
+        out.write("\t{ %d, %d, %d, %s },\n" % (offset, size, index, param_c))
+    out.write("};\n\n")
+
+
+def list_files(root):
+    """Files below root, in the order of the directory table."""
+    names = []
+    for top, dirs, files in os.walk(root):
+        dirs.sort()
+        for name in files:
+            names.append(os.path.join(top, name))
+    return sorted(names, key=lambda n: os.path.relpath(n, root).lower())
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate the HTTPSRV file system image")
+    parser.add_argument("--ssi", default="",
+                        help="comma separated SSI function names, in SSI link table order")
+    parser.add_argument("--max-name", type=int, default=32,
+                        help="HTTPSRV_CFG_MAX_SCRIPT_LN of the target")
+    parser.add_argument("-o", "--output",
+                        help="image to write, with CRLF line ends like the one in the tree; stdout if omitted")
+    parser.add_argument("root", help="directory holding the files served as /")
+    args = parser.parse_args()
+
+    ssi_names = [n for n in args.ssi.split(",") if n]
+    if args.output:
+        out = open(args.output, "w", newline="\r\n")
+    else:
+        out = sys.stdout
+    entries = []
+
+    out.write(HEADER)
+    for name in list_files(args.root):
+        with open(name, "rb") as f:
+            data = f.read()
+        path = os.path.relpath(name, os.path.dirname(os.path.abspath(args.root)))
+        path = path.replace(os.sep, "/")
+        url = "/" + os.path.relpath(name, args.root).replace(os.sep, "/")
+        ident = c_ident(path)
+        if os.path.splitext(name)[1].lower() in TEMPLATES:
+            spans = compile_template(data, ssi_names, args.max_name, name)
+            ssi = "%s_ssi, sizeof(%s_ssi) / sizeof(%s_ssi[0])" % (ident, ident, ident)
+        else:
+            spans = None
+            ssi = "0, 0"
+        emit_file(out, path, data, spans)
+        entries.append('\t{ "%s", 0, (unsigned char*)%s, sizeof(%s), %s, 0x%08x },\n' %
+                       (url, ident, ident, ssi, fnv1a(data)))
+
+    out.write("const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[] = {\n")
+    for line in entries:
+        out.write(line)
+    out.write("\t{ 0, 0, 0, 0 }\n")
+    out.write("};\n\n")
+    if args.output:
+        out.close()
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -955,7 +955,11 @@ mqtt_tcp_recv_cb(void *arg, struct altcp_pcb *pcb, struct pbuf *p, err_t err)
 
     /* Tell remote that data has been received */
     altcp_recved(pcb, p->tot_len);
-    res = mqtt_parse_incoming(client, p);
+    {
+      PERF_START;
+      res = mqtt_parse_incoming(client, p);
+      PERF_STOP("mqtt_parse_incoming");
+    }
     pbuf_free(p);
 
     if (res != MQTT_CONNECT_ACCEPTED) {
@@ -1397,6 +1401,10 @@ mqtt_client_connect(mqtt_client_t *client, const ip_addr_t *ip_addr, u16_t port,
   if (client->conn == NULL) {
     return ERR_MEM;
   }
+#if MQTT_TOS && !LWIP_ALTCP
+  /* Mark before connecting so the whole connection gets the priority */
+  client->conn->tos = MQTT_TOS;
+#endif
 
   /* Set arg pointer for callbacks */
   altcp_arg(client->conn, client);
@@ -122,6 +122,14 @@ static u16_t dns_txid;
 #if DNS_TABLE_SIZE > 255
 #error DNS_TABLE_SIZE must fit into an u8_t
 #endif
+
+/** Number of hash buckets indexing the names of dns_table, a power of two */
+#ifndef DNS_HASH_BUCKETS
+#define DNS_HASH_BUCKETS          8
+#endif
+#if (DNS_HASH_BUCKETS & (DNS_HASH_BUCKETS - 1)) != 0
+#error DNS_HASH_BUCKETS must be a power of two
+#endif
 #if DNS_MAX_SERVERS > 255
 #error DNS_MAX_SERVERS must fit into an u8_t
 #endif
@@ -213,9 +221,15 @@ typedef enum {
   DNS_STATE_UNUSED           = 0,
   DNS_STATE_NEW              = 1,
   DNS_STATE_ASKING           = 2,
-  DNS_STATE_DONE             = 3
+  DNS_STATE_DONE             = 3,
+  DNS_STATE_FAILED           = 4
 } dns_state_enum_t;
 
+/** Entry has a query on the wire: either a first resolution or the
+ * background refresh (prefetch) of a cached answer */
+#define DNS_ENTRY_PENDING(entry) (((entry)->state == DNS_STATE_ASKING) || \
+                                  (((entry)->state == DNS_STATE_DONE) && (entry)->prefetch))
+
 /** DNS table entry */
 struct dns_table_entry {
   u32_t ttl;
@@ -226,9 +240,19 @@ struct dns_table_entry {
   u8_t  tmr;
   u8_t  retries;
   u8_t  seqno;
+  /* cached answer was returned since it was (re)fetched */
+  u8_t  used;
+  /* background refresh of a DONE entry in progress */
+  u8_t  prefetch;
+  /* refresh was tried for the cached answer, a failed one is not repeated */
+  u8_t  prefetched;
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
   u8_t pcb_idx;
 #endif
+  /* dns_name_hash() of name, compared before the name itself */
+  u16_t name_hash;
+  /* next entry of the same hash bucket, index + 1, 0 ends the chain */
+  u8_t  hash_next;
   char name[DNS_MAX_NAME_LENGTH];
 #if LWIP_IPV4 && LWIP_IPV6
   u8_t reqaddrtype;
@@ -285,6 +309,7 @@ static err_t dns_lookup_local(const char *hostname, size_t hostnamelen, ip_addr_
 static void dns_recv(void *s, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr, u16_t port);
 static void dns_check_entries(void);
 static void dns_call_found(u8_t idx, ip_addr_t *addr);
+static void dns_prefetch_stop(u8_t idx);
 
 /*-----------------------------------------------------------------------------
  * Globals
@@ -297,6 +322,8 @@ static u8_t                   dns_last_pcb_idx;
 #endif
 static u8_t                   dns_seqno;
 static struct dns_table_entry dns_table[DNS_TABLE_SIZE];
+/* first entry of each hash bucket, index + 1 so that the zeroed array is empty */
+static u8_t                   dns_hash_head[DNS_HASH_BUCKETS];
 static struct dns_req_entry   dns_requests[DNS_MAX_REQUESTS];
 static ip_addr_t              dns_servers[DNS_MAX_SERVERS];
 
@@ -598,6 +625,58 @@ dns_local_addhost(const char *hostname, const ip_addr_t *addr)
 #endif /* DNS_LOCAL_HOSTLIST_IS_DYNAMIC*/
 #endif /* DNS_LOCAL_HOSTLIST */
 
+/**
+ * Case-insensitive hash (FNV-1a) of a host name. Table entries keep the hash
+ * of their name and are chained in the bucket it selects, lookups walk that
+ * chain and compare only the names of entries whose hash matches.
+ */
+static u16_t
+dns_name_hash(const char *name, size_t namelen)
+{
+  u32_t hash = 2166136261UL;
+  size_t i;
+
+  for (i = 0; i < namelen; i++) {
+    u8_t c = (u8_t)name[i];
+    if ((c >= 'A') && (c <= 'Z')) {
+      c = (u8_t)(c + ('a' - 'A'));
+    }
+    hash = (hash ^ c) * 16777619UL;
+  }
+  return (u16_t)(hash ^ (hash >> 16));
+}
+
+/**
+ * Chain a table entry into the bucket of its name_hash. Entries stay chained
+ * whatever their state until dns_enqueue() fills them with another name.
+ */
+static void
+dns_hash_link(u8_t idx)
+{
+  u8_t *head = &dns_hash_head[dns_table[idx].name_hash & (DNS_HASH_BUCKETS - 1)];
+
+  dns_table[idx].hash_next = *head;
+  *head = (u8_t)(idx + 1);
+}
+
+/**
+ * Remove a table entry from the bucket of its name_hash, if it is chained.
+ */
+static void
+dns_hash_unlink(u8_t idx)
+{
+  u8_t *link = &dns_hash_head[dns_table[idx].name_hash & (DNS_HASH_BUCKETS - 1)];
+
+  while (*link != 0) {
+    if (*link == idx + 1) {
+      *link = dns_table[idx].hash_next;
+      dns_table[idx].hash_next = 0;
+      return;
+    }
+    link = &dns_table[*link - 1].hash_next;
+  }
+}
+
 /**
  * @ingroup dns
  * Look up a hostname in the array of known hostnames.
@@ -612,12 +691,14 @@ dns_local_addhost(const char *hostname, const ip_addr_t *addr)
  * @param addr the hostname's IP address, as u32_t (instead of ip_addr_t to
  *         better check for failure: != IPADDR_NONE) or IPADDR_NONE if the hostname
  *         was not found in the cached dns_table.
- * @return ERR_OK if found, ERR_ARG if not found
+ * @return ERR_OK if found, ERR_VAL if the name recently failed to resolve
+ *         (negative cache), ERR_ARG if not found
  */
 static err_t
 dns_lookup(const char *name, size_t hostnamelen, ip_addr_t *addr LWIP_DNS_ADDRTYPE_ARG(u8_t dns_addrtype))
 {
   size_t namelen;
+  u16_t hash;
   u8_t i;
 #if DNS_LOCAL_HOSTLIST
   if (dns_lookup_local(name, hostnamelen, addr LWIP_DNS_ADDRTYPE_ARG(dns_addrtype)) == ERR_OK) {
@@ -631,18 +712,30 @@ dns_lookup(const char *name, size_t hostnamelen, ip_addr_t *addr LWIP_DNS_ADDRTY
 #endif /* DNS_LOOKUP_LOCAL_EXTERN */
 
   namelen = LWIP_MIN(hostnamelen, DNS_MAX_NAME_LENGTH - 1);
-  /* Walk through name list, return entry if found. If not, return NULL. */
-  for (i = 0; i < DNS_TABLE_SIZE; ++i) {
-    if ((dns_table[i].state == DNS_STATE_DONE) &&
-        (lwip_strnicmp(name, dns_table[i].name, namelen) == 0) &&
-        !dns_table[i].name[namelen] &&
-        LWIP_DNS_ADDRTYPE_MATCH_IP(dns_addrtype, dns_table[i].ipaddr)) {
+  hash = dns_name_hash(name, namelen);
+  /* Walk through the bucket of the name, return entry if found. If not, return NULL. */
+  for (i = dns_hash_head[hash & (DNS_HASH_BUCKETS - 1)]; i != 0; i = dns_table[i - 1].hash_next) {
+    struct dns_table_entry *entry = &dns_table[i - 1];
+    if ((entry->name_hash != hash) ||
+        ((entry->state != DNS_STATE_DONE) && (entry->state != DNS_STATE_FAILED)) ||
+        (lwip_strnicmp(name, entry->name, namelen) != 0) ||
+        entry->name[namelen]) {
+      continue;
+    }
+    if (entry->state == DNS_STATE_FAILED) {
+      /* negative entries are per name, whatever the address type */
+      LWIP_DEBUGF(DNS_DEBUG, ("dns_lookup: \"%s\": failed recently, %"U32_F" s left\n",
+                              name, entry->ttl));
+      return ERR_VAL;
+    }
+    if (LWIP_DNS_ADDRTYPE_MATCH_IP(dns_addrtype, entry->ipaddr)) {
       LWIP_DEBUGF(DNS_DEBUG, ("dns_lookup: \"%s\": found = ", name));
-      ip_addr_debug_print_val(DNS_DEBUG, dns_table[i].ipaddr);
+      ip_addr_debug_print_val(DNS_DEBUG, entry->ipaddr);
       LWIP_DEBUGF(DNS_DEBUG, ("\n"));
       if (addr) {
-        ip_addr_copy(*addr, dns_table[i].ipaddr);
+        ip_addr_copy(*addr, entry->ipaddr);
       }
+      entry->used = 1;
       return ERR_OK;
     }
   }
@@ -785,6 +878,11 @@ dns_send(u8_t idx)
 #endif
      ) {
     /* DNS server not valid anymore, e.g. PPP netif has been shut down */
+    if (entry->prefetch) {
+      /* keep serving the cached address until it expires */
+      dns_prefetch_stop(idx);
+      return ERR_OK;
+    }
     /* call specified callback function if provided */
     dns_call_found(idx, NULL);
     /* flush this entry */
@@ -997,7 +1095,7 @@ dns_call_found(u8_t idx, ip_addr_t *addr)
     if (i == idx) {
       continue; /* only check other requests */
     }
-    if (dns_table[i].state == DNS_STATE_ASKING) {
+    if (DNS_ENTRY_PENDING(&dns_table[i])) {
       if (dns_table[i].pcb_idx == dns_table[idx].pcb_idx) {
         /* another request is still using the same pcb */
         dns_table[idx].pcb_idx = DNS_MAX_SOURCE_PORTS;
@@ -1026,7 +1124,7 @@ again:
 
   /* check whether the ID is unique */
   for (i = 0; i < DNS_TABLE_SIZE; i++) {
-    if ((dns_table[i].state == DNS_STATE_ASKING) &&
+    if (DNS_ENTRY_PENDING(&dns_table[i]) &&
         (dns_table[i].txid == txid)) {
       /* ID already used by another pending query */
       goto again;
@@ -1053,6 +1151,73 @@ dns_backupserver_available(struct dns_table_entry *pentry)
   return ret;
 }
 
+/**
+ * Turn an entry whose resolution failed into a negative cache entry, so that
+ * lookups of the name fail immediately for ttl seconds, and report the
+ * failure to the waiting requests. A ttl of 0 just flushes the entry.
+ */
+static void
+dns_negative_response(u8_t idx, u32_t ttl)
+{
+  struct dns_table_entry *entry = &dns_table[idx];
+
+  if (ttl == 0) {
+    dns_call_found(idx, NULL);
+    entry->state = DNS_STATE_UNUSED;
+    return;
+  }
+  LWIP_DEBUGF(DNS_DEBUG, ("dns: \"%s\": negative entry for %"U32_F" s\n", entry->name, ttl));
+  entry->state = DNS_STATE_FAILED;
+  entry->ttl = ttl;
+  dns_call_found(idx, NULL);
+}
+
+/**
+ * Refresh a cached entry in the background shortly before its TTL runs out.
+ * The entry stays DONE, so lookups keep returning the current address until
+ * the answer arrives. Only the first server is asked, once per answer, and
+ * failures are not reported: the entry then simply expires.
+ */
+static void
+dns_prefetch_start(u8_t idx)
+{
+  err_t err;
+  struct dns_table_entry *entry = &dns_table[idx];
+
+  entry->used = 0;
+#if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_RAND_SRC_PORT) != 0)
+  entry->pcb_idx = dns_alloc_pcb();
+  if (entry->pcb_idx >= DNS_MAX_SOURCE_PORTS) {
+    return;
+  }
+#endif
+  LWIP_DEBUGF(DNS_DEBUG, ("dns_prefetch_start: \"%s\": %"U32_F" s left\n", entry->name, entry->ttl));
+  entry->txid = dns_create_txid();
+  entry->prefetch = 1;
+  entry->prefetched = 1;
+  entry->server_idx = 0;
+  entry->tmr = 1;
+  entry->retries = 0;
+  err = dns_send(idx);
+  if (err != ERR_OK) {
+    LWIP_DEBUGF(DNS_DEBUG | LWIP_DBG_LEVEL_WARNING,
+                ("dns_send returned error: %s\n", lwip_strerr(err)));
+  }
+}
+
+/**
+ * Give up the background refresh of an entry, if any.
+ */
+static void
+dns_prefetch_stop(u8_t idx)
+{
+  if (dns_table[idx].prefetch) {
+    dns_table[idx].prefetch = 0;
+    /* no request waits on a prefetch: this only releases the pcb */
+    dns_call_found(idx, NULL);
+  }
+}
+
 /**
  * dns_check_entry() - see if entry has not yet been queried and, if so, sends out a query.
  * Check an entry in the dns_table:
@@ -1101,9 +1266,7 @@ dns_check_entry(u8_t i)
           } else {
             LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": timeout\n", entry->name));
             /* call specified callback function if provided */
-            dns_call_found(i, NULL);
-            /* flush this entry */
-            entry->state = DNS_STATE_UNUSED;
+            dns_negative_response(i, DNS_NEG_TTL_FAILURE);
             break;
           }
         } else {
@@ -1123,8 +1286,31 @@ dns_check_entry(u8_t i)
       /* if the time to live is nul */
       if ((entry->ttl == 0) || (--entry->ttl == 0)) {
         LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": flush\n", entry->name));
+        dns_prefetch_stop(i);
         /* flush this entry, there cannot be any related pending entries in this state */
         entry->state = DNS_STATE_UNUSED;
+      } else if (entry->prefetch) {
+        if (--entry->tmr == 0) {
+          if (++entry->retries == DNS_MAX_RETRIES) {
+            LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": prefetch timeout\n", entry->name));
+            dns_prefetch_stop(i);
+          } else {
+            entry->tmr = entry->retries;
+            err = dns_send(i);
+            if (err != ERR_OK) {
+              LWIP_DEBUGF(DNS_DEBUG | LWIP_DBG_LEVEL_WARNING,
+                          ("dns_send returned error: %s\n", lwip_strerr(err)));
+            }
+          }
+        }
+      } else if (entry->used && !entry->prefetched && (entry->ttl <= DNS_PREFETCH_TIME)) {
+        dns_prefetch_start(i);
+      }
+      break;
+    case DNS_STATE_FAILED:
+      if ((entry->ttl == 0) || (--entry->ttl == 0)) {
+        LWIP_DEBUGF(DNS_DEBUG, ("dns_check_entry: \"%s\": negative entry expired\n", entry->name));
+        entry->state = DNS_STATE_UNUSED;
       }
       break;
     case DNS_STATE_UNUSED:
@@ -1158,6 +1344,9 @@ dns_correct_response(u8_t idx, u32_t ttl)
   struct dns_table_entry *entry = &dns_table[idx];
 
   entry->state = DNS_STATE_DONE;
+  entry->prefetch = 0;
+  entry->prefetched = 0;
+  entry->used = 0;
 
   LWIP_DEBUGF(DNS_DEBUG, ("dns_recv: \"%s\": response = ", entry->name));
   ip_addr_debug_print_val(DNS_DEBUG, entry->ipaddr);
@@ -1213,7 +1402,7 @@ dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr,
     txid = lwip_htons(hdr.id);
     for (i = 0; i < DNS_TABLE_SIZE; i++) {
       struct dns_table_entry *entry = &dns_table[i];
-      if ((entry->state == DNS_STATE_ASKING) &&
+      if (DNS_ENTRY_PENDING(entry) &&
           (entry->txid == txid)) {
 
         /* We only care about the question(s) and the answers. The authrr
@@ -1273,7 +1462,7 @@ dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr,
           /* if there is another backup DNS server to try
            * then don't stop the DNS request
            */
-          if (dns_backupserver_available(entry)) {
+          if (dns_backupserver_available(entry) && !entry->prefetch) {
             /* avoid retrying the same server */
             entry->retries = DNS_MAX_RETRIES-1;
             entry->tmr     = 1;
@@ -1349,8 +1538,9 @@ dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr,
             --nanswers;
           }
 #if LWIP_IPV4 && LWIP_IPV6
-          if ((entry->reqaddrtype == LWIP_DNS_ADDRTYPE_IPV4_IPV6) ||
-              (entry->reqaddrtype == LWIP_DNS_ADDRTYPE_IPV6_IPV4)) {
+          if (!entry->prefetch &&
+              ((entry->reqaddrtype == LWIP_DNS_ADDRTYPE_IPV4_IPV6) ||
+               (entry->reqaddrtype == LWIP_DNS_ADDRTYPE_IPV6_IPV4))) {
             if (entry->reqaddrtype == LWIP_DNS_ADDRTYPE_IPV4_IPV6) {
               /* IPv4 failed, try IPv6 */
               dns_table[i].reqaddrtype = LWIP_DNS_ADDRTYPE_IPV6;
@@ -1368,8 +1558,14 @@ dns_recv(void *arg, struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *addr,
         }
         /* call callback to indicate error, clean up memory and return */
         pbuf_free(p);
-        dns_call_found(i, NULL);
-        dns_table[i].state = DNS_STATE_UNUSED;
+        if (entry->prefetch) {
+          /* keep serving the cached address until it expires */
+          dns_prefetch_stop(i);
+        } else if ((hdr.flags2 & DNS_FLAG2_ERR_MASK) == DNS_FLAG2_ERR_NAME) {
+          dns_negative_response(i, DNS_NEG_TTL_NXDOMAIN);
+        } else {
+          dns_negative_response(i, DNS_NEG_TTL_FAILURE);
+        }
         return;
       }
     }
@@ -1398,17 +1594,21 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
   u8_t lseq, lseqi;
   struct dns_table_entry *entry = NULL;
   size_t namelen;
+  u16_t hash;
   struct dns_req_entry *req;
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) != 0)
-  u8_t r;
+  u8_t r, n;
 #endif
 
   namelen = LWIP_MIN(hostnamelen, DNS_MAX_NAME_LENGTH - 1);
+  hash = dns_name_hash(name, namelen);
 
 #if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) != 0)
   /* check for duplicate entries */
-  for (i = 0; i < DNS_TABLE_SIZE; i++) {
+  for (n = dns_hash_head[hash & (DNS_HASH_BUCKETS - 1)]; n != 0; n = dns_table[i].hash_next) {
+    i = (u8_t)(n - 1);
     if ((dns_table[i].state == DNS_STATE_ASKING) &&
+        (dns_table[i].name_hash == hash) &&
         (lwip_strnicmp(name, dns_table[i].name, namelen) == 0) &&
         !dns_table[i].name[namelen]) {
 #if LWIP_IPV4 && LWIP_IPV6
@@ -1445,7 +1645,7 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
       break;
     }
     /* check if this is the oldest completed entry */
-    if (entry->state == DNS_STATE_DONE) {
+    if ((entry->state == DNS_STATE_DONE) || (entry->state == DNS_STATE_FAILED)) {
       u8_t age = (u8_t)(dns_seqno - entry->seqno);
       if (age > lseq) {
         lseq = age;
@@ -1456,7 +1656,7 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
 
   /* if we don't have found an unused entry, use the oldest completed one */
   if (i == DNS_TABLE_SIZE) {
-    if ((lseqi >= DNS_TABLE_SIZE) || (dns_table[lseqi].state != DNS_STATE_DONE)) {
+    if (lseqi >= DNS_TABLE_SIZE) {
       /* no entry can be used now, table is full */
       LWIP_DEBUGF(DNS_DEBUG, ("dns_enqueue: \"%s\": DNS entries table is full\n", name));
       return ERR_MEM;
@@ -1464,6 +1664,7 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
       /* use the oldest completed one */
       i = lseqi;
       entry = &dns_table[i];
+      dns_prefetch_stop(i);
     }
   }
 
@@ -1493,6 +1694,12 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
   /* fill the entry */
   entry->state = DNS_STATE_NEW;
   entry->seqno = dns_seqno;
+  entry->used = 0;
+  entry->prefetch = 0;
+  entry->prefetched = 0;
+  dns_hash_unlink(i);
+  entry->name_hash = hash;
+  dns_hash_link(i);
   LWIP_DNS_SET_ADDRTYPE(entry->reqaddrtype, dns_addrtype);
   LWIP_DNS_SET_ADDRTYPE(req->reqaddrtype, dns_addrtype);
   req->found = found;
@@ -1536,6 +1743,8 @@ dns_enqueue(const char *name, size_t hostnamelen, dns_found_callback found,
  * - ERR_INPROGRESS enqueue a request to be sent to the DNS server
  *   for resolution if no errors are present.
  * - ERR_ARG: dns client not initialized or invalid hostname
+ * - ERR_VAL: no DNS server set, or the name failed to resolve recently
+ *   (see DNS_NEG_TTL_NXDOMAIN and DNS_NEG_TTL_FAILURE)
  *
  * @param hostname the hostname that is to be queried
  * @param addr pointer to a ip_addr_t where to store the address if it is already
@@ -1571,6 +1780,7 @@ dns_gethostbyname_addrtype(const char *hostname, ip_addr_t *addr, dns_found_call
                            void *callback_arg, u8_t dns_addrtype)
 {
   size_t hostnamelen;
+  err_t err;
 #if LWIP_DNS_SUPPORT_MDNS_QUERIES
   u8_t is_mdns;
 #endif
@@ -1613,8 +1823,10 @@ dns_gethostbyname_addrtype(const char *hostname, ip_addr_t *addr, dns_found_call
     }
   }
   /* already have this address cached? */
-  if (dns_lookup(hostname, hostnamelen, addr LWIP_DNS_ADDRTYPE_ARG(dns_addrtype)) == ERR_OK) {
-    return ERR_OK;
+  err = dns_lookup(hostname, hostnamelen, addr LWIP_DNS_ADDRTYPE_ARG(dns_addrtype));
+  if ((err == ERR_OK) || (err == ERR_VAL)) {
+    /* cached address, or cached failure */
+    return err;
   }
 #if LWIP_IPV4 && LWIP_IPV6
   if ((dns_addrtype == LWIP_DNS_ADDRTYPE_IPV4_IPV6) || (dns_addrtype == LWIP_DNS_ADDRTYPE_IPV6_IPV4)) {
@@ -0,0 +1,319 @@
+/**
+ * @file
+ * Per-flow statistics: a bounded 5-tuple table with LRU eviction, fed from
+ * the TCP and UDP input/output paths.
+ *
+ * Lookups go through a small hash index. TCP and UDP PCBs additionally keep
+ * the slot of their last flow as a hint, so the common case of a connected
+ * PCB costs one key compare. A miss on a full table scans the table once to
+ * find the least recently used entry, which bounds the worst case to
+ * FLOW_STATS_TABLE_SIZE compares.
+ */
+
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "lwip/opt.h"
+
+#if LWIP_FLOW_STATS /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/flow_stats.h"
+#include "lwip/def.h"
+#include "lwip/debug.h"
+
+#include <string.h>
+
+struct flow_stats_cost flow_stats_cost;
+
+static struct flow_stats_entry flow_table[FLOW_STATS_TABLE_SIZE];
+/* bucket heads, slot index + 1 (0 = empty) */
+static u8_t flow_buckets[FLOW_STATS_HASH_SIZE];
+/* LRU clock, advanced on every update */
+static u32_t flow_clock;
+
+static u32_t
+flow_stats_addr_fold(const ip_addr_t *addr)
+{
+#if LWIP_IPV6
+  if (IP_IS_V6(addr)) {
+    const u32_t *w = ip_2_ip6(addr)->addr;
+    return w[0] ^ w[1] ^ w[2] ^ w[3];
+  }
+#endif /* LWIP_IPV6 */
+#if LWIP_IPV4
+  return ip4_addr_get_u32(ip_2_ip4(addr));
+#else
+  return 0;
+#endif /* LWIP_IPV4 */
+}
+
+static u8_t
+flow_stats_hash(u8_t proto, const ip_addr_t *local_ip, u16_t local_port,
+                const ip_addr_t *remote_ip, u16_t remote_port)
+{
+  u32_t h;
+
+  /* multiply between the parts so that address and port steps cannot cancel
+     (peer N+1 on port N+1 would xor to the same value as peer N on port N) */
+  h = (flow_stats_addr_fold(remote_ip) ^ proto) * 2654435761UL;
+  h = (h ^ flow_stats_addr_fold(local_ip) ^ (((u32_t)local_port << 16) | remote_port)) * 2654435761UL;
+  /* the top bits depend on all input bits */
+  return (u8_t)((h >> 24) & (FLOW_STATS_HASH_SIZE - 1));
+}
+
+static int
+flow_stats_match(const struct flow_stats_entry *e, u8_t proto,
+                 const ip_addr_t *local_ip, u16_t local_port,
+                 const ip_addr_t *remote_ip, u16_t remote_port)
+{
+  return (e->proto == proto) &&
+         (e->local_port == local_port) && (e->remote_port == remote_port) &&
+         ip_addr_eq(&e->remote_ip, remote_ip) && ip_addr_eq(&e->local_ip, local_ip);
+}
+
+static void
+flow_stats_unlink(u8_t idx)
+{
+  struct flow_stats_entry *e = &flow_table[idx];
+  u8_t *link = &flow_buckets[flow_stats_hash(e->proto, &e->local_ip, e->local_port,
+                                             &e->remote_ip, e->remote_port)];
+
+  while (*link != 0) {
+    if (*link == (u8_t)(idx + 1)) {
+      *link = e->next;
+      return;
+    }
+    link = &flow_table[*link - 1].next;
+  }
+  LWIP_ASSERT("flow_stats_unlink: entry not in its bucket", 0);
+}
+
+/* Take a free slot or evict the least recently used flow. */
+static u8_t
+flow_stats_alloc(void)
+{
+  u8_t i;
+  u8_t victim = 0;
+
+  for (i = 0; i < FLOW_STATS_TABLE_SIZE; i++) {
+    if (flow_table[i].proto == 0) {
+      return i;
+    }
+    /* wrap-safe: the oldest stamp is the furthest behind the clock */
+    if ((u32_t)(flow_clock - flow_table[i].last_used) >
+        (u32_t)(flow_clock - flow_table[victim].last_used)) {
+      victim = i;
+    }
+  }
+  flow_stats_unlink(victim);
+  flow_stats_cost.evictions++;
+  return victim;
+}
+
+static struct flow_stats_entry *
+flow_stats_get(u8_t proto, const ip_addr_t *local_ip, u16_t local_port,
+               const ip_addr_t *remote_ip, u16_t remote_port, u8_t *hint)
+{
+  struct flow_stats_entry *e;
+  u8_t bucket;
+  u8_t idx;
+
+  flow_stats_cost.lookups++;
+  if ((hint != NULL) && (*hint != 0)) {
+    e = &flow_table[*hint - 1];
+    if (flow_stats_match(e, proto, local_ip, local_port, remote_ip, remote_port)) {
+      flow_stats_cost.hint_hits++;
+      return e;
+    }
+  }
+
+  bucket = flow_stats_hash(proto, local_ip, local_port, remote_ip, remote_port);
+  for (idx = flow_buckets[bucket]; idx != 0; idx = flow_table[idx - 1].next) {
+    flow_stats_cost.probes++;
+    e = &flow_table[idx - 1];
+    if (flow_stats_match(e, proto, local_ip, local_port, remote_ip, remote_port)) {
+      if (hint != NULL) {
+        *hint = idx;
+      }
+      return e;
+    }
+  }
+
+  idx = flow_stats_alloc();
+  e = &flow_table[idx];
+  memset(e, 0, sizeof(*e));
+  ip_addr_copy(e->local_ip, *local_ip);
+  ip_addr_copy(e->remote_ip, *remote_ip);
+  e->local_port = local_port;
+  e->remote_port = remote_port;
+  e->proto = proto;
+  e->rtt_min_ms = 0xffff;
+  e->next = flow_buckets[bucket];
+  flow_buckets[bucket] = (u8_t)(idx + 1);
+  flow_stats_cost.inserts++;
+  if (hint != NULL) {
+    *hint = (u8_t)(idx + 1);
+  }
+  return e;
+}
+
+void
+flow_stats_init(void)
+{
+  flow_stats_reset();
+}
+
+/**
+ * Drop all tracked flows and reset the cost counters.
+ */
+void
+flow_stats_reset(void)
+{
+  memset(flow_table, 0, sizeof(flow_table));
+  memset(flow_buckets, 0, sizeof(flow_buckets));
+  memset(&flow_stats_cost, 0, sizeof(flow_stats_cost));
+  flow_clock = 0;
+}
+
+/**
+ * Account one event on a flow, creating the flow if it is not tracked yet.
+ *
+ * @param proto IP_PROTO_TCP or IP_PROTO_UDP
+ * @param hint optional per-PCB slot hint, updated to the slot used (may be NULL)
+ * @param what FLOW_STATS_RX, FLOW_STATS_TX, FLOW_STATS_REXMIT or FLOW_STATS_RTT
+ * @param val byte count or RTT in milliseconds, depending on what
+ */
+void
+flow_stats_update(u8_t proto,
+                  const ip_addr_t *local_ip, u16_t local_port,
+                  const ip_addr_t *remote_ip, u16_t remote_port,
+                  u8_t *hint, u8_t what, u32_t val)
+{
+  struct flow_stats_entry *e;
+
+  LWIP_ASSERT_CORE_LOCKED();
+
+  e = flow_stats_get(proto, local_ip, local_port, remote_ip, remote_port, hint);
+  e->last_used = ++flow_clock;
+
+  switch (what) {
+    case FLOW_STATS_RX:
+      e->rx_pkts++;
+      e->rx_bytes += val;
+      break;
+    case FLOW_STATS_TX:
+      e->tx_pkts++;
+      e->tx_bytes += val;
+      break;
+    case FLOW_STATS_REXMIT:
+      e->tx_pkts++;
+      e->tx_bytes += val;
+      e->rexmits++;
+      break;
+    case FLOW_STATS_RTT:
+      if (val > 0xffff) {
+        val = 0xffff;
+      }
+      e->rtt_samples++;
+      e->rtt_sum_ms += val;
+      if (val < e->rtt_min_ms) {
+        e->rtt_min_ms = (u16_t)val;
+      }
+      if (val > e->rtt_max_ms) {
+        e->rtt_max_ms = (u16_t)val;
+      }
+      break;
+    default:
+      LWIP_ASSERT("flow_stats_update: invalid event", 0);
+      break;
+  }
+}
+
+/**
+ * Iterate over the tracked flows.
+ * Must be called from the TCPIP thread or with the core lock held.
+ *
+ * @param prev entry returned by the previous call, NULL to start
+ * @return the next tracked flow, or NULL when done
+ */
+const struct flow_stats_entry *
+flow_stats_next(const struct flow_stats_entry *prev)
+{
+  const struct flow_stats_entry *e = (prev == NULL) ? flow_table : prev + 1;
+
+  for (; e < &flow_table[FLOW_STATS_TABLE_SIZE]; e++) {
+    if (e->proto != 0) {
+      return e;
+    }
+  }
+  return NULL;
+}
+
+/**
+ * Find the heaviest flows by total (rx + tx) bytes.
+ * Must be called from the TCPIP thread or with the core lock held.
+ *
+ * @param out array receiving up to max entries, heaviest first
+ * @param max size of out
+ * @return number of entries written to out
+ */
+u8_t
+flow_stats_top(const struct flow_stats_entry **out, u8_t max)
+{
+  const struct flow_stats_entry *e = NULL;
+  u8_t n = 0;
+
+  while ((e = flow_stats_next(e)) != NULL) {
+    u32_t bytes = e->rx_bytes + e->tx_bytes;
+    u8_t pos = n;
+
+    /* insertion into the sorted output, dropping the lightest on overflow */
+    while ((pos > 0) && (out[pos - 1]->rx_bytes + out[pos - 1]->tx_bytes < bytes)) {
+      if (pos < max) {
+        out[pos] = out[pos - 1];
+      }
+      pos--;
+    }
+    if (pos < max) {
+      out[pos] = e;
+      if (n < max) {
+        n++;
+      }
+    }
+  }
+  return n;
+}
+
+#if LWIP_STATS_DISPLAY
+void
+flow_stats_display(void)
+{
+  const struct flow_stats_entry *e = NULL;
+  char local[IPADDR_STRLEN_MAX];
+  char remote[IPADDR_STRLEN_MAX];
+
+  LWIP_PLATFORM_DIAG(("\nFLOWS\n\t"));
+  LWIP_PLATFORM_DIAG(("lookups: %"U32_F" hint_hits: %"U32_F" probes: %"U32_F
+                      " inserts: %"U32_F" evictions: %"U32_F"\n",
+                      flow_stats_cost.lookups, flow_stats_cost.hint_hits, flow_stats_cost.probes,
+                      flow_stats_cost.inserts, flow_stats_cost.evictions));
+  while ((e = flow_stats_next(e)) != NULL) {
+    ipaddr_ntoa_r(&e->local_ip, local, sizeof(local));
+    ipaddr_ntoa_r(&e->remote_ip, remote, sizeof(remote));
+    LWIP_PLATFORM_DIAG(("%s %s:%"U16_F" %s:%"U16_F"\n\t",
+                        (e->proto == IP_PROTO_TCP) ? "TCP" : "UDP",
+                        local, e->local_port, remote, e->remote_port));
+    LWIP_PLATFORM_DIAG(("rx: %"U32_F"/%"U32_F" tx: %"U32_F"/%"U32_F" rexmit: %"U32_F"\n\t",
+                        e->rx_pkts, e->rx_bytes, e->tx_pkts, e->tx_bytes, e->rexmits));
+    if (e->rtt_samples != 0) {
+      LWIP_PLATFORM_DIAG(("rtt min/avg/max: %"U16_F"/%"U32_F"/%"U16_F" ms\n",
+                          e->rtt_min_ms, e->rtt_sum_ms / e->rtt_samples, e->rtt_max_ms));
+    } else {
+      LWIP_PLATFORM_DIAG(("rtt: -\n"));
+    }
+  }
+}
+#endif /* LWIP_STATS_DISPLAY */
+
+#endif /* LWIP_FLOW_STATS */
@@ -40,6 +40,7 @@
 
 #include "lwip/init.h"
 #include "lwip/stats.h"
+#include "lwip/flow_stats.h"
 #include "lwip/sys.h"
 #include "lwip/mem.h"
 #include "lwip/memp.h"
@@ -357,6 +358,7 @@ lwip_init(void)
 
   /* Modules initialization */
   stats_init();
+  flow_stats_init();
 #if !NO_SYS
   sys_init();
 #endif /* !NO_SYS */
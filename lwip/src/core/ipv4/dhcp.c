@@ -244,6 +244,7 @@ static err_t dhcp_decline(struct netif *netif);
 #endif /* LWIP_DHCP_DOES_ACD_CHECK */
 static err_t dhcp_rebind(struct netif *netif);
 static err_t dhcp_reboot(struct netif *netif);
+static err_t dhcp_attach(struct netif *netif);
 static void dhcp_set_state(struct dhcp *dhcp, u8_t new_state);
 
 /* receive, unfold, parse and free incoming messages */
@@ -708,6 +709,13 @@ dhcp_handle_ack(struct netif *netif, struct dhcp_msg *msg_in)
   /* (y)our internet address */
   ip4_addr_copy(dhcp->offered_ip_addr, msg_in->yiaddr);
 
+#if LWIP_DHCP_INIT_REBOOT
+  /* a lease confirmed after INIT-REBOOT was not offered, take the server from the ACK */
+  if ((dhcp->state == DHCP_STATE_REBOOTING) && dhcp_option_given(dhcp, DHCP_OPTION_IDX_SERVER_ID)) {
+    ip_addr_set_ip4_u32(&dhcp->server_ip_addr, lwip_htonl(dhcp_get_option_value(dhcp, DHCP_OPTION_IDX_SERVER_ID)));
+  }
+#endif /* LWIP_DHCP_INIT_REBOOT */
+
 #if LWIP_DHCP_BOOTP_FILE
   /* copy boot server address,
      boot file name copied in dhcp_parse_reply if not overloaded */
@@ -809,6 +817,53 @@ void dhcp_cleanup(struct netif *netif)
  */
 err_t
 dhcp_start(struct netif *netif)
+{
+  err_t result;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("netif != NULL", (netif != NULL), return ERR_ARG;);
+  LWIP_ERROR("netif is not up, old style port?", netif_is_up(netif), return ERR_ARG;);
+  LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("dhcp_start(netif=%p) %c%c%"U16_F"\n", (void *)netif, netif->name[0], netif->name[1], (u16_t)netif->num));
+
+  result = dhcp_attach(netif);
+  if (result != ERR_OK) {
+    return result;
+  }
+
+  if (!netif_is_link_up(netif)) {
+    /* set state INIT and wait for dhcp_network_changed() to call dhcp_discover() */
+    dhcp_set_state(netif_dhcp_data(netif), DHCP_STATE_INIT);
+    return ERR_OK;
+  }
+
+  /* (re)start the DHCP negotiation */
+  result = dhcp_discover(netif);
+  if (result != ERR_OK) {
+    /* free resources allocated above */
+    dhcp_release_and_stop(netif);
+    return ERR_MEM;
+  }
+  return result;
+}
+
+#if LWIP_DHCP_INIT_REBOOT
+/**
+ * @ingroup dhcp4
+ * Start DHCP negotiation for a network interface with a lease kept from an
+ * earlier session on the same network.
+ *
+ * The lease is confirmed with a REQUEST (INIT-REBOOT). Its address is used
+ * while the server answers: a NAK removes it and starts discovery, an ACK
+ * binds it like any other lease.
+ *
+ * @param netif The lwIP network interface
+ * @param lease The lease to confirm, dhcp_start() is used without an address
+ * @return lwIP error code
+ * - ERR_OK - No error
+ * - ERR_MEM - Out of memory
+ */
+err_t
+dhcp_start_reboot(struct netif *netif, const struct dhcp_lease *lease)
 {
   struct dhcp *dhcp;
   err_t result;
@@ -816,8 +871,87 @@ dhcp_start(struct netif *netif)
   LWIP_ASSERT_CORE_LOCKED();
   LWIP_ERROR("netif != NULL", (netif != NULL), return ERR_ARG;);
   LWIP_ERROR("netif is not up, old style port?", netif_is_up(netif), return ERR_ARG;);
+
+  if ((lease == NULL) || ip4_addr_isany_val(lease->ip_addr)) {
+    return dhcp_start(netif);
+  }
+  LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("dhcp_start_reboot(netif=%p) %c%c%"U16_F"\n", (void *)netif, netif->name[0], netif->name[1], (u16_t)netif->num));
+
+  result = dhcp_attach(netif);
+  if (result != ERR_OK) {
+    return result;
+  }
   dhcp = netif_dhcp_data(netif);
-  LWIP_DEBUGF(DHCP_DEBUG | LWIP_DBG_TRACE | LWIP_DBG_STATE, ("dhcp_start(netif=%p) %c%c%"U16_F"\n", (void *)netif, netif->name[0], netif->name[1], (u16_t)netif->num));
+
+  ip4_addr_copy(dhcp->offered_ip_addr, lease->ip_addr);
+  ip4_addr_copy(dhcp->offered_sn_mask, lease->sn_mask);
+  ip4_addr_copy(dhcp->offered_gw_addr, lease->gw_addr);
+  ip_addr_copy_from_ip4(dhcp->server_ip_addr, lease->server_ip_addr);
+  dhcp->offered_t0_lease = lease->lease_time;
+  if (!ip4_addr_isany_val(lease->sn_mask)) {
+    dhcp->flags |= DHCP_FLAG_SUBNET_MASK_GIVEN;
+  }
+
+  /* use the address until the server answers, the state is set first so
+     that netif callbacks see the lease being confirmed */
+  dhcp_set_state(dhcp, DHCP_STATE_REBOOTING);
+  netif_set_addr(netif, &lease->ip_addr, &lease->sn_mask, &lease->gw_addr);
+
+  if (!netif_is_link_up(netif)) {
+    /* dhcp_network_changed_link_up() sends the request */
+    return ERR_OK;
+  }
+
+  result = dhcp_reboot(netif);
+  if (result != ERR_OK) {
+    /* free resources allocated above */
+    dhcp_release_and_stop(netif);
+    return ERR_MEM;
+  }
+  return result;
+}
+
+/**
+ * @ingroup dhcp4
+ * Get the lease the interface is bound to, to be kept for dhcp_start_reboot().
+ *
+ * @param netif The lwIP network interface
+ * @param lease Filled with the lease
+ * @return ERR_OK, ERR_VAL if DHCP did not supply the interface address
+ */
+err_t
+dhcp_get_lease(const struct netif *netif, struct dhcp_lease *lease)
+{
+  struct dhcp *dhcp;
+
+  LWIP_ASSERT_CORE_LOCKED();
+  LWIP_ERROR("netif != NULL", (netif != NULL), return ERR_ARG;);
+  LWIP_ERROR("lease != NULL", (lease != NULL), return ERR_ARG;);
+
+  if (!dhcp_supplied_address(netif)) {
+    return ERR_VAL;
+  }
+  dhcp = netif_dhcp_data(netif);
+
+  ip4_addr_copy(lease->ip_addr, dhcp->offered_ip_addr);
+  ip4_addr_copy(lease->sn_mask, *netif_ip4_netmask(netif));
+  ip4_addr_copy(lease->gw_addr, *netif_ip4_gw(netif));
+  ip4_addr_copy(lease->server_ip_addr, *ip_2_ip4(&dhcp->server_ip_addr));
+  lease->lease_time = dhcp->offered_t0_lease;
+  return ERR_OK;
+}
+#endif /* LWIP_DHCP_INIT_REBOOT */
+
+/**
+ * Attach a cleared DHCP client to the interface, allocating it if needed.
+ *
+ * @param netif The lwIP network interface
+ * @return ERR_OK, ERR_MEM if the client or its PCB cannot be allocated
+ */
+static err_t
+dhcp_attach(struct netif *netif)
+{
+  struct dhcp *dhcp = netif_dhcp_data(netif);
 
   /* check MTU of the netif */
   if (netif->mtu < DHCP_MAX_MSG_LEN_MIN_REQUIRED) {
@@ -864,21 +998,7 @@ dhcp_start(struct netif *netif)
     return ERR_MEM;
   }
   dhcp->pcb_allocated = 1;
-
-  if (!netif_is_link_up(netif)) {
-    /* set state INIT and wait for dhcp_network_changed() to call dhcp_discover() */
-    dhcp_set_state(dhcp, DHCP_STATE_INIT);
-    return ERR_OK;
-  }
-
-  /* (re)start the DHCP negotiation */
-  result = dhcp_discover(netif);
-  if (result != ERR_OK) {
-    /* free resources allocated above */
-    dhcp_release_and_stop(netif);
-    return ERR_MEM;
-  }
-  return result;
+  return ERR_OK;
 }
 
 /**
@@ -42,6 +42,7 @@
 
 #include "lwip/def.h"
 #include "lwip/stats.h"
+#include "lwip/flow_stats.h"
 #include "lwip/mem.h"
 #include "lwip/debug.h"
 
@@ -162,6 +163,7 @@ stats_display(void)
     MEMP_STATS_DISPLAY(i);
   }
   SYS_STATS_DISPLAY();
+  flow_stats_display();
 }
 #endif /* LWIP_STATS_DISPLAY */
 
@@ -0,0 +1,187 @@
+/**
+ * @file
+ * TCP congestion control algorithms.
+ *
+ * Reno is the algorithm lwIP has always used. With LWIP_TCP_CC enabled it is
+ * reached through a per-PCB ops table, next to TCP Veno, which targets links
+ * with random (non-congestion) loss such as Wi-Fi.
+ */
+
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "lwip/opt.h"
+
+#if LWIP_TCP /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/tcp_cc.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/debug.h"
+
+#include <string.h>
+
+/**
+ * Reno cwnd growth for an ACK of new data: slow start below ssthresh,
+ * one MSS per round trip above it.
+ */
+void
+tcp_reno_cong_avoid(struct tcp_pcb *pcb, tcpwnd_size_t acked)
+{
+  if (pcb->cwnd < pcb->ssthresh) {
+    tcpwnd_size_t increase;
+    /* limit to 1 SMSS segment during period following RTO */
+    u8_t num_seg = (pcb->flags & TF_RTO) ? 1 : 2;
+    /* RFC 3465, section 2.2 Slow Start */
+    increase = LWIP_MIN(acked, (tcpwnd_size_t)(num_seg * pcb->mss));
+    TCP_WND_INC(pcb->cwnd, increase);
+    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: slow start cwnd %"TCPWNDSIZE_F"\n", pcb->cwnd));
+  } else {
+    /* RFC 3465, section 2.1 Congestion Avoidance */
+    TCP_WND_INC(pcb->bytes_acked, acked);
+    if (pcb->bytes_acked >= pcb->cwnd) {
+      pcb->bytes_acked = (tcpwnd_size_t)(pcb->bytes_acked - pcb->cwnd);
+      TCP_WND_INC(pcb->cwnd, pcb->mss);
+    }
+    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_receive: congestion avoidance cwnd %"TCPWNDSIZE_F"\n", pcb->cwnd));
+  }
+}
+
+/**
+ * Reno ssthresh on loss: half of the minimum of the current cwnd and the
+ * advertised window.
+ */
+tcpwnd_size_t
+tcp_reno_ssthresh(struct tcp_pcb *pcb)
+{
+  return (tcpwnd_size_t)(LWIP_MIN(pcb->cwnd, pcb->snd_wnd) / 2);
+}
+
+#if LWIP_TCP_CC
+
+const struct tcp_cc_ops tcp_cc_reno = {
+  "reno",
+  NULL,
+  tcp_reno_cong_avoid,
+  tcp_reno_ssthresh,
+  NULL
+};
+
+/*
+ * TCP Veno (Fu & Liew, IEEE JSAC 2003).
+ *
+ * The Vegas estimate of the data queued in the network,
+ *   N = cwnd * (rtt - basertt) / rtt,
+ * tells a random loss (N below beta: the path is not congested) from a
+ * congestion loss. Random losses cut cwnd to 4/5 instead of 1/2. In
+ * congestion avoidance with N at or above beta, cwnd grows only every
+ * other round trip so the queue drains instead of building up.
+ */
+
+/** Backlog threshold, in segments */
+#ifndef TCP_VENO_BETA
+#define TCP_VENO_BETA 3
+#endif
+
+struct tcp_veno {
+  u32_t basertt; /* smallest RTT seen on the connection (ms), 0 until sampled */
+  u32_t rtt;     /* last RTT sample (ms) */
+  u8_t inc;      /* cwnd may grow in this round trip */
+};
+
+#define TCP_VENO(pcb) ((struct tcp_veno *)(void *)(pcb)->cc_priv)
+
+static void
+tcp_veno_init(struct tcp_pcb *pcb)
+{
+  LWIP_ASSERT("tcp_veno: cc_priv too small", sizeof(struct tcp_veno) <= sizeof(pcb->cc_priv));
+  memset(pcb->cc_priv, 0, sizeof(pcb->cc_priv));
+  TCP_VENO(pcb)->inc = 1;
+}
+
+/* Estimated number of our segments queued along the path */
+static u32_t
+tcp_veno_backlog(const struct tcp_pcb *pcb)
+{
+  const struct tcp_veno *v = (const struct tcp_veno *)(const void *)pcb->cc_priv;
+
+  if ((v->basertt == 0) || (v->rtt <= v->basertt)) {
+    return 0;
+  }
+  return (u32_t)(((u64_t)pcb->cwnd * (v->rtt - v->basertt)) / ((u64_t)v->rtt * pcb->mss));
+}
+
+static void
+tcp_veno_cong_avoid(struct tcp_pcb *pcb, tcpwnd_size_t acked)
+{
+  struct tcp_veno *v = TCP_VENO(pcb);
+
+  if ((v->basertt == 0) || (pcb->cwnd < pcb->ssthresh) ||
+      (tcp_veno_backlog(pcb) < TCP_VENO_BETA) || v->inc) {
+    tcp_reno_cong_avoid(pcb, acked);
+  }
+}
+
+static tcpwnd_size_t
+tcp_veno_ssthresh(struct tcp_pcb *pcb)
+{
+  u32_t eff_wnd = LWIP_MIN(pcb->cwnd, pcb->snd_wnd);
+
+  if ((TCP_VENO(pcb)->basertt != 0) && (tcp_veno_backlog(pcb) < TCP_VENO_BETA)) {
+    /* random loss */
+    LWIP_DEBUGF(TCP_CWND_DEBUG, ("tcp_veno: random loss, backlog %"U32_F"\n", tcp_veno_backlog(pcb)));
+    return (tcpwnd_size_t)((eff_wnd * 4) / 5);
+  }
+  return (tcpwnd_size_t)(eff_wnd / 2);
+}
+
+static void
+tcp_veno_rtt_sample(struct tcp_pcb *pcb, u32_t rtt_ms)
+{
+  struct tcp_veno *v = TCP_VENO(pcb);
+
+  if (rtt_ms == 0) {
+    rtt_ms = 1;
+  }
+  if ((v->basertt == 0) || (rtt_ms < v->basertt)) {
+    v->basertt = rtt_ms;
+  }
+  v->rtt = rtt_ms;
+  /* lwIP times one segment per round trip, so each sample ends a round */
+  v->inc = (u8_t)!v->inc;
+}
+
+const struct tcp_cc_ops tcp_cc_veno = {
+  "veno",
+  tcp_veno_init,
+  tcp_veno_cong_avoid,
+  tcp_veno_ssthresh,
+  tcp_veno_rtt_sample
+};
+
+/**
+ * @ingroup tcp_raw
+ * Select the congestion control algorithm of a PCB. Usually called right
+ * after tcp_new() or from the accept callback.
+ *
+ * @param pcb tcp_pcb to configure
+ * @param cc algorithm, e.g. &tcp_cc_reno or &tcp_cc_veno
+ */
+void
+tcp_set_cc(struct tcp_pcb *pcb, const struct tcp_cc_ops *cc)
+{
+  LWIP_ASSERT_CORE_LOCKED();
+
+  LWIP_ERROR("tcp_set_cc: invalid pcb", pcb != NULL, return);
+  LWIP_ERROR("tcp_set_cc: invalid cc", (cc != NULL) && (cc->cong_avoid != NULL) &&
+             (cc->ssthresh != NULL), return);
+
+  pcb->cc = cc;
+  if (cc->init != NULL) {
+    cc->init(pcb);
+  }
+}
+
+#endif /* LWIP_TCP_CC */
+
+#endif /* LWIP_TCP */
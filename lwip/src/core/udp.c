@@ -60,6 +60,7 @@
 #include "lwip/icmp.h"
 #include "lwip/icmp6.h"
 #include "lwip/stats.h"
+#include "lwip/flow_stats.h"
 #include "lwip/snmp.h"
 #include "lwip/dhcp.h"
 
@@ -398,6 +399,8 @@ udp_input(struct pbuf *p, struct netif *inp)
         }
       }
 #endif /* SO_REUSE && SO_REUSE_RXTOALL */
+      FLOW_STATS_UDP(pcb, ip_current_dest_addr(), ip_current_src_addr(), src,
+                     FLOW_STATS_RX, p->tot_len);
       /* callback */
       if (pcb->recv != NULL) {
         /* now the recv function is responsible for freeing p */
@@ -895,6 +898,7 @@ udp_sendto_if_src_chksum(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *d
 
   /* @todo: must this be increased even if error occurred? */
   MIB2_STATS_INC(mib2.udpoutdatagrams);
+  FLOW_STATS_UDP(pcb, src_ip, dst_ip, dst_port, FLOW_STATS_TX, q->tot_len);
 
   /* did we chain a separate header pbuf earlier? */
   if (q != p) {
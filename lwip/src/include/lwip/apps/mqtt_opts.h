@@ -92,6 +92,14 @@ extern "C" {
 #define MQTT_CONNECT_TIMOUT 100
 #endif
 
+/**
+ * IP type of service of the MQTT connection (DSCP << 2), 0 leaves it unmarked.
+ * Only applied without LWIP_ALTCP.
+ */
+#ifndef MQTT_TOS
+#define MQTT_TOS 0
+#endif
+
 /**
  * @}
  */
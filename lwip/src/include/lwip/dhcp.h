@@ -119,6 +119,20 @@ struct dhcp
 };
 
 
+#if LWIP_DHCP_INIT_REBOOT
+/** Lease kept from an earlier session, see dhcp_start_reboot() */
+struct dhcp_lease
+{
+  ip4_addr_t ip_addr;
+  ip4_addr_t sn_mask;
+  ip4_addr_t gw_addr;
+  /** server which granted the lease, renewals are sent to it */
+  ip4_addr_t server_ip_addr;
+  /** lease period (in seconds) */
+  u32_t lease_time;
+};
+#endif /* LWIP_DHCP_INIT_REBOOT */
+
 void dhcp_set_struct(struct netif *netif, struct dhcp *dhcp);
 /** Remove a struct dhcp previously set to the netif using dhcp_set_struct() */
 #define dhcp_remove_struct(netif) netif_set_client_data(netif, LWIP_NETIF_CLIENT_DATA_INDEX_DHCP, NULL)
@@ -130,6 +144,10 @@ void dhcp_stop(struct netif *netif);
 void dhcp_release_and_stop(struct netif *netif);
 void dhcp_inform(struct netif *netif);
 void dhcp_network_changed_link_up(struct netif *netif);
+#if LWIP_DHCP_INIT_REBOOT
+err_t dhcp_start_reboot(struct netif *netif, const struct dhcp_lease *lease);
+err_t dhcp_get_lease(const struct netif *netif, struct dhcp_lease *lease);
+#endif /* LWIP_DHCP_INIT_REBOOT */
 
 u8_t dhcp_supplied_address(const struct netif *netif);
 /* to be called every minute */
@@ -0,0 +1,112 @@
+/**
+ * @file
+ * Per-flow statistics API (to be used from TCPIP thread)
+ */
+
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef LWIP_HDR_FLOW_STATS_H
+#define LWIP_HDR_FLOW_STATS_H
+
+#include "lwip/opt.h"
+
+#if LWIP_FLOW_STATS /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/ip_addr.h"
+#include "lwip/prot/ip.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if FLOW_STATS_TABLE_SIZE > 255
+#error "FLOW_STATS_TABLE_SIZE must be <= 255"
+#endif
+#if (FLOW_STATS_HASH_SIZE & (FLOW_STATS_HASH_SIZE - 1)) != 0
+#error "FLOW_STATS_HASH_SIZE must be a power of two"
+#endif
+
+/** Kind of event accounted by flow_stats_update() */
+#define FLOW_STATS_RX     0 /* val: received bytes */
+#define FLOW_STATS_TX     1 /* val: transmitted bytes */
+#define FLOW_STATS_REXMIT 2 /* val: retransmitted bytes */
+#define FLOW_STATS_RTT    3 /* val: RTT sample in milliseconds */
+
+/** Accounting data of one flow, keyed by its 5-tuple */
+struct flow_stats_entry {
+  ip_addr_t local_ip;
+  ip_addr_t remote_ip;
+  /* ports are in host byte order */
+  u16_t local_port;
+  u16_t remote_port;
+  /** IP_PROTO_TCP or IP_PROTO_UDP, 0 for an unused slot */
+  u8_t proto;
+  /** hash chain link (slot index + 1, 0 terminates) */
+  u8_t next;
+
+  u32_t rx_pkts;
+  u32_t rx_bytes;
+  u32_t tx_pkts;
+  u32_t tx_bytes;
+  u32_t rexmits;
+
+  u32_t rtt_samples;
+  u32_t rtt_sum_ms;
+  u16_t rtt_min_ms;
+  u16_t rtt_max_ms;
+
+  /** LRU stamp of the last update */
+  u32_t last_used;
+};
+
+/** Cost counters of the accounting path. The average number of chain steps
+ * per lookup is probes / (lookups - hint_hits). */
+struct flow_stats_cost {
+  u32_t lookups;   /* Calls into the table. */
+  u32_t hint_hits; /* Lookups resolved by the per-PCB slot hint. */
+  u32_t probes;    /* Hash chain entries compared. */
+  u32_t inserts;   /* New flows added. */
+  u32_t evictions; /* Flows dropped to make room (LRU). */
+};
+
+/** Cost counters of the flow table. Add this to your debugger's watchlist. */
+extern struct flow_stats_cost flow_stats_cost;
+
+void flow_stats_init(void);
+void flow_stats_update(u8_t proto,
+                       const ip_addr_t *local_ip, u16_t local_port,
+                       const ip_addr_t *remote_ip, u16_t remote_port,
+                       u8_t *hint, u8_t what, u32_t val);
+void flow_stats_reset(void);
+
+const struct flow_stats_entry *flow_stats_next(const struct flow_stats_entry *prev);
+u8_t flow_stats_top(const struct flow_stats_entry **out, u8_t max);
+
+#if LWIP_STATS_DISPLAY
+void flow_stats_display(void);
+#else
+#define flow_stats_display()
+#endif /* LWIP_STATS_DISPLAY */
+
+#define FLOW_STATS_TCP(pcb, what, val) flow_stats_update(IP_PROTO_TCP, \
+    &(pcb)->local_ip, (pcb)->local_port, &(pcb)->remote_ip, (pcb)->remote_port, \
+    &(pcb)->flow_hint, (what), (u32_t)(val))
+#define FLOW_STATS_UDP(pcb, lip, rip, rport, what, val) flow_stats_update(IP_PROTO_UDP, \
+    (lip), (pcb)->local_port, (rip), (rport), \
+    &(pcb)->flow_hint, (what), (u32_t)(val))
+
+#ifdef __cplusplus
+}
+#endif
+
+#else /* LWIP_FLOW_STATS */
+
+#define flow_stats_init()
+#define flow_stats_display()
+#define FLOW_STATS_TCP(pcb, what, val)
+#define FLOW_STATS_UDP(pcb, lip, rip, rport, what, val)
+
+#endif /* LWIP_FLOW_STATS */
+
+#endif /* LWIP_HDR_FLOW_STATS_H */
@@ -957,6 +957,16 @@
 #define LWIP_DHCP_DOES_ACD_CHECK        0
 #endif
 
+/**
+ * LWIP_DHCP_INIT_REBOOT==1: Provide dhcp_start_reboot() to confirm a lease kept
+ * from an earlier session with a single REQUEST (INIT-REBOOT, RFC 2131 3.2)
+ * instead of the DISCOVER/OFFER/REQUEST/ACK exchange, and dhcp_get_lease() to
+ * read the lease to keep.
+ */
+#if !defined LWIP_DHCP_INIT_REBOOT || defined __DOXYGEN__
+#define LWIP_DHCP_INIT_REBOOT           0
+#endif
+
 /**
  * LWIP_DHCP_BOOTP_FILE==1: Store offered_si_addr and boot_file_name.
  */
@@ -1178,6 +1188,26 @@
 #define DNS_MAX_RETRIES                 4
 #endif
 
+/** DNS_NEG_TTL_NXDOMAIN: seconds a name reported as non-existent (NXDOMAIN)
+ * stays in the table as a negative entry. Meanwhile dns_gethostbyname() fails
+ * with ERR_VAL without sending a query. 0 disables negative caching. */
+#if !defined DNS_NEG_TTL_NXDOMAIN || defined __DOXYGEN__
+#define DNS_NEG_TTL_NXDOMAIN            0
+#endif
+
+/** DNS_NEG_TTL_FAILURE: like DNS_NEG_TTL_NXDOMAIN, for queries that timed out
+ * or got another error or no usable answer. Keep this short. */
+#if !defined DNS_NEG_TTL_FAILURE || defined __DOXYGEN__
+#define DNS_NEG_TTL_FAILURE             0
+#endif
+
+/** DNS_PREFETCH_TIME: a cached name that was looked up since its last answer
+ * is queried again in the background this many seconds before its TTL runs
+ * out, so that frequent lookups keep hitting the cache. 0 disables prefetch. */
+#if !defined DNS_PREFETCH_TIME || defined __DOXYGEN__
+#define DNS_PREFETCH_TIME               0
+#endif
+
 /** DNS do a name checking between the query and the response. */
 #if !defined DNS_DOES_NAME_CHECK || defined __DOXYGEN__
 #define DNS_DOES_NAME_CHECK             1
@@ -1344,6 +1374,23 @@
 #define LWIP_TCP_MAX_SACK_NUM           4
 #endif
 
+/**
+ * LWIP_TCP_CC==1: Route cwnd/ssthresh updates through a per-PCB congestion
+ * control ops table (see lwip/tcp_cc.h) instead of the built-in Reno code.
+ * Each PCB carries one ops pointer and a small private state area.
+ */
+#if !defined LWIP_TCP_CC || defined __DOXYGEN__
+#define LWIP_TCP_CC                     0
+#endif
+
+/**
+ * LWIP_TCP_CC_DEFAULT: Congestion control algorithm given to new PCBs
+ * (&tcp_cc_reno or &tcp_cc_veno). Only used if LWIP_TCP_CC is enabled.
+ */
+#if !defined LWIP_TCP_CC_DEFAULT || defined __DOXYGEN__
+#define LWIP_TCP_CC_DEFAULT             (&tcp_cc_reno)
+#endif
+
 /**
  * TCP_MSS: TCP Maximum segment size. (default is 536, a conservative default,
  * you might want to increase this.)
@@ -2347,6 +2394,30 @@
 #define MIB2_STATS                      0
 #endif
 
+/**
+ * LWIP_FLOW_STATS==1: Enable per-flow accounting (packets, bytes, retransmits
+ * and RTT samples per 5-tuple) for TCP and UDP. See lwip/flow_stats.h.
+ */
+#if !defined LWIP_FLOW_STATS || defined __DOXYGEN__
+#define LWIP_FLOW_STATS                 0
+#endif
+
+/**
+ * FLOW_STATS_TABLE_SIZE: Number of flows tracked at the same time. When the
+ * table is full the least recently used flow is evicted. Must be <= 255.
+ */
+#if !defined FLOW_STATS_TABLE_SIZE || defined __DOXYGEN__
+#define FLOW_STATS_TABLE_SIZE           16
+#endif
+
+/**
+ * FLOW_STATS_HASH_SIZE: Number of hash buckets used to find a flow from its
+ * 5-tuple. Must be a power of two.
+ */
+#if !defined FLOW_STATS_HASH_SIZE || defined __DOXYGEN__
+#define FLOW_STATS_HASH_SIZE            16
+#endif
+
 #else
 
 #define LINK_STATS                      0
@@ -2367,6 +2438,7 @@
 #define MLD6_STATS                      0
 #define ND6_STATS                       0
 #define MIB2_STATS                      0
+#define LWIP_FLOW_STATS                 0
 
 #endif /* LWIP_STATS */
 /**
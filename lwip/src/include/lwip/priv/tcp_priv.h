@@ -51,6 +51,7 @@
 #include "lwip/ip6.h"
 #include "lwip/ip6_addr.h"
 #include "lwip/prot/tcp.h"
+#include "lwip/tcp_cc.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -156,6 +157,20 @@ err_t            tcp_process_refused_data(struct tcp_pcb *pcb);
 
 #define TCP_TCPLEN(seg) ((seg)->len + (((TCPH_FLAGS((seg)->tcphdr) & (TCP_FIN | TCP_SYN)) != 0) ? 1U : 0U))
 
+/* Congestion control dispatch (see lwip/tcp_cc.h) */
+#if LWIP_TCP_CC
+#define TCP_CC_CONG_AVOID(pcb, acked) (pcb)->cc->cong_avoid((pcb), (acked))
+#define TCP_CC_SSTHRESH(pcb)          (pcb)->cc->ssthresh(pcb)
+#define TCP_CC_RTT_SAMPLE(pcb, rtt_ms) do { \
+    if ((pcb)->cc->rtt_sample != NULL) { \
+      (pcb)->cc->rtt_sample((pcb), (rtt_ms)); \
+    } } while (0)
+#else /* LWIP_TCP_CC */
+#define TCP_CC_CONG_AVOID(pcb, acked) tcp_reno_cong_avoid((pcb), (acked))
+#define TCP_CC_SSTHRESH(pcb)          tcp_reno_ssthresh(pcb)
+#define TCP_CC_RTT_SAMPLE(pcb, rtt_ms)
+#endif /* LWIP_TCP_CC */
+
 /** Flags used on input processing, not on pcb->flags
 */
 #define TF_RESET     (u8_t)0x08U   /* Connection was reset. */
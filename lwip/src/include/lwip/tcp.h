@@ -58,6 +58,9 @@ extern "C" {
 
 struct tcp_pcb;
 struct tcp_pcb_listen;
+#if LWIP_TCP_CC
+struct tcp_cc_ops;
+#endif /* LWIP_TCP_CC */
 
 /** Function prototype for tcp accept callback functions. Called when a new
  * connection can be accepted on a listening pcb.
@@ -304,6 +307,9 @@ struct tcp_pcb {
 
   s16_t rto;    /* retransmission time-out (in ticks of TCP_SLOW_INTERVAL) */
   u8_t nrtx;    /* number of retransmissions */
+#if LWIP_FLOW_STATS
+  u8_t flow_hint; /* flow_stats slot of this connection (slot + 1) */
+#endif /* LWIP_FLOW_STATS */
 
   /* fast retransmit/recovery */
   u8_t dupacks;
@@ -312,6 +318,11 @@ struct tcp_pcb {
   /* congestion avoidance/control variables */
   tcpwnd_size_t cwnd;
   tcpwnd_size_t ssthresh;
+#if LWIP_TCP_CC
+  const struct tcp_cc_ops *cc; /* congestion control algorithm */
+  u32_t cc_priv[4];            /* private state of the algorithm */
+  u32_t rttest_ms;             /* sys_now() when the timed segment was sent */
+#endif /* LWIP_TCP_CC */
 
   /* first byte following last rto byte */
   u32_t rto_end;
@@ -0,0 +1,67 @@
+/**
+ * @file
+ * TCP congestion control API
+ */
+
+/*
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#ifndef LWIP_HDR_TCP_CC_H
+#define LWIP_HDR_TCP_CC_H
+
+#include "lwip/opt.h"
+
+#if LWIP_TCP /* don't build if not configured for use in lwipopts.h */
+
+#include "lwip/tcp.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Classic Reno (RFC 5681 with RFC 3465 byte counting). Always built: this is
+ * the code used directly when LWIP_TCP_CC is disabled, and the building block
+ * other algorithms fall back to. */
+void          tcp_reno_cong_avoid(struct tcp_pcb *pcb, tcpwnd_size_t acked);
+tcpwnd_size_t tcp_reno_ssthresh(struct tcp_pcb *pcb);
+
+#if LWIP_TCP_CC
+
+/**
+ * @ingroup tcp_raw
+ * Congestion control algorithm. All callbacks run in the TCPIP thread.
+ * Fast recovery (cwnd inflation and deflation back to ssthresh) and the
+ * cwnd reset to one segment on RTO stay in the TCP core.
+ */
+struct tcp_cc_ops {
+  /** Algorithm name, for diagnostics */
+  const char *name;
+  /** Reset pcb->cc_priv. Called when the algorithm is attached. May be NULL. */
+  void (*init)(struct tcp_pcb *pcb);
+  /** Grow cwnd for an ACK of new data (ESTABLISHED and later only) */
+  void (*cong_avoid)(struct tcp_pcb *pcb, tcpwnd_size_t acked);
+  /** Return the new ssthresh on loss (fast retransmit or RTO). The core
+   * enforces the 2 * MSS lower bound. */
+  tcpwnd_size_t (*ssthresh)(struct tcp_pcb *pcb);
+  /** RTT sample in milliseconds, at most one per round trip. May be NULL. */
+  void (*rtt_sample)(struct tcp_pcb *pcb, u32_t rtt_ms);
+};
+
+/** Classic Reno, identical to the built-in behaviour */
+extern const struct tcp_cc_ops tcp_cc_reno;
+/** TCP Veno: Reno with a Vegas-style backlog estimate. Losses seen while the
+ * estimated queue is short are taken as random (wireless) losses and only
+ * reduce cwnd by 1/5 instead of 1/2. */
+extern const struct tcp_cc_ops tcp_cc_veno;
+
+void tcp_set_cc(struct tcp_pcb *pcb, const struct tcp_cc_ops *cc);
+
+#endif /* LWIP_TCP_CC */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LWIP_TCP */
+
+#endif /* LWIP_HDR_TCP_CC_H */
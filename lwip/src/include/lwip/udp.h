@@ -87,6 +87,10 @@ struct udp_pcb {
   struct udp_pcb *next;
 
   u8_t flags;
+#if LWIP_FLOW_STATS
+  /** flow_stats slot of the last flow seen on this pcb (slot + 1) */
+  u8_t flow_hint;
+#endif /* LWIP_FLOW_STATS */
   /** ports are in host byte order */
   u16_t local_port, remote_port;
 
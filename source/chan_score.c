@@ -0,0 +1,142 @@
+/*
+ * chan_score.c
+ * Channel metrics and scoring of chan_select, see chan_select.h.
+ * Plain C without RTOS dependencies.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "chan_select.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define CHAN_24G_LAST 14
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+/* Share of a 2.4 GHz network counted on a channel 0 - 4 channels away, 1/16 units */
+static const uint8_t s_overlap[] = {16U, 12U, 8U, 4U, 1U};
+
+static const uint8_t s_channels[CHAN_SELECT_NUM_CHANNELS] = {1,  2,  3,  4,  5,  6,   7,   8,   9,   10,  11, 12,
+                                                             13, 14, 36, 40, 44, 48, 149, 153, 157, 161, 165};
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static int chan_index(int channel)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHAN_SELECT_NUM_CHANNELS; i++)
+    {
+        if (s_channels[i] == channel)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+/* Share of the networks on channel b interfering on channel a, 1/16 units */
+static uint32_t chan_overlap(int a, int b)
+{
+    int d;
+
+    if ((a > CHAN_24G_LAST) || (b > CHAN_24G_LAST))
+    {
+        return (a == b) ? 16U : 0U;
+    }
+    d = (a > b) ? (a - b) : (b - a);
+    return (d < (int)sizeof(s_overlap)) ? s_overlap[d] : 0U;
+}
+
+void chan_db_reset(chan_db_t *db)
+{
+    (void)memset(db, 0, sizeof(*db));
+}
+
+void chan_db_add(chan_db_t *db, int channel, int rssi_dbm)
+{
+    int idx = chan_index(channel);
+    int above;
+
+    if (idx < 0)
+    {
+        return;
+    }
+    above = rssi_dbm - CHAN_SELECT_NOISE_FLOOR_DBM;
+    db->round[idx].occupancy += 16U;
+    db->round[idx].interference += (above > 0) ? (uint32_t)above * 16U : 0U;
+}
+
+void chan_db_fold(chan_db_t *db)
+{
+    uint32_t i;
+
+    for (i = 0; i < CHAN_SELECT_NUM_CHANNELS; i++)
+    {
+        chan_metrics_t *avg         = &db->avg[i];
+        const chan_metrics_t *round = &db->round[i];
+
+        if (db->scans == 0U)
+        {
+            *avg = *round;
+        }
+        else
+        {
+            avg->occupancy    = (avg->occupancy + round->occupancy) / 2U;
+            avg->interference = (avg->interference + round->interference) / 2U;
+        }
+    }
+    (void)memset(db->round, 0, sizeof(db->round));
+    db->scans++;
+}
+
+uint32_t chan_db_score(const chan_db_t *db, int channel)
+{
+    uint32_t score = 0U;
+    uint32_t i;
+
+    for (i = 0; i < CHAN_SELECT_NUM_CHANNELS; i++)
+    {
+        uint32_t overlap = chan_overlap(channel, s_channels[i]);
+
+        if (overlap != 0U)
+        {
+            score += overlap * (db->avg[i].occupancy * CHAN_SELECT_BSS_COST + db->avg[i].interference) / 16U;
+        }
+    }
+    return score;
+}
+
+int chan_db_best(const chan_db_t *db, const int *candidates, uint32_t count, int fallback)
+{
+    int best;
+    uint32_t best_score;
+    uint32_t i;
+
+    if (db->scans == 0U)
+    {
+        return fallback;
+    }
+
+    /* Stay on the fallback channel unless another one is strictly better */
+    best       = fallback;
+    best_score = (chan_index(fallback) >= 0) ? chan_db_score(db, fallback) : UINT32_MAX;
+    for (i = 0; i < count; i++)
+    {
+        uint32_t score = chan_db_score(db, candidates[i]);
+
+        if (score < best_score)
+        {
+            best       = candidates[i];
+            best_score = score;
+        }
+    }
+    return best;
+}
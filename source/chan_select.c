@@ -0,0 +1,78 @@
+/*
+ * chan_select.c
+ * Access point channel picked from the metrics of recent scans,
+ * see chan_select.h.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "chan_select.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "wpl.h"
+
+#include <string.h>
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const int s_candidates[] = {CHAN_SELECT_CANDIDATES};
+
+/* Written by the WPL scan callback, under critical section */
+static chan_db_t s_db;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static void chan_select_scan_result(int channel, int rssi_dbm)
+{
+    taskENTER_CRITICAL();
+    if (channel == 0)
+    {
+        chan_db_fold(&s_db);
+    }
+    else
+    {
+        chan_db_add(&s_db, channel, rssi_dbm);
+    }
+    taskEXIT_CRITICAL();
+}
+
+void chan_select_init(void)
+{
+    WPL_SetScanResultCallback(chan_select_scan_result);
+}
+
+int chan_select_channel(int fallback)
+{
+    int channel;
+
+    taskENTER_CRITICAL();
+    channel = chan_db_best(&s_db, s_candidates, sizeof(s_candidates) / sizeof(s_candidates[0]), fallback);
+    taskEXIT_CRITICAL();
+    return channel;
+}
+
+int chan_select_has_data(void)
+{
+    return (s_db.scans != 0U) ? 1 : 0;
+}
+
+int chan_select_save(chan_select_state_t *state)
+{
+    taskENTER_CRITICAL();
+    (void)memcpy(state->avg, s_db.avg, sizeof(state->avg));
+    state->scans = s_db.scans;
+    taskEXIT_CRITICAL();
+    return (state->scans != 0U) ? 1 : 0;
+}
+
+void chan_select_restore(const chan_select_state_t *state)
+{
+    taskENTER_CRITICAL();
+    (void)memcpy(s_db.avg, state->avg, sizeof(s_db.avg));
+    s_db.scans = state->scans;
+    taskEXIT_CRITICAL();
+}
@@ -0,0 +1,112 @@
+/*
+ * chan_select.h
+ * Channel selection for the provisioning access point
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef CHAN_SELECT_H
+#define CHAN_SELECT_H
+
+#include <stdint.h>
+
+/*
+ * Channel selection for the access point. Every scan done through WPL
+ * (the web page scan, or the one started after the AP came up) is folded into
+ * per channel metrics:
+ *
+ *   occupancy     number of networks seen on the channel
+ *   interference  signal strength of those networks above the noise floor
+ *
+ * Both are averaged over the recent scans, the newest scan weighing half.
+ * When the AP starts, chan_select_channel() picks the candidate channel with
+ * the lowest score from the cached metrics, without scanning. In 2.4 GHz the
+ * networks on the overlapping neighbour channels count too, weighted by the
+ * distance. Without any scan data the fallback channel is used.
+ *
+ * The averaged metrics survive a reset: the application saves them with
+ * chan_select_save() and restores them at boot with chan_select_restore(),
+ * so the first AP after a power cycle already starts on a scored channel.
+ * Only a board that never scanned starts on the fallback channel.
+ *
+ * A scan while the AP is up is not free. Every channel is dwelt on for
+ * about 100 ms (MRVDRV_ACTIVE_SCAN_CHAN_TIME / MRVDRV_PASSIVE_SCAN_CHAN_TIME),
+ * and with CONFIG_SCAN_CHANNEL_GAP the radio goes back to the AP channel for
+ * 50 ms between two of them. A full 2.4 + 5 GHz scan takes several seconds,
+ * during which beacons are late and client traffic waits in the firmware.
+ * Hence the application scans only to seed the metrics when there are none.
+ *
+ * Candidates must be non-DFS channels, an AP on a DFS channel would have to
+ * listen for radar before it can start.
+ *
+ * The scoring (chan_score.c) has no RTOS dependencies, recorded scan datasets
+ * can be replayed through it on a host.
+ */
+
+/* Channels the AP may be started on */
+#ifndef CHAN_SELECT_CANDIDATES
+#define CHAN_SELECT_CANDIDATES 1, 6, 11
+#endif
+
+/* Cost of a network on the channel, in the unit of 1 dB above the noise floor */
+#ifndef CHAN_SELECT_BSS_COST
+#define CHAN_SELECT_BSS_COST 10U
+#endif
+
+/* Noise floor, weaker networks cost only their occupancy */
+#ifndef CHAN_SELECT_NOISE_FLOOR_DBM
+#define CHAN_SELECT_NOISE_FLOOR_DBM (-95)
+#endif
+
+/* Tracked channels: 2.4 GHz 1 - 14, 5 GHz non-DFS 36 - 48 and 149 - 165 */
+#define CHAN_SELECT_NUM_CHANNELS 23U
+
+typedef struct chan_metrics
+{
+    uint32_t occupancy;    /* networks, 1/16 units */
+    uint32_t interference; /* dB above the noise floor summed over networks, 1/16 units */
+} chan_metrics_t;
+
+typedef struct chan_db
+{
+    chan_metrics_t avg[CHAN_SELECT_NUM_CHANNELS];   /* averaged over the folded scans */
+    chan_metrics_t round[CHAN_SELECT_NUM_CHANNELS]; /* scan in progress */
+    uint32_t scans;                                 /* folded scans */
+} chan_db_t;
+
+/* Scoring, chan_score.c */
+void chan_db_reset(chan_db_t *db);
+/* Accounts a network of the scan in progress, unknown channels are ignored. */
+void chan_db_add(chan_db_t *db, int channel, int rssi_dbm);
+/* Completes the scan in progress. */
+void chan_db_fold(chan_db_t *db);
+/* Score of a channel, lower is better. */
+uint32_t chan_db_score(const chan_db_t *db, int channel);
+/* Best of the candidates, fallback without scan data or if it scores as good. */
+int chan_db_best(const chan_db_t *db, const int *candidates, uint32_t count, int fallback);
+
+/* Service, chan_select.c */
+
+/* Registers with WPL for scan results, call after WPL_Start(). */
+void chan_select_init(void);
+
+/* Channel for the AP, returns immediately. */
+int chan_select_channel(int fallback);
+
+/* True once a scan has been folded into the metrics, or metrics were restored. */
+int chan_select_has_data(void);
+
+/* Averaged metrics, as persisted */
+typedef struct chan_select_state
+{
+    chan_metrics_t avg[CHAN_SELECT_NUM_CHANNELS];
+    uint32_t scans;
+} chan_select_state_t;
+
+/* Copies the averaged metrics to state, returns 0 if there are none yet. */
+int chan_select_save(chan_select_state_t *state);
+
+/* Takes over persisted metrics, the scans folded later average with them. */
+void chan_select_restore(const chan_select_state_t *state);
+
+#endif /* CHAN_SELECT_H */
@@ -14,6 +14,32 @@
 
 #define FILE_HEADER "wifi_credentials:"
 
+#define LEASE_HEADER "dhcp_lease:"
+
+#define CHAN_HEADER "chan_metrics:"
+
+/* Longest credentials string, terminating \0 included */
+#define CREDENTIALS_MAX_LEN \
+    (sizeof(FILE_HEADER) + WPL_WIFI_SSID_LENGTH + WPL_WIFI_PASSWORD_LENGTH + WIFI_SECURITY_LENGTH + 4)
+
+/* DHCP lease of the saved network, stored after the \0 of the credentials
+ * string so that files written without it still read the same */
+typedef struct
+{
+    char header[sizeof(LEASE_HEADER)];
+    wpl_dhcp_lease_t lease;
+} dhcp_lease_record_t;
+
+/* Channel metrics of the AP, stored after the lease record if there is one */
+typedef struct
+{
+    char header[sizeof(CHAN_HEADER)];
+    chan_select_state_t state;
+} chan_record_t;
+
+/* Longest file */
+#define FILE_MAX_LEN (CREDENTIALS_MAX_LEN + sizeof(dhcp_lease_record_t) + sizeof(chan_record_t))
+
 static uint32_t save_file(char *filename, char *data, uint32_t data_len)
 {
     if ((filename == NULL) || (strlen(filename) > 63) || (data == NULL) || (data_len <= 0))
@@ -36,10 +62,13 @@ static uint32_t save_file(char *filename, char *data, uint32_t data_len)
     return 0;
 }
 
+static uint32_t append_chan_record(char *filename, char *file_buf, uint32_t len);
+
 uint32_t init_flash_storage(char *filename)
 {
     /* Flash structure */
-    mflash_file_t file_table[] = {{.path = filename, .max_size = 200}, {0}};
+    /* The file takes a whole sector, a larger max_size than before still matches the existing filesystem */
+    mflash_file_t file_table[] = {{.path = filename, .max_size = FILE_MAX_LEN}, {0}};
 
     if (mflash_init(file_table, 1) != kStatus_Success)
     {
@@ -77,7 +106,7 @@ uint32_t save_wifi_credentials(char *filename, char *ssid, char *passphrase, cha
         return 1;
     }
 
-    char credentials_buf[sizeof(FILE_HEADER) + WPL_WIFI_SSID_LENGTH + WPL_WIFI_PASSWORD_LENGTH + WIFI_SECURITY_LENGTH + 4];
+    char credentials_buf[FILE_MAX_LEN];
     uint32_t data_len;
 
     strcpy(credentials_buf, FILE_HEADER);
@@ -89,6 +118,7 @@ uint32_t save_wifi_credentials(char *filename, char *ssid, char *passphrase, cha
     strcat(credentials_buf, "\n");
 
     data_len = strlen(credentials_buf) + 1; // Need to also store \0
+    data_len = append_chan_record(filename, credentials_buf, data_len);
 
     if (save_file(filename, credentials_buf, data_len))
     {
@@ -158,9 +188,197 @@ uint32_t get_saved_wifi_credentials(char *filename, char *ssid, char *passphrase
 
 uint32_t reset_saved_wifi_credentials(char *filename)
 {
+    char file_buf[1 + sizeof(chan_record_t)] = "";
+
     if (filename == NULL || (strlen(filename) > 63))
     {
         return 1;
     }
-    return save_file(filename, "", 1);
+    return save_file(filename, file_buf, append_chan_record(filename, file_buf, 1));
+}
+
+/* Maps the file, returns the length of the string it starts with, \0 included, or 0 if there is none */
+static uint32_t map_file(char *filename, uint8_t **data, uint32_t *data_len)
+{
+    uint32_t len;
+
+    if ((filename == NULL) || (strlen(filename) > 63) ||
+        (mflash_file_mmap(filename, data, data_len) != kStatus_Success))
+    {
+        return 0;
+    }
+
+    len = strnlen((char *)*data, *data_len);
+    return (len < *data_len) ? (len + 1U) : 0U;
+}
+
+/* Maps the saved credentials, returns the length of their string with its \0 or 0 if there are none */
+static uint32_t map_credentials(char *filename, uint8_t **data, uint32_t *data_len)
+{
+    uint32_t len = map_file(filename, data, data_len);
+
+    if ((len <= sizeof(FILE_HEADER)) || (strncmp((char *)*data, FILE_HEADER, strlen(FILE_HEADER)) != 0))
+    {
+        return 0;
+    }
+    return len;
+}
+
+/* True if the mapped file holds a record of length len with the given header at offset */
+static bool has_record(const uint8_t *data, uint32_t data_len, uint32_t offset, const char *header, uint32_t len)
+{
+    return (data_len >= offset + len) && (memcmp(data + offset, header, strlen(header) + 1U) == 0);
+}
+
+/* Offset of the channel record of the mapped file, 0 if there is none */
+static uint32_t chan_record_offset(const uint8_t *data, uint32_t data_len, uint32_t str_len)
+{
+    uint32_t offset = str_len;
+
+    if (has_record(data, data_len, offset, LEASE_HEADER, sizeof(dhcp_lease_record_t)))
+    {
+        offset += sizeof(dhcp_lease_record_t);
+    }
+    return has_record(data, data_len, offset, CHAN_HEADER, sizeof(chan_record_t)) ? offset : 0U;
+}
+
+/* Copies the saved channel record, if any, to file_buf + len, returns the new length */
+static uint32_t append_chan_record(char *filename, char *file_buf, uint32_t len)
+{
+    uint8_t *data;
+    uint32_t data_len = 0;
+    uint32_t str_len;
+    uint32_t offset;
+
+    str_len = map_file(filename, &data, &data_len);
+    offset  = (str_len != 0U) ? chan_record_offset(data, data_len, str_len) : 0U;
+    if (offset == 0U)
+    {
+        return len;
+    }
+
+    (void)memcpy(&file_buf[len], data + offset, sizeof(chan_record_t));
+    return len + sizeof(chan_record_t);
+}
+
+/* True if the mapped credentials are the ones of the network ssid */
+static bool credentials_of(const uint8_t *data, const char *ssid)
+{
+    size_t ssid_len = strlen(ssid);
+
+    data += strlen(FILE_HEADER);
+    return (strncmp((const char *)data, ssid, ssid_len) == 0) && (data[ssid_len] == '\n');
+}
+
+uint32_t save_dhcp_lease(char *filename, const char *ssid, const wpl_dhcp_lease_t *lease)
+{
+    char file_buf[FILE_MAX_LEN];
+    dhcp_lease_record_t record;
+    uint8_t *data;
+    uint32_t data_len = 0;
+    uint32_t creds_len;
+
+    creds_len = map_credentials(filename, &data, &data_len);
+    if ((creds_len == 0U) || (creds_len > CREDENTIALS_MAX_LEN) || !credentials_of(data, ssid))
+    {
+        return 1;
+    }
+
+    (void)memset(&record, 0, sizeof(record));
+    strcpy(record.header, LEASE_HEADER);
+    record.lease = *lease;
+
+    /* Renewals mostly confirm the same lease, spare the flash */
+    if ((data_len >= creds_len + sizeof(record)) && (memcmp(data + creds_len, &record, sizeof(record)) == 0))
+    {
+        return 0;
+    }
+
+    (void)memcpy(file_buf, data, creds_len);
+    (void)memcpy(&file_buf[creds_len], &record, sizeof(record));
+
+    return save_file(filename, file_buf, append_chan_record(filename, file_buf, creds_len + sizeof(record)));
+}
+
+uint32_t get_saved_dhcp_lease(char *filename, const char *ssid, wpl_dhcp_lease_t *lease)
+{
+    dhcp_lease_record_t record;
+    uint8_t *data;
+    uint32_t data_len = 0;
+    uint32_t creds_len;
+
+    creds_len = map_credentials(filename, &data, &data_len);
+    if ((creds_len == 0U) || !has_record(data, data_len, creds_len, LEASE_HEADER, sizeof(record)) ||
+        !credentials_of(data, ssid))
+    {
+        return 1;
+    }
+
+    /* The record is not aligned in the file */
+    (void)memcpy(&record, data + creds_len, sizeof(record));
+    *lease = record.lease;
+    return 0;
+}
+
+uint32_t save_chan_metrics(char *filename, const chan_select_state_t *state)
+{
+    char file_buf[FILE_MAX_LEN] = "";
+    chan_record_t record;
+    uint8_t *data;
+    uint32_t data_len = 0;
+    uint32_t str_len;
+    uint32_t offset;
+    uint32_t len;
+
+    if ((filename == NULL) || (strlen(filename) > 63))
+    {
+        return 1;
+    }
+
+    (void)memset(&record, 0, sizeof(record));
+    strcpy(record.header, CHAN_HEADER);
+    record.state = *state;
+
+    /* Keep the credentials and the lease, or start an empty file */
+    str_len = map_file(filename, &data, &data_len);
+    if ((str_len == 0U) || (str_len > CREDENTIALS_MAX_LEN))
+    {
+        len = 1U;
+    }
+    else
+    {
+        offset = chan_record_offset(data, data_len, str_len);
+        if ((offset != 0U) && (memcmp(data + offset, &record, sizeof(record)) == 0))
+        {
+            return 0;
+        }
+        len = has_record(data, data_len, str_len, LEASE_HEADER, sizeof(dhcp_lease_record_t)) ?
+                  (str_len + sizeof(dhcp_lease_record_t)) :
+                  str_len;
+        (void)memcpy(file_buf, data, len);
+    }
+
+    (void)memcpy(&file_buf[len], &record, sizeof(record));
+    return save_file(filename, file_buf, len + sizeof(record));
+}
+
+uint32_t get_saved_chan_metrics(char *filename, chan_select_state_t *state)
+{
+    chan_record_t record;
+    uint8_t *data;
+    uint32_t data_len = 0;
+    uint32_t str_len;
+    uint32_t offset;
+
+    str_len = map_file(filename, &data, &data_len);
+    offset  = (str_len != 0U) ? chan_record_offset(data, data_len, str_len) : 0U;
+    if (offset == 0U)
+    {
+        return 1;
+    }
+
+    /* The record is not aligned in the file */
+    (void)memcpy(&record, data + offset, sizeof(record));
+    *state = record.state;
+    return 0;
 }
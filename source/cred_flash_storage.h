@@ -8,6 +8,9 @@
 
 #include <stdint.h>
 
+#include "wpl.h"
+#include "chan_select.h"
+
 #ifndef CRED_FLASH_STORAGE_H
 #define CRED_FLASH_STORAGE_H
 
@@ -19,4 +22,18 @@ uint32_t get_saved_wifi_credentials(char *filename, char *ssid, char *passphrase
 
 uint32_t reset_saved_wifi_credentials(char *filename);
 
+/* DHCP lease of the network ssid, kept in the credentials file if they are the ones of ssid.
+ * Written only if it changed, save_wifi_credentials() and reset_saved_wifi_credentials() drop it. */
+uint32_t save_dhcp_lease(char *filename, const char *ssid, const wpl_dhcp_lease_t *lease);
+
+/* Returns 0 if a lease of the network ssid is saved */
+uint32_t get_saved_dhcp_lease(char *filename, const char *ssid, wpl_dhcp_lease_t *lease);
+
+/* Channel metrics of the AP, kept in the credentials file whatever network is saved.
+ * Written only if they changed, the credentials functions keep them. */
+uint32_t save_chan_metrics(char *filename, const chan_select_state_t *state);
+
+/* Returns 0 if channel metrics are saved */
+uint32_t get_saved_chan_metrics(char *filename, chan_select_state_t *state);
+
 #endif
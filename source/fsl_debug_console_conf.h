@@ -10,7 +10,10 @@
 #define DEBUG_CONSOLE_TRANSMIT_BUFFER_LEN 512U
 #define DEBUG_CONSOLE_RECEIVE_BUFFER_LEN 1024U
 #define DEBUG_CONSOLE_TX_RELIABLE_ENABLE 1
-#define DEBUG_CONSOLE_RX_ENABLE 1
+/* Console input is read by serial_cmd.c through its own read handle on the
+ * ring buffer of DEBUG_CONSOLE_TRANSFER_NON_BLOCKING (mcux_config.h), the
+ * serial manager takes a single read handle */
+#define DEBUG_CONSOLE_RX_ENABLE 0
 #define DEBUG_CONSOLE_PRINTF_MAX_LOG_LEN 128U
 #define DEBUG_CONSOLE_SCANF_MAX_LOG_LEN 20U
 #define DEBUG_CONSOLE_SYNCHRONIZATION_BM 0
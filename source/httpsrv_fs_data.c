@@ -1,9 +1,9 @@
 /*
- * Copyright 2024 NXP
- *
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+/* Generated by lwip/src/apps/httpsrv/tools/httpsrv_ssi_compile.py, do not edit */
+
 #include <httpsrv_fs.h>
 
 extern const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[];
@@ -3553,11 +3553,11 @@ static const unsigned char httpsrv_fs_webui_webconfig_js[] = {
 };
 
 const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[] = {
-	{ "/favicon.ico", 0, (unsigned char*)httpsrv_fs_webui_favicon_ico, sizeof(httpsrv_fs_webui_favicon_ico) },
-	{ "/index.html", 0, (unsigned char*)httpsrv_fs_webui_index_html, sizeof(httpsrv_fs_webui_index_html) },
-	{ "/NXP_logo.png", 0, (unsigned char*)httpsrv_fs_webui_NXP_logo_png, sizeof(httpsrv_fs_webui_NXP_logo_png) },
-	{ "/webconfig.css", 0, (unsigned char*)httpsrv_fs_webui_webconfig_css, sizeof(httpsrv_fs_webui_webconfig_css) },
-	{ "/webconfig.js", 0, (unsigned char*)httpsrv_fs_webui_webconfig_js, sizeof(httpsrv_fs_webui_webconfig_js) },
+	{ "/favicon.ico", 0, (unsigned char*)httpsrv_fs_webui_favicon_ico, sizeof(httpsrv_fs_webui_favicon_ico), 0, 0, 0x5d71dc06 },
+	{ "/index.html", 0, (unsigned char*)httpsrv_fs_webui_index_html, sizeof(httpsrv_fs_webui_index_html), 0, 0, 0xbd942e4f },
+	{ "/NXP_logo.png", 0, (unsigned char*)httpsrv_fs_webui_NXP_logo_png, sizeof(httpsrv_fs_webui_NXP_logo_png), 0, 0, 0x7a456439 },
+	{ "/webconfig.css", 0, (unsigned char*)httpsrv_fs_webui_webconfig_css, sizeof(httpsrv_fs_webui_webconfig_css), 0, 0, 0x205be6dd },
+	{ "/webconfig.js", 0, (unsigned char*)httpsrv_fs_webui_webconfig_js, sizeof(httpsrv_fs_webui_webconfig_js), 0, 0, 0xe83aa680 },
 	{ 0, 0, 0, 0 }
 };
 
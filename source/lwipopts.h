@@ -71,7 +71,9 @@ void sys_mark_tcpip_thread(void);
 #define LWIP_LOOPBACK_MAX_PBUFS            8
 
 #define TCPIP_THREAD_NAME      "tcp/ip"
+#ifndef TCPIP_THREAD_STACKSIZE
 #define TCPIP_THREAD_STACKSIZE 768
+#endif
 #define TCPIP_THREAD_PRIO      2
 #define TCPIP_MBOX_SIZE        32
 
@@ -106,6 +108,11 @@ void sys_mark_tcpip_thread(void);
 #define DEFAULT_THREAD_STACKSIZE 200
 #define DEFAULT_THREAD_PRIO      1
 
+/* Cycle count statistics of PERF_START/PERF_STOP sections, see arch/perf.h */
+#ifndef LWIP_PERF
+#define LWIP_PERF 0
+#endif
+
 #define LWIP_DEBUG       0
 #define LWIP_DEBUG_TRACE 0
 #define SOCKETS_DEBUG    LWIP_DBG_OFF // | LWIP_DBG_MASK_LEVEL
@@ -206,6 +213,12 @@ void sys_mark_tcpip_thread(void);
  */
 #define MEMP_NUM_PBUF 10
 
+/**
+ * LWIP_SUPPORT_CUSTOM_PBUF: received A-MSDU subframes are custom PBUF_REF
+ * pbufs pointing into the A-MSDU buffer (CONFIG_AMSDU_RX_ZERO_COPY).
+ */
+#define LWIP_SUPPORT_CUSTOM_PBUF 1
+
 /**
  * MEMP_NUM_TCP_PCB: the number of simulatenously active TCP connections.
  * (requires the LWIP_TCP option)
@@ -368,6 +381,20 @@ void sys_mark_tcpip_thread(void);
  */
 #define LWIP_TCP_KEEPALIVE 1
 
+/**
+ * LWIP_TCP_CC==1: Per-PCB congestion control. New PCBs keep Reno, the opt.h
+ * default; tcp_set_cc(pcb, &tcp_cc_veno) selects Veno on a connection.
+ * tests/host/tcp_cc_sim compares both over a lossy link: Veno gains 10-45%
+ * with random loss but loses about 10% when a shallow queue also overflows.
+ */
+#define LWIP_TCP_CC 1
+
+/**
+ * MQTT_TOS: DSCP CS4 on the MQTT connection, sent on WMM AC_VI ahead of
+ * best effort HTTP transfers.
+ */
+#define MQTT_TOS 0x80
+
 /*
    ----------------------------------------
    ---------- Statistics options ----------
@@ -383,6 +410,11 @@ void sys_mark_tcpip_thread(void);
  */
 #define LWIP_STATS_DISPLAY 1
 
+/**
+ * LWIP_FLOW_STATS==1: Enable per-flow accounting (see lwip/flow_stats.h).
+ */
+#define LWIP_FLOW_STATS 0
+
 /*
    ----------------------------------
    ---------- DHCP options ----------
@@ -393,12 +425,17 @@ void sys_mark_tcpip_thread(void);
  */
 #define LWIP_DHCP                      1
 #define LWIP_NETIF_EXT_STATUS_CALLBACK 1
+/* Rejoin known networks with the lease of the last session */
+#define LWIP_DHCP_INIT_REBOOT          1
 
 /**
  * DNS related options, revisit later to fine tune.
  */
 #define LWIP_DNS            1
-#define DNS_TABLE_SIZE      2  // number of table entries, default 4
+#define DNS_TABLE_SIZE      8  // number of table entries, default 4
+#define DNS_NEG_TTL_NXDOMAIN 60 // seconds to cache NXDOMAIN answers, default 0
+#define DNS_NEG_TTL_FAILURE  5  // seconds to cache timeouts/errors, default 0
+#define DNS_PREFETCH_TIME    10 // refresh used entries this long before expiry, default 0
 #define DNS_MAX_NAME_LENGTH 64 // max. name length, default 256
 #define DNS_MAX_SERVERS     2  // number of DNS servers, default 2
 #define DNS_DOES_NAME_CHECK 1  // compare received name with given,def 0
@@ -10,10 +10,16 @@
 #define CONFIG_FLASH_BASE_ADDRESS 0x08000000
 #define DEBUG_CONSOLE_SYNCHRONIZATION_MODE 0
 // #define SERIAL_MANAGER_NON_BLOCKING_MODE 0
+/* Interrupt driven console: the debug console owns the RX ring buffer and a
+ * non-blocking serial manager handle, serial_cmd.c reads the ring. This also
+ * selects SERIAL_MANAGER_NON_BLOCKING_MODE. */
+#define DEBUG_CONSOLE_TRANSFER_NON_BLOCKING
 // #define CONFIG_DBI_USE_MIPI_PANEL 0
 #define CONFIG_LV_ATTRIBUTE_MEM_ALIGN 
 #define CONFIG_LV_ATTRIBUTE_LARGE_CONST 
 // #define MPU_SUPPORT 0
 // #define USE_PERCEPIO_TRACELYZER 0
+/* Task stack sizes measured by the stack profiling mode, see stack_profile.h */
+#include "stack_sizes.h"
 
 #endif /* _MCUX_CONFIG_H_ */
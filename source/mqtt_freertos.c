@@ -2,6 +2,7 @@
  * mqtt_freertos.c
  * Integrated MQTT functionality for RW612
  * Publishes oxygen level and fill state (INCREASE/DECREASE/STABLE); subscribes to requests and alarms.
+ * Oxygen level samples are kept in a time series ring and uploaded in delta encoded batches.
  * Uses lwIP sys_timeout for timing.
  *
  * SPDX-License-Identifier: BSD-3-Clause
@@ -11,6 +12,8 @@
  * Includes
  ******************************************************************************/
 #include "mqtt_freertos.h"
+#include "telemetry_ring.h"
+#include "twt_manager.h"
 #include "board.h"
 #include "fsl_silicon_id.h"
 #include "lwip/opt.h"
@@ -31,16 +34,29 @@
 #ifndef EXAMPLE_MQTT_SERVER_PORT
 #define EXAMPLE_MQTT_SERVER_PORT 1883
 #endif
+#ifndef APP_THREAD_STACKSIZE
 #define APP_THREAD_STACKSIZE 1024
+#endif
 #define APP_THREAD_PRIO      DEFAULT_THREAD_PRIO
 #define STEP_DELAY_MS        100    /* ms between each level step */
 #define OFF_DELAY_MS        5000    /* ms before starting increase */
+#ifndef TELEMETRY_UPLOAD_INTERVAL_MS
+#define TELEMETRY_UPLOAD_INTERVAL_MS 5000 /* ms between sample batch uploads */
+#endif
+/* TWT flows of the periodic traffic, awake time covers a publish and its acknowledgement */
+#define TWT_FLOW_TELEMETRY 0U
+#define TWT_FLOW_KEEPALIVE 1U
+#define TWT_MQTT_AWAKE_MS  30U
+#ifndef TELEMETRY_BATCH_MAX
+#define TELEMETRY_BATCH_MAX 192 /* max batch payload, must fit MQTT_OUTPUT_RINGBUF_SIZE with the header */
+#endif
 
 /* MQTT topics */
 #define TANK_ALARM "tank/alarm"
 #define TANK_AVAILABILITY "tank/availability"
 #define TANK_FILL_STATE "tank/fill_state"
 #define TANK_OXYGEN_LEVEL "tank/oxygen_level"
+#define TANK_OXYGEN_HISTORY "tank/oxygen_history"
 #define TANK_OXYGEN_REQUEST "tank/oxygen_request"
 
 /*******************************************************************************
@@ -58,6 +74,10 @@ static void app_thread(void *arg);
 static void oxygen_decrease_step(void *ctx);
 static void oxygen_increase_step(void *ctx);
 static void publish_change(mqtt_client_t *client);
+static void telemetry_upload(void *ctx);
+static void telemetry_send_batch(mqtt_client_t *client);
+static void telemetry_published_cb(void *arg, err_t err);
+static void telemetry_set_interval(void *ctx);
 
 /*******************************************************************************
  * Variables
@@ -68,6 +88,12 @@ static char client_id[(SILICONID_MAX_LENGTH * 2) + 5];
 /* oxygen level and tracking */
 static int oxygen_level      = 100;
 static int prev_oxygen_level = 100;
+static int sent_oxygen_level = -1;   /* last level published on TANK_OXYGEN_LEVEL */
+
+/* sample batch upload */
+static bool telemetry_in_flight = false;
+static uint32_t telemetry_interval_ms = TELEMETRY_UPLOAD_INTERVAL_MS;
+static uint8_t telemetry_buf[TELEMETRY_BATCH_MAX];
 
 /* tank state */
 static bool alarm_active = false;
@@ -107,22 +133,97 @@ static void publish_availability(void *ctx)
                  (void*)TANK_AVAILABILITY);
     /* Immediately publish initial STABLE state */
     publish_change(client);
+
+    /* Start batch uploads, samples stored while offline go first */
+    telemetry_in_flight = false;
+    sent_oxygen_level   = -1;
+    sys_untimeout(telemetry_upload, client);
+    telemetry_upload(client);
+}
+
+/* Upload stored samples in one publish, and the current level if it changed */
+static void telemetry_upload(void *ctx)
+{
+    mqtt_client_t *client = (mqtt_client_t*)ctx;
+
+    if (!telemetry_in_flight)
+    {
+        telemetry_send_batch(client);
+    }
+
+    if (oxygen_level != sent_oxygen_level)
+    {
+        char pl[4];
+        int l = snprintf(pl, sizeof(pl), "%d", oxygen_level);
+        if (mqtt_publish(client,
+                         TANK_OXYGEN_LEVEL,
+                         pl, l,
+                         1, 1,
+                         mqtt_message_published_cb,
+                         (void*)TANK_OXYGEN_LEVEL) == ERR_OK)
+        {
+            sent_oxygen_level = oxygen_level;
+        }
+    }
+
+    sys_timeout(telemetry_interval_ms, telemetry_upload, client);
+}
+
+/* Publish the oldest stored samples, as many as fit one batch */
+static void telemetry_send_batch(mqtt_client_t *client)
+{
+    size_t len = telemetry_ring_encode(telemetry_buf, sizeof(telemetry_buf));
+
+    if (len != 0 &&
+        mqtt_publish(client,
+                     TANK_OXYGEN_HISTORY,
+                     telemetry_buf, len,
+                     1, 0,
+                     telemetry_published_cb,
+                     client) == ERR_OK)
+    {
+        telemetry_in_flight = true;
+    }
+}
+
+/* Change the upload cadence, the TWT agreement follows it */
+static void telemetry_set_interval(void *ctx)
+{
+    telemetry_interval_ms = (uint32_t)(uintptr_t)ctx;
+    if (mqtt_client_is_connected(mqtt_client))
+    {
+        sys_untimeout(telemetry_upload, mqtt_client);
+        sys_timeout(telemetry_interval_ms, telemetry_upload, mqtt_client);
+        (void)twt_manager_set_flow(TWT_FLOW_TELEMETRY, telemetry_interval_ms, TWT_MQTT_AWAKE_MS);
+    }
+}
+
+/*
+ * Batch acknowledged by broker: drop it from the ring and send the next one
+ * of a backlog right away, a batch per interval would fall behind the ring.
+ * Otherwise retry next interval.
+ */
+static void telemetry_published_cb(void *arg, err_t err)
+{
+    telemetry_in_flight = false;
+    if (err == ERR_OK)
+    {
+        telemetry_ring_commit();
+        telemetry_send_batch((mqtt_client_t*)arg);
+    }
+    else
+    {
+        PRINTF("Error publicando '%s': %d\r\n", TANK_OXYGEN_HISTORY, err);
+    }
 }
 
 /* Publish level and state (INCREASE/DECREASE/STABLE) if changed or first invocation */
 static void publish_change(mqtt_client_t *client)
 {
-    /* level */
+    /* level: stored as sample, uploaded by telemetry_upload() */
     if (oxygen_level != prev_oxygen_level) {
-        char pl[4];
-        int l = snprintf(pl, sizeof(pl), "%d", oxygen_level);
         PRINTF("DBG: tank/oxygen_level=%d%%\r\n", oxygen_level);
-        mqtt_publish(client,
-                     TANK_OXYGEN_LEVEL,
-                     pl, l,
-                     1, 1,
-                     mqtt_message_published_cb,
-                     (void*)TANK_OXYGEN_LEVEL);
+        telemetry_ring_record(sys_now(), oxygen_level);
     }
 
     /* state */
@@ -288,10 +389,17 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
         PRINTF("MQTT '%s' connected\r\n", ci->client_id);
         mqtt_subscribe_topics(client);
         tcpip_callback(publish_availability, client);
+        /* Radio may sleep between uploads and keepalives */
+        (void)twt_manager_set_flow(TWT_FLOW_TELEMETRY, telemetry_interval_ms, TWT_MQTT_AWAKE_MS);
+        (void)twt_manager_set_flow(TWT_FLOW_KEEPALIVE, ci->keep_alive * 1000U, TWT_MQTT_AWAKE_MS);
     }
     else if (status == MQTT_CONNECT_DISCONNECTED)
     {
         PRINTF("MQTT disconnected\r\n");
+        /* pending requests are dropped without callback */
+        telemetry_in_flight = false;
+        (void)twt_manager_set_flow(TWT_FLOW_TELEMETRY, 0U, 0U);
+        (void)twt_manager_set_flow(TWT_FLOW_KEEPALIVE, 0U, 0U);
         sys_timeout(1000, connect_to_mqtt, NULL);
     }
     else
@@ -365,6 +473,15 @@ static void app_thread(void *arg)
     vTaskDelete(NULL);
 }
 
+/* Telemetry upload cadence, may be called from any thread */
+void mqtt_freertos_set_upload_interval(uint32_t interval_ms)
+{
+    if (interval_ms != 0U)
+    {
+        tcpip_callback(telemetry_set_interval, (void *)(uintptr_t)interval_ms);
+    }
+}
+
 /* Entry point */
 void mqtt_freertos_run_thread(struct netif *netif)
 {
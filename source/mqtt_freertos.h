@@ -18,4 +18,11 @@
  */
 void mqtt_freertos_run_thread(struct netif *netif);
 
+/*!
+ * @brief Change the time between telemetry uploads
+ *
+ * @param interval_ms  new upload interval in ms
+ */
+void mqtt_freertos_set_upload_interval(uint32_t interval_ms);
+
 #endif /* MQTT_FREERTOS_H */
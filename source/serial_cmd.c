@@ -0,0 +1,225 @@
+/*
+ * serial_cmd.c
+ * Interrupt fed console line input and command dispatcher, see serial_cmd.h.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "serial_cmd.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_debug_console.h"
+#include "fsl_component_serial_manager.h"
+
+#include <string.h>
+
+#if !(defined(SERIAL_MANAGER_NON_BLOCKING_MODE) && (SERIAL_MANAGER_NON_BLOCKING_MODE > 0U))
+#error "serial_cmd needs SERIAL_MANAGER_NON_BLOCKING_MODE"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#define SERIAL_CMD_READ_CHUNK 16U
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static SERIAL_MANAGER_READ_HANDLE_DEFINE(s_readHandle);
+static TaskHandle_t s_cmdTask;
+
+static const serial_cmd_t *s_tables[SERIAL_CMD_MAX_TABLES];
+static size_t s_tableSizes[SERIAL_CMD_MAX_TABLES];
+
+static char s_line[SERIAL_CMD_LINE_LENGTH];
+static size_t s_lineLength;
+static bool s_lineOverflow;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static void serial_cmd_help(void)
+{
+    size_t i, j;
+
+    for (i = 0; i < SERIAL_CMD_MAX_TABLES; i++)
+    {
+        for (j = 0; j < s_tableSizes[i]; j++)
+        {
+            PRINTF("  %-10s %s\r\n", s_tables[i][j].name, s_tables[i][j].help);
+        }
+    }
+}
+
+static void serial_cmd_dispatch(char *line)
+{
+    char *argv[SERIAL_CMD_MAX_ARGS];
+    int argc = 0;
+    size_t i, j;
+
+    while ((*line != '\0') && (argc < (int)SERIAL_CMD_MAX_ARGS))
+    {
+        while (*line == ' ')
+        {
+            *line++ = '\0';
+        }
+        if (*line == '\0')
+        {
+            break;
+        }
+        argv[argc++] = line;
+        while ((*line != ' ') && (*line != '\0'))
+        {
+            line++;
+        }
+    }
+
+    if (argc == 0)
+    {
+        return;
+    }
+
+    if (strcmp(argv[0], "help") == 0)
+    {
+        serial_cmd_help();
+        return;
+    }
+
+    for (i = 0; i < SERIAL_CMD_MAX_TABLES; i++)
+    {
+        for (j = 0; j < s_tableSizes[i]; j++)
+        {
+            if (strcmp(argv[0], s_tables[i][j].name) == 0)
+            {
+                s_tables[i][j].handler(argc, argv);
+                return;
+            }
+        }
+    }
+    PRINTF("Unknown command %s, enter 'help' for the list.\r\n", argv[0]);
+}
+
+void serial_cmd_feed(const uint8_t *data, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i < length; i++)
+    {
+        char c = (char)data[i];
+
+        if ((c == '\r') || (c == '\n'))
+        {
+            if (s_lineOverflow)
+            {
+                PRINTF("[!] Command line too long\r\n");
+            }
+            else if (s_lineLength != 0U)
+            {
+                s_line[s_lineLength] = '\0';
+                serial_cmd_dispatch(s_line);
+            }
+            s_lineLength   = 0;
+            s_lineOverflow = false;
+        }
+        else if ((c == '\b') || (c == 0x7F))
+        {
+            if (s_lineLength != 0U)
+            {
+                s_lineLength--;
+            }
+        }
+        else if (s_lineLength < (SERIAL_CMD_LINE_LENGTH - 1U))
+        {
+            s_line[s_lineLength++] = (c == '\t') ? ' ' : c;
+        }
+        else
+        {
+            /* Drop the rest of the line */
+            s_lineOverflow = true;
+        }
+    }
+}
+
+int serial_cmd_register(const serial_cmd_t *cmds, size_t count)
+{
+    size_t i;
+
+    for (i = 0; i < SERIAL_CMD_MAX_TABLES; i++)
+    {
+        if (s_tables[i] == NULL)
+        {
+            s_tableSizes[i] = count;
+            s_tables[i]     = cmds;
+            return 0;
+        }
+    }
+    return -1;
+}
+
+/* Called from the UART interrupt when the ring buffer holds data */
+static void serial_cmd_rx_callback(void *callbackParam,
+                                   serial_manager_callback_message_t *message,
+                                   serial_manager_status_t status)
+{
+    BaseType_t woken = pdFALSE;
+
+    (void)callbackParam;
+    (void)message;
+    (void)status;
+
+    if (s_cmdTask != NULL)
+    {
+        vTaskNotifyGiveFromISR(s_cmdTask, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+static void serial_cmd_task(void *arg)
+{
+    uint8_t data[SERIAL_CMD_READ_CHUNK];
+    uint32_t length;
+
+    (void)arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        do
+        {
+            length = 0;
+            if (SerialManager_TryRead((serial_read_handle_t)s_readHandle, data, sizeof(data), &length) !=
+                kStatus_SerialManager_Success)
+            {
+                break;
+            }
+            serial_cmd_feed(data, length);
+        } while (length == sizeof(data));
+    }
+}
+
+int serial_cmd_init(void)
+{
+    if (SerialManager_OpenReadHandle(g_serialHandle, (serial_read_handle_t)s_readHandle) !=
+        kStatus_SerialManager_Success)
+    {
+        PRINTF("[!] Cannot open console for reading\r\n");
+        return -1;
+    }
+
+    if (xTaskCreate(serial_cmd_task, "serial_cmd", SERIAL_CMD_TASK_STACKSIZE, NULL, tskIDLE_PRIORITY + 1,
+                    &s_cmdTask) != pdPASS)
+    {
+        PRINTF("[!] Command task creation failed\r\n");
+        (void)SerialManager_CloseReadHandle((serial_read_handle_t)s_readHandle);
+        return -1;
+    }
+
+    (void)SerialManager_InstallRxCallback((serial_read_handle_t)s_readHandle, serial_cmd_rx_callback, NULL);
+
+    /* Characters received before the callback was installed */
+    xTaskNotifyGive(s_cmdTask);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/*
+ * serial_cmd.h
+ * Interrupt fed console command input
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef SERIAL_CMD_H
+#define SERIAL_CMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Console command input. Received characters are stored in the serial manager
+ * ring buffer by the UART interrupt; a single low priority task is woken from
+ * the interrupt, assembles lines and runs the matching command. Nothing waits
+ * on the UART itself.
+ *
+ * A line is split at spaces into at most SERIAL_CMD_MAX_ARGS words, the first
+ * one selects the command. "help" lists the registered commands.
+ */
+
+#ifndef SERIAL_CMD_LINE_LENGTH
+#define SERIAL_CMD_LINE_LENGTH 64U
+#endif
+
+#ifndef SERIAL_CMD_MAX_ARGS
+#define SERIAL_CMD_MAX_ARGS 8U
+#endif
+
+/* Number of command tables which can be registered */
+#ifndef SERIAL_CMD_MAX_TABLES
+#define SERIAL_CMD_MAX_TABLES 4U
+#endif
+
+#ifndef SERIAL_CMD_TASK_STACKSIZE
+#define SERIAL_CMD_TASK_STACKSIZE 384U
+#endif
+
+typedef void (*serial_cmd_handler_t)(int argc, char **argv);
+
+typedef struct serial_cmd
+{
+    const char *name;
+    const char *help;
+    serial_cmd_handler_t handler;
+} serial_cmd_t;
+
+/* Opens the console read handle and starts the command task. */
+int serial_cmd_init(void);
+
+/* Adds a table of commands (the table must stay valid). */
+int serial_cmd_register(const serial_cmd_t *cmds, size_t count);
+
+/* Line assembly and dispatch, called by the command task with received data.
+ * Independent of the UART, so it can be fed from anywhere. */
+void serial_cmd_feed(const uint8_t *data, size_t length);
+
+#endif /* SERIAL_CMD_H */
@@ -0,0 +1,282 @@
+/*
+ * stack_profile.c
+ * Stack high-water mark profiling, see stack_profile.h.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "stack_profile.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_debug_console.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+#if (configCHECK_FOR_STACK_OVERFLOW > 0)
+/* Called from the context switch when a task has overflowed its stack */
+void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
+{
+    (void)xTask;
+
+    PRINTF("[!] Stack overflow in task %s\r\n", pcTaskName);
+    taskDISABLE_INTERRUPTS();
+    for (;;)
+        ;
+}
+#endif
+
+#if STACK_PROFILE_ENABLED
+
+#if (configUSE_TRACE_FACILITY != 1) || (configRECORD_STACK_HIGH_ADDRESS != 1)
+#error "Stack profiling needs configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS"
+#endif
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+/* Suggested sizes are rounded up to keep the stack 8 byte aligned */
+#define STACK_PROFILE_ALIGN 2U
+
+typedef struct stack_profile_entry
+{
+    char name[configMAX_TASK_NAME_LEN];
+    uint32_t size; /* words */
+    uint32_t used; /* words, worst case */
+} stack_profile_entry_t;
+
+/* Configuration macro setting the stack size of a task */
+typedef struct stack_profile_macro
+{
+    const char *task;  /* task name as created */
+    const char *macro; /* stack size macro */
+    bool bytes;        /* the macro is in bytes (OSA_TASK_DEFINE), otherwise in stack words */
+} stack_profile_macro_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static const stack_profile_macro_t s_macros[] = {
+    {"main_task", "MAIN_TASK_STACKSIZE", false},
+    {"http_srv_task", "HTTPD_STACKSIZE", false},
+    {"serial_cmd", "SERIAL_CMD_TASK_STACKSIZE", false},
+    {"twt_manager", "TWT_MANAGER_TASK_STACKSIZE", false},
+    {"app_task", "APP_THREAD_STACKSIZE", false},
+    {"tcp/ip", "TCPIP_THREAD_STACKSIZE", false},
+    {"HTTP server", "HTTPSRV_CFG_SERVER_STACK_SIZE", false},
+    {"HTTP server session", "HTTPSRV_CFG_HTTP_SESSION_STACK_SIZE", false},
+    {"Tmr Svc", "configTIMER_TASK_STACK_DEPTH", false},
+    {"IDLE", "configMINIMAL_STACK_SIZE", false},
+    {"wlcmgr_task", "CONFIG_WLCMGR_STACK_SIZE", true},
+    {"wlcmgr_nb_task", "CONFIG_WLCMGR_NB_STACK_SIZE", true},
+    {"wlcmgr_mon_task", "CONFIG_WLCMGR_MON_STACK_SIZE", true},
+    {"wps_task", "CONFIG_WPS_STACK_SIZE", true},
+    {"cpu_loading_task", "CONFIG_CPU_LOADING_STACK_SIZE", true},
+    {"netmgr_task", "CONFIG_NETMGR_STACK_SIZE", true},
+    {"dhcpd_task", "CONFIG_DHCP_SERVER_STACK_SIZE", true},
+    {"wifi_core_task", "CONFIG_WIFI_CORE_STACK_SIZE", true},
+    {"wifi_scan_task", "CONFIG_WIFI_SCAN_STACK_SIZE", true},
+    {"wifi_drv_task", "CONFIG_WIFI_DRIVER_STACK_SIZE", true},
+    {"wifi_drv_tx_task", "CONFIG_WIFI_DRV_TX_STACK_SIZE", true},
+    {"wifi_pre_asleep_task", "CONFIG_WIFI_PRE_ASLEEP_STACK_SIZE", true},
+    {"wifi_powersave_task", "CONFIG_WIFI_POWERSAVE_STACK_SIZE", true},
+    {"HAL_ImuMain", "IMU_TASK_STACK_SIZE", true},
+    {"HAL_ImuMainCpu13", "IMU_TASK_STACK_SIZE", true},
+    {"HAL_ImuMainCpu23", "IMU_TASK_STACK_SIZE", true},
+    {"SerialManager_Task", "SERIAL_MANAGER_TASK_STACK_SIZE", true},
+};
+
+static stack_profile_entry_t s_entries[STACK_PROFILE_MAX_TASKS];
+static uint32_t s_samples;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static void stack_profile_update(const TaskStatus_t *status)
+{
+    uint32_t size = (uint32_t)(status->pxEndOfStack - status->pxStackBase) + 1U;
+    uint32_t used = size - (uint32_t)status->usStackHighWaterMark;
+    int i;
+
+    for (i = 0; i < STACK_PROFILE_MAX_TASKS; i++)
+    {
+        stack_profile_entry_t *entry = &s_entries[i];
+
+        if (entry->name[0] == '\0')
+        {
+            (void)strncpy(entry->name, status->pcTaskName, sizeof(entry->name) - 1U);
+        }
+        else if (strncmp(entry->name, status->pcTaskName, sizeof(entry->name)) != 0)
+        {
+            continue;
+        }
+
+        if (used > entry->used)
+        {
+            entry->used = used;
+        }
+        if (size > entry->size)
+        {
+            entry->size = size;
+        }
+        return;
+    }
+}
+
+static void stack_profile_sample(void)
+{
+    UBaseType_t count = uxTaskGetNumberOfTasks();
+    TaskStatus_t *status;
+    UBaseType_t i;
+
+    status = pvPortMalloc(count * sizeof(TaskStatus_t));
+    if (status == NULL)
+    {
+        return;
+    }
+
+    count = uxTaskGetSystemState(status, count, NULL);
+    for (i = 0; i < count; i++)
+    {
+        stack_profile_update(&status[i]);
+    }
+    vPortFree(status);
+    s_samples++;
+}
+
+static const stack_profile_macro_t *stack_profile_find_macro(const char *name)
+{
+    size_t i;
+
+    for (i = 0; i < sizeof(s_macros) / sizeof(s_macros[0]); i++)
+    {
+        /* Task names longer than configMAX_TASK_NAME_LEN - 1 are truncated */
+        if (strncmp(s_macros[i].task, name, configMAX_TASK_NAME_LEN - 1U) == 0)
+        {
+            return &s_macros[i];
+        }
+    }
+    return NULL;
+}
+
+/* Stack size for the worst case of a task, in words */
+static uint32_t stack_profile_suggest(const stack_profile_entry_t *entry)
+{
+    uint32_t suggested = entry->used + (entry->used * STACK_PROFILE_MARGIN + 99U) / 100U;
+
+    suggested = (suggested + STACK_PROFILE_ALIGN - 1U) & ~(STACK_PROFILE_ALIGN - 1U);
+    if (suggested < configMINIMAL_STACK_SIZE)
+    {
+        suggested = configMINIMAL_STACK_SIZE;
+    }
+    return suggested;
+}
+
+/* A task before the entry at index uses the same macro */
+static bool stack_profile_macro_seen(int index, const stack_profile_macro_t *macro)
+{
+    const stack_profile_macro_t *other;
+    int i;
+
+    for (i = 0; i < index; i++)
+    {
+        other = stack_profile_find_macro(s_entries[i].name);
+        if ((other != NULL) && (strcmp(other->macro, macro->macro) == 0))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void stack_profile_report(void)
+{
+    int i, j;
+
+    PRINTF("/* Stack sizes from %u samples, margin %u%%, for stack_sizes.h */\r\n", (unsigned int)s_samples,
+           (unsigned int)STACK_PROFILE_MARGIN);
+    for (i = 0; (i < STACK_PROFILE_MAX_TASKS) && (s_entries[i].name[0] != '\0'); i++)
+    {
+        const stack_profile_entry_t *entry = &s_entries[i];
+        const stack_profile_macro_t *macro = stack_profile_find_macro(entry->name);
+        uint32_t suggested                 = stack_profile_suggest(entry);
+
+        if (macro != NULL)
+        {
+            /* One define per macro, with the largest size of the tasks sharing it */
+            if (stack_profile_macro_seen(i, macro))
+            {
+                continue;
+            }
+            for (j = i + 1; (j < STACK_PROFILE_MAX_TASKS) && (s_entries[j].name[0] != '\0'); j++)
+            {
+                const stack_profile_macro_t *other = stack_profile_find_macro(s_entries[j].name);
+
+                if ((other != NULL) && (strcmp(other->macro, macro->macro) == 0) &&
+                    (stack_profile_suggest(&s_entries[j]) > suggested))
+                {
+                    entry     = &s_entries[j];
+                    suggested = stack_profile_suggest(entry);
+                }
+            }
+        }
+
+        if (macro == NULL)
+        {
+            PRINTF("/* %s: %u words, used %u of %u */\r\n", entry->name, (unsigned int)suggested,
+                   (unsigned int)entry->used, (unsigned int)entry->size);
+        }
+        else if (macro->bytes)
+        {
+            PRINTF("#define %s %u /* bytes, %s used %u of %u words */\r\n", macro->macro,
+                   (unsigned int)(suggested * sizeof(StackType_t)), entry->name, (unsigned int)entry->used,
+                   (unsigned int)entry->size);
+        }
+        else
+        {
+            PRINTF("#define %s %u /* words, %s used %u of %u */\r\n", macro->macro, (unsigned int)suggested,
+                   entry->name, (unsigned int)entry->used, (unsigned int)entry->size);
+        }
+    }
+}
+
+static void stack_profile_task(void *arg)
+{
+    TickType_t last_report = xTaskGetTickCount();
+
+    (void)arg;
+
+    for (;;)
+    {
+        stack_profile_sample();
+        if ((xTaskGetTickCount() - last_report) >= pdMS_TO_TICKS(STACK_PROFILE_REPORT_MS))
+        {
+            stack_profile_report();
+            last_report = xTaskGetTickCount();
+        }
+        vTaskDelay(pdMS_TO_TICKS(STACK_PROFILE_SAMPLE_MS));
+    }
+}
+
+void stack_profile_start(void)
+{
+    if (xTaskCreate(stack_profile_task, "stack_profile", 384, NULL, tskIDLE_PRIORITY + 1, NULL) != pdPASS)
+    {
+        PRINTF("[!] Stack profile task creation failed\r\n");
+    }
+}
+
+#else /* STACK_PROFILE_ENABLED */
+
+void stack_profile_start(void)
+{
+}
+
+void stack_profile_report(void)
+{
+}
+
+#endif /* STACK_PROFILE_ENABLED */
@@ -0,0 +1,56 @@
+/*
+ * stack_profile.h
+ * Stack high-water mark profiling and stack overflow guard
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STACK_PROFILE_H
+#define STACK_PROFILE_H
+
+/*
+ * Stack profiling mode. When enabled, a low priority task samples the stack
+ * high-water mark of every task, keeps the worst case per task name (tasks
+ * like HTTP sessions come and go) and periodically prints the stack size
+ * macro of each task with a size suggested from the measured usage, in the
+ * unit of the macro:
+ *
+ *   #define MAIN_TASK_STACKSIZE 1104 // words, main_task used 930 of 2048
+ *   #define CONFIG_WLCMGR_STACK_SIZE 2400 // bytes, wlcmgr_task used 498 of 1280 words
+ *
+ * xTaskCreate and sys_thread_new take stack words, OSA_TASK_DEFINE bytes.
+ * Tasks sharing a macro get the largest of their sizes. Tasks without a known
+ * macro are printed as a comment. Run the workloads of interest, then copy
+ * the last printed block into stack_sizes.h, which every source sees through
+ * mcux_config.h.
+ */
+
+#ifndef STACK_PROFILE_ENABLED
+#define STACK_PROFILE_ENABLED 0
+#endif
+
+/* Safety margin added on top of the measured usage, in percent */
+#ifndef STACK_PROFILE_MARGIN
+#define STACK_PROFILE_MARGIN 20
+#endif
+
+/* Sampling and report periods */
+#ifndef STACK_PROFILE_SAMPLE_MS
+#define STACK_PROFILE_SAMPLE_MS 200
+#endif
+#ifndef STACK_PROFILE_REPORT_MS
+#define STACK_PROFILE_REPORT_MS 30000
+#endif
+
+/* Number of distinct task names tracked */
+#ifndef STACK_PROFILE_MAX_TASKS
+#define STACK_PROFILE_MAX_TASKS 24
+#endif
+
+/* Starts the profiling task (does nothing if STACK_PROFILE_ENABLED is 0). */
+void stack_profile_start(void);
+
+/* Prints the suggested stack sizes measured so far. */
+void stack_profile_report(void);
+
+#endif /* STACK_PROFILE_H */
@@ -0,0 +1,15 @@
+/*
+ * stack_sizes.h
+ * Task stack sizes measured by the stack profiling mode, see stack_profile.h.
+ * mcux_config.h includes it ahead of every source, so a size defined here
+ * replaces the default of its task creation site. Put the defines of the
+ * last block stack_profile_report() printed between the guards; with none,
+ * the defaults apply.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef STACK_SIZES_H
+#define STACK_SIZES_H
+
+#endif /* STACK_SIZES_H */
@@ -0,0 +1,136 @@
+/*
+ * telemetry_ring.c
+ * Time series ring of sensor samples with delta/varint batch encoding.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "telemetry_ring.h"
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static telemetry_sample_t ring[TELEMETRY_RING_SIZE];
+
+/* Sequence numbers of samples (index into ring is seq % TELEMETRY_RING_SIZE) */
+static uint32_t head_seq;   /* next sample to be written */
+static uint32_t acked_seq;  /* first sample not uploaded yet */
+static uint32_t batch_seq;  /* end of the last encoded batch */
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* First sample still stored and not uploaded */
+static uint32_t telemetry_ring_first(void)
+{
+    if ((head_seq - acked_seq) > TELEMETRY_RING_SIZE)
+    {
+        /* Older samples were overwritten */
+        return head_seq - TELEMETRY_RING_SIZE;
+    }
+    return acked_seq;
+}
+
+static size_t put_varint(uint8_t *buf, size_t pos, size_t size, uint32_t v)
+{
+    do
+    {
+        if (pos >= size)
+        {
+            return 0;
+        }
+        buf[pos++] = (uint8_t)((v & 0x7F) | ((v > 0x7F) ? 0x80 : 0));
+        v >>= 7;
+    } while (v != 0);
+    return pos;
+}
+
+static size_t put_svarint(uint8_t *buf, size_t pos, size_t size, int32_t v)
+{
+    return put_varint(buf, pos, size, ((uint32_t)v << 1) ^ (uint32_t)(v >> 31));
+}
+
+void telemetry_ring_record(uint32_t time, int32_t value)
+{
+    telemetry_sample_t *s = &ring[head_seq % TELEMETRY_RING_SIZE];
+
+    s->time  = time;
+    s->value = value;
+    head_seq++;
+}
+
+uint32_t telemetry_ring_pending(void)
+{
+    return head_seq - telemetry_ring_first();
+}
+
+size_t telemetry_ring_encode(uint8_t *buf, size_t size)
+{
+    /* Room for the count, a worst case count fits in 5 bytes */
+    const size_t hdr = 5;
+    uint32_t seq     = telemetry_ring_first();
+    uint32_t count   = 0;
+    size_t pos       = hdr;
+    size_t next;
+    const telemetry_sample_t *prev = NULL;
+    size_t len;
+
+    if ((seq == head_seq) || (size <= hdr))
+    {
+        return 0;
+    }
+
+    for (; seq != head_seq; seq++)
+    {
+        const telemetry_sample_t *s = &ring[seq % TELEMETRY_RING_SIZE];
+
+        if (prev == NULL)
+        {
+            next = put_varint(buf, pos, size, s->time);
+            next = next ? put_svarint(buf, next, size, s->value) : 0;
+        }
+        else
+        {
+            next = put_varint(buf, pos, size, s->time - prev->time);
+            next = next ? put_svarint(buf, next, size, (int32_t)((uint32_t)s->value - (uint32_t)prev->value)) : 0;
+        }
+        if (next == 0)
+        {
+            /* Batch is full */
+            break;
+        }
+        pos  = next;
+        prev = s;
+        count++;
+    }
+
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    /* Put count in front of the samples */
+    len = put_varint(buf, 0, hdr, count);
+    if (len < hdr)
+    {
+        size_t i;
+        for (i = hdr; i < pos; i++)
+        {
+            buf[i - (hdr - len)] = buf[i];
+        }
+        pos -= hdr - len;
+    }
+
+    batch_seq = seq;
+    return pos;
+}
+
+void telemetry_ring_commit(void)
+{
+    /* The batch may have been overwritten meanwhile, never move backwards */
+    if ((int32_t)(batch_seq - acked_seq) > 0)
+    {
+        acked_seq = batch_seq;
+    }
+}
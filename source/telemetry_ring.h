@@ -0,0 +1,56 @@
+/*
+ * telemetry_ring.h
+ * Time series ring of sensor samples with delta/varint batch encoding.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TELEMETRY_RING_H
+#define TELEMETRY_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * In-RAM time series of sensor samples, uploaded in delta encoded batches.
+ *
+ * Batch format (all numbers are LEB128 varints, signed ones zigzag encoded):
+ *   count                 number of samples in the batch
+ *   time                  timestamp of the first sample (ms)
+ *   value (signed)        value of the first sample
+ *   count - 1 times:
+ *     time delta          ms since the previous sample
+ *     value delta (signed) change since the previous sample
+ *
+ * Not thread safe: all functions are to be called from the same thread (the
+ * application uses the lwIP TCPIP thread).
+ */
+
+/* RAM used for samples. When full, the oldest samples are overwritten. */
+#ifndef TELEMETRY_RING_BUDGET
+#define TELEMETRY_RING_BUDGET 2048
+#endif
+
+typedef struct telemetry_sample
+{
+    uint32_t time; /* ms */
+    int32_t value;
+} telemetry_sample_t;
+
+#define TELEMETRY_RING_SIZE (TELEMETRY_RING_BUDGET / sizeof(telemetry_sample_t))
+
+/* Store a new sample. */
+void telemetry_ring_record(uint32_t time, int32_t value);
+
+/* Number of samples not uploaded yet. */
+uint32_t telemetry_ring_pending(void);
+
+/* Encode the oldest samples not uploaded yet into buf. Returns number of
+ * bytes written (0 if there is nothing to send). The samples stay in the ring
+ * until telemetry_ring_commit() confirms the upload. */
+size_t telemetry_ring_encode(uint8_t *buf, size_t size);
+
+/* Drop the samples of the last encoded batch (upload was acknowledged). */
+void telemetry_ring_commit(void);
+
+#endif /* TELEMETRY_RING_H */
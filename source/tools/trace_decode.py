@@ -0,0 +1,201 @@
+#!/usr/bin/env python3
+#
+# trace_decode.py
+# Decoder of the scheduler and interrupt trace of trace_ring.c
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+"""Decode the scheduler/interrupt trace recorded by trace_ring.c.
+
+Input is either a console log containing the output of trace_ring_dump()
+(lines "trace-begin", "trace-task", "trace", "trace-end"; the last complete
+dump is used), or a raw memory image of s_traceRing saved by the debugger
+(--binary, optionally with --cpu-hz if the image is incomplete).
+
+For each task the IRQ to task wake latency is reported: the time from the
+entry of an interrupt that made the task ready to the moment the task starts
+running. Interrupt handler durations are reported per exception number, for
+the handlers whose exit was traced (those ending with portYIELD_FROM_ISR).
+
+Handlers only record their entry. Each record carries the exception number
+it was made in (0 in a task), which tells when a handler has returned without
+an exit record: an event of the exception it interrupted, or one made in a
+task or in PendSV (the lowest priority, so no handler is active any more).
+
+Usage:
+    trace_decode.py [--binary] [--csv] FILE
+"""
+
+import argparse
+import struct
+import sys
+
+MAGIC = 0x54524352
+
+EV_SWITCH_IN = 1
+EV_READY = 2
+EV_ISR_ENTER = 3
+EV_ISR_EXIT = 4
+EV_ISR_YIELD = 5
+EV_BLOCK_RECV = 6
+EV_BLOCK_SEND = 7
+
+# Contexts in which no other handler can be active
+CTX_THREAD = 0
+CTX_PENDSV = 14
+
+RECORD = struct.Struct("<IBBH")
+HEADER = struct.Struct("<IIIII")
+
+
+class Trace:
+    def __init__(self, cpu_hz, records, tasks):
+        self.cpu_hz = cpu_hz
+        self.records = records  # (time, type, id, ctx), time unwrapped to 64 bit
+        self.tasks = tasks  # task number -> name
+
+
+def unwrap(raw):
+    """Turn 32 bit cycle counts into a monotonic 64 bit timeline."""
+    out = []
+    base = 0
+    prev = None
+    for time, ev, ident, ctx in raw:
+        if prev is not None and time < prev:
+            base += 1 << 32
+        prev = time
+        out.append((base + time, ev, ident, ctx))
+    return out
+
+
+def parse_log(lines):
+    dump = None
+    current = None
+    for line in lines:
+        line = line.strip()
+        fields = line.split(",")
+        if fields[0] == "trace-begin":
+            current = {"cpu_hz": int(fields[1]), "tasks": {}, "records": []}
+        elif current is None:
+            continue
+        elif fields[0] == "trace-task":
+            current["tasks"][int(fields[1])] = ",".join(fields[2:])
+        elif fields[0] == "trace":
+            current["records"].append((int(fields[1], 16), int(fields[2]), int(fields[3]), int(fields[4])))
+        elif fields[0] == "trace-end":
+            dump = current
+            current = None
+    if dump is None:
+        raise ValueError("no complete trace dump found")
+    return Trace(dump["cpu_hz"], unwrap(dump["records"]), dump["tasks"])
+
+
+def parse_binary(data, cpu_hz=None):
+    magic, head, size, hz, _enabled = HEADER.unpack_from(data, 0)
+    if magic != MAGIC:
+        raise ValueError("bad magic 0x%08x" % magic)
+    if size & (size - 1):
+        raise ValueError("bad ring size %d" % size)
+    first = head - size if head > size else 0
+    raw = []
+    for seq in range(first, head):
+        offset = HEADER.size + (seq & (size - 1)) * RECORD.size
+        time, ev, ctx, ident = RECORD.unpack_from(data, offset)
+        raw.append((time, ev, ident, ctx))
+    return Trace(cpu_hz or hz, unwrap(raw), {})
+
+
+def percentile(values, pct):
+    """Nearest rank percentile of a sorted list."""
+    if not values:
+        return 0
+    rank = max(1, -(-pct * len(values) // 100))
+    return values[int(rank) - 1]
+
+
+def analyze(trace):
+    """Returns ({task: [latency cycles]}, {exception: [duration cycles]})."""
+    wake = {}
+    isr_time = {}
+    isr_stack = []  # (exception, enter time) of the handlers still running
+    pending = {}  # task -> enter time of the interrupt which readied it
+
+    for time, ev, ident, ctx in trace.records:
+        # Handlers above the one recording have returned without an exit record
+        if ctx in (CTX_THREAD, CTX_PENDSV):
+            del isr_stack[:]
+        else:
+            for depth in range(len(isr_stack) - 1, -1, -1):
+                if isr_stack[depth][0] == ctx:
+                    # A new entry also ends an earlier run of the same handler
+                    del isr_stack[depth if ev == EV_ISR_ENTER else depth + 1:]
+                    break
+
+        if ev == EV_ISR_ENTER:
+            isr_stack.append((ident, time))
+        elif ev in (EV_ISR_EXIT, EV_ISR_YIELD):
+            # Records may start in the middle of a handler
+            if isr_stack and isr_stack[-1][0] == ident:
+                exc, enter = isr_stack.pop()
+                isr_time.setdefault(exc, []).append(time - enter)
+        elif ev == EV_READY:
+            # Only tasks readied by a traced handler, not from a task or SysTick
+            if isr_stack and isr_stack[-1][0] == ctx and ident not in pending:
+                pending[ident] = isr_stack[0][1]
+        elif ev == EV_SWITCH_IN:
+            if ident in pending:
+                wake.setdefault(ident, []).append(time - pending.pop(ident))
+        elif ev in (EV_BLOCK_RECV, EV_BLOCK_SEND):
+            pending.pop(ident, None)
+    return wake, isr_time
+
+
+def report(trace, out, csv):
+    wake, isr_time = analyze(trace)
+    scale = 1e6 / trace.cpu_hz if trace.cpu_hz else 1.0
+    unit = "us" if trace.cpu_hz else "cycles"
+
+    rows = []
+    for task, values in sorted(wake.items()):
+        name = trace.tasks.get(task, "#%d" % task)
+        rows.append(("wake", name, sorted(values)))
+    for exc, values in sorted(isr_time.items()):
+        name = "IRQ%d" % (exc - 16) if exc >= 16 else "exc%d" % exc
+        rows.append(("isr", name, sorted(values)))
+
+    if csv:
+        out.write("kind,name,count,p50_%s,p90_%s,p99_%s,max_%s\n" % ((unit,) * 4))
+    else:
+        out.write("%d records, times in %s\n" % (len(trace.records), unit))
+        out.write("%-5s %-20s %8s %10s %10s %10s %10s\n" % ("kind", "name", "count", "p50", "p90", "p99", "max"))
+    for kind, name, values in rows:
+        stats = [percentile(values, p) * scale for p in (50, 90, 99)] + [values[-1] * scale]
+        if csv:
+            out.write("%s,%s,%d,%s\n" % (kind, name, len(values), ",".join("%.2f" % s for s in stats)))
+        else:
+            out.write("%-5s %-20s %8d %10.2f %10.2f %10.2f %10.2f\n" % ((kind, name, len(values)) + tuple(stats)))
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Decode trace_ring.c traces")
+    parser.add_argument("--binary", action="store_true", help="input is a memory image of s_traceRing")
+    parser.add_argument("--cpu-hz", type=int, help="override the recorded CPU clock")
+    parser.add_argument("--csv", action="store_true", help="machine readable output")
+    parser.add_argument("file")
+    args = parser.parse_args()
+
+    if args.binary:
+        with open(args.file, "rb") as f:
+            trace = parse_binary(f.read(), args.cpu_hz)
+    else:
+        with open(args.file, "r", errors="replace") as f:
+            trace = parse_log(f)
+        if args.cpu_hz:
+            trace.cpu_hz = args.cpu_hz
+
+    report(trace, sys.stdout, args.csv)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
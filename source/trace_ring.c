@@ -0,0 +1,129 @@
+/*
+ * trace_ring.c
+ * Binary trace of scheduler and interrupt events, see trace_ring.h.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_common.h"
+#include "fsl_debug_console.h"
+
+#if configUSE_TRACE_RING
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+
+#if (TRACE_RING_SIZE & (TRACE_RING_SIZE - 1U)) != 0U
+#error "TRACE_RING_SIZE must be a power of two"
+#endif
+
+/* Memory image of the trace, can be dumped by the debugger */
+typedef struct trace_ring
+{
+    uint32_t magic;
+    uint32_t head; /* total number of records written */
+    uint32_t size;
+    uint32_t cpu_hz;
+    volatile uint32_t enabled;
+    trace_record_t records[TRACE_RING_SIZE];
+} trace_ring_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+trace_ring_t s_traceRing;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+void trace_ring_init(void)
+{
+    MSDK_EnableCpuCycleCounter();
+
+    s_traceRing.magic   = TRACE_RING_MAGIC;
+    s_traceRing.head    = 0;
+    s_traceRing.size    = TRACE_RING_SIZE;
+    s_traceRing.cpu_hz  = SystemCoreClock;
+    s_traceRing.enabled = 1;
+}
+
+void trace_ring_record(uint32_t type, uint32_t id)
+{
+    UBaseType_t mask;
+    trace_record_t *record;
+
+    if (s_traceRing.enabled == 0U)
+    {
+        return;
+    }
+
+    mask   = portSET_INTERRUPT_MASK_FROM_ISR();
+    record = &s_traceRing.records[s_traceRing.head & (TRACE_RING_SIZE - 1U)];
+
+    record->time = DWT->CYCCNT;
+    record->type = (uint8_t)type;
+    record->ctx  = (uint8_t)__get_IPSR();
+    record->id   = (uint16_t)id;
+    s_traceRing.head++;
+    portCLEAR_INTERRUPT_MASK_FROM_ISR(mask);
+}
+
+void trace_ring_record_current(uint32_t type)
+{
+    trace_ring_record(type, uxTaskGetTaskNumber(xTaskGetCurrentTaskHandle()));
+}
+
+void trace_ring_isr(uint32_t type)
+{
+    uint32_t exception = __get_IPSR();
+
+#if !TRACE_RING_SYSTICK
+    if (exception == ((uint32_t)SysTick_IRQn + 16U))
+    {
+        return;
+    }
+#endif
+    trace_ring_record(type, exception);
+}
+
+void trace_ring_dump(void)
+{
+    UBaseType_t count = uxTaskGetNumberOfTasks();
+    TaskStatus_t *status;
+    uint32_t first;
+    uint32_t i;
+
+    s_traceRing.enabled = 0;
+
+    first = (s_traceRing.head > TRACE_RING_SIZE) ? (s_traceRing.head - TRACE_RING_SIZE) : 0U;
+    PRINTF("trace-begin,%u,%u\r\n", (unsigned int)s_traceRing.cpu_hz, (unsigned int)(s_traceRing.head - first));
+
+    status = pvPortMalloc(count * sizeof(TaskStatus_t));
+    if (status != NULL)
+    {
+        count = uxTaskGetSystemState(status, count, NULL);
+        for (i = 0; i < count; i++)
+        {
+            PRINTF("trace-task,%u,%s\r\n", (unsigned int)status[i].xTaskNumber, status[i].pcTaskName);
+        }
+        vPortFree(status);
+    }
+
+    for (i = first; i != s_traceRing.head; i++)
+    {
+        const trace_record_t *record = &s_traceRing.records[i & (TRACE_RING_SIZE - 1U)];
+
+        PRINTF("trace,%08x,%u,%u,%u\r\n", (unsigned int)record->time, (unsigned int)record->type,
+               (unsigned int)record->id, (unsigned int)record->ctx);
+    }
+    PRINTF("trace-end\r\n");
+
+    s_traceRing.head    = 0;
+    s_traceRing.enabled = 1;
+}
+
+#endif /* configUSE_TRACE_RING */
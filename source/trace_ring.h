@@ -0,0 +1,80 @@
+/*
+ * trace_ring.h
+ * Binary trace of scheduler and interrupt events
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TRACE_RING_H
+#define TRACE_RING_H
+
+#include <stdint.h>
+
+/*
+ * Binary trace of scheduler and interrupt events, enabled by
+ * configUSE_TRACE_RING in FreeRTOSConfig.h (which includes this header and
+ * maps the FreeRTOS trace hooks onto it).
+ *
+ * Each event is an 8 byte record, little endian:
+ *   u32 time   DWT cycle counter
+ *   u8  type   TRACE_EV_xxx
+ *   u8  ctx    exception number the event was recorded in, 0 in a task
+ *   u16 id     task number (TaskStatus_t.xTaskNumber) or exception number
+ *
+ * Interrupt handlers only record their entry. The exit is recorded by the
+ * port when the handler ends with portYIELD_FROM_ISR; for handlers returning
+ * without it the decoder finds the end from ctx of the following events.
+ *
+ * trace_ring_dump() (console command "trace") prints the ring together with
+ * the task names; feed the console log to source/tools/trace_decode.py to get IRQ to task wake latencies.
+ * The ring can also be saved from memory by the debugger (s_traceRing) and
+ * decoded with --binary.
+ */
+
+/* Number of records, power of two */
+#ifndef TRACE_RING_SIZE
+#define TRACE_RING_SIZE 1024U
+#endif
+
+/* Also trace the SysTick interrupt (fills the ring with a record per tick) */
+#ifndef TRACE_RING_SYSTICK
+#define TRACE_RING_SYSTICK 0
+#endif
+
+#define TRACE_RING_MAGIC 0x54524352U /* "RCRT" */
+
+#define TRACE_EV_SWITCH_IN   1U /* task starts running */
+#define TRACE_EV_READY       2U /* task moved to the ready list */
+#define TRACE_EV_ISR_ENTER   3U
+#define TRACE_EV_ISR_EXIT    4U /* returns to the interrupted task */
+#define TRACE_EV_ISR_YIELD   5U /* returns through a context switch */
+#define TRACE_EV_BLOCK_RECV  6U /* task blocks on a queue/semaphore receive */
+#define TRACE_EV_BLOCK_SEND  7U /* task blocks on a full queue */
+
+typedef struct trace_record
+{
+    uint32_t time;
+    uint8_t type;
+    uint8_t ctx;
+    uint16_t id;
+} trace_record_t;
+
+/* Enables the cycle counter and starts recording; call before the scheduler starts. */
+void trace_ring_init(void);
+void trace_ring_record(uint32_t type, uint32_t id);
+void trace_ring_record_current(uint32_t type);
+void trace_ring_isr(uint32_t type);
+/* Prints the trace and clears it. */
+void trace_ring_dump(void);
+
+/* FreeRTOS hooks (the TCB macros only expand in tasks.c) */
+#define traceTASK_CREATE(pxNewTCB)            ((pxNewTCB)->uxTaskNumber = (pxNewTCB)->uxTCBNumber)
+#define traceTASK_SWITCHED_IN()               trace_ring_record(TRACE_EV_SWITCH_IN, pxCurrentTCB->uxTCBNumber)
+#define traceMOVED_TASK_TO_READY_STATE(pxTCB) trace_ring_record(TRACE_EV_READY, (pxTCB)->uxTCBNumber)
+#define traceBLOCKING_ON_QUEUE_RECEIVE(pxQueue) trace_ring_record_current(TRACE_EV_BLOCK_RECV)
+#define traceBLOCKING_ON_QUEUE_SEND(pxQueue)    trace_ring_record_current(TRACE_EV_BLOCK_SEND)
+#define traceISR_ENTER()                      trace_ring_isr(TRACE_EV_ISR_ENTER)
+#define traceISR_EXIT()                       trace_ring_isr(TRACE_EV_ISR_EXIT)
+#define traceISR_EXIT_TO_SCHEDULER()          trace_ring_isr(TRACE_EV_ISR_YIELD)
+
+#endif /* TRACE_RING_H */
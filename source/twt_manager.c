@@ -0,0 +1,274 @@
+/*
+ * twt_manager.c
+ * Individual TWT agreement sized to the periodic traffic of the application,
+ * see twt_manager.h.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include "twt_manager.h"
+
+#include "FreeRTOS.h"
+#include "task.h"
+#include "fsl_debug_console.h"
+#include "wpl.h"
+
+#include <stdbool.h>
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+typedef struct twt_flow
+{
+    uint32_t period_ms;
+    uint32_t awake_ms;
+} twt_flow_t;
+
+typedef struct twt_params
+{
+    uint32_t interval_ms;
+    uint32_t wake_ms;
+} twt_params_t;
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+static TaskHandle_t s_twtTask;
+
+/* Written by the callers, under critical section */
+static twt_flow_t s_flows[TWT_MANAGER_MAX_FLOWS];
+static bool s_linkUp;
+static uint32_t s_linkEpoch; /* counts association changes */
+
+/* Owned by the manager task */
+static volatile twt_state_t s_state = TWT_STATE_IDLE;
+static uint32_t s_seenEpoch;
+static twt_params_t s_agreed;   /* valid in TWT_STATE_ACTIVE */
+static twt_params_t s_rejected; /* valid in TWT_STATE_REJECTED */
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+static uint32_t twt_gcd(uint32_t a, uint32_t b)
+{
+    while (b != 0U)
+    {
+        uint32_t t = a % b;
+        a          = b;
+        b          = t;
+    }
+    return a;
+}
+
+/* Agreement wanted for the registered flows, interval 0 if none */
+static twt_params_t twt_manager_wanted(void)
+{
+    twt_params_t p       = {0U, 0U};
+    uint32_t shortest_ms = 0U;
+    uint32_t i;
+
+    for (i = 0; i < TWT_MANAGER_MAX_FLOWS; i++)
+    {
+        const twt_flow_t *flow = &s_flows[i];
+
+        if (flow->period_ms == 0U)
+        {
+            continue;
+        }
+        p.interval_ms = (p.interval_ms == 0U) ? flow->period_ms : twt_gcd(p.interval_ms, flow->period_ms);
+        if ((shortest_ms == 0U) || (flow->period_ms < shortest_ms))
+        {
+            shortest_ms = flow->period_ms;
+        }
+        if (flow->awake_ms > p.wake_ms)
+        {
+            p.wake_ms = flow->awake_ms;
+        }
+    }
+
+    if ((p.interval_ms != 0U) && (p.interval_ms < TWT_MANAGER_MIN_INTERVAL_MS))
+    {
+        /* Occurrences of the other flows wait at most one interval */
+        p.interval_ms = shortest_ms;
+    }
+    if ((p.interval_ms < TWT_MANAGER_MIN_INTERVAL_MS) || (p.wake_ms >= p.interval_ms))
+    {
+        /* Radio has to stay awake */
+        p.interval_ms = 0U;
+    }
+    if (p.wake_ms == 0U)
+    {
+        p.wake_ms = 1U;
+    }
+    else if (p.wake_ms > TWT_MANAGER_MAX_WAKE_MS)
+    {
+        p.wake_ms = TWT_MANAGER_MAX_WAKE_MS;
+    }
+    return p;
+}
+
+static bool twt_params_equal(const twt_params_t *a, const twt_params_t *b)
+{
+    return (a->interval_ms == b->interval_ms) && (a->wake_ms == b->wake_ms);
+}
+
+static void twt_manager_teardown(void)
+{
+    if (s_state == TWT_STATE_ACTIVE)
+    {
+        (void)WPL_TwtTeardown(TWT_MANAGER_FLOW_ID);
+        s_state = TWT_STATE_IDLE;
+    }
+}
+
+static void twt_manager_update(void)
+{
+    twt_params_t wanted;
+    bool link_up;
+    uint32_t epoch;
+    wpl_ret_t ret;
+
+    taskENTER_CRITICAL();
+    link_up = s_linkUp;
+    epoch   = s_linkEpoch;
+    wanted  = twt_manager_wanted();
+    taskEXIT_CRITICAL();
+
+    if (epoch != s_seenEpoch)
+    {
+        /* Agreements and AP capabilities end with the association */
+        s_seenEpoch = epoch;
+        s_state     = TWT_STATE_IDLE;
+    }
+    if (!link_up)
+    {
+        return;
+    }
+
+    if ((s_state == TWT_STATE_UNSUPPORTED) ||
+        ((s_state == TWT_STATE_ACTIVE) && twt_params_equal(&wanted, &s_agreed)) ||
+        ((s_state == TWT_STATE_REJECTED) && twt_params_equal(&wanted, &s_rejected)))
+    {
+        return;
+    }
+
+    twt_manager_teardown();
+
+    if (wanted.interval_ms == 0U)
+    {
+        s_state = TWT_STATE_IDLE;
+        return;
+    }
+
+    if (!WPL_TwtSupported())
+    {
+        PRINTF("[i] TWT not supported by the AP, radio stays awake\r\n");
+        s_state = TWT_STATE_UNSUPPORTED;
+        return;
+    }
+
+    ret = WPL_TwtSetup(wanted.interval_ms * 1000U, wanted.wake_ms * 1000U, TWT_MANAGER_FLOW_ID);
+    if (ret == WPLRET_SUCCESS)
+    {
+        PRINTF("[i] TWT agreement: wake %u ms every %u ms\r\n", (unsigned int)wanted.wake_ms,
+               (unsigned int)wanted.interval_ms);
+        s_agreed = wanted;
+        s_state  = TWT_STATE_ACTIVE;
+    }
+    else
+    {
+        PRINTF("[!] TWT agreement (wake %u ms every %u ms) rejected: %d\r\n", (unsigned int)wanted.wake_ms,
+               (unsigned int)wanted.interval_ms, (int)ret);
+        s_rejected = wanted;
+        s_state    = TWT_STATE_REJECTED;
+    }
+}
+
+static void twt_manager_task(void *arg)
+{
+    (void)arg;
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        /* Let a burst of changes settle before talking to the AP */
+        while (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(TWT_MANAGER_SETTLE_MS)) != 0U)
+        {
+        }
+        twt_manager_update();
+    }
+}
+
+static void twt_manager_kick(void)
+{
+    if (s_twtTask != NULL)
+    {
+        (void)xTaskNotifyGive(s_twtTask);
+    }
+}
+
+int twt_manager_init(void)
+{
+    if (s_twtTask != NULL)
+    {
+        return 0;
+    }
+    if (xTaskCreate(twt_manager_task, "twt_manager", TWT_MANAGER_TASK_STACKSIZE, NULL, tskIDLE_PRIORITY + 1,
+                    &s_twtTask) != pdPASS)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+int twt_manager_set_flow(uint8_t id, uint32_t period_ms, uint32_t awake_ms)
+{
+    bool changed;
+
+    if (id >= TWT_MANAGER_MAX_FLOWS)
+    {
+        return -1;
+    }
+
+    taskENTER_CRITICAL();
+    changed = (s_flows[id].period_ms != period_ms) || (s_flows[id].awake_ms != awake_ms);
+    s_flows[id].period_ms = period_ms;
+    s_flows[id].awake_ms  = awake_ms;
+    taskEXIT_CRITICAL();
+
+    if (changed)
+    {
+        twt_manager_kick();
+    }
+    return 0;
+}
+
+void twt_manager_link_up(void)
+{
+    taskENTER_CRITICAL();
+    if (s_linkUp != true)
+    {
+        s_linkUp = true;
+        s_linkEpoch++;
+    }
+    taskEXIT_CRITICAL();
+    twt_manager_kick();
+}
+
+void twt_manager_link_down(void)
+{
+    taskENTER_CRITICAL();
+    if (s_linkUp != false)
+    {
+        s_linkUp = false;
+        s_linkEpoch++;
+    }
+    taskEXIT_CRITICAL();
+    twt_manager_kick();
+}
+
+twt_state_t twt_manager_state(void)
+{
+    return s_state;
+}
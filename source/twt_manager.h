@@ -0,0 +1,79 @@
+/*
+ * twt_manager.h
+ * Target Wake Time session manager
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef TWT_MANAGER_H
+#define TWT_MANAGER_H
+
+#include <stdint.h>
+
+/*
+ * Target Wake Time session manager. The application registers its periodic
+ * traffic (period and how long the radio has to stay awake per occurrence),
+ * the manager keeps one individual TWT agreement with the AP sized to it:
+ *
+ *   interval  greatest common divisor of the registered periods, so every
+ *             occurrence falls on a service period; when that is shorter
+ *             than TWT_MANAGER_MIN_INTERVAL_MS the shortest period is used
+ *   duration  longest registered awake time
+ *
+ * The agreement is renegotiated (teardown + setup) when the registered
+ * traffic changes. Changes are applied by a low priority task after
+ * TWT_MANAGER_SETTLE_MS without further changes, so a burst of updates costs
+ * one negotiation. Without TWT support on the AP, or when the AP rejects the
+ * agreement, the radio simply stays awake; a rejected agreement is retried
+ * only once the traffic changes or the link is reestablished.
+ *
+ * All functions except twt_manager_init() may be called from any task.
+ */
+
+#ifndef TWT_MANAGER_MAX_FLOWS
+#define TWT_MANAGER_MAX_FLOWS 4U
+#endif
+
+/* Shortest service period interval worth negotiating */
+#ifndef TWT_MANAGER_MIN_INTERVAL_MS
+#define TWT_MANAGER_MIN_INTERVAL_MS 50U
+#endif
+
+/* Longest service period TWT can describe (255 units of 256 us) */
+#define TWT_MANAGER_MAX_WAKE_MS 65U
+
+#ifndef TWT_MANAGER_SETTLE_MS
+#define TWT_MANAGER_SETTLE_MS 500U
+#endif
+
+/* TWT flow identifier used for the agreement */
+#ifndef TWT_MANAGER_FLOW_ID
+#define TWT_MANAGER_FLOW_ID 0U
+#endif
+
+#ifndef TWT_MANAGER_TASK_STACKSIZE
+#define TWT_MANAGER_TASK_STACKSIZE 384U
+#endif
+
+typedef enum twt_state
+{
+    TWT_STATE_IDLE,        /* not connected or no periodic traffic */
+    TWT_STATE_ACTIVE,      /* agreement in place */
+    TWT_STATE_UNSUPPORTED, /* AP or firmware without TWT */
+    TWT_STATE_REJECTED,    /* AP refused the agreement */
+} twt_state_t;
+
+/* Starts the manager task. */
+int twt_manager_init(void);
+
+/* Registers, updates or (period_ms 0) removes periodic traffic.
+ * id is chosen by the caller, below TWT_MANAGER_MAX_FLOWS. */
+int twt_manager_set_flow(uint8_t id, uint32_t period_ms, uint32_t awake_ms);
+
+/* STA association state, agreements are negotiated only while connected. */
+void twt_manager_link_up(void);
+void twt_manager_link_down(void);
+
+twt_state_t twt_manager_state(void);
+
+#endif /* TWT_MANAGER_H */
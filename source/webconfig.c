@@ -21,10 +21,17 @@
 #include "fsl_debug_console.h"
 #include "webconfig.h"
 #include "cred_flash_storage.h"
+#include "stack_profile.h"
+#include "serial_cmd.h"
+#include "twt_manager.h"
+#include "chan_select.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
 #include "FreeRTOS.h"
+#include "queue.h"
 
 #include "mqtt_freertos.h"
 #include "lwip/netif.h"
@@ -41,10 +48,30 @@ static uint32_t SetBoardToClient();
 static uint32_t SetBoardToAP();
 static uint32_t CleanUpAP();
 static uint32_t CleanUpClient();
+static void CMD_HandleUserChoice(int argc, char **argv);
+static void CMD_HandleInterval(int argc, char **argv);
+#if LWIP_PERF
+static void CMD_HandlePerf(int argc, char **argv);
+#endif
+#if configUSE_TRACE_RING
+static void CMD_HandleTrace(int argc, char **argv);
+#endif
+static void WaitForStateSwitch(void);
+static void RestoreChanMetrics(void);
+static void SaveChanMetrics(void);
+#if LWIP_DHCP_INIT_REBOOT
+static void RestoreDhcpLease(const char *ssid);
+static void SaveDhcpLease(const char *ssid);
+static void DhcpLeaseChangeCallback(void);
+#endif
 
 /*******************************************************************************
  * Definitions
  ******************************************************************************/
+/* Notifications of the main task */
+#define MAIN_NOTIFY_SWITCH_STATE (1UL << 0) /* g_BoardState.wifiState changed */
+#define MAIN_NOTIFY_SAVE_LEASE   (1UL << 1) /* the DHCP lease changed */
+
 typedef enum board_wifi_states
 {
     WIFI_STATE_CLIENT,
@@ -72,11 +99,36 @@ const HTTPSRV_CGI_LINK_STRUCT cgi_lnk_tbl[] = {
     {0, 0} // DO NOT REMOVE - last item - end of table
 };
 
+static const serial_cmd_t webconfig_cmds[] = {
+    {"r", "reset to AP mode after a failed connection", CMD_HandleUserChoice},
+    {"a", "retry a failed connection", CMD_HandleUserChoice},
+    {"interval", "<ms> set the telemetry upload interval", CMD_HandleInterval},
+#if LWIP_PERF
+    {"perf", "[mark|reset] print section cycle counts, compared with the marked ones", CMD_HandlePerf},
+#endif
+#if configUSE_TRACE_RING
+    {"trace", "print and clear the scheduler and interrupt trace", CMD_HandleTrace},
+#endif
+};
+
+#if LWIP_PERF
+/* Allowed increase of a section average over its marked one, in percent */
+#define PERF_TOLERANCE 10U
+#endif
+
 /*******************************************************************************
  * Variables
  ******************************************************************************/
 struct board_state_variables g_BoardState;
 
+/* Choice of the user after a failed connection, filled by the command task */
+static QueueHandle_t s_userChoice;
+
+#if LWIP_DHCP_INIT_REBOOT
+/* Network the DHCP lease belongs to, set by SaveDhcpLease() at the join */
+static char s_leaseSsid[WPL_WIFI_SSID_LENGTH + 1];
+#endif
+
 /*******************************************************************************
  * Code
  ******************************************************************************/
@@ -207,6 +259,9 @@ static int CGI_HandlePost(HTTPSRV_CGI_REQ_STRUCT *param)
 
     if (err == false)
     {
+#if LWIP_DHCP_INIT_REBOOT
+        RestoreDhcpLease(posted_ssid);
+#endif
         /* Initiate joining process */
         PRINTF("[i] Joining: %s\r\n", posted_ssid);
         result = WPL_Join(WIFI_NETWORK_LABEL);
@@ -249,11 +304,14 @@ static int CGI_HandlePost(HTTPSRV_CGI_REQ_STRUCT *param)
         g_BoardState.connected = true;
         /* Since the Joining was successful, we can save the credentials to the Flash */
         save_wifi_credentials(CONNECTION_INFO_FILENAME, posted_ssid, posted_passphrase, posted_security);
+#if LWIP_DHCP_INIT_REBOOT
+        SaveDhcpLease(posted_ssid);
+#endif
 
         /* Resume the main task, this will make sure to clean up and shut down the AP*/
         /* Since g_BoardState.connected == true, the reconnection to AP will be skipped and
          * the main task will be put back to sleep waiting for a reset event */
-        vTaskResume(g_BoardState.mainTask);
+        (void)xTaskNotify(g_BoardState.mainTask, MAIN_NOTIFY_SWITCH_STATE, eSetBits);
     }
 
     return (response.content_length);
@@ -294,7 +352,7 @@ static int CGI_HandleReset(HTTPSRV_CGI_REQ_STRUCT *param)
         g_BoardState.wifiState = WIFI_STATE_AP;
         g_BoardState.connected = false;
 
-        vTaskResume(g_BoardState.mainTask);
+        (void)xTaskNotify(g_BoardState.mainTask, MAIN_NOTIFY_SWITCH_STATE, eSetBits);
     }
 
     return 0;
@@ -359,12 +417,17 @@ static void LinkStatusChangeCallback(bool linkState)
         /* -------- LINK LOST -------- */
         /* DO SOMETHING */
         PRINTF("-------- LINK LOST --------\r\n");
+        twt_manager_link_down();
     }
     else
     {
         /* -------- LINK REESTABLISHED -------- */
         /* DO SOMETHING */
         PRINTF("-------- LINK REESTABLISHED --------\r\n");
+        if (g_BoardState.wifiState == WIFI_STATE_CLIENT)
+        {
+            twt_manager_link_up();
+        }
     }
 }
 
@@ -379,6 +442,17 @@ static void main_task(void *arg)
         "\r\n"
         "Starting webconfig DEMO\r\n");
 
+    stack_profile_start();
+
+    s_userChoice = xQueueCreate(1, sizeof(char));
+    if ((s_userChoice == NULL) || (serial_cmd_init() != 0) ||
+        (serial_cmd_register(webconfig_cmds, sizeof(webconfig_cmds) / sizeof(webconfig_cmds[0])) != 0))
+    {
+        PRINTF("[!] Console command setup failed\r\n");
+        while (1)
+            __BKPT(0);
+    }
+
     /* When the App starts up, it will first read the mflash to check if any
      * credentials have been saved from previous runs.
      * If the mflash is empty, the board starts and AP allowing the user to configure
@@ -434,6 +508,20 @@ static void main_task(void *arg)
 
     WC_DEBUG("[i] Successfully initialized Wi-Fi module\r\n");
 
+#if LWIP_DHCP_INIT_REBOOT
+    /* Saves leases granted after the join, e.g. a new address after the kept one was refused */
+    WPL_SetDhcpLeaseCallback(DhcpLeaseChangeCallback);
+#endif
+
+    if (twt_manager_init() != 0)
+    {
+        PRINTF("[!] TWT manager creation failed\r\n");
+    }
+
+    /* Collects channel metrics from the scans for the AP, starting from the saved ones */
+    chan_select_init();
+    RestoreChanMetrics();
+
     /* Start WebServer */
     if (xTaskCreate(http_srv_task, "http_srv_task", HTTPD_STACKSIZE, NULL, HTTPD_PRIORITY, NULL) != pdPASS)
     {
@@ -458,17 +546,21 @@ static void main_task(void *arg)
             /*case WIFI_STATE_CLIENT:
                 SetBoardToClient();
                 // Suspend here until its time to swtich back to AP
-                vTaskSuspend(NULL);
+                WaitForStateSwitch();
                 CleanUpClient();
                 break;*/
 
 			case WIFI_STATE_CLIENT:
 				SetBoardToClient();
+				if (g_BoardState.connected)
+				{
+					twt_manager_link_up();
+				}
 				/* ↓ Aquí arrancamos el MQTT thread ↓ */
 				PRINTF("[i] Wi-Fi conectado, arrancando thread MQTT...\r\n");
 				mqtt_freertos_run_thread(netif_default);
 				/* …y luego, si toca, suspendemos esta tarea: */
-				vTaskSuspend(NULL);
+				WaitForStateSwitch();
 				CleanUpClient();
 				break;
 
@@ -476,7 +568,7 @@ static void main_task(void *arg)
             default:
                 SetBoardToAP();
                 /* Suspend here until its time to stop the AP */
-                vTaskSuspend(NULL);
+                WaitForStateSwitch();
                 CleanUpAP();
         }
     }
@@ -486,14 +578,18 @@ static void main_task(void *arg)
 static uint32_t SetBoardToAP()
 {
     uint32_t result;
+    int channel;
 
     /* Set the global ssid and password to the default AP ssid and password */
     strcpy(g_BoardState.ssid, WIFI_SSID);
     strcpy(g_BoardState.password, WIFI_PASSWORD);
 
+    /* Least crowded channel according to the recent scans, no scan here */
+    channel = chan_select_channel(WIFI_AP_CHANNEL);
+
     /* Start the access point */
-    PRINTF("Starting Access Point: SSID: %s, Chnl: %d\r\n", g_BoardState.ssid, WIFI_AP_CHANNEL);
-    result = WPL_Start_AP(g_BoardState.ssid, g_BoardState.password, WIFI_AP_CHANNEL);
+    PRINTF("Starting Access Point: SSID: %s, Chnl: %d\r\n", g_BoardState.ssid, channel);
+    result = WPL_Start_AP(g_BoardState.ssid, g_BoardState.password, channel);
 
     if (result != WPLRET_SUCCESS)
     {
@@ -507,6 +603,19 @@ static uint32_t SetBoardToAP()
     WPL_GetIP(ip, 0);
     PRINTF(" Now join that network on your device and connect to this IP: %s\r\n", ip);
 
+    if (!chan_select_has_data())
+    {
+        /* The AP is already reachable, seed the channel metrics for its next start.
+         * The scan leaves the AP channel for seconds, see chan_select.h, done once per board. */
+        char *ssids = WPL_Scan();
+
+        if (ssids != NULL)
+        {
+            vPortFree(ssids);
+            SaveChanMetrics();
+        }
+    }
+
     return 0;
 }
 
@@ -516,6 +625,9 @@ static uint32_t CleanUpAP()
     /* Give time for reply message to reach the web interface before destorying the conection */
     vTaskDelay(10000 / portTICK_PERIOD_MS);
 
+    /* Keep what the scans of the web page added to the channel metrics */
+    SaveChanMetrics();
+
     WC_DEBUG("[i] Stopping AP!\r\n");
     if (WPL_Stop_AP() != WPLRET_SUCCESS)
     {
@@ -546,6 +658,9 @@ static uint32_t SetBoardToClient()
         if (result == WPLRET_SUCCESS)
         {
             PRINTF("Connecting as client to ssid: %s with password %s\r\n", g_BoardState.ssid, g_BoardState.password);
+#if LWIP_DHCP_INIT_REBOOT
+            RestoreDhcpLease(g_BoardState.ssid);
+#endif
             result = WPL_Join(WIFI_NETWORK_LABEL);
         }
 
@@ -554,16 +669,16 @@ static uint32_t SetBoardToClient()
             PRINTF("[!] Cannot connect to Wi-Fi\r\n[!]ssid: %s\r\n[!]passphrase: %s\r\n", g_BoardState.ssid,
                    g_BoardState.password);
             char c;
+
+            /* Drop a choice entered before the prompt */
+            (void)xQueueReset(s_userChoice);
             do
             {
-                PRINTF("[i] To reset the board to AP mode, press 'r'.\r\n");
-                PRINTF("[i] In order to try connecting again press 'a'.\r\n");
+                PRINTF("[i] To reset the board to AP mode, enter 'r'.\r\n");
+                PRINTF("[i] In order to try connecting again enter 'a'.\r\n");
 
-                do
-                {
-                    c = GETCHAR();
-                    // Skip over \n and \r and don't print the prompt again, just get next char
-                } while (c == '\n' || c == '\r');
+                /* Filled by the command task, see CMD_HandleUserChoice() */
+                (void)xQueueReceive(s_userChoice, &c, portMAX_DELAY);
 
                 switch (c)
                 {
@@ -597,6 +712,9 @@ static uint32_t SetBoardToClient()
             PRINTF("[i] Connected to Wi-Fi\r\nssid: %s\r\n[!]passphrase: %s\r\n", g_BoardState.ssid,
                    g_BoardState.password);
             g_BoardState.connected = true;
+#if LWIP_DHCP_INIT_REBOOT
+            SaveDhcpLease(g_BoardState.ssid);
+#endif
             char ip[16];
             WPL_GetIP(ip, 1);
             PRINTF(" Now join that network on your device and connect to this IP: %s\r\n", ip);
@@ -605,12 +723,83 @@ static uint32_t SetBoardToClient()
     return 0;
 }
 
+/* Console commands answering the prompt of SetBoardToClient() */
+static void CMD_HandleUserChoice(int argc, char **argv)
+{
+    char c = argv[0][0];
+
+    (void)argc;
+
+    /* Keep only the latest choice */
+    (void)xQueueOverwrite(s_userChoice, &c);
+}
+
+/* Console command changing the publish cadence, the TWT agreement follows it */
+static void CMD_HandleInterval(int argc, char **argv)
+{
+    long interval_ms = (argc > 1) ? strtol(argv[1], NULL, 10) : 0;
+
+    if (interval_ms <= 0)
+    {
+        PRINTF("Usage: interval <ms>\r\n");
+        return;
+    }
+    mqtt_freertos_set_upload_interval((uint32_t)interval_ms);
+}
+
+#if LWIP_PERF
+/* Console command printing the PERF_START/PERF_STOP statistics. "perf mark"
+ * keeps the current averages as baseline and starts a new run, so that
+ * following "perf" reports the sections which got slower since then. */
+static void CMD_HandlePerf(int argc, char **argv)
+{
+    static lwip_perf_baseline_t s_baseline[LWIP_PERF_MAX_ENTRIES];
+    static size_t s_baselineCount;
+
+    if ((argc > 1) && (strcmp(argv[1], "mark") == 0))
+    {
+        s_baselineCount = lwip_perf_snapshot(s_baseline, LWIP_PERF_MAX_ENTRIES);
+        lwip_perf_reset();
+        PRINTF("Marked %u sections\r\n", (unsigned int)s_baselineCount);
+    }
+    else if ((argc > 1) && (strcmp(argv[1], "reset") == 0))
+    {
+        lwip_perf_reset();
+    }
+    else
+    {
+        lwip_perf_dump();
+        if (s_baselineCount != 0)
+        {
+            PRINTF("%d sections slower than marked\r\n",
+                   lwip_perf_compare(s_baseline, s_baselineCount, PERF_TOLERANCE));
+        }
+    }
+}
+#endif
+
+#if configUSE_TRACE_RING
+/* Console command printing the trace for source/tools/trace_decode.py */
+static void CMD_HandleTrace(int argc, char **argv)
+{
+    (void)argc;
+    (void)argv;
+
+    trace_ring_dump();
+}
+#endif
+
 /* Wait for any transmissions to finish and clean up the Client connection */
 static uint32_t CleanUpClient()
 {
     /* Give time for reply message to reach the web interface before destroying the connection */
     vTaskDelay(1000 / portTICK_PERIOD_MS);
 
+    /* Keep what the scans of the web page added to the channel metrics */
+    SaveChanMetrics();
+
+    twt_manager_link_down();
+
     /* Leave the external AP */
     if (WPL_Leave() != WPLRET_SUCCESS)
     {
@@ -627,6 +816,87 @@ static uint32_t CleanUpClient()
 
     return 0;
 }
+
+/* Block the main task until the Wi-Fi state is switched, saving changed DHCP leases meanwhile */
+static void WaitForStateSwitch(void)
+{
+    uint32_t notified = 0U;
+
+    while ((notified & MAIN_NOTIFY_SWITCH_STATE) == 0U)
+    {
+        (void)xTaskNotifyWait(0U, UINT32_MAX, &notified, portMAX_DELAY);
+#if LWIP_DHCP_INIT_REBOOT
+        if (((notified & MAIN_NOTIFY_SAVE_LEASE) != 0U) && (g_BoardState.wifiState == WIFI_STATE_CLIENT) &&
+            g_BoardState.connected)
+        {
+            SaveDhcpLease(s_leaseSsid);
+        }
+#endif
+    }
+}
+
+#if LWIP_DHCP_INIT_REBOOT
+/* Called from the TCP/IP thread, the flash is written by the main task */
+static void DhcpLeaseChangeCallback(void)
+{
+    (void)xTaskNotify(g_BoardState.mainTask, MAIN_NOTIFY_SAVE_LEASE, eSetBits);
+}
+
+/* Confirm the lease saved for the network at the next join, instead of discovering one */
+static void RestoreDhcpLease(const char *ssid)
+{
+    wpl_dhcp_lease_t lease;
+
+    if (get_saved_dhcp_lease(CONNECTION_INFO_FILENAME, ssid, &lease) == 0)
+    {
+        (void)WPL_SetDhcpLease(&lease);
+    }
+    else
+    {
+        (void)WPL_SetDhcpLease(NULL);
+    }
+}
+
+/* Keep the lease of the joined network for the next boot */
+static void SaveDhcpLease(const char *ssid)
+{
+    wpl_dhcp_lease_t lease;
+
+    /* Later lease changes are saved for this network */
+    if (ssid != s_leaseSsid)
+    {
+        (void)snprintf(s_leaseSsid, sizeof(s_leaseSsid), "%s", ssid);
+    }
+
+    if (WPL_GetDhcpLease(&lease) == WPLRET_SUCCESS)
+    {
+        (void)save_dhcp_lease(CONNECTION_INFO_FILENAME, ssid, &lease);
+    }
+}
+#endif
+
+/* Channel metrics of the previous runs, so that the first AP does not start on the fixed channel */
+static void RestoreChanMetrics(void)
+{
+    chan_select_state_t state;
+
+    if (get_saved_chan_metrics(CONNECTION_INFO_FILENAME, &state) == 0)
+    {
+        chan_select_restore(&state);
+    }
+}
+
+/* Keep the channel metrics for the next boot, the flash is written only if they changed */
+static void SaveChanMetrics(void)
+{
+    chan_select_state_t state;
+
+    if (chan_select_save(&state) != 0)
+    {
+        (void)save_chan_metrics(CONNECTION_INFO_FILENAME, &state);
+    }
+}
+
 /*!
  * @brief Main function.
  */
@@ -635,8 +905,12 @@ int main(void)
     /* Initialize the hardware */
     BOARD_InitHardware();
 
+#if configUSE_TRACE_RING
+    trace_ring_init();
+#endif
+
     /* Create the main Task */
-    if (xTaskCreate(main_task, "main_task", 2048, NULL, configMAX_PRIORITIES - 4, &g_BoardState.mainTask) != pdPASS)
+    if (xTaskCreate(main_task, "main_task", MAIN_TASK_STACKSIZE, NULL, configMAX_PRIORITIES - 4, &g_BoardState.mainTask) != pdPASS)
     {
         PRINTF("[!] MAIN Task creation failed!\r\n");
         while (1)
@@ -34,6 +34,10 @@
 
 #define MAX_RETRY_TICKS 50
 
+#ifndef MAIN_TASK_STACKSIZE
+#define MAIN_TASK_STACKSIZE 2048
+#endif
+
 #ifndef HTTPD_STACKSIZE
 #define HTTPD_STACKSIZE 512
 #endif
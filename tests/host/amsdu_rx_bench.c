@@ -0,0 +1,369 @@
+/*
+ * amsdu_rx_bench.c
+ * Host benchmark of received A-MSDUs: bytes copied per delivered frame with
+ * subframes copied out of the A-MSDU against subframes referencing it
+ * (CONFIG_AMSDU_RX_ZERO_COPY), on synthetic A-MSDUs run through
+ * wlan_11n_deaggregate_pkt() and lwIP pbufs
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/stats.h"
+
+#include "mlan_api.h"
+#include "amsdu_rx.h"
+
+#include "host_test.h"
+
+#define AMSDUS   5000U
+#define SUB_MAX  32U
+#define HELD_MAX 3U
+#define ETH_HLEN 14U
+
+typedef struct
+{
+    const char *name;
+    unsigned n;     /* subframes */
+    u16_t first;    /* IP length of the first subframe */
+    u16_t rest;     /* IP length of the others */
+    unsigned held;  /* A-MSDUs whose frames the stack still holds when the next one arrives */
+} scenario_t;
+
+typedef struct
+{
+    uint64_t copied;    /* memcpy() bytes from the RX buffer to the frames lwIP gets */
+    uint64_t moved;     /* memmove() bytes, the MAC addresses over the LLC/SNAP header */
+    uint32_t frames;
+    uint32_t refs;      /* frames pointing into their A-MSDU */
+    uint32_t fallbacks; /* A-MSDUs without a buffer of their own */
+    uint32_t drops;
+    double ns;
+} run_result_t;
+
+mlan_status wlan_11n_deaggregate_pkt(mlan_private *priv, pmlan_buffer pmbuf);
+
+/* Copies are counted through the linker: -Wl,--wrap=memcpy,--wrap=memmove */
+void *__real_memcpy(void *dst, const void *src, size_t n);
+void *__real_memmove(void *dst, const void *src, size_t n);
+
+static int counting;
+static run_result_t *res;
+
+void *__wrap_memcpy(void *dst, const void *src, size_t n)
+{
+    if (counting)
+    {
+        res->copied += n;
+    }
+    return __real_memcpy(dst, src, n);
+}
+
+void *__wrap_memmove(void *dst, const void *src, size_t n)
+{
+    if (counting)
+    {
+        res->moved += n;
+    }
+    return __real_memmove(dst, src, n);
+}
+
+/* amsdu_inbuf of mlan_11n_rxreorder.c */
+static u8_t amsdu_inbuf[4096];
+
+static const scenario_t *cur;
+static unsigned cur_amsdu, cur_sub;
+static int zero_copy;
+static struct
+{
+    struct pbuf *p;
+    unsigned amsdu, sub;
+} held[HELD_MAX + 1U][SUB_MAX];
+static unsigned held_cnt[HELD_MAX + 1U];
+
+static u8_t payload_byte(unsigned amsdu, unsigned sub, unsigned k)
+{
+    return (u8_t)(amsdu * 7U + sub * 13U + k);
+}
+
+static u16_t sub_len(unsigned sub)
+{
+    return (sub == 0U) ? cur->first : cur->rest;
+}
+
+/* A-MSDU i of the scenario as the radio delivers it, returns its length */
+static u16_t amsdu_build(u8_t *buf, unsigned i)
+{
+    static const u8_t llc[8] = {0xaa, 0xaa, 0x03, 0x00, 0x00, 0x00, 0x08, 0x00};
+    unsigned pos = 0U, j, k;
+
+    for (j = 0U; j < cur->n; j++)
+    {
+        u16_t len = sub_len(j);
+
+        buf[pos++] = 0x02; /* DA: the station */
+        for (k = 1U; k < 6U; k++)
+        {
+            buf[pos++] = (u8_t)k;
+        }
+        buf[pos++] = 0x06; /* SA: a peer per subframe */
+        buf[pos++] = 0x00;
+        buf[pos++] = (u8_t)(i >> 8);
+        buf[pos++] = (u8_t)i;
+        buf[pos++] = (u8_t)j;
+        buf[pos++] = 0x00;
+        buf[pos++] = (u8_t)((len + 8U) >> 8);
+        buf[pos++] = (u8_t)(len + 8U);
+        for (k = 0U; k < 8U; k++)
+        {
+            buf[pos++] = llc[k];
+        }
+        for (k = 0U; k < len; k++)
+        {
+            buf[pos++] = payload_byte(i, j, k);
+        }
+        while ((j + 1U < cur->n) && ((pos & 3U) != 0U))
+        {
+            buf[pos++] = 0U;
+        }
+    }
+    return (u16_t)pos;
+}
+
+/* gen_pbuf_from_data() of wifi_netif.c */
+static struct pbuf *pool_pbuf(const u8_t *data, u16_t len)
+{
+    struct pbuf *p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+
+    if ((p != NULL) && (pbuf_take(p, data, len) != ERR_OK))
+    {
+        pbuf_free(p);
+        p = NULL;
+    }
+    return p;
+}
+
+/* deliver_packet_above(): the stack keeps the frame for a while */
+static void deliver(struct pbuf *p, const u8_t *amsdu_lo, const u8_t *amsdu_hi)
+{
+    unsigned slot = cur_amsdu % (HELD_MAX + 1U);
+
+    res->frames++;
+    if (((const u8_t *)p->payload >= amsdu_lo) && ((const u8_t *)p->payload < amsdu_hi))
+    {
+        res->refs++;
+    }
+    held[slot][held_cnt[slot]].p     = p;
+    held[slot][held_cnt[slot]].amsdu = cur_amsdu;
+    held[slot][held_cnt[slot]].sub   = cur_sub;
+    held_cnt[slot]++;
+    cur_sub++;
+}
+
+/* Frame as the subframe was sent, Ethernet header and payload */
+static int frame_ok(struct pbuf *p, unsigned amsdu, unsigned sub)
+{
+    static u8_t frame[2048];
+    u16_t len = sub_len(sub);
+    unsigned k;
+
+    if ((p->tot_len != ETH_HLEN + len) || (pbuf_copy_partial(p, frame, p->tot_len, 0) != p->tot_len))
+    {
+        return 0;
+    }
+    if ((frame[0] != 0x02) || (frame[5] != 0x05) || (frame[9] != (u8_t)amsdu) || (frame[10] != (u8_t)sub) ||
+        (frame[12] != 0x08) || (frame[13] != 0x00))
+    {
+        return 0;
+    }
+    for (k = 0U; k < len; k++)
+    {
+        if (frame[ETH_HLEN + k] != payload_byte(amsdu, sub, k))
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static struct pbuf *rx_amsdu_pbuf;
+
+/* mlan_glue.c and the A-MSDU handlers of wifi_netif.c */
+void wrapper_deliver_amsdu_subframe(pmlan_buffer amsdu_pmbuf, t_u8 *data, t_u16 pkt_len)
+{
+    struct pbuf *p = NULL;
+
+    if ((amsdu_pmbuf->flags & MLAN_BUF_FLAG_AMSDU_REF) != 0U)
+    {
+        /* handle_amsdu_ref_packet() */
+        p = amsdu_rx_subframe((struct pbuf *)amsdu_pmbuf->lwip_pbuf, data, pkt_len);
+    }
+    if (p == NULL)
+    {
+        /* handle_amsdu_data_packet() */
+        p = pool_pbuf(data, pkt_len);
+    }
+    if (p == NULL)
+    {
+        res->drops++;
+        cur_sub++;
+        return;
+    }
+    deliver(p, (const u8_t *)rx_amsdu_pbuf->payload, (const u8_t *)rx_amsdu_pbuf->payload + rx_amsdu_pbuf->len);
+}
+
+/* process_data_packet() and wlan_11n_dispatch_amsdu_pkt() for one A-MSDU */
+static void rx_amsdu(const u8_t *data, u16_t len)
+{
+    mlan_buffer mbuf;
+    struct pbuf *p = NULL;
+
+    counting = 1;
+    if (zero_copy)
+    {
+        p = amsdu_rx_alloc(data, len);
+        res->fallbacks += (p == NULL);
+    }
+    if (p == NULL)
+    {
+        p = pool_pbuf(data, len);
+    }
+    if (p == NULL)
+    {
+        res->drops += cur->n;
+        counting = 0;
+        return;
+    }
+
+    memset(&mbuf, 0, sizeof(mbuf));
+    mbuf.lwip_pbuf = p;
+    mbuf.data_len  = len;
+    rx_amsdu_pbuf  = p;
+    if (zero_copy && (p->len >= len))
+    {
+        /* deaggregated in place */
+        mbuf.pdesc = p->payload;
+        mbuf.flags = MLAN_BUF_FLAG_AMSDU_REF;
+    }
+    else
+    {
+        pbuf_copy_partial(p, amsdu_inbuf, len, 0);
+        mbuf.pbuf = amsdu_inbuf;
+    }
+    (void)wlan_11n_deaggregate_pkt(NULL, &mbuf);
+    pbuf_free(p);
+    counting = 0;
+}
+
+static void release(unsigned slot)
+{
+    unsigned k;
+
+    for (k = 0U; k < held_cnt[slot]; k++)
+    {
+        CHECK(frame_ok(held[slot][k].p, held[slot][k].amsdu, held[slot][k].sub));
+        pbuf_free(held[slot][k].p);
+    }
+    held_cnt[slot] = 0U;
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static void run(const scenario_t *s, int zc, run_result_t *r)
+{
+    static u8_t radio[4096];
+    unsigned i;
+    double busy = 0.0, start;
+
+    memset(r, 0, sizeof(*r));
+    cur       = s;
+    res       = r;
+    zero_copy = zc;
+    for (i = 0U; i < AMSDUS; i++)
+    {
+        u16_t len = amsdu_build(radio, i);
+
+        if (i > s->held)
+        {
+            release((i - s->held - 1U) % (HELD_MAX + 1U));
+        }
+        cur_amsdu = i;
+        cur_sub   = 0U;
+        start     = now_ns();
+        rx_amsdu(radio, len);
+        busy += now_ns() - start;
+        CHECK(cur_sub == s->n || r->drops != 0U);
+    }
+    for (i = 0U; i <= HELD_MAX; i++)
+    {
+        release(i);
+    }
+    r->ns = busy / AMSDUS;
+
+    /* every buffer is back */
+    CHECK(memp_AMSDU_RX.stats->used == 0U);
+    CHECK(memp_AMSDU_SUBFRAME.stats->used == 0U);
+    CHECK(lwip_stats.memp[MEMP_PBUF_POOL]->used == 0U);
+}
+
+int main(void)
+{
+    static const scenario_t scenarios[] = {
+        {"bulk TCP, 2 x 1500", 2U, 1500U, 1500U, 0U},
+        {"bulk TCP, 2 x 1500", 2U, 1500U, 1500U, 1U},
+        {"bulk TCP, 2 x 1500", 2U, 1500U, 1500U, 2U},
+        {"mixed, 1500 + 3 x 512", 4U, 1500U, 512U, 0U},
+        {"small, 6 x 512", 6U, 512U, 512U, 1U},
+        {"TCP ACKs, 24 x 40", 24U, 40U, 40U, 0U},
+    };
+    run_result_t copy, zc;
+    unsigned i;
+
+    stats_init();
+    mem_init();
+    memp_init();
+
+    printf("CONFIG_AMSDU_RX_BUFS %u, CONFIG_AMSDU_RX_REF_PBUFS %u, PBUF_POOL_SIZE %u x %u B, %u A-MSDUs per row\n",
+           CONFIG_AMSDU_RX_BUFS, CONFIG_AMSDU_RX_REF_PBUFS, PBUF_POOL_SIZE, PBUF_POOL_BUFSIZE, AMSDUS);
+    printf("bytes copied per delivered frame, held: A-MSDUs the stack holds when the next one arrives\n");
+    printf("%-24s %4s %10s %10s %8s %8s %9s %9s %6s\n", "A-MSDU", "held", "copy B", "ref B", "refs", "fallbk",
+           "copy ns", "ref ns", "drops");
+    for (i = 0U; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        const scenario_t *s = &scenarios[i];
+
+        run(s, 0, &copy);
+        run(s, 1, &zc);
+        printf("%-24s %4u %10.1f %10.1f %7.0f%% %8u %9.0f %9.0f %6u\n", s->name, s->held,
+               (double)copy.copied / copy.frames, (double)zc.copied / zc.frames, 100.0 * zc.refs / zc.frames,
+               zc.fallbacks, copy.ns / s->n, zc.ns / s->n, copy.drops + zc.drops);
+
+        CHECK(copy.frames == AMSDUS * s->n);
+        CHECK(zc.frames == AMSDUS * s->n);
+        CHECK(copy.refs == 0U);
+        CHECK(zc.copied < copy.copied);
+        /* the MAC addresses move in place, 12 bytes per subframe on both paths */
+        CHECK(zc.moved == copy.moved);
+        CHECK(zc.moved == (uint64_t)AMSDUS * s->n * 2U * MLAN_MAC_ADDR_LENGTH);
+        if ((s->held < CONFIG_AMSDU_RX_BUFS) && ((s->held + 1U) * s->n <= CONFIG_AMSDU_RX_REF_PBUFS))
+        {
+            /* only the copy out of the RX buffer is left */
+            CHECK(zc.refs == zc.frames);
+            CHECK(zc.fallbacks == 0U);
+        }
+    }
+
+    return host_test_result();
+}
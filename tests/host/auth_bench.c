@@ -0,0 +1,277 @@
+/*
+ * auth_bench.c
+ * Host benchmark of HTTP Basic authentication with 10 realms of 50 users:
+ * realm index against the linear realm scan, credential cache against
+ * decoding and searching the user table on every request
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "httpsrv_base64.h"
+#include "httpsrv_host.h"
+
+#include "host_test.h"
+
+#define ROUNDS 200000U
+#define REALMS 10U
+#define USERS  50U
+
+extern const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[];
+
+static HTTPSRV_AUTH_USER_STRUCT users[REALMS][USERS + 1];
+static char names[REALMS][USERS][16];
+static char passwords[REALMS][USERS][24];
+
+static const HTTPSRV_AUTH_REALM_STRUCT realms[] = {
+    {"Status", "/status.shtml", HTTPSRV_AUTH_BASIC, users[0]},
+    {"Administration", "/admin/", HTTPSRV_AUTH_BASIC, users[1]},
+    {"Network", "/network/", HTTPSRV_AUTH_BASIC, users[2]},
+    {"Wireless", "/wifi/", HTTPSRV_AUTH_BASIC, users[3]},
+    {"System", "/system/", HTTPSRV_AUTH_BASIC, users[4]},
+    {"Logs", "/logs/", HTTPSRV_AUTH_BASIC, users[5]},
+    {"Firmware", "/firmware/", HTTPSRV_AUTH_BASIC, users[6]},
+    {"Certificates", "/certs/", HTTPSRV_AUTH_BASIC, users[7]},
+    {"Diagnostics", "/diag/", HTTPSRV_AUTH_BASIC, users[8]},
+    {"API", "/api/", HTTPSRV_AUTH_BASIC, users[9]},
+    {0, 0, HTTPSRV_AUTH_INVALID, 0},
+};
+
+/* Request paths of the realm lookup, with the realm each belongs to, -1 for none */
+static const struct
+{
+    const char *path;
+    int realm;
+} paths[] = {
+    {"/index.html", -1},          {"/style.css", -1},           {"/status.shtml", 0},
+    {"/admin/users.html", 1},     {"/network/dhcp.cgi", 2},     {"/wifi/scan.cgi", 3},
+    {"/system/reboot.cgi", 4},    {"/logs/today.txt", 5},       {"/firmware/upload.cgi", 6},
+    {"/certs/ca.pem", 7},         {"/diag/ping.cgi", 8},        {"/api/v1/state", 9},
+    {"/help/wifi/", 3},           {"/admin/wifi/", 1},          {"/images/logo.png", -1},
+    {"/a", -1},                   {"/", -1},                    {"/api", -1},
+};
+
+/* Realm lookup as it was: first realm of the table whose path occurs in the request path */
+static const HTTPSRV_AUTH_REALM_STRUCT *linear_realm(const char *path)
+{
+    const HTTPSRV_AUTH_REALM_STRUCT *table = realms;
+
+    while ((table->path != NULL) && (strstr(path, table->path) == NULL))
+    {
+        table++;
+    }
+    return (table->path ? table : NULL);
+}
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* Authorization header line of a user */
+static void auth_line(char *line, const char *name, const char *password)
+{
+    char plain[48];
+
+    snprintf(plain, sizeof(plain), "%s:%s", name, password);
+    strcpy(line, "Authorization: Basic ");
+    base64_encode(plain, line + strlen(line));
+}
+
+/*
+ * Authentication part of a request, as httpsrv_req_read() and
+ * httpsrv_req_do() run it: parse the header, find the realm, check the
+ * credentials. Returns 1 if the request may go on.
+ */
+static int auth_request(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, const char *path, const char *line)
+{
+    char hdr[128];
+    const HTTPSRV_AUTH_REALM_STRUCT *realm;
+    int ok = 1;
+
+    strcpy(session->request.path, path);
+    if (line != NULL)
+    {
+        strcpy(hdr, line);
+        httpsrv_req_hdr(server, session, hdr);
+    }
+    realm = httpsrv_req_realm(server, session->request.path);
+    if (realm != NULL)
+    {
+        ok = httpsrv_req_auth(server, session, realm);
+    }
+    httpsrv_req_auth_free(session);
+    return ok;
+}
+
+static void test_realms(HTTPSRV_STRUCT *server)
+{
+    char path[64];
+    unsigned i, r;
+
+    for (i = 0U; i < sizeof(paths) / sizeof(paths[0]); i++)
+    {
+        strcpy(path, paths[i].path);
+        CHECK(httpsrv_req_realm(server, path) == linear_realm(paths[i].path));
+        CHECK(linear_realm(paths[i].path) == ((paths[i].realm < 0) ? NULL : &realms[paths[i].realm]));
+    }
+    /* Realm paths at every position of a longer path */
+    for (r = 0U; r < REALMS; r++)
+    {
+        for (i = 0U; i < 8U; i++)
+        {
+            snprintf(path, sizeof(path), "%.*s%sx", (int)i, "/abcdefg", realms[r].path);
+            CHECK(httpsrv_req_realm(server, path) == linear_realm(path));
+        }
+    }
+}
+
+static void test_auth(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session)
+{
+    char good[96], bad[96], other[96];
+    const char *keep;
+
+    auth_line(good, names[9][USERS - 1], passwords[9][USERS - 1]);
+    auth_line(bad, names[9][USERS - 1], "wrong");
+    auth_line(other, names[3][0], passwords[3][0]);
+
+    CHECK(auth_request(server, session, "/index.html", NULL));
+    CHECK(!auth_request(server, session, "/api/v1/state", NULL));
+    CHECK(auth_request(server, session, "/api/v1/state", good));
+    /* verified once, then from the cache while it holds */
+    CHECK(auth_request(server, session, "/api/v1/state", good));
+    CHECK(!auth_request(server, session, "/api/v1/state", bad));
+    /* credentials of another realm */
+    CHECK(!auth_request(server, session, "/api/v1/state", other));
+    CHECK(auth_request(server, session, "/wifi/scan.cgi", other));
+
+    /* the cached verification ends with the password in the table */
+    keep                              = users[9][USERS - 1].password;
+    users[9][USERS - 1].password      = "changed";
+    CHECK(!auth_request(server, session, "/api/v1/state", good));
+    users[9][USERS - 1].password      = (char *)keep;
+    CHECK(auth_request(server, session, "/api/v1/state", good));
+    httpsrv_host_time += HTTPSRV_CFG_AUTH_CACHE_TIMEOUT;
+    CHECK(auth_request(server, session, "/api/v1/state", good));
+
+    /* through the whole request */
+    CHECK(httpsrv_host_request(server, session, "GET /status.shtml HTTP/1.1\r\nHost: device\r\n\r\n") == 401);
+    CHECK(strstr(httpsrv_host_out, "WWW-Authenticate: Basic realm=\"Status\"") != NULL);
+    auth_line(good, names[0][7], passwords[0][7]);
+    strcat(good, "\r\n\r\n");
+    {
+        char request[160] = "GET /status.shtml HTTP/1.1\r\nHost: device\r\n";
+
+        strcat(request, good);
+        CHECK(httpsrv_host_request(server, session, request) == 200);
+    }
+}
+
+/* ns per request of a workload: users of one realm requested round robin */
+static double bench(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, unsigned realm, unsigned first,
+                    unsigned count)
+{
+    static char lines[USERS][96];
+    unsigned i, ok = 0U;
+    double start;
+
+    for (i = 0U; i < count; i++)
+    {
+        auth_line(lines[i], names[realm][first + i], passwords[realm][first + i]);
+    }
+    httpsrv_auth_cache_flush(server);
+    start = now_ns();
+    for (i = 0U; i < ROUNDS; i++)
+    {
+        ok += auth_request(server, session, paths[2U + realm].path, lines[i % count]);
+    }
+    CHECK(ok == ROUNDS);
+    return (now_ns() - start) / ROUNDS;
+}
+
+/* ns per request for a path outside the realms */
+static double bench_open(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session)
+{
+    unsigned i, ok = 0U;
+    double start;
+
+    start = now_ns();
+    for (i = 0U; i < ROUNDS; i++)
+    {
+        ok += auth_request(server, session, "/index.html", NULL);
+    }
+    CHECK(ok == ROUNDS);
+    return (now_ns() - start) / ROUNDS;
+}
+
+static double bench_realm(HTTPSRV_STRUCT *server, int indexed)
+{
+    char path[sizeof(paths) / sizeof(paths[0])][64];
+    const unsigned n = sizeof(paths) / sizeof(paths[0]);
+    unsigned i, hits = 0U;
+    double start;
+
+    for (i = 0U; i < n; i++)
+    {
+        strcpy(path[i], paths[i].path);
+    }
+    start = now_ns();
+    for (i = 0U; i < ROUNDS; i++)
+    {
+        hits += ((indexed ? httpsrv_req_realm(server, path[i % n]) : linear_realm(path[i % n])) != NULL);
+    }
+    CHECK(hits != 0U);
+    return (now_ns() - start) / ROUNDS;
+}
+
+int main(void)
+{
+    HTTPSRV_PARAM_STRUCT params;
+    HTTPSRV_STRUCT *server;
+    HTTPSRV_SESSION_STRUCT *session;
+    unsigned r, u;
+
+    for (r = 0U; r < REALMS; r++)
+    {
+        for (u = 0U; u < USERS; u++)
+        {
+            snprintf(names[r][u], sizeof(names[r][u]), "user%u_%02u", r, u);
+            snprintf(passwords[r][u], sizeof(passwords[r][u]), "pw%02u-%u-secret", u, r);
+            users[r][u].user_id  = names[r][u];
+            users[r][u].password = passwords[r][u];
+        }
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.auth_table = realms;
+    server            = httpsrv_create_server(&params);
+    CHECK(server != NULL);
+    if (server == NULL)
+    {
+        return host_test_result();
+    }
+    session = httpsrv_host_session(server);
+    HTTPSRV_FS_init(httpsrv_fs_data);
+
+    test_realms(server);
+    test_auth(server, session);
+
+    printf("%u realms of %u users, HTTPSRV_CFG_AUTH_CACHE_SIZE %u, %u requests per row\n", REALMS, USERS,
+           (unsigned)HTTPSRV_CFG_AUTH_CACHE_SIZE, ROUNDS);
+    printf("%-40s %8s\n", "case", "ns/req");
+    printf("%-40s %8.0f\n", "realm lookup, linear scan", bench_realm(server, 0));
+    printf("%-40s %8.0f\n", "realm lookup, index", bench_realm(server, 1));
+    printf("%-40s %8.0f\n", "unprotected path, no credentials", bench_open(server, session));
+    printf("%-40s %8.0f\n", "first user of first realm", bench(server, session, 0U, 0U, 1U));
+    printf("%-40s %8.0f\n", "last user of last realm", bench(server, session, REALMS - 1U, USERS - 1U, 1U));
+    printf("%-40s %8.0f\n", "4 users of last realm, round robin", bench(server, session, REALMS - 1U, USERS - 4U, 4U));
+    printf("%-40s %8.0f\n", "50 users of last realm, round robin", bench(server, session, REALMS - 1U, 0U, USERS));
+
+    return host_test_result();
+}
@@ -0,0 +1,431 @@
+/*
+ * dns_sim.c
+ * Host test of the lwIP DNS client against a stand-in resolver: positive and
+ * negative cache TTLs, prefetch of used entries and the name hash index
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "lwip/dns.h"
+#include "lwip/mem.h"
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+#include "lwip/prot/dns.h"
+#include "lwip/udp.h"
+
+#include "host_test.h"
+
+/* Stand-in resolver behaviour per query */
+typedef enum
+{
+    RESOLVER_ANSWER,
+    RESOLVER_NXDOMAIN,
+    RESOLVER_SERVFAIL,
+    RESOLVER_SILENT
+} resolver_mode_t;
+
+#define QUERY_MAX 8
+
+static struct udp_pcb dns_pcb;
+static udp_recv_fn dns_recv_fn;
+static void *dns_recv_arg;
+static ip_addr_t server;
+
+static struct
+{
+    u16_t txid;
+    char name[DNS_MAX_NAME_LENGTH];
+} queries[QUERY_MAX];
+static unsigned query_cnt;   /* pending, not answered yet */
+static unsigned query_total; /* sent by dns.c */
+
+static unsigned found_cnt;
+static ip_addr_t found_addr;
+static int found_ok;
+
+/* UDP layer of dns.c */
+
+struct udp_pcb *udp_new_ip_type(u8_t type)
+{
+    return &dns_pcb;
+}
+
+err_t udp_bind(struct udp_pcb *pcb, const ip_addr_t *ipaddr, u16_t port)
+{
+    return ERR_OK;
+}
+
+void udp_recv(struct udp_pcb *pcb, udp_recv_fn recv, void *recv_arg)
+{
+    dns_recv_fn  = recv;
+    dns_recv_arg = recv_arg;
+}
+
+void udp_remove(struct udp_pcb *pcb)
+{
+}
+
+err_t udp_sendto(struct udp_pcb *pcb, struct pbuf *p, const ip_addr_t *dst_ip, u16_t dst_port)
+{
+    struct dns_hdr hdr;
+    char *out;
+    u16_t off = SIZEOF_DNS_HDR;
+    u8_t len;
+
+    CHECK(ip_addr_eq(dst_ip, &server));
+    CHECK(dst_port == DNS_SERVER_PORT);
+    query_total++;
+    if (query_cnt == QUERY_MAX)
+    {
+        return ERR_OK;
+    }
+    pbuf_copy_partial(p, &hdr, SIZEOF_DNS_HDR, 0);
+    queries[query_cnt].txid = lwip_ntohs(hdr.id);
+    out                     = queries[query_cnt].name;
+    /* decode the labels of the question */
+    while ((len = pbuf_get_at(p, off++)) != 0)
+    {
+        if (out != queries[query_cnt].name)
+        {
+            *out++ = '.';
+        }
+        pbuf_copy_partial(p, out, len, off);
+        out += len;
+        off = (u16_t)(off + len);
+    }
+    *out = 0;
+    query_cnt++;
+    return ERR_OK;
+}
+
+/* Answer the oldest pending query */
+static void resolver_reply(resolver_mode_t mode, u32_t ttl, u32_t addr)
+{
+    u8_t buf[SIZEOF_DNS_HDR + DNS_MAX_NAME_LENGTH + 2 + 4 + 16];
+    struct dns_hdr hdr;
+    const char *label;
+    u16_t len = SIZEOF_DNS_HDR;
+    struct pbuf *p;
+
+    if (query_cnt == 0U)
+    {
+        return;
+    }
+    if (mode != RESOLVER_SILENT)
+    {
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.id           = lwip_htons(queries[0].txid);
+        hdr.flags1       = DNS_FLAG1_RESPONSE | DNS_FLAG1_RD;
+        hdr.flags2       = (mode == RESOLVER_NXDOMAIN) ? DNS_FLAG2_ERR_NAME :
+                           (mode == RESOLVER_SERVFAIL) ? 2 : DNS_FLAG2_ERR_NONE;
+        hdr.numquestions = PP_HTONS(1);
+        hdr.numanswers   = (mode == RESOLVER_ANSWER) ? PP_HTONS(1) : 0;
+        memcpy(buf, &hdr, SIZEOF_DNS_HDR);
+
+        /* question: the name as asked, type A, class IN */
+        label = queries[0].name;
+        while (*label != 0)
+        {
+            const char *dot = strchr(label, '.');
+            u8_t n          = (u8_t)(dot ? (size_t)(dot - label) : strlen(label));
+
+            buf[len++] = n;
+            memcpy(&buf[len], label, n);
+            len   = (u16_t)(len + n);
+            label = dot ? dot + 1 : label + n;
+        }
+        buf[len++] = 0;
+        buf[len++] = 0;
+        buf[len++] = DNS_RRTYPE_A;
+        buf[len++] = 0;
+        buf[len++] = DNS_RRCLASS_IN;
+
+        if (mode == RESOLVER_ANSWER)
+        {
+            /* answer: pointer to the question name, A, IN, ttl, address */
+            buf[len++] = 0xc0;
+            buf[len++] = SIZEOF_DNS_HDR;
+            buf[len++] = 0;
+            buf[len++] = DNS_RRTYPE_A;
+            buf[len++] = 0;
+            buf[len++] = DNS_RRCLASS_IN;
+            buf[len++] = (u8_t)(ttl >> 24);
+            buf[len++] = (u8_t)(ttl >> 16);
+            buf[len++] = (u8_t)(ttl >> 8);
+            buf[len++] = (u8_t)ttl;
+            buf[len++] = 0;
+            buf[len++] = 4;
+            memcpy(&buf[len], &addr, 4);
+            len = (u16_t)(len + 4);
+        }
+
+        p = pbuf_alloc(PBUF_TRANSPORT, len, PBUF_RAM);
+        pbuf_take(p, buf, len);
+        dns_recv_fn(dns_recv_arg, &dns_pcb, p, &server, DNS_SERVER_PORT);
+    }
+    query_cnt--;
+    memmove(&queries[0], &queries[1], query_cnt * sizeof(queries[0]));
+}
+
+static void found(const char *name, const ip_addr_t *ipaddr, void *arg)
+{
+    found_cnt++;
+    found_ok = (ipaddr != NULL);
+    if (ipaddr != NULL)
+    {
+        ip_addr_copy(found_addr, *ipaddr);
+    }
+}
+
+/* dns_tmr() runs every DNS_TMR_INTERVAL, one second */
+static void tick(unsigned seconds)
+{
+    while (seconds-- != 0U)
+    {
+        dns_tmr();
+    }
+}
+
+/* Let time pass with the resolver down, until cached entries expire */
+static void settle(unsigned seconds)
+{
+    while (seconds-- != 0U)
+    {
+        dns_tmr();
+        while (query_cnt != 0U)
+        {
+            resolver_reply(RESOLVER_SILENT, 0U, 0U);
+        }
+    }
+}
+
+static err_t lookup(const char *name, u32_t *addr)
+{
+    ip_addr_t ip;
+    err_t err = dns_gethostbyname(name, &ip, found, NULL);
+
+    if ((err == ERR_OK) && (addr != NULL))
+    {
+        *addr = ip4_addr_get_u32(ip_2_ip4(&ip));
+    }
+    return err;
+}
+
+/* Resolve a name through the resolver, return the ticks it took */
+static unsigned resolve(const char *name, resolver_mode_t mode, u32_t ttl, u32_t addr)
+{
+    unsigned before = found_cnt, ticks = 0U;
+
+    CHECK(lookup(name, NULL) == ERR_INPROGRESS);
+    CHECK(query_cnt == 1U && strcmp(queries[0].name, name) == 0);
+    while ((found_cnt == before) && (ticks < 60U))
+    {
+        resolver_reply(mode, ttl, addr);
+        if (found_cnt == before)
+        {
+            tick(1U);
+            ticks++;
+        }
+    }
+    CHECK(found_cnt == before + 1U);
+    return ticks;
+}
+
+static void test_positive(void)
+{
+    u32_t addr = 0;
+    unsigned sent;
+
+    resolve("pos.example", RESOLVER_ANSWER, 60U, PP_HTONL(0x0a000001UL));
+    CHECK(found_ok && ip4_addr_get_u32(ip_2_ip4(&found_addr)) == PP_HTONL(0x0a000001UL));
+    sent = query_total;
+    /* not used: expires without a prefetch */
+    tick(59U);
+    CHECK(query_total == sent);
+    CHECK(lookup("pos.example", &addr) == ERR_OK && addr == PP_HTONL(0x0a000001UL));
+    CHECK(lookup("POS.Example.", &addr) == ERR_OK && addr == PP_HTONL(0x0a000001UL));
+    tick(1U);
+    CHECK(query_total == sent);
+    CHECK(lookup("pos.example", NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_ANSWER, 60U, PP_HTONL(0x0a000001UL));
+}
+
+static void test_nxdomain(void)
+{
+    unsigned sent;
+
+    resolve("nx.example", RESOLVER_NXDOMAIN, 0U, 0U);
+    CHECK(!found_ok);
+    sent = query_total;
+    /* cached failure for DNS_NEG_TTL_NXDOMAIN seconds, nothing on the wire */
+    CHECK(lookup("nx.example", NULL) == ERR_VAL);
+    tick(DNS_NEG_TTL_NXDOMAIN - 1U);
+    CHECK(lookup("nx.example", NULL) == ERR_VAL);
+    CHECK(query_total == sent);
+    tick(1U);
+    CHECK(lookup("nx.example", NULL) == ERR_INPROGRESS);
+    CHECK(query_total == sent + 1U);
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000002UL));
+    CHECK(found_ok);
+}
+
+static void test_timeout(void)
+{
+    unsigned ticks, sent = query_total;
+
+    ticks = resolve("slow.example", RESOLVER_SILENT, 0U, 0U);
+    CHECK(!found_ok);
+    CHECK(query_total - sent == DNS_MAX_RETRIES);
+    printf("timeout after %u s and %u queries\n", ticks, query_total - sent);
+    sent = query_total;
+    tick(DNS_NEG_TTL_FAILURE - 1U);
+    CHECK(lookup("slow.example", NULL) == ERR_VAL);
+    CHECK(query_total == sent);
+    tick(1U);
+    CHECK(lookup("slow.example", NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_SERVFAIL, 0U, 0U);
+    CHECK(!found_ok && lookup("slow.example", NULL) == ERR_VAL);
+    tick(DNS_NEG_TTL_FAILURE);
+}
+
+/* Tick until the prefetch query goes out, the cached address must stay served */
+static unsigned tick_to_prefetch(const char *name, u32_t addr, u32_t ttl)
+{
+    unsigned t, sent = query_total;
+    u32_t got = 0;
+
+    for (t = 1U; t < ttl && query_total == sent; t++)
+    {
+        CHECK(lookup(name, &got) == ERR_OK && got == addr);
+        tick(1U);
+    }
+    CHECK(query_total == sent + 1U);
+    CHECK(query_cnt == 1U && strcmp(queries[0].name, name) == 0);
+    CHECK(lookup(name, &got) == ERR_OK && got == addr);
+    return ttl - t + 1U;
+}
+
+static void test_prefetch(void)
+{
+    unsigned left, before;
+    u32_t got = 0;
+
+    resolve("pre.example", RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000003UL));
+    left = tick_to_prefetch("pre.example", PP_HTONL(0x0a000003UL), 30U);
+    printf("prefetch with %u s left\n", left);
+    CHECK(left <= DNS_PREFETCH_TIME && left + 1U >= DNS_PREFETCH_TIME);
+    /* the refresh replaces the address, no request callback for it */
+    before = found_cnt;
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000013UL));
+    CHECK(found_cnt == before);
+    CHECK(lookup("pre.example", &got) == ERR_OK && got == PP_HTONL(0x0a000013UL));
+    tick(25U);
+    CHECK(lookup("pre.example", &got) == ERR_OK && got == PP_HTONL(0x0a000013UL));
+    settle(5U);
+    CHECK(lookup("pre.example", NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000013UL));
+
+    /* failed refresh: keep serving until the TTL runs out, no negative entry */
+    resolve("pfail.example", RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000004UL));
+    left = tick_to_prefetch("pfail.example", PP_HTONL(0x0a000004UL), 30U);
+    resolver_reply(RESOLVER_SERVFAIL, 0U, 0U);
+    before = query_total;
+    while (--left != 0U)
+    {
+        /* still used, but the refresh is not repeated */
+        CHECK(lookup("pfail.example", &got) == ERR_OK && got == PP_HTONL(0x0a000004UL));
+        tick(1U);
+    }
+    CHECK(query_total == before);
+    CHECK(lookup("pfail.example", &got) == ERR_OK && got == PP_HTONL(0x0a000004UL));
+    tick(1U);
+    CHECK(lookup("pfail.example", NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000004UL));
+
+    /* unanswered refresh: retried, then given up, the entry still expires on time */
+    resolve("psilent.example", RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000005UL));
+    left = tick_to_prefetch("psilent.example", PP_HTONL(0x0a000005UL), 30U);
+    before = query_total;
+    resolver_reply(RESOLVER_SILENT, 0U, 0U);
+    tick(left - 1U);
+    CHECK(query_total - before == DNS_MAX_RETRIES - 1U);
+    while (query_cnt != 0U)
+    {
+        resolver_reply(RESOLVER_SILENT, 0U, 0U);
+    }
+    CHECK(lookup("psilent.example", &got) == ERR_OK && got == PP_HTONL(0x0a000005UL));
+    tick(1U);
+    CHECK(lookup("psilent.example", NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000005UL));
+}
+
+#if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) != 0)
+/* A second request for a name being resolved waits on the same query */
+static void test_duplicate(void)
+{
+    unsigned before = found_cnt, sent = query_total;
+
+    CHECK(lookup("dup.example", NULL) == ERR_INPROGRESS);
+    CHECK(lookup("DUP.example", NULL) == ERR_INPROGRESS);
+    CHECK(query_total == sent + 1U);
+    resolver_reply(RESOLVER_ANSWER, 30U, PP_HTONL(0x0a000006UL));
+    CHECK(found_cnt == before + 2U && found_ok);
+}
+#endif
+
+/* More names than entries: the hash chains follow eviction and refill */
+static void test_index(void)
+{
+    char name[32];
+    unsigned i, n = 3U * DNS_TABLE_SIZE;
+    u32_t got = 0;
+
+    for (i = 0U; i < n; i++)
+    {
+        snprintf(name, sizeof(name), "host%u.example", i);
+        resolve(name, RESOLVER_ANSWER, 300U, lwip_htonl(0x0a010000UL + i));
+    }
+    for (i = n - DNS_TABLE_SIZE; i < n; i++)
+    {
+        snprintf(name, sizeof(name), "HOST%u.example", i);
+        CHECK(lookup(name, &got) == ERR_OK && got == lwip_htonl(0x0a010000UL + i));
+    }
+    snprintf(name, sizeof(name), "host%u.example", n - DNS_TABLE_SIZE - 1U);
+    CHECK(lookup(name, NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_NXDOMAIN, 0U, 0U);
+    CHECK(lookup(name, NULL) == ERR_VAL);
+    /* took the entry of the oldest name, the next one */
+    snprintf(name, sizeof(name), "host%u.example", n - DNS_TABLE_SIZE);
+    CHECK(lookup(name, NULL) == ERR_INPROGRESS);
+    resolver_reply(RESOLVER_ANSWER, 300U, 0U);
+    for (i = n - DNS_TABLE_SIZE + 2U; i < n; i++)
+    {
+        snprintf(name, sizeof(name), "host%u.example", i);
+        CHECK(lookup(name, &got) == ERR_OK && got == lwip_htonl(0x0a010000UL + i));
+    }
+    settle(300U);
+}
+
+int main(void)
+{
+    mem_init();
+    memp_init();
+    dns_init();
+    IP_ADDR4(&server, 192, 168, 1, 1);
+    dns_setserver(0, &server);
+
+    test_positive();
+    test_nxdomain();
+    test_timeout();
+    test_prefetch();
+#if ((LWIP_DNS_SECURE & LWIP_DNS_SECURE_NO_MULTIPLE_OUTSTANDING) != 0)
+    test_duplicate();
+#endif
+    test_index();
+    CHECK(query_cnt == 0U);
+
+    return host_test_result();
+}
@@ -0,0 +1,299 @@
+/*
+ * event_replay.c
+ * Host replay of firmware event traces through the event buffers of
+ * wifi-mem.c: buffers in use, heap or pool allocations and events dropped,
+ * with a single consumer that frees each buffer once it has handled it
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mlan_api.h"
+#include "osa.h"
+
+#include "host_test.h"
+
+/* Depth of the bus event queue, as in wifi-internal.h */
+#define MAX_EVENTS 20
+
+/* 2560 B buffers of the pool build, POOL_ID12_BUF0_CNT of mem_pool_config.c */
+#ifndef HOST_EVENT_POOL_BUFS
+#define HOST_EVENT_POOL_BUFS 1
+#endif
+#define HOST_EVENT_POOL_BUF_SIZE 2560U
+
+#define HOST_STR_(x) #x
+#define HOST_STR(x)  HOST_STR_(x)
+
+#define TRACE_MAX_EVENTS 4096
+
+typedef struct
+{
+    unsigned long time;    /* arrival, us */
+    unsigned long service; /* handling by the consumer, us */
+    unsigned id;
+    unsigned size;
+} trace_event_t;
+
+/*
+ * OSA memory: heap blocks with their size in front, and the 2560 B pool.
+ */
+static struct
+{
+    unsigned allocs;
+    unsigned fails;
+    size_t in_use;
+    size_t peak;
+} heap, pool;
+
+static uint8_t pool_bufs[HOST_EVENT_POOL_BUFS][HOST_EVENT_POOL_BUF_SIZE];
+static int pool_used[HOST_EVENT_POOL_BUFS];
+static int pool_handle;
+MemoryPool_t buf_2560_MemoryPool = &pool_handle;
+
+void *OSA_MemoryAllocate(uint32_t memLength)
+{
+    size_t *p = malloc(sizeof(size_t) + memLength);
+
+    heap.allocs++;
+    if (p == NULL)
+    {
+        heap.fails++;
+        return NULL;
+    }
+    *p = memLength;
+    heap.in_use += memLength;
+    if (heap.in_use > heap.peak)
+    {
+        heap.peak = heap.in_use;
+    }
+    return p + 1;
+}
+
+void OSA_MemoryFree(void *p)
+{
+    size_t *block = (size_t *)p - 1;
+
+    heap.in_use -= *block;
+    free(block);
+}
+
+void *OSA_MemoryPoolAllocate(MemoryPool_t handle)
+{
+    unsigned i;
+
+    CHECK(handle == buf_2560_MemoryPool);
+    pool.allocs++;
+    for (i = 0U; i < HOST_EVENT_POOL_BUFS; i++)
+    {
+        if (!pool_used[i])
+        {
+            pool_used[i] = 1;
+            pool.in_use += HOST_EVENT_POOL_BUF_SIZE;
+            if (pool.in_use > pool.peak)
+            {
+                pool.peak = pool.in_use;
+            }
+            return pool_bufs[i];
+        }
+    }
+    pool.fails++;
+    return NULL;
+}
+
+void OSA_MemoryPoolFree(MemoryPool_t handle, void *memory)
+{
+    unsigned i = (unsigned)(((uint8_t *)memory - pool_bufs[0]) / HOST_EVENT_POOL_BUF_SIZE);
+
+    CHECK(handle == buf_2560_MemoryPool);
+    CHECK((i < HOST_EVENT_POOL_BUFS) && pool_used[i]);
+    pool_used[i] = 0;
+    pool.in_use -= HOST_EVENT_POOL_BUF_SIZE;
+}
+
+/*
+ * Trace: lines of "<time_us> <count> <interval_us> <event_id> <size>
+ * <service_us>", count events of the same id and size from time on.
+ */
+static int cmp_event(const void *a, const void *b)
+{
+    const trace_event_t *x = a, *y = b;
+
+    return (x->time > y->time) - (x->time < y->time);
+}
+
+static unsigned trace_load(const char *path, trace_event_t *events)
+{
+    char line[160];
+    unsigned n = 0U;
+    FILE *f    = fopen(path, "r");
+
+    CHECK(f != NULL);
+    if (f == NULL)
+    {
+        return 0U;
+    }
+    while (fgets(line, sizeof(line), f) != NULL)
+    {
+        unsigned long time, interval, service;
+        unsigned count, id, size, i;
+
+        if ((line[0] == '#') ||
+            (sscanf(line, "%lu %u %lu %x %u %lu", &time, &count, &interval, &id, &size, &service) != 6))
+        {
+            continue;
+        }
+        for (i = 0U; (i < count) && (n < TRACE_MAX_EVENTS); i++, n++)
+        {
+            events[n].time    = time + i * interval;
+            events[n].service = service;
+            events[n].id      = id;
+            events[n].size    = size;
+        }
+    }
+    fclose(f);
+    /* qsort is not stable, but events of the same time are the same anyway */
+    qsort(events, n, sizeof(events[0]), cmp_event);
+    return n;
+}
+
+/* Result of a replay */
+typedef struct
+{
+    unsigned events;
+    unsigned small_events; /* of CONFIG_EVENTBUF_SMALL_SIZE or less */
+    unsigned max_size;
+    unsigned dropped_alloc;
+    unsigned dropped_queue;
+    unsigned max_queued;
+} replay_t;
+
+static void replay(const trace_event_t *events, unsigned n, replay_t *r)
+{
+    static void *queue[MAX_EVENTS];
+    static unsigned long done[MAX_EVENTS]; /* time its handling ends */
+    unsigned head = 0U, count = 0U, i;
+    unsigned long busy_until = 0UL;
+
+    memset(r, 0, sizeof(*r));
+    for (i = 0U; i < n; i++)
+    {
+        const trace_event_t *e = &events[i];
+        void *buf;
+
+        /* Events handled by now give their buffers back */
+        while ((count != 0U) && (done[head] <= e->time))
+        {
+            wifi_free_eventbuf(queue[head]);
+            head = (head + 1U) % MAX_EVENTS;
+            count--;
+        }
+
+        r->events++;
+        r->small_events += (e->size <= CONFIG_EVENTBUF_SMALL_SIZE);
+        if (e->size > r->max_size)
+        {
+            r->max_size = e->size;
+        }
+
+        /* As the IMU RX path: allocate, copy, queue, free if the queue is full */
+        buf = wifi_malloc_eventbuf(e->size);
+        if (buf == NULL)
+        {
+            r->dropped_alloc++;
+            continue;
+        }
+        memset(buf, (int)e->id, e->size);
+        if (count == MAX_EVENTS)
+        {
+            wifi_free_eventbuf(buf);
+            r->dropped_queue++;
+            continue;
+        }
+
+        busy_until                          = ((busy_until > e->time) ? busy_until : e->time) + e->service;
+        queue[(head + count) % MAX_EVENTS] = buf;
+        done[(head + count) % MAX_EVENTS]  = busy_until;
+        count++;
+        if (count > r->max_queued)
+        {
+            r->max_queued = count;
+        }
+    }
+
+    while (count != 0U)
+    {
+        wifi_free_eventbuf(queue[head]);
+        head = (head + 1U) % MAX_EVENTS;
+        count--;
+    }
+}
+
+static void run_trace(const char *dir, const char *name)
+{
+    static trace_event_t events[TRACE_MAX_EVENTS];
+    char path[256];
+    wifi_eventbuf_stats_t before, after;
+    unsigned heap_allocs = heap.allocs, pool_allocs = pool.allocs, pool_fails = pool.fails;
+    unsigned n, large_allocs;
+    replay_t r;
+
+    snprintf(path, sizeof(path), "%s/%s.trace", dir, name);
+    n = trace_load(path, events);
+    CHECK(n != 0U);
+
+    wifi_get_eventbuf_stats(&before);
+    heap.peak = heap.in_use;
+    replay(events, n, &r);
+    wifi_get_eventbuf_stats(&after);
+
+    large_allocs = (heap.allocs - heap_allocs) + (pool.allocs - pool_allocs);
+    printf("%-15s %6u %6u %5u %5u %8u %5u %5u %6u %9zu\n", name, r.events, r.max_queued, after.small_peak,
+           after.large_peak, after.small_overflow - before.small_overflow, r.dropped_alloc, r.dropped_queue,
+           large_allocs, heap.peak);
+
+    /* Every buffer given back, the counters agree with what the replay saw */
+    CHECK(after.small_in_use == 0U);
+    CHECK(after.large_in_use == 0U);
+    CHECK(heap.in_use == 0U);
+    CHECK(pool.in_use == 0U);
+    CHECK(after.max_size >= r.max_size);
+    CHECK(after.alloc_fail - before.alloc_fail == r.dropped_alloc);
+    CHECK(pool.fails - pool_fails == r.dropped_alloc);
+    CHECK(after.small_peak <= CONFIG_EVENTBUF_SMALL_NUM);
+    /* Only events too big for the small buffers, or finding them all in
+     * use, go to the heap or pool */
+    CHECK(large_allocs == (r.events - (CONFIG_EVENTBUF_SMALL_NUM ? r.small_events : 0U)) +
+                              (after.small_overflow - before.small_overflow));
+#if CONFIG_MEM_POOLS
+    CHECK(heap.allocs == heap_allocs);
+#else
+    CHECK(pool.allocs == pool_allocs);
+    CHECK(r.dropped_alloc == 0U);
+#endif
+}
+
+int main(int argc, char *argv[])
+{
+    const char *dir = (argc > 1) ? argv[1] : "events";
+    wifi_eventbuf_stats_t stats;
+
+    printf("CONFIG_EVENTBUF_SMALL_NUM %u of %u B, large buffers from the %s, MAX_EVENTS %u\n",
+           (unsigned)CONFIG_EVENTBUF_SMALL_NUM, (unsigned)CONFIG_EVENTBUF_SMALL_SIZE,
+           CONFIG_MEM_POOLS ? "pool of " HOST_STR(HOST_EVENT_POOL_BUFS) " x 2560 B" : "heap", MAX_EVENTS);
+    /* The buffer peaks are those of wifi_get_eventbuf_stats(), since the start */
+    printf("%-15s %6s %6s %5s %5s %8s %5s %5s %6s %9s\n", "trace", "events", "queued", "small", "large", "overflow",
+           "drop", "full", "allocs", "heap peak");
+
+    run_trace(dir, "connected_idle");
+    run_trace(dir, "scan");
+    run_trace(dir, "roaming");
+
+    wifi_get_eventbuf_stats(&stats);
+    CHECK(stats.max_size == 2004U);
+
+    return host_test_result();
+}
@@ -0,0 +1,174 @@
+/*
+ * flow_stats_bench.c
+ * Host benchmark of the per-flow accounting: cost per update with the PCB
+ * hint, through the hash index and with LRU eviction, plus table checks
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "lwip/flow_stats.h"
+
+#include "host_test.h"
+
+#define ROUNDS 2000000U
+
+/* What the hot path costs without the table: the call and the argument setup */
+static volatile u32_t sink;
+
+static void __attribute__((noinline))
+nop_update(u8_t proto, const ip_addr_t *local_ip, u16_t local_port, const ip_addr_t *remote_ip,
+           u16_t remote_port, u8_t *hint, u8_t what, u32_t val)
+{
+    sink += val;
+}
+
+typedef void (*update_fn)(u8_t, const ip_addr_t *, u16_t, const ip_addr_t *, u16_t, u8_t *, u8_t, u32_t);
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static ip_addr_t local_ip;
+static ip_addr_t peers[64];
+
+/*
+ * Account ROUNDS segments spread round robin over flows peers, each flow
+ * with its own PCB hint, or without hints like an unconnected UDP PCB.
+ */
+static double run(update_fn fn, unsigned flows, int use_hint)
+{
+    u8_t hints[64];
+    unsigned i;
+    double start;
+
+    memset(hints, 0, sizeof(hints));
+    start = now_ns();
+    for (i = 0U; i < ROUNDS; i++)
+    {
+        unsigned f = i % flows;
+
+        fn(IP_PROTO_TCP, &local_ip, 80, &peers[f], (u16_t)(49152U + f), use_hint ? &hints[f] : NULL,
+           FLOW_STATS_RX, 1460U);
+    }
+    return (now_ns() - start) / ROUNDS;
+}
+
+/* Print one row, return the chain steps per lookup that missed the hint */
+static double bench(const char *name, unsigned flows, int use_hint)
+{
+    double base, cost;
+    u32_t misses;
+
+    flow_stats_reset();
+    base   = run(nop_update, flows, use_hint);
+    cost   = run(flow_stats_update, flows, use_hint);
+    misses = flow_stats_cost.lookups - flow_stats_cost.hint_hits;
+    printf("%-28s %5u %9.1f %9.1f %9.1f %8.3f %8.2f %8.3f\n", name, flows, base, cost, cost - base,
+           (double)flow_stats_cost.hint_hits / flow_stats_cost.lookups,
+           misses ? (double)flow_stats_cost.probes / misses : 0.0,
+           (double)flow_stats_cost.evictions / flow_stats_cost.lookups);
+    return misses ? (double)flow_stats_cost.probes / misses : 0.0;
+}
+
+/* One segment of flow i, with its own hint */
+#define FLOW_STATS_UPDATE_TEST(i)                                                                      \
+    flow_stats_update(IP_PROTO_TCP, &local_ip, 80, &peers[i], (u16_t)(49152U + (i)), &hints[i], FLOW_STATS_RX, \
+                      100U)
+
+static void test_table(void)
+{
+    const struct flow_stats_entry *top[4];
+    const struct flow_stats_entry *e = NULL;
+    u8_t hints[FLOW_STATS_TABLE_SIZE + 1];
+    unsigned i, n = 0U;
+
+    flow_stats_reset();
+    memset(hints, 0, sizeof(hints));
+    /* flow i carries i + 1 segments */
+    for (i = 0U; i < FLOW_STATS_TABLE_SIZE; i++)
+    {
+        unsigned k;
+
+        for (k = 0U; k <= i; k++)
+        {
+            FLOW_STATS_UPDATE_TEST(i);
+        }
+    }
+    CHECK(flow_stats_cost.inserts == FLOW_STATS_TABLE_SIZE);
+    CHECK(flow_stats_cost.evictions == 0U);
+    /* after the first segment every update resolves through its hint */
+    CHECK(flow_stats_cost.hint_hits == flow_stats_cost.lookups - FLOW_STATS_TABLE_SIZE);
+    while ((e = flow_stats_next(e)) != NULL)
+    {
+        n++;
+    }
+    CHECK(n == FLOW_STATS_TABLE_SIZE);
+
+    CHECK(flow_stats_top(top, 4) == 4);
+    for (i = 0U; i < 4U; i++)
+    {
+        CHECK(top[i]->remote_port == 49152U + FLOW_STATS_TABLE_SIZE - 1U - i);
+        CHECK(top[i]->rx_bytes == 100U * (FLOW_STATS_TABLE_SIZE - i));
+    }
+
+    /* flow 0 is touched again, so a new flow evicts flow 1, the least recently used */
+    FLOW_STATS_UPDATE_TEST(0);
+    FLOW_STATS_UPDATE_TEST(FLOW_STATS_TABLE_SIZE);
+    CHECK(flow_stats_cost.evictions == 1U);
+    for (e = NULL, n = 0U; (e = flow_stats_next(e)) != NULL;)
+    {
+        CHECK(e->remote_port != 49153U);
+        n += (e->remote_port == 49152U);
+    }
+    CHECK(n == 1U);
+
+    /* a stale hint of flow 1 falls back to the hash index and re-adds the flow */
+    FLOW_STATS_UPDATE_TEST(1);
+    CHECK(flow_stats_cost.evictions == 2U);
+    flow_stats_update(IP_PROTO_UDP, &local_ip, 53, &peers[2], 49154U, NULL, FLOW_STATS_RTT, 70000U);
+    for (e = NULL; (e = flow_stats_next(e)) != NULL;)
+    {
+        if (e->proto == IP_PROTO_UDP)
+        {
+            CHECK(e->rtt_samples == 1U && e->rtt_max_ms == 0xffffU && e->rtt_min_ms == 0xffffU);
+        }
+    }
+}
+
+int main(void)
+{
+    unsigned i;
+
+    IP_ADDR4(&local_ip, 192, 168, 1, 10);
+    for (i = 0U; i < 64U; i++)
+    {
+        IP_ADDR4(&peers[i], 192, 168, (u8_t)(i / 8U + 1U), (u8_t)(i + 20U));
+    }
+
+    test_table();
+
+    printf("FLOW_STATS_TABLE_SIZE %u, FLOW_STATS_HASH_SIZE %u, %u updates per row\n", FLOW_STATS_TABLE_SIZE,
+           FLOW_STATS_HASH_SIZE, ROUNDS);
+    printf("%-28s %5s %9s %9s %9s %8s %8s %8s\n", "case", "flows", "base ns", "ns", "added ns", "hint",
+           "probes", "evict");
+    bench("connected PCB, hint", 4U, 1);
+    bench("connected PCBs, hint", FLOW_STATS_TABLE_SIZE, 1);
+    bench("unconnected, hash index", 4U, 0);
+    /* a full table spreads over the buckets, chains stay short */
+    CHECK(bench("unconnected, hash index", FLOW_STATS_TABLE_SIZE, 0) < 2.0);
+    bench("churn, LRU eviction", 2U * FLOW_STATS_TABLE_SIZE, 1);
+    bench("churn, LRU eviction", 4U * FLOW_STATS_TABLE_SIZE, 0);
+
+    /* the worst case, a miss on a full table, stays one scan of the table */
+    CHECK(flow_stats_cost.probes <= flow_stats_cost.lookups * FLOW_STATS_TABLE_SIZE);
+
+    return host_test_result();
+}
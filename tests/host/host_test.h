@@ -0,0 +1,31 @@
+/*
+ * host_test.h
+ * Minimal check macro shared by the host tests
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+static int host_test_failures;
+
+#define CHECK(cond)                                                            \
+    do                                                                         \
+    {                                                                          \
+        if (!(cond))                                                           \
+        {                                                                      \
+            printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond);   \
+            host_test_failures++;                                              \
+        }                                                                      \
+    } while (0)
+
+static inline int host_test_result(void)
+{
+    printf("%s\n", host_test_failures == 0 ? "PASS" : "FAIL");
+    return host_test_failures == 0 ? 0 : 1;
+}
+
+#endif /* HOST_TEST_H */
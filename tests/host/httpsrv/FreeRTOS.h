@@ -0,0 +1,24 @@
+/*
+ * FreeRTOS.h
+ * The part of the FreeRTOS API the HTTPSRV sources use, for the single
+ * threaded host tests: heap from the C library, no tasks
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdlib.h>
+
+#define pdPASS (1)
+#define pdFAIL (0)
+
+#define pvPortMalloc(size) malloc(size)
+#define vPortFree(ptr)     free(ptr)
+
+#define taskYIELD()
+#define vTaskDelete(task)
+#define xTaskCreate(fn, name, stack, arg, prio, handle) (pdFAIL)
+
+#endif /* HOST_FREERTOS_H */
@@ -0,0 +1,268 @@
+/*
+ * httpsrv_host.c
+ * Host harness of the HTTPSRV sources: socket layer and lwIP OS functions
+ * of a single threaded server with one client connection
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "httpsrv_host.h"
+
+#define HOST_SOCK (1)
+
+uint32_t httpsrv_host_time;
+char httpsrv_host_out[HTTPSRV_HOST_OUT_SIZE];
+uint32_t httpsrv_host_out_len;
+uint32_t httpsrv_host_sends;
+
+static const char *host_req;
+static size_t host_req_len;
+static size_t host_req_pos;
+
+/*
+ * lwIP OS layer: nothing blocks, there is only the test's thread.
+ */
+u32_t sys_now(void)
+{
+    return httpsrv_host_time;
+}
+
+err_t sys_sem_new(sys_sem_t *sem, u8_t count)
+{
+    *sem = (void *)sem;
+    return ERR_OK;
+}
+
+void sys_sem_free(sys_sem_t *sem)
+{
+    *sem = NULL;
+}
+
+void sys_sem_signal(sys_sem_t *sem)
+{
+}
+
+u32_t sys_arch_sem_wait(sys_sem_t *sem, u32_t timeout)
+{
+    return 0;
+}
+
+err_t sys_mutex_new(sys_mutex_t *mutex)
+{
+    *mutex = (void *)mutex;
+    return ERR_OK;
+}
+
+void sys_mutex_free(sys_mutex_t *mutex)
+{
+    *mutex = NULL;
+}
+
+void sys_mutex_lock(sys_mutex_t *mutex)
+{
+}
+
+void sys_mutex_unlock(sys_mutex_t *mutex)
+{
+}
+
+void sys_msleep(u32_t ms)
+{
+    httpsrv_host_time += ms;
+}
+
+sys_thread_t sys_thread_new(const char *name, lwip_thread_fn thread, void *arg, int stacksize, int prio)
+{
+    return NULL;
+}
+
+/*
+ * Sockets: the listening socket does nothing, the connection socket reads
+ * the request and captures the response.
+ */
+int lwip_socket(int domain, int type, int protocol)
+{
+    return 0;
+}
+
+int lwip_setsockopt(int s, int level, int optname, const void *optval, socklen_t optlen)
+{
+    return 0;
+}
+
+int lwip_getsockopt(int s, int level, int optname, void *optval, socklen_t *optlen)
+{
+    /* The request is read to its end, no more data yet */
+    *(int *)optval = EWOULDBLOCK;
+    return 0;
+}
+
+int lwip_bind(int s, const struct sockaddr *name, socklen_t namelen)
+{
+    return 0;
+}
+
+int lwip_listen(int s, int backlog)
+{
+    return 0;
+}
+
+int lwip_accept(int s, struct sockaddr *addr, socklen_t *addrlen)
+{
+    return -1;
+}
+
+int lwip_select(int maxfdp1, fd_set *readset, fd_set *writeset, fd_set *exceptset, struct timeval *timeout)
+{
+    return 0;
+}
+
+int lwip_shutdown(int s, int how)
+{
+    return 0;
+}
+
+int lwip_close(int s)
+{
+    return 0;
+}
+
+int lwip_getpeername(int s, struct sockaddr *name, socklen_t *namelen)
+{
+    memset(name, 0, *namelen);
+    name->sa_family = AF_INET;
+    return 0;
+}
+
+int lwip_getsockname(int s, struct sockaddr *name, socklen_t *namelen)
+{
+    memset(name, 0, *namelen);
+    name->sa_family = AF_INET;
+    return 0;
+}
+
+const char *lwip_inet_ntop(int af, const void *src, char *dst, socklen_t size)
+{
+    snprintf(dst, size, "0.0.0.0");
+    return dst;
+}
+
+ssize_t lwip_recv(int s, void *mem, size_t len, int flags)
+{
+    size_t n = host_req_len - host_req_pos;
+
+    if ((s != HOST_SOCK) || (n == 0))
+    {
+        return -1;
+    }
+    if (n > len)
+    {
+        n = len;
+    }
+    memcpy(mem, host_req + host_req_pos, n);
+    host_req_pos += n;
+    return (ssize_t)n;
+}
+
+ssize_t lwip_send(int s, const void *dataptr, size_t size, int flags)
+{
+    if (s != HOST_SOCK)
+    {
+        return (ssize_t)size;
+    }
+    if (httpsrv_host_out_len < HTTPSRV_HOST_OUT_SIZE)
+    {
+        size_t n = LWIP_MIN(size, HTTPSRV_HOST_OUT_SIZE - httpsrv_host_out_len);
+
+        memcpy(httpsrv_host_out + httpsrv_host_out_len, dataptr, n);
+    }
+    httpsrv_host_out_len += size;
+    httpsrv_host_sends++;
+    return (ssize_t)size;
+}
+
+/* Fresh session on the connection socket, as httpsrv_ses_init() leaves it */
+static void host_session_open(HTTPSRV_SESSION_STRUCT *session)
+{
+    char *path = session->request.path;
+
+    memset(&session->request, 0, sizeof(session->request));
+    memset(&session->response, 0, sizeof(session->response));
+    session->request.path  = path;
+    session->buffer.offset = 0;
+    session->state         = HTTPSRV_SES_WAIT_REQ;
+    session->sock          = HOST_SOCK;
+    session->valid         = HTTPSRV_VALID;
+    session->timeout       = HTTPSRV_CFG_SES_TIMEOUT;
+    session->flags         = HTTPSRV_FLAG_PROCESS_HEADER;
+    if (HTTPSRV_CFG_KEEPALIVE_ENABLED)
+    {
+        session->flags |= HTTPSRV_FLAG_KEEP_ALIVE_ENABLED | HTTPSRV_FLAG_IS_KEEP_ALIVE;
+    }
+    session->time = sys_now();
+}
+
+/* What the session task does with a closed session, before the next connection */
+static void host_session_close(HTTPSRV_SESSION_STRUCT *session)
+{
+    if (session->response.file)
+    {
+        HTTPSRV_FS_close(session->response.file);
+        session->response.file = NULL;
+    }
+    httpsrv_req_auth_free(session);
+    host_session_open(session);
+}
+
+HTTPSRV_SESSION_STRUCT *httpsrv_host_session(HTTPSRV_STRUCT *server)
+{
+    HTTPSRV_SESSION_STRUCT *session;
+
+    session = mmap(NULL, sizeof(*session), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT, -1, 0);
+    if (session == MAP_FAILED)
+    {
+        return NULL;
+    }
+    memset(session, 0, sizeof(*session));
+    session->request.path = httpsrv_mem_alloc_zero(server->params.max_uri + 1);
+    session->buffer.data  = httpsrv_mem_alloc_zero(HTTPSRV_SES_BUF_SIZE_PRV);
+#if HTTPSRV_CFG_ADMISSION_ENABLED
+    session->adm = &server->adm[0];
+#endif
+    host_session_open(session);
+    return session;
+}
+
+int httpsrv_host_request(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, const char *request)
+{
+    int status = 0;
+
+    host_req             = request;
+    host_req_len         = strlen(request);
+    host_req_pos         = 0;
+    httpsrv_host_out_len = 0;
+    httpsrv_host_sends   = 0;
+    session->time        = sys_now(); /* the request arrives now */
+
+    /* Until the session closes, or waits for the next request of a keep-alive connection */
+    do
+    {
+        httpsrv_http_process(server, session);
+    } while ((session->state != HTTPSRV_SES_CLOSE) &&
+             !((session->state == HTTPSRV_SES_WAIT_REQ) && (host_req_pos == host_req_len)));
+
+    if (session->state == HTTPSRV_SES_CLOSE)
+    {
+        host_session_close(session);
+    }
+    if ((httpsrv_host_out_len > 12) && (strncmp(httpsrv_host_out, "HTTP/1.", 7) == 0))
+    {
+        status = atoi(httpsrv_host_out + 9);
+    }
+    return status;
+}
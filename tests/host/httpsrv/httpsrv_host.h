@@ -0,0 +1,37 @@
+/*
+ * httpsrv_host.h
+ * Host harness of the HTTPSRV sources: the session state machine runs in
+ * the test's thread against a socket layer which replays a request and
+ * captures the response
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HTTPSRV_HOST_H
+#define HTTPSRV_HOST_H
+
+#include "httpsrv.h"
+#include "httpsrv_prv.h"
+#include "httpsrv_supp.h"
+
+/* Captured bytes of a response, the rest is only counted */
+#define HTTPSRV_HOST_OUT_SIZE (64 * 1024)
+
+extern uint32_t httpsrv_host_time;               /* sys_now() in ms */
+extern char httpsrv_host_out[HTTPSRV_HOST_OUT_SIZE];
+extern uint32_t httpsrv_host_out_len;             /* Response bytes sent */
+extern uint32_t httpsrv_host_sends;               /* lwip_send() calls of the response */
+
+/*
+ * New session of server, at an address which fits the uint32_t session
+ * handles of the SSI and CGI API.
+ */
+HTTPSRV_SESSION_STRUCT *httpsrv_host_session(HTTPSRV_STRUCT *server);
+
+/*
+ * Run one request through the session: read, process, respond. Returns the
+ * status code of the response, 0 if there was none.
+ */
+int httpsrv_host_request(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, const char *request);
+
+#endif /* HTTPSRV_HOST_H */
@@ -0,0 +1,234 @@
+/*
+ * imu_ring_sim.c
+ * Host simulator of the IMU RX ring: budgeted polling, batched buffer return and
+ * adaptive interrupt holdoff against the per-frame interrupt and ack of the original loop
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "fsl_adapter_imu_rx_poll.h"
+#include "host_test.h"
+
+/* Model of the link, times in microseconds */
+#define SIM_FIFO_DEPTH 16U  /* IMU_MAX_MSG_CNT_LONG */
+#define SIM_RX_BUFS    32U  /* RX buffers the peer can fill before they come back */
+#define SIM_TIME_US    1000000U
+#define COST_ISR       2U   /* interrupt entry, mask and event set */
+#define COST_WAKE      3U   /* context switch into the IMU task */
+#define COST_FRAME     3U   /* read, copy and hand one frame to the driver */
+#define COST_MSG       4U   /* one buffer return message to the peer */
+#define COST_APP       6U   /* tcpip_thread work per frame, runs while the IMU task yields */
+
+typedef struct
+{
+    const char *name;
+    uint32_t budget;  /* IMU_RX_BUDGET */
+    uint32_t batch;   /* IMU_RX_FREE_BATCH */
+    uint8_t holdoff;  /* IMU_RX_HOLDOFF_MAX */
+} sim_cfg_t;
+
+typedef struct
+{
+    uint32_t produced;
+    uint32_t handled;
+    uint32_t dropped;
+    uint32_t irqs;
+    uint32_t polls;
+    uint32_t msgs;
+    uint64_t busy_us;
+    uint64_t latency_us;
+} sim_result_t;
+
+static uint32_t lcg = 1U;
+
+static double sim_rand(void)
+{
+    lcg = lcg * 1103515245U + 12345U;
+    return ((double)((lcg >> 8) & 0xFFFFFFU) + 1.0) / 16777217.0;
+}
+
+static void sim_run(const sim_cfg_t *cfg, uint32_t fps, sim_result_t *res)
+{
+    uint32_t fifo_t[SIM_FIFO_DEPTH];
+    uint32_t fifo_seq[SIM_FIFO_DEPTH];
+    uint32_t head = 0U, count = 0U, seq = 0U, expect = 0U;
+    uint32_t pool = SIM_RX_BUFS, pending = 0U;
+    bool masked = false, polling = false;
+    uint8_t holdoff = 0U;
+    uint32_t rx = 0U;
+    uint64_t busy_until = 0U;
+    double next_arrival = 0.0, mean = 1e6 / (double)fps;
+    uint32_t t;
+
+    lcg = 1U;
+    *res = (sim_result_t){0};
+    next_arrival = -log(sim_rand()) * mean;
+
+    for (t = 0U; t < SIM_TIME_US || count != 0U || polling; t++)
+    {
+        while (t < SIM_TIME_US && next_arrival <= (double)t)
+        {
+            res->produced++;
+            if (count == SIM_FIFO_DEPTH || pool == 0U)
+            {
+                res->dropped++;
+                seq++;
+            }
+            else
+            {
+                uint32_t idx = (head + count) % SIM_FIFO_DEPTH;
+                fifo_t[idx]  = t;
+                fifo_seq[idx] = seq++;
+                count++;
+                pool--;
+            }
+            next_arrival += -log(sim_rand()) * mean;
+        }
+
+        if (busy_until > t)
+        {
+            continue;
+        }
+
+        if (!polling)
+        {
+            if (masked || count == 0U)
+            {
+                continue;
+            }
+            res->irqs++;
+            masked  = true;
+            polling = true;
+            res->busy_us += COST_ISR + COST_WAKE;
+            busy_until = t + COST_ISR + COST_WAKE;
+            continue;
+        }
+
+        /* One turn of the HAL_ImuReceive() loop, frames keep arriving while it runs */
+        if (count != 0U && (cfg->budget == 0U || rx < cfg->budget))
+        {
+            uint32_t cost = COST_FRAME + COST_APP;
+
+            CHECK(fifo_seq[head] >= expect);
+            expect = fifo_seq[head] + 1U;
+            res->latency_us += t - fifo_t[head];
+            head = (head + 1U) % SIM_FIFO_DEPTH;
+            count--;
+            rx++;
+            res->handled++;
+            if (++pending == cfg->batch)
+            {
+                pool += pending;
+                pending = 0U;
+                res->msgs++;
+                cost += COST_MSG;
+            }
+            res->busy_us += cost;
+            busy_until = t + cost;
+            continue;
+        }
+
+        /* End of the call: return the rest of the buffers, then holdoff or unmask */
+        uint32_t cost = 0U;
+
+        res->polls++;
+        if (pending != 0U)
+        {
+            pool += pending;
+            pending = 0U;
+            res->msgs++;
+            cost += COST_MSG;
+        }
+        if (HAL_ImuRxHoldoffStep(&holdoff, cfg->holdoff, count != 0U))
+        {
+            cost += COST_WAKE;
+        }
+        else
+        {
+            masked  = false;
+            polling = false;
+        }
+        rx = 0U;
+        res->busy_us += cost;
+        busy_until = t + cost;
+    }
+
+    CHECK(res->handled + res->dropped == res->produced);
+    CHECK(pool == SIM_RX_BUFS);
+    CHECK(holdoff == 0U);
+}
+
+static void test_holdoff_step(void)
+{
+    uint8_t holdoff = 0U;
+    uint32_t i;
+
+    CHECK(!HAL_ImuRxHoldoffStep(&holdoff, 4U, false));
+    for (i = 0U; i < 10U; i++)
+    {
+        CHECK(HAL_ImuRxHoldoffStep(&holdoff, 4U, true));
+    }
+    CHECK(holdoff == 4U);
+    for (i = 0U; i < 4U; i++)
+    {
+        CHECK(HAL_ImuRxHoldoffStep(&holdoff, 4U, false));
+    }
+    CHECK(!HAL_ImuRxHoldoffStep(&holdoff, 4U, false));
+
+    holdoff = 0U;
+    CHECK(HAL_ImuRxHoldoffStep(&holdoff, 0U, true));
+    CHECK(holdoff == 0U);
+    CHECK(!HAL_ImuRxHoldoffStep(&holdoff, 0U, false));
+}
+
+int main(void)
+{
+    static const sim_cfg_t cfgs[] = {
+        {"per-frame", 0U, 1U, 0U},
+        {"budget+batch", 16U, 8U, 0U},
+        {"budget+batch+holdoff", 16U, 8U, IMU_RX_HOLDOFF_MAX},
+    };
+    static const uint32_t loads[] = {1000U, 10000U, 40000U, 70000U, 90000U};
+    sim_result_t res[sizeof(cfgs) / sizeof(cfgs[0])];
+    uint32_t l, c;
+
+    test_holdoff_step();
+
+    printf("%-8s %-22s %9s %9s %9s %10s %9s %9s\n", "frames/s", "config", "irq/kfr", "msg/kfr", "poll/kfr",
+           "cpu us/fr", "lat us", "drop %");
+    for (l = 0U; l < sizeof(loads) / sizeof(loads[0]); l++)
+    {
+        for (c = 0U; c < sizeof(cfgs) / sizeof(cfgs[0]); c++)
+        {
+            sim_result_t *r = &res[c];
+
+            sim_run(&cfgs[c], loads[l], r);
+            printf("%-8u %-22s %9.1f %9.1f %9.1f %10.2f %9.1f %9.2f\n", loads[l], cfgs[c].name,
+                   1000.0 * r->irqs / r->handled, 1000.0 * r->msgs / r->handled, 1000.0 * r->polls / r->handled,
+                   (double)r->busy_us / r->handled, (double)r->latency_us / r->handled,
+                   100.0 * r->dropped / r->produced);
+        }
+
+        /* Batching never costs more mailbox messages than one per frame */
+        CHECK(res[1].msgs <= res[0].msgs);
+        CHECK(res[2].msgs <= res[0].msgs);
+        /* Under load the holdoff keeps the interrupt off between polls */
+        if (loads[l] >= 40000U)
+        {
+            CHECK(res[2].irqs <= res[1].irqs);
+            CHECK(res[2].busy_us / res[2].handled <= res[0].busy_us / res[0].handled);
+        }
+        /* Nothing is lost where the per-frame loop keeps up */
+        if (res[0].dropped == 0U)
+        {
+            CHECK(res[2].dropped == 0U);
+        }
+    }
+
+    return host_test_result();
+}
@@ -0,0 +1,38 @@
+/*
+ * cc.h
+ * lwIP compiler and platform definitions of the host tests
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_CC_H
+#define HOST_CC_H
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LWIP_TIMEVAL_PRIVATE 0
+#define LWIP_ERRNO_INCLUDE   <errno.h>
+#include <sys/time.h>
+
+#define PACK_STRUCT_BEGIN
+#define PACK_STRUCT_STRUCT __attribute__((__packed__))
+#define PACK_STRUCT_END
+#define PACK_STRUCT_FIELD(x) x
+
+#define LWIP_PLATFORM_DIAG(x) \
+    do                        \
+    {                         \
+        printf x;             \
+    } while (0)
+
+#define LWIP_PLATFORM_ASSERT(x)                                                \
+    do                                                                         \
+    {                                                                          \
+        printf("Assertion \"%s\" failed at %s:%d\n", x, __FILE__, __LINE__); \
+        abort();                                                               \
+    } while (0)
+
+#define LWIP_RAND() ((u32_t)rand())
+
+#endif /* HOST_CC_H */
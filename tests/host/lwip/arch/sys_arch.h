@@ -0,0 +1,24 @@
+/*
+ * sys_arch.h
+ * lwIP OS abstraction types of the host tests which build with NO_SYS 0,
+ * single threaded: the tests provide the sys_ functions they call
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_SYS_ARCH_H
+#define HOST_SYS_ARCH_H
+
+typedef void *sys_sem_t;
+typedef void *sys_mutex_t;
+typedef void *sys_mbox_t;
+typedef void *sys_thread_t;
+
+#define sys_sem_valid(sem)           (*(sem) != NULL)
+#define sys_sem_set_invalid(sem)     (*(sem) = NULL)
+#define sys_mutex_valid(mutex)       (*(mutex) != NULL)
+#define sys_mutex_set_invalid(mutex) (*(mutex) = NULL)
+#define sys_mbox_valid(mbox)         (*(mbox) != NULL)
+#define sys_mbox_set_invalid(mbox)   (*(mbox) = NULL)
+
+#endif /* HOST_SYS_ARCH_H */
@@ -0,0 +1,71 @@
+/*
+ * lwipopts.h
+ * lwIP options of the host tests: NO_SYS core with the DNS and TCP settings
+ * of source/lwipopts.h. Each target enables the protocols it builds.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_LWIPOPTS_H
+#define HOST_LWIPOPTS_H
+
+#ifndef NO_SYS
+#define NO_SYS               1
+#endif
+#define SYS_LIGHTWEIGHT_PROT 0
+#define LWIP_NETCONN         0
+#ifndef LWIP_SOCKET
+#define LWIP_SOCKET          0
+#endif
+#define LWIP_IPV4            1
+#define LWIP_IPV6            0
+#ifndef LWIP_UDP
+#define LWIP_UDP             1
+#endif
+#ifndef LWIP_TCP
+#define LWIP_TCP             0
+#endif
+#ifndef LWIP_STATS
+#define LWIP_STATS           0
+#endif
+#define LWIP_ARP             0
+#define LWIP_ETHERNET        0
+#define LWIP_ICMP            0
+#define LWIP_RAW             0
+#define IP_REASSEMBLY        0
+#define IP_FRAG              0
+#define MEM_LIBC_MALLOC      1
+#ifndef MEMP_MEM_MALLOC
+#define MEMP_MEM_MALLOC      1
+#endif
+#define MEM_ALIGNMENT        8
+
+/* As in source/lwipopts.h */
+#ifndef LWIP_DNS
+#define LWIP_DNS             1
+#endif
+#ifndef LWIP_DNS_SECURE
+#define LWIP_DNS_SECURE      0
+#endif
+#define DNS_TABLE_SIZE       8
+#define DNS_NEG_TTL_NXDOMAIN 60
+#define DNS_NEG_TTL_FAILURE  5
+#define DNS_PREFETCH_TIME    10
+#define DNS_MAX_NAME_LENGTH  64
+#define DNS_MAX_SERVERS      2
+#define DNS_DOES_NAME_CHECK  1
+
+/* As in source/lwipopts.h, the pool sizes matter with MEMP_MEM_MALLOC 0 */
+#define PBUF_POOL_SIZE           40
+#define PBUF_POOL_BUFSIZE        1580
+#define MEMP_NUM_PBUF            10
+#define LWIP_SUPPORT_CUSTOM_PBUF 1
+
+/* As in source/lwipopts.h with CONFIG_NETWORK_HIGH_PERF */
+#define TCP_MSS              1460
+#define TCP_SND_BUF          (12 * TCP_MSS)
+#define TCP_WND              (15 * TCP_MSS)
+#define MEMP_NUM_TCP_SEG     48
+#define LWIP_TCP_CC          1
+
+#endif /* HOST_LWIPOPTS_H */
@@ -0,0 +1,94 @@
+/*
+ * mlan_api.h
+ * The declarations mlan_11n_aggr.c and wifi-mem.c use, as in mlan_decl.h,
+ * mlan_fw.h, mlan_main.h and wifi.h, for building them on the host
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_MLAN_API_H
+#define HOST_MLAN_API_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+
+typedef uint8_t t_u8;
+typedef uint16_t t_u16;
+typedef uint32_t t_u32;
+typedef int32_t t_s32;
+typedef void t_void;
+
+typedef enum _mlan_status
+{
+    MLAN_STATUS_FAILURE = 0xffffffff,
+    MLAN_STATUS_SUCCESS = 0,
+} mlan_status;
+
+#define IN
+#define OUT
+
+#define MNULL                   ((void *)0)
+#define MBIT(x)                 (((t_u32)1) << (x))
+#define MLAN_MAC_ADDR_LENGTH    6U
+#define MLAN_RX_DATA_BUF_SIZE   (4 * 1024)
+#define MLAN_BUF_FLAG_AMSDU_REF MBIT(4)
+#define LLC_SNAP_LEN            8
+
+typedef struct _mlan_buffer
+{
+    t_u32 flags;
+    t_void *pdesc;
+    t_void *lwip_pbuf;
+    t_u8 *pbuf;
+    t_u32 data_offset;
+    t_u32 data_len;
+    t_u32 use_count;
+} mlan_buffer, *pmlan_buffer;
+
+typedef struct _mlan_private mlan_private;
+
+typedef struct
+{
+    t_u8 dest_addr[MLAN_MAC_ADDR_LENGTH];
+    t_u8 src_addr[MLAN_MAC_ADDR_LENGTH];
+    t_u16 h803_len;
+} Eth803Hdr_t;
+
+typedef struct
+{
+    t_u8 llc_dsap;
+    t_u8 llc_ssap;
+    t_u8 llc_ctrl;
+    t_u8 snap_oui[3];
+    t_u16 snap_type;
+} Rfc1042Hdr_t;
+
+typedef struct __attribute__((packed))
+{
+    Eth803Hdr_t eth803_hdr;
+    Rfc1042Hdr_t rfc1042_hdr;
+} RxPacketHdr_t;
+
+#define mlan_ntohs(x) ((t_u16)((((t_u16)(x)&0x00ffU) << 8) | (((t_u16)(x)&0xff00U) >> 8)))
+
+typedef struct
+{
+    t_u32 small_in_use;
+    t_u32 small_peak;
+    t_u32 large_in_use;
+    t_u32 large_peak;
+    t_u32 small_overflow;
+    t_u32 alloc_fail;
+    t_u32 max_size;
+} wifi_eventbuf_stats_t;
+
+void *wifi_malloc_eventbuf(size_t size);
+void wifi_free_eventbuf(void *buffer);
+void wifi_get_eventbuf_stats(wifi_eventbuf_stats_t *stats);
+
+#define ENTER()
+#define LEAVE()
+#define PRINTM(level, ...)
+
+#endif /* HOST_MLAN_API_H */
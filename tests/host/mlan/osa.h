@@ -0,0 +1,58 @@
+/*
+ * osa.h
+ * The OSA functions of the mlan sources built on the host. Memory functions
+ * are defined by each test. Nothing is preempted: critical sections are
+ * empty and mutexes are always free.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_OSA_H
+#define HOST_OSA_H
+
+#include <stdint.h>
+
+typedef void *MemoryPool_t;
+
+extern MemoryPool_t buf_2560_MemoryPool;
+
+void *OSA_MemoryAllocate(uint32_t memLength);
+void OSA_MemoryFree(void *p);
+void *OSA_MemoryPoolAllocate(MemoryPool_t pool);
+void OSA_MemoryPoolFree(MemoryPool_t pool, void *memory);
+
+#define OSA_SR_ALLOC()
+#define OSA_ENTER_CRITICAL()
+#define OSA_EXIT_CRITICAL()
+
+typedef enum
+{
+    KOSA_StatusSuccess = 0,
+    KOSA_StatusError   = 1,
+} osa_status_t;
+
+typedef void *osa_mutex_handle_t;
+
+#define osaWaitForever_c               0xFFFFFFFFU
+#define OSA_MUTEX_HANDLE_DEFINE(name) uint32_t name[1]
+
+static inline osa_status_t OSA_MutexCreate(osa_mutex_handle_t mutexHandle)
+{
+    (void)mutexHandle;
+    return KOSA_StatusSuccess;
+}
+
+static inline osa_status_t OSA_MutexLock(osa_mutex_handle_t mutexHandle, uint32_t millisec)
+{
+    (void)mutexHandle;
+    (void)millisec;
+    return KOSA_StatusSuccess;
+}
+
+static inline osa_status_t OSA_MutexUnlock(osa_mutex_handle_t mutexHandle)
+{
+    (void)mutexHandle;
+    return KOSA_StatusSuccess;
+}
+
+#endif /* HOST_OSA_H */
@@ -0,0 +1,14 @@
+/*
+ * wifi-debug.h
+ * Debug logs of the driver, off on the host
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_WIFI_DEBUG_H
+#define HOST_WIFI_DEBUG_H
+
+#define w_mem_d(...)
+#define w_mem_e(...)
+
+#endif /* HOST_WIFI_DEBUG_H */
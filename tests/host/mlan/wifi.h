@@ -0,0 +1,34 @@
+/*
+ * wifi.h
+ * The VDLL declarations of wifi.h and wifi-internal.h, for building
+ * wifi_vdll.c on the host
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "mlan_api.h"
+
+typedef struct
+{
+    t_u32 requests;
+    t_u32 hits;
+    t_u32 prefetches;
+    t_u32 prefetch_hits;
+    t_u32 stalls;
+    t_u32 stall_ms_total;
+    t_u32 stall_ms_max;
+} wifi_vdll_stats_t;
+
+void wifi_get_vdll_stats(wifi_vdll_stats_t *stats);
+
+void wifi_vdll_init(void);
+void wifi_vdll_reset(void);
+const t_u8 *wifi_vdll_block(const t_u8 *image, t_u32 image_len, t_u32 offset, t_u16 len);
+void wifi_vdll_block_sent(const t_u8 *image, t_u32 image_len);
+void wifi_vdll_command(t_u16 command, const t_u8 *image, t_u32 image_len);
+void wifi_vdll_stall(t_u32 stall_ms);
+
+#endif /* HOST_WIFI_H */
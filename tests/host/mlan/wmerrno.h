@@ -0,0 +1,6 @@
+/*
+ * wmerrno.h
+ * Empty: nothing of it is used by the mlan sources built on the host
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
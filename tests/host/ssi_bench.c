@@ -0,0 +1,134 @@
+/*
+ * ssi_bench.c
+ * Host benchmark of server side includes: a status page served from its
+ * precompiled template against the run time scan for script tokens
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "httpsrv_host.h"
+
+#include "host_test.h"
+
+#define PAGES    20000U
+#define SSI_CNT  20U /* SSI calls in root/status.shtml */
+#define MAX_DIR  8U
+
+/* Image generated from root/ by httpsrv_ssi_compile.py --ssi wifi,net,sys */
+extern const HTTPSRV_FS_DIR_ENTRY httpsrv_fs_data[];
+
+/* The same image without the templates, served by httpsrv_sendextstr() */
+static HTTPSRV_FS_DIR_ENTRY scan_fs[MAX_DIR];
+
+static const char request[] = "GET /status.shtml HTTP/1.1\r\nHost: device\r\nUser-Agent: ssi_bench\r\n\r\n";
+static unsigned ssi_calls;
+
+static int ssi_value(HTTPSRV_SSI_PARAM_STRUCT *param)
+{
+    char value[48];
+    int n;
+
+    ssi_calls++;
+    n = snprintf(value, sizeof(value), "[%s]", param->com_param);
+    HTTPSRV_ssi_write(param->ses_handle, value, (uint32_t)n);
+    return 0;
+}
+
+static const HTTPSRV_SSI_LINK_STRUCT ssi_tbl[] = {
+    {"wifi", ssi_value},
+    {"net", ssi_value},
+    {"sys", ssi_value},
+    {0, 0},
+};
+
+static double now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/* ns per page, sends per page in *sends */
+static double bench(HTTPSRV_STRUCT *server, HTTPSRV_SESSION_STRUCT *session, double *sends)
+{
+    uint64_t calls = 0U;
+    unsigned i;
+    double start;
+
+    start = now_ns();
+    for (i = 0U; i < PAGES; i++)
+    {
+        httpsrv_host_request(server, session, request);
+        calls += httpsrv_host_sends;
+    }
+    *sends = (double)calls / PAGES;
+    return (now_ns() - start) / PAGES;
+}
+
+int main(void)
+{
+    static char template_out[HTTPSRV_HOST_OUT_SIZE];
+    HTTPSRV_PARAM_STRUCT params;
+    HTTPSRV_STRUCT *server;
+    HTTPSRV_SESSION_STRUCT *session;
+    uint32_t template_len;
+    unsigned i;
+    double tpl_ns, scan_ns, tpl_sends, scan_sends;
+
+    for (i = 0U; (i < MAX_DIR - 1U) && (httpsrv_fs_data[i].NAME != NULL); i++)
+    {
+        scan_fs[i]           = httpsrv_fs_data[i];
+        scan_fs[i].SSI       = NULL;
+        scan_fs[i].SSI_COUNT = 0U;
+    }
+
+    memset(&params, 0, sizeof(params));
+    params.ssi_lnk_tbl = ssi_tbl;
+    server             = httpsrv_create_server(&params);
+    CHECK(server != NULL);
+    if (server == NULL)
+    {
+        return host_test_result();
+    }
+    CHECK(server->ssi_cnt == 3U);
+    session = httpsrv_host_session(server);
+    CHECK(session != NULL);
+
+    /* Both paths produce the same page */
+    HTTPSRV_FS_init(httpsrv_fs_data);
+    ssi_calls = 0U;
+    CHECK(httpsrv_host_request(server, session, request) == 200);
+    CHECK(ssi_calls == SSI_CNT);
+    CHECK(httpsrv_host_out_len < HTTPSRV_HOST_OUT_SIZE);
+    template_len = httpsrv_host_out_len;
+    memcpy(template_out, httpsrv_host_out, template_len);
+    CHECK(strstr(template_out, "<%") == NULL);
+    CHECK(strstr(template_out, "<td class=\"value\">[ssid]</td>") != NULL);
+    CHECK(strstr(template_out, "<td class=\"value\">[build]</td>") != NULL);
+
+    HTTPSRV_FS_init(scan_fs);
+    ssi_calls = 0U;
+    CHECK(httpsrv_host_request(server, session, request) == 200);
+    CHECK(ssi_calls == SSI_CNT);
+    CHECK(httpsrv_host_out_len == template_len);
+    CHECK(memcmp(httpsrv_host_out, template_out, template_len) == 0);
+
+    HTTPSRV_FS_init(httpsrv_fs_data);
+    tpl_ns = bench(server, session, &tpl_sends);
+    HTTPSRV_FS_init(scan_fs);
+    scan_ns = bench(server, session, &scan_sends);
+
+    printf("status.shtml: %u bytes, %u SSI calls, session buffer %u bytes, %u pages per row\n",
+           (unsigned)scan_fs[0].SIZE, SSI_CNT, (unsigned)HTTPSRV_SES_BUF_SIZE_PRV, PAGES);
+    printf("%-22s %10s %10s %8s\n", "path", "ns/page", "ns/KB", "sends");
+    printf("%-22s %10.0f %10.0f %8.1f\n", "compiled template", tpl_ns, tpl_ns * 1024.0 / template_len, tpl_sends);
+    printf("%-22s %10.0f %10.0f %8.1f\n", "token scan", scan_ns, scan_ns * 1024.0 / template_len, scan_sends);
+    printf("template saves %.0f%% of the page time\n", 100.0 * (scan_ns - tpl_ns) / scan_ns);
+
+    return host_test_result();
+}
@@ -0,0 +1,332 @@
+/*
+ * tcp_cc_sim.c
+ * Host comparison of the TCP congestion control algorithms: a bulk transfer
+ * between two lwIP endpoints over a simulated Wi-Fi link with random loss
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+
+#include "lwip/init.h"
+#include "lwip/ip4.h"
+#include "lwip/netif.h"
+#include "lwip/pbuf.h"
+#include "lwip/priv/tcp_priv.h"
+#include "lwip/tcp.h"
+#include "lwip/tcp_cc.h"
+
+#include "host_test.h"
+
+/* Link model, times in microseconds */
+#define STEP_US     50U
+#define SIM_US      30000000U /* 30 s transfer */
+#define DELAY_US    5000U     /* one way propagation, 10 ms RTT */
+#define QUEUE_PKTS  32U       /* forward queue of the AP, drop tail */
+#define PKT_MAX     64U
+#define SEEDS       8U        /* runs per scenario and algorithm, each with its own loss pattern */
+
+typedef struct
+{
+    struct pbuf *p;
+    u32_t at; /* delivery time */
+} link_pkt_t;
+
+typedef struct
+{
+    link_pkt_t pkt[PKT_MAX];
+    unsigned head, cnt;
+} link_fifo_t;
+
+typedef struct
+{
+    const char *name;
+    u32_t rate_kbps; /* forward link rate */
+    u32_t loss_ppm;  /* random loss per data packet, after air time */
+    u32_t queue;     /* forward queue limit in packets */
+    int veno_wins;   /* Veno must match or beat Reno on average */
+} scenario_t;
+
+static u32_t now_us;
+static u32_t rng;
+static const scenario_t *cur;
+
+static link_fifo_t fwd_queue; /* waiting for air time, at = 0 */
+static link_fifo_t fwd_air;   /* sent, reaching the receiver at .at */
+static link_fifo_t rev;       /* ACKs */
+static u32_t air_free_at;
+static u32_t drops_random, drops_queue;
+
+static struct netif if_snd, if_rcv;
+static struct tcp_pcb *snd_pcb;
+static u32_t rx_bytes;
+static u8_t payload[TCP_MSS];
+
+u32_t sys_now(void)
+{
+    return now_us / 1000U;
+}
+
+/* tcp_tmr() is called from the simulation loop */
+void tcp_timer_needed(void)
+{
+}
+
+static u32_t rand32(void)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return rng >> 1;
+}
+
+static int fifo_put(link_fifo_t *f, struct pbuf *p, u32_t at)
+{
+    if (f->cnt == PKT_MAX)
+    {
+        return 0;
+    }
+    f->pkt[(f->head + f->cnt) % PKT_MAX].p  = p;
+    f->pkt[(f->head + f->cnt) % PKT_MAX].at = at;
+    f->cnt++;
+    return 1;
+}
+
+static struct pbuf *fifo_get(link_fifo_t *f)
+{
+    struct pbuf *p = f->pkt[f->head].p;
+
+    f->head = (f->head + 1U) % PKT_MAX;
+    f->cnt--;
+    return p;
+}
+
+static err_t link_output(struct netif *netif, struct pbuf *p, const ip4_addr_t *dst)
+{
+    struct pbuf *q = pbuf_clone(PBUF_RAW, PBUF_RAM, p);
+
+    if (q == NULL)
+    {
+        return ERR_MEM;
+    }
+    if (ip4_addr_eq(dst, netif_ip4_addr(&if_rcv)))
+    {
+        /* towards the station: queued behind the AP radio */
+        if ((fwd_queue.cnt >= cur->queue) || !fifo_put(&fwd_queue, q, 0U))
+        {
+            drops_queue++;
+            pbuf_free(q);
+        }
+    }
+    else if (!fifo_put(&rev, q, now_us + DELAY_US))
+    {
+        pbuf_free(q);
+    }
+    return ERR_OK;
+}
+
+static err_t link_netif_init(struct netif *netif)
+{
+    netif->output = link_output;
+    netif->mtu    = 1500;
+    netif->flags  = NETIF_FLAG_LINK_UP;
+    return ERR_OK;
+}
+
+static void link_step(void)
+{
+    /* the radio sends the head of the queue when it is free */
+    if ((fwd_queue.cnt != 0U) && (now_us >= air_free_at))
+    {
+        struct pbuf *p = fifo_get(&fwd_queue);
+        u32_t air      = (p->tot_len * 8U * 1000U) / cur->rate_kbps;
+
+        air_free_at = now_us + air;
+        if ((rand32() % 1000000U) < cur->loss_ppm)
+        {
+            /* lost after the last retry, not caused by the queue */
+            drops_random++;
+            pbuf_free(p);
+        }
+        else if (!fifo_put(&fwd_air, p, now_us + air + DELAY_US))
+        {
+            pbuf_free(p);
+        }
+    }
+    while ((fwd_air.cnt != 0U) && (fwd_air.pkt[fwd_air.head].at <= now_us))
+    {
+        ip4_input(fifo_get(&fwd_air), &if_rcv);
+    }
+    while ((rev.cnt != 0U) && (rev.pkt[rev.head].at <= now_us))
+    {
+        ip4_input(fifo_get(&rev), &if_snd);
+    }
+}
+
+static void snd_fill(struct tcp_pcb *pcb)
+{
+    while (tcp_sndbuf(pcb) >= TCP_MSS && tcp_sndqueuelen(pcb) < TCP_SND_QUEUELEN)
+    {
+        if (tcp_write(pcb, payload, TCP_MSS, 0) != ERR_OK)
+        {
+            break;
+        }
+    }
+    tcp_output(pcb);
+}
+
+static err_t snd_sent(void *arg, struct tcp_pcb *pcb, u16_t len)
+{
+    snd_fill(pcb);
+    return ERR_OK;
+}
+
+static void snd_err(void *arg, err_t err)
+{
+    snd_pcb = NULL;
+}
+
+static err_t snd_connected(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    tcp_sent(pcb, snd_sent);
+    snd_fill(pcb);
+    return ERR_OK;
+}
+
+static err_t rcv_recv(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err)
+{
+    if (p != NULL)
+    {
+        rx_bytes += p->tot_len;
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+    }
+    return ERR_OK;
+}
+
+static err_t rcv_accept(void *arg, struct tcp_pcb *pcb, err_t err)
+{
+    tcp_recv(pcb, rcv_recv);
+    return ERR_OK;
+}
+
+static void link_flush(link_fifo_t *f)
+{
+    while (f->cnt != 0U)
+    {
+        pbuf_free(fifo_get(f));
+    }
+}
+
+/* Goodput in kbit/s of one transfer with the given algorithm */
+static u32_t sim_run(const scenario_t *s, const struct tcp_cc_ops *cc, u32_t seed)
+{
+    struct tcp_pcb *lpcb;
+    ip4_addr_t a, b;
+    u32_t next_tmr = 0U;
+
+    cur          = s;
+    rng          = seed;
+    now_us       = 0U;
+    air_free_at  = 0U;
+    rx_bytes     = 0U;
+    drops_random = 0U;
+    drops_queue  = 0U;
+
+    lpcb = tcp_new();
+    tcp_bind(lpcb, IP_ADDR_ANY, 80);
+    lpcb = tcp_listen(lpcb);
+    tcp_accept(lpcb, rcv_accept);
+
+    snd_pcb = tcp_new();
+    tcp_set_cc(snd_pcb, cc);
+    tcp_err(snd_pcb, snd_err);
+    a = *netif_ip4_addr(&if_snd);
+    b = *netif_ip4_addr(&if_rcv);
+    tcp_bind(snd_pcb, &a, 0);
+    tcp_connect(snd_pcb, &b, 80, snd_connected);
+
+    for (; now_us < SIM_US; now_us += STEP_US)
+    {
+        link_step();
+        if (now_us >= next_tmr)
+        {
+            tcp_tmr();
+            next_tmr += TCP_TMR_INTERVAL * 1000U;
+        }
+    }
+
+    CHECK(snd_pcb != NULL);
+    if (snd_pcb != NULL)
+    {
+        tcp_abort(snd_pcb);
+    }
+    tcp_close(lpcb);
+    while (tcp_active_pcbs != NULL)
+    {
+        tcp_abort(tcp_active_pcbs);
+    }
+    /* with the RSTs of the aborts */
+    link_flush(&fwd_queue);
+    link_flush(&fwd_air);
+    link_flush(&rev);
+    return (u32_t)(((u64_t)rx_bytes * 8U) / (SIM_US / 1000U));
+}
+
+int main(void)
+{
+    static const scenario_t scenarios[] = {
+        {"20 Mbps, no loss", 20000U, 0U, QUEUE_PKTS, 1},
+        {"20 Mbps, 0.5% loss", 20000U, 5000U, QUEUE_PKTS, 1},
+        {"20 Mbps, 1% loss", 20000U, 10000U, QUEUE_PKTS, 1},
+        {"20 Mbps, 2% loss", 20000U, 20000U, QUEUE_PKTS, 1},
+        {"20 Mbps, 5% loss", 20000U, 50000U, QUEUE_PKTS, 1},
+        /* congestion losses only */
+        {"6 Mbps, 4 pkt queue", 6000U, 0U, 4U, 1},
+        /* both: Veno grows every other round trip while the queue is full */
+        {"6 Mbps, 4 pkt queue, 1%", 6000U, 10000U, 4U, 0},
+    };
+    ip4_addr_t ip, mask, gw;
+    unsigned i;
+
+    lwip_init();
+    IP4_ADDR(&mask, 255, 255, 255, 0);
+    ip4_addr_set_zero(&gw);
+    IP4_ADDR(&ip, 10, 0, 0, 1);
+    netif_add(&if_snd, &ip, &mask, &gw, NULL, link_netif_init, ip4_input);
+    IP4_ADDR(&ip, 10, 0, 1, 1);
+    netif_add(&if_rcv, &ip, &mask, &gw, NULL, link_netif_init, ip4_input);
+    netif_set_up(&if_snd);
+    netif_set_up(&if_rcv);
+
+    printf("TCP_MSS %u, TCP_SND_BUF %u, TCP_WND %u, RTT %u ms, %u s per run\n", TCP_MSS, TCP_SND_BUF, TCP_WND,
+           2U * DELAY_US / 1000U, SIM_US / 1000000U);
+    printf("%-26s %10s %10s %8s %8s\n", "link", "reno kbps", "veno kbps", "gain", "worst");
+    for (i = 0U; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        u32_t reno = 0U, veno = 0U, seed;
+        double worst = 1e9;
+
+        for (seed = 1U; seed <= SEEDS; seed++)
+        {
+            u32_t r = sim_run(&scenarios[i], &tcp_cc_reno, seed);
+            u32_t v = sim_run(&scenarios[i], &tcp_cc_veno, seed);
+
+            CHECK(r != 0U && v != 0U);
+            reno += r;
+            veno += v;
+            if (r != 0U && 100.0 * ((double)v - r) / r < worst)
+            {
+                worst = 100.0 * ((double)v - r) / r;
+            }
+        }
+        reno /= SEEDS;
+        veno /= SEEDS;
+        printf("%-26s %10u %10u %7.1f%% %7.1f%%\n", scenarios[i].name, reno, veno,
+               reno ? 100.0 * ((double)veno - reno) / reno : 0.0, worst);
+        if (scenarios[i].veno_wins)
+        {
+            CHECK(veno >= reno);
+        }
+    }
+
+    return host_test_result();
+}
@@ -0,0 +1,419 @@
+/*
+ * telemetry_ring_sim.c
+ * Host test of the telemetry ring: batch format round trip, overwrite and
+ * commit rules, and the bytes per sample of the batched upload against one
+ * MQTT publish per sample
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "telemetry_ring.h"
+
+#include "host_test.h"
+
+/* As in source/mqtt_freertos.c */
+#define TELEMETRY_BATCH_MAX 192
+#define STEP_DELAY_MS       100
+#define OFF_DELAY_MS        5000
+#define TOPIC_HISTORY       "tank/oxygen_history"
+#define TOPIC_LEVEL         "tank/oxygen_level"
+
+#define SIM_MS      600000U /* 10 minutes of samples per run */
+#define LOG_MAX     8192U
+#define TCPIP_HDR   40U     /* IPv4 and TCP header of a segment */
+#define MQTT_PUBACK 4U
+
+typedef struct
+{
+    const char *name;
+    /* next sample after *time, returns 0 when the value did not change */
+    int (*next)(uint32_t *time, int32_t *value);
+} signal_t;
+
+static telemetry_sample_t sent_log[LOG_MAX];
+static uint32_t sent_cnt;
+static uint32_t rng;
+static int demo_dir;
+
+static uint32_t rand32(void)
+{
+    rng = rng * 1103515245UL + 12345UL;
+    return rng >> 1;
+}
+
+static size_t get_varint(const uint8_t *buf, size_t pos, size_t len, uint32_t *v)
+{
+    unsigned shift = 0U;
+
+    *v = 0U;
+    do
+    {
+        if ((pos >= len) || (shift > 28U))
+        {
+            return 0;
+        }
+        *v |= (uint32_t)(buf[pos] & 0x7FU) << shift;
+        shift += 7U;
+    } while (buf[pos++] & 0x80U);
+    return pos;
+}
+
+/* Decoder of the batch format of telemetry_ring.h, returns the sample count or -1 */
+static int decode(const uint8_t *buf, size_t len, telemetry_sample_t *out, uint32_t max)
+{
+    uint32_t count, i, t, v;
+    size_t pos;
+
+    pos = get_varint(buf, 0, len, &count);
+    if ((pos == 0) || (count == 0U) || (count > max))
+    {
+        return -1;
+    }
+    for (i = 0U; i < count; i++)
+    {
+        pos = get_varint(buf, pos, len, &t);
+        pos = pos ? get_varint(buf, pos, len, &v) : 0;
+        if (pos == 0)
+        {
+            return -1;
+        }
+        v = (v >> 1) ^ (0U - (v & 1U));
+        out[i].time  = (i == 0U) ? t : out[i - 1U].time + t;
+        out[i].value = (int32_t)((i == 0U) ? v : (uint32_t)out[i - 1U].value + v);
+    }
+    return (pos == len) ? (int)count : -1;
+}
+
+static void drain(void)
+{
+    uint8_t buf[TELEMETRY_BATCH_MAX];
+
+    while (telemetry_ring_pending() != 0U)
+    {
+        CHECK(telemetry_ring_encode(buf, sizeof(buf)) != 0U);
+        telemetry_ring_commit();
+    }
+}
+
+static void test_round_trip(void)
+{
+    static const telemetry_sample_t in[] = {
+        {0U, 0},           {1U, -1},         {0xFFFFFFF0U, INT32_MAX}, {5U, INT32_MIN}, /* time wraps */
+        {5U, INT32_MAX},   {100U, 42},       {100U, 42},               {0x7FFFFFFFU, -100000},
+    };
+    const uint32_t n = sizeof(in) / sizeof(in[0]);
+    telemetry_sample_t out[16];
+    uint8_t buf[TELEMETRY_BATCH_MAX];
+    size_t len;
+    uint32_t i;
+
+    drain();
+    CHECK(telemetry_ring_encode(buf, sizeof(buf)) == 0U);
+    for (i = 0U; i < n; i++)
+    {
+        telemetry_ring_record(in[i].time, in[i].value);
+    }
+    CHECK(telemetry_ring_pending() == n);
+    len = telemetry_ring_encode(buf, sizeof(buf));
+    CHECK(decode(buf, len, out, 16U) == (int)n);
+    CHECK(memcmp(in, out, sizeof(in)) == 0);
+
+    /* not acknowledged: the same batch again */
+    CHECK(telemetry_ring_encode(buf, sizeof(buf)) == len);
+    CHECK(telemetry_ring_pending() == n);
+    telemetry_ring_commit();
+    CHECK(telemetry_ring_pending() == 0U);
+    /* a second acknowledgement of the batch changes nothing */
+    telemetry_ring_record(1000U, 7);
+    telemetry_ring_commit();
+    CHECK(telemetry_ring_pending() == 1U);
+    drain();
+}
+
+/* Batches split at the buffer size, no sample lost or repeated */
+static void test_split(void)
+{
+    telemetry_sample_t out[TELEMETRY_RING_SIZE];
+    uint8_t buf[16];
+    size_t len;
+    uint32_t i, got = 0U;
+    int n;
+
+    drain();
+    CHECK(telemetry_ring_encode(buf, 5) == 0U);
+    for (i = 0U; i < 100U; i++)
+    {
+        telemetry_ring_record(i * 1000U, (int32_t)(i * i) - 2000);
+    }
+    CHECK(telemetry_ring_encode(buf, 5) == 0U);
+    /* one sample of this size does not fit 6 bytes */
+    CHECK(telemetry_ring_encode(buf, 6) == 0U);
+    while (telemetry_ring_pending() != 0U)
+    {
+        len = telemetry_ring_encode(buf, sizeof(buf));
+        CHECK((len != 0U) && (len <= sizeof(buf)));
+        n = decode(buf, len, out, TELEMETRY_RING_SIZE);
+        CHECK(n > 0);
+        if ((len == 0U) || (n <= 0))
+        {
+            break;
+        }
+        for (i = 0U; i < (uint32_t)n; i++)
+        {
+            CHECK(out[i].time == (got + i) * 1000U);
+            CHECK(out[i].value == (int32_t)((got + i) * (got + i)) - 2000);
+        }
+        got += (uint32_t)n;
+        telemetry_ring_commit();
+    }
+    CHECK(got == 100U);
+}
+
+/* Full ring: the oldest samples go, an acknowledgement never brings them back */
+static void test_overwrite(void)
+{
+    telemetry_sample_t out[TELEMETRY_RING_SIZE];
+    uint8_t buf[TELEMETRY_BATCH_MAX];
+    size_t len;
+    uint32_t i;
+
+    drain();
+    for (i = 0U; i < TELEMETRY_RING_SIZE + 10U; i++)
+    {
+        telemetry_ring_record(i, (int32_t)i);
+    }
+    CHECK(telemetry_ring_pending() == TELEMETRY_RING_SIZE);
+    len = telemetry_ring_encode(buf, sizeof(buf));
+    CHECK(decode(buf, len, out, TELEMETRY_RING_SIZE) > 0);
+    CHECK(out[0].time == 10U);
+
+    /* the batch in flight is overwritten before its acknowledgement */
+    for (i = 0U; i < TELEMETRY_RING_SIZE; i++)
+    {
+        telemetry_ring_record(1000U + i, (int32_t)i);
+    }
+    telemetry_ring_commit();
+    CHECK(telemetry_ring_pending() == TELEMETRY_RING_SIZE);
+    len = telemetry_ring_encode(buf, sizeof(buf));
+    CHECK(decode(buf, len, out, TELEMETRY_RING_SIZE) > 0);
+    CHECK(out[0].time == 1000U);
+    drain();
+}
+
+/* Level of the demo: one step per STEP_DELAY_MS from 100 down to 1, a pause, then back up */
+static int sig_demo(uint32_t *time, int32_t *value)
+{
+    if ((*value <= 1) && (demo_dir < 0))
+    {
+        demo_dir = 1;
+        *time += OFF_DELAY_MS;
+    }
+    else if ((*value >= 100) && (demo_dir > 0))
+    {
+        demo_dir = -1;
+    }
+    *time += STEP_DELAY_MS;
+    *value += demo_dir;
+    return 1;
+}
+
+/* Sensor read every second: a slow drift and a little noise */
+static int sig_slow(uint32_t *time, int32_t *value)
+{
+    int32_t v = 2000 + (int32_t)((*time / 1000U) % 60U) + (int32_t)(rand32() % 5U) - 2;
+
+    *time += 1000U;
+    if (v == *value)
+    {
+        return 0;
+    }
+    *value = v;
+    return 1;
+}
+
+/* 12 bit ADC at 10 Hz, full scale noise: the worst case of the delta encoding */
+static int sig_noise(uint32_t *time, int32_t *value)
+{
+    *time += 100U;
+    *value = (int32_t)(rand32() % 4096U);
+    return 1;
+}
+
+static uint32_t digits(int32_t v)
+{
+    char s[12];
+
+    return (uint32_t)snprintf(s, sizeof(s), "%d", (int)v);
+}
+
+/* Bytes of a QoS 1 PUBLISH */
+static uint32_t mqtt_publish_len(const char *topic, uint32_t payload)
+{
+    uint32_t rem = 2U + (uint32_t)strlen(topic) + 2U + payload;
+
+    return 1U + (rem > 127U ? 2U : 1U) + rem;
+}
+
+typedef struct
+{
+    uint32_t samples;   /* recorded */
+    uint32_t delivered; /* decoded at the broker */
+    uint32_t lost;      /* overwritten before their upload */
+    uint32_t payload;   /* history batch bytes */
+    uint32_t mqtt;      /* PUBLISH and PUBACK bytes, history and retained level */
+    uint32_t segments;  /* TCP segments of those */
+    uint32_t old_mqtt;  /* the same for one retained publish per sample */
+    uint32_t old_segments;
+} sim_result_t;
+
+/* Broker side of an acknowledged batch: every sample once, in order, gaps only for overwrites */
+static void deliver(const uint8_t *buf, size_t len, sim_result_t *r)
+{
+    static telemetry_sample_t out[TELEMETRY_RING_SIZE];
+    int n = decode(buf, len, out, TELEMETRY_RING_SIZE);
+    int i;
+
+    CHECK(n > 0);
+    for (i = 0; i < n; i++)
+    {
+        uint32_t j = r->delivered + r->lost;
+
+        while ((j < sent_cnt) && (sent_log[j].time != out[i].time))
+        {
+            j++;
+            r->lost++;
+        }
+        CHECK((j < sent_cnt) && (sent_log[j].value == out[i].value));
+        r->delivered++;
+    }
+}
+
+/*
+ * telemetry_upload() of source/mqtt_freertos.c every interval_ms: history
+ * batches, the next one on the PUBACK of the last until the ring is empty,
+ * and the retained level if it changed. The PUBACKs come within the
+ * interval, unless the broker is unreachable from stall_from for stall_ms:
+ * then the publish times out and the batch stays in the ring.
+ */
+static void sim_run(const signal_t *sig, uint32_t interval_ms, uint32_t stall_from, uint32_t stall_ms,
+                    sim_result_t *r)
+{
+    uint8_t buf[TELEMETRY_BATCH_MAX];
+    uint32_t time = 0U, next_upload = interval_ms, now;
+    int32_t value = 100, level_sent = -1;
+
+    drain();
+    memset(r, 0, sizeof(*r));
+    rng      = 1U;
+    demo_dir = -1;
+    sent_cnt = 0U;
+    sig->next(&time, &value);
+
+    for (now = 0U; (now < SIM_MS) || (telemetry_ring_pending() != 0U); now = next_upload, next_upload += interval_ms)
+    {
+        /* samples until this upload */
+        while ((time <= next_upload) && (time < SIM_MS) && (sent_cnt < LOG_MAX))
+        {
+            telemetry_ring_record(time, value);
+            sent_log[sent_cnt++] = (telemetry_sample_t){time, value};
+            r->samples++;
+            r->old_mqtt += mqtt_publish_len(TOPIC_LEVEL, digits(value)) + MQTT_PUBACK;
+            r->old_segments += 2U;
+            while (!sig->next(&time, &value))
+            {
+            }
+        }
+
+        while (telemetry_ring_pending() != 0U)
+        {
+            size_t len = telemetry_ring_encode(buf, sizeof(buf));
+
+            CHECK(len != 0U);
+            r->mqtt += mqtt_publish_len(TOPIC_HISTORY, (uint32_t)len);
+            r->segments++;
+            if ((next_upload < stall_from) || (next_upload >= stall_from + stall_ms))
+            {
+                r->payload += (uint32_t)len;
+                r->mqtt += MQTT_PUBACK;
+                r->segments++;
+                deliver(buf, len, r);
+                telemetry_ring_commit();
+            }
+            else
+            {
+                break;
+            }
+        }
+        if ((sent_cnt != 0U) && (sent_log[sent_cnt - 1U].value != level_sent))
+        {
+            level_sent = sent_log[sent_cnt - 1U].value;
+            r->mqtt += mqtt_publish_len(TOPIC_LEVEL, digits(level_sent)) + MQTT_PUBACK;
+            r->segments += 2U;
+        }
+    }
+    CHECK(r->delivered + r->lost == r->samples);
+}
+
+int main(void)
+{
+    static const signal_t signals[] = {
+        {"demo level, 10 Hz", sig_demo},
+        {"sensor 1 Hz, drift", sig_slow},
+        {"12 bit noise, 10 Hz", sig_noise},
+    };
+    static const uint32_t intervals[] = {1000U, 5000U, 30000U};
+    sim_result_t r;
+    unsigned i, k;
+    uint32_t unsent = 0U;
+
+    test_round_trip();
+    test_split();
+    test_overwrite();
+
+    printf("ring %u samples (%u B), batch max %u B, %u s of samples per row\n", (unsigned)TELEMETRY_RING_SIZE,
+           (unsigned)TELEMETRY_RING_BUDGET, TELEMETRY_BATCH_MAX, SIM_MS / 1000U);
+    printf("bytes per sample: batch payload, MQTT (PUBLISH + PUBACK), on the wire with TCP/IP headers\n");
+    printf("%-22s %8s %8s %8s %8s %8s %9s %9s\n", "signal", "interval", "samples", "lost", "payload", "mqtt",
+           "wire", "old wire");
+    for (i = 0U; i < sizeof(signals) / sizeof(signals[0]); i++)
+    {
+        for (k = 0U; k < sizeof(intervals) / sizeof(intervals[0]); k++)
+        {
+            double mqtt, wire, old_wire;
+
+            sim_run(&signals[i], intervals[k], 0U, 0U, &r);
+            mqtt     = (double)r.mqtt / r.samples;
+            wire     = (double)(r.mqtt + r.segments * TCPIP_HDR) / r.samples;
+            old_wire = (double)(r.old_mqtt + r.old_segments * TCPIP_HDR) / r.samples;
+            printf("%-22s %6u s %8u %8u %8.2f %8.2f %8.2f %9.2f\n", signals[i].name, intervals[k] / 1000U,
+                   r.samples, r.lost, (double)r.payload / r.delivered, mqtt, wire, old_wire);
+            /* a batch of one sample costs what a publish per sample does, and the level on top */
+            if (intervals[k] >= 5000U)
+            {
+                CHECK(wire < old_wire);
+            }
+            /* up to the time the ring holds of a 10 Hz signal, nothing is lost */
+            if (intervals[k] <= TELEMETRY_RING_SIZE * STEP_DELAY_MS)
+            {
+                CHECK(r.lost == 0U);
+            }
+        }
+    }
+
+    /* broker unreachable for a minute at the application's interval */
+    sim_run(&signals[0], 5000U, 120000U, 60000U, &r);
+    printf("%-22s %6u s %8u %8u   broker unreachable 60 s, ring holds %u s\n", signals[0].name, 5U, r.samples,
+           r.lost, (unsigned)(TELEMETRY_RING_SIZE * STEP_DELAY_MS / 1000U));
+    /* what the ring could not hold of the samples since the last acknowledged upload, at 115 s */
+    for (i = 0U; i < sent_cnt; i++)
+    {
+        unsent += (sent_log[i].time > 115000U) && (sent_log[i].time <= 180000U);
+    }
+    CHECK(r.lost != 0U);
+    CHECK(r.lost == unsent - TELEMETRY_RING_SIZE);
+
+    return host_test_result();
+}
@@ -0,0 +1,27 @@
+/*
+ * FreeRTOS.h
+ * The part of the FreeRTOS API twt_manager.c uses, for the single threaded
+ * host test: ticks are milliseconds
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_FREERTOS_H
+#define HOST_FREERTOS_H
+
+#include <stdint.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+
+#define pdFALSE (0)
+#define pdTRUE  (1)
+#define pdPASS  (1)
+#define pdFAIL  (0)
+
+#define portMAX_DELAY     ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
+#define tskIDLE_PRIORITY  ((UBaseType_t)0U)
+
+#endif /* HOST_FREERTOS_H */
@@ -0,0 +1,15 @@
+/*
+ * fsl_debug_console.h
+ * Console of the host test
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef HOST_FSL_DEBUG_CONSOLE_H
+#define HOST_FSL_DEBUG_CONSOLE_H
+
+#include <stdio.h>
+
+#define PRINTF printf
+
+#endif /* HOST_FSL_DEBUG_CONSOLE_H */
@@ -0,0 +1,306 @@
+/*
+ * twt_sim.c
+ * Host test of the TWT session manager against a simulated AP behind the
+ * WPL TWT functions: agreement sizing, renegotiation after changes settle,
+ * fallback without TWT support and after a rejection
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <setjmp.h>
+#include <stdio.h>
+
+#include "task.h"
+#include "twt_manager.h"
+#include "wpl.h"
+
+#include "host_test.h"
+
+/* Flows of mqtt_freertos.c */
+#define FLOW_UPLOAD    0U
+#define FLOW_KEEPALIVE 1U
+
+/*
+ * Manager task: run by the test until it waits without a notification
+ * pending, then resumed from its start, where it waits again.
+ */
+static TaskFunction_t task_fn;
+static jmp_buf task_blocked;
+static uint32_t task_notified;
+static uint32_t now_ms;
+
+/* Flow change made while the task lets a burst settle */
+static struct
+{
+    uint32_t at_ms;
+    uint8_t id;
+    uint32_t period_ms, awake_ms;
+} later;
+static int later_pending;
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *handle)
+{
+    task_fn = fn;
+    *handle = (TaskHandle_t)&task_fn;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    CHECK(task == (TaskHandle_t)&task_fn);
+    task_notified++;
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t wait)
+{
+    uint32_t count;
+
+    if ((task_notified == 0U) && later_pending && (wait != portMAX_DELAY) && (later.at_ms <= now_ms + wait))
+    {
+        now_ms        = later.at_ms;
+        later_pending = 0;
+        (void)twt_manager_set_flow(later.id, later.period_ms, later.awake_ms);
+    }
+    if (task_notified == 0U)
+    {
+        if (wait == portMAX_DELAY)
+        {
+            longjmp(task_blocked, 1);
+        }
+        now_ms += wait;
+        return 0U;
+    }
+    count         = task_notified;
+    task_notified = clear ? 0U : (task_notified - 1U);
+    return count;
+}
+
+/* Lets the manager act on what happened since it last ran */
+static void run_manager(void)
+{
+    if (setjmp(task_blocked) == 0)
+    {
+        task_fn(NULL);
+    }
+}
+
+/*
+ * Simulated AP and firmware, with the checks of wpl_nxp.c.
+ */
+static struct
+{
+    bool connected;
+    bool twt;                 /* AP and firmware support TWT */
+    uint32_t max_interval_us; /* longer intervals are rejected, 0 for none */
+    bool agreement;
+    uint32_t interval_us, wake_us;
+    unsigned setups, teardowns, rejects, bad_calls;
+} ap;
+
+bool WPL_TwtSupported(void)
+{
+    return ap.connected && ap.twt;
+}
+
+wpl_ret_t WPL_TwtSetup(uint32_t interval_us, uint32_t wake_duration_us, uint8_t flow_id)
+{
+    uint32_t wake_units = (wake_duration_us + 255U) / 256U;
+
+    ap.setups++;
+    if (!ap.connected)
+    {
+        ap.bad_calls++;
+        return WPLRET_NOT_CONNECTED;
+    }
+    if ((flow_id > 7U) || (wake_units == 0U) || (wake_units > UINT8_MAX) || (interval_us <= wake_units * 256U) ||
+        ap.agreement)
+    {
+        ap.bad_calls++;
+        return WPLRET_BAD_PARAM;
+    }
+    if (!ap.twt || ((ap.max_interval_us != 0U) && (interval_us > ap.max_interval_us)))
+    {
+        ap.rejects++;
+        return WPLRET_FAIL;
+    }
+    ap.agreement   = true;
+    ap.interval_us = interval_us;
+    ap.wake_us     = wake_duration_us;
+    return WPLRET_SUCCESS;
+}
+
+wpl_ret_t WPL_TwtTeardown(uint8_t flow_id)
+{
+    ap.teardowns++;
+    if (!ap.connected || !ap.agreement || (flow_id != TWT_MANAGER_FLOW_ID))
+    {
+        ap.bad_calls++;
+        return WPLRET_FAIL;
+    }
+    ap.agreement = false;
+    return WPLRET_SUCCESS;
+}
+
+static void associate(bool twt)
+{
+    ap.connected = true;
+    ap.twt       = twt;
+    ap.agreement = false;
+    twt_manager_link_up();
+}
+
+static void disassociate(void)
+{
+    /* the agreement ends with the association */
+    ap.connected = false;
+    ap.agreement = false;
+    twt_manager_link_down();
+}
+
+static void test_sizing(void)
+{
+    associate(true);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_IDLE);
+    CHECK(ap.setups == 0U);
+
+    /* Telemetry upload every 5 s, keepalive every 60 s: one service period per upload */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 5000U, 20U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 60000U, 15U);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_ACTIVE);
+    CHECK(ap.setups == 1U);
+    CHECK(ap.agreement && (ap.interval_us == 5000000U) && (ap.wake_us == 20000U));
+
+    /* The same traffic registered again changes nothing */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 5000U, 20U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 60000U, 25U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 60000U, 15U);
+    run_manager();
+    CHECK((ap.setups == 1U) && (ap.teardowns == 0U));
+
+    /* Periods without a useful common divisor: the shortest one */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 1000U, 10U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 1030U, 10U);
+    run_manager();
+    CHECK((ap.setups == 2U) && (ap.teardowns == 1U));
+    CHECK(ap.agreement && (ap.interval_us == 1000000U) && (ap.wake_us == 10000U));
+
+    /* Longest service period TWT can describe */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 1000U, 300U);
+    run_manager();
+    CHECK(ap.agreement && (ap.interval_us == 1000000U) && (ap.wake_us == TWT_MANAGER_MAX_WAKE_MS * 1000U));
+
+    /* Awake most of the time: no agreement */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 40U, 10U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 0U, 0U);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_IDLE);
+    CHECK(!ap.agreement);
+
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 0U, 0U);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_IDLE);
+    CHECK(twt_manager_set_flow(TWT_MANAGER_MAX_FLOWS, 1000U, 10U) == -1);
+}
+
+static void test_settle(void)
+{
+    unsigned setups;
+    uint32_t start;
+
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 5000U, 20U);
+    run_manager();
+    setups = ap.setups;
+
+    /* Interval changed, then changed again before the first change settled */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 10000U, 20U);
+    start           = now_ms;
+    later.at_ms     = now_ms + TWT_MANAGER_SETTLE_MS / 2U;
+    later.id        = FLOW_UPLOAD;
+    later.period_ms = 30000U;
+    later.awake_ms  = 20U;
+    later_pending   = 1;
+    run_manager();
+    CHECK(!later_pending);
+    CHECK(ap.setups == setups + 1U);
+    CHECK(ap.interval_us == 30000000U);
+    CHECK(now_ms - start == TWT_MANAGER_SETTLE_MS / 2U + TWT_MANAGER_SETTLE_MS);
+}
+
+static void test_unsupported(void)
+{
+    unsigned setups;
+
+    disassociate();
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_IDLE);
+
+    associate(false);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_UNSUPPORTED);
+    setups = ap.setups;
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 5000U, 20U);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_UNSUPPORTED);
+    CHECK(ap.setups == setups);
+
+    /* Next AP has TWT */
+    disassociate();
+    associate(true);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_ACTIVE);
+    CHECK(ap.setups == setups + 1U);
+}
+
+static void test_rejected(void)
+{
+    unsigned setups;
+
+    ap.max_interval_us = 20000000U;
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 30000U, 20U);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_REJECTED);
+    CHECK(!ap.agreement);
+    setups = ap.setups;
+
+    /* Not retried for the same traffic */
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 60000U, 15U);
+    (void)twt_manager_set_flow(FLOW_KEEPALIVE, 0U, 0U);
+    run_manager();
+    CHECK(ap.setups == setups);
+
+    /* Retried once the traffic changes, or on the next association */
+    (void)twt_manager_set_flow(FLOW_UPLOAD, 30000U, 25U);
+    run_manager();
+    CHECK(ap.setups == setups + 1U);
+    disassociate();
+    associate(true);
+    run_manager();
+    CHECK(ap.setups == setups + 2U);
+
+    ap.max_interval_us = 0U;
+    disassociate();
+    associate(true);
+    run_manager();
+    CHECK(twt_manager_state() == TWT_STATE_ACTIVE);
+}
+
+int main(void)
+{
+    CHECK(twt_manager_init() == 0);
+    CHECK(task_fn != NULL);
+
+    test_sizing();
+    test_settle();
+    test_unsupported();
+    test_rejected();
+
+    printf("setups %u, teardowns %u, rejected %u\n", ap.setups, ap.teardowns, ap.rejects);
+    /* Never called while disconnected, with an agreement in place or with bad parameters */
+    CHECK(ap.bad_calls == 0U);
+
+    return host_test_result();
+}
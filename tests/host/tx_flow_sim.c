@@ -0,0 +1,235 @@
+/*
+ * tx_flow_sim.c
+ * Host simulation of a TCP sender in tcpip_thread against a throttled radio:
+ * the original low_level_output() retry loop against WMM TX flow control
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "host_test.h"
+#include "mlan_tx_flow.h"
+
+/* Model, times in microseconds */
+#define POOL          16U     /* MAX_WMM_BUF_NUM */
+#define HIGH_WM       12U     /* CONFIG_TX_FLOW_HIGH_WM */
+#define LOW_WM        4U      /* CONFIG_TX_FLOW_LOW_WM */
+#define RETRIES       50U     /* retry_attempts, MAX_RETRY_TICKS */
+#define SIM_TIME_US   2000000U
+#define COST_SEND     20U     /* tcp_output() and copy of one segment */
+#define COST_SPIN     10U     /* one retry: TX event post and outbuf lookup */
+#define COST_SLEEP    1000U   /* OSA_TimeDelay(1) for a peer in power save */
+#define COST_REFUSE   2U      /* refused segment */
+#define COST_ACK      5U      /* tcp_input() of an ACK */
+#define RTT_US        2000U
+#define FASTTMR_US    250000U /* TCP_FAST_INTERVAL, retries TF_NAGLEMEMERR segments */
+#define ACK_RING      256U
+
+typedef struct
+{
+    const char *name;
+    uint32_t air_us;    /* radio time per packet */
+    uint32_t ps_period; /* peer power save cycle, 0 for none */
+    uint32_t ps_sleep;  /* part of the cycle the peer sleeps */
+} scenario_t;
+
+typedef struct
+{
+    uint32_t sent;
+    uint32_t refused;
+    uint32_t pauses;
+    uint32_t resumes;
+    uint64_t in_driver_us; /* tcpip_thread spinning or sleeping in low_level_output() */
+    uint32_t max_stall_us; /* longest single stay in low_level_output() */
+    uint64_t ack_wait_us;
+    uint32_t acks;
+    uint32_t max_ack_wait_us;
+    uint32_t max_queued;
+} sim_result_t;
+
+static bool peer_asleep(const scenario_t *s, uint32_t t)
+{
+    return (s->ps_period != 0U) && ((t % s->ps_period) < s->ps_sleep);
+}
+
+static void sim_run(const scenario_t *s, bool flow_control, sim_result_t *r)
+{
+    uint32_t queued = 0U, t;
+    uint32_t radio_busy_until = 0U, tcpip_busy_until = 0U;
+    uint32_t acks[ACK_RING], ack_head = 0U, ack_cnt = 0U;
+    bool paused = false, waiting = false;
+    bool retrying = false;
+    uint32_t retries = 0U, stall_start = 0U;
+
+    *r = (sim_result_t){0};
+
+    for (t = 0U; t < SIM_TIME_US; t++)
+    {
+        /* Driver TX task: the radio sends while the peer is awake */
+        if (t >= radio_busy_until && queued != 0U && !peer_asleep(s, t))
+        {
+            queued--;
+            r->sent++;
+            radio_busy_until = t + s->air_us;
+            if (ack_cnt < ACK_RING)
+            {
+                acks[(ack_head + ack_cnt++) % ACK_RING] = t + RTT_US;
+            }
+            /* wifi_tx_flow_resume() and handle_tx_resume() */
+            if (flow_control && paused && wlan_tx_flow_can_resume(queued, POOL - queued, LOW_WM))
+            {
+                paused  = false;
+                waiting = false;
+                r->resumes++;
+            }
+        }
+
+        if (t < tcpip_busy_until)
+        {
+            continue;
+        }
+
+        /* Original loop: tcpip_thread stays in low_level_output() until a buffer frees up */
+        if (retrying)
+        {
+            if (queued < POOL)
+            {
+                queued++;
+                retrying = false;
+            }
+            else if (--retries == 0U)
+            {
+                r->refused++;
+                retrying = false;
+                waiting  = true;
+            }
+            else
+            {
+                tcpip_busy_until = t + (peer_asleep(s, t) ? COST_SLEEP : COST_SPIN);
+                r->in_driver_us += tcpip_busy_until - t;
+                continue;
+            }
+            if (t - stall_start > r->max_stall_us)
+            {
+                r->max_stall_us = t - stall_start;
+            }
+            continue;
+        }
+
+        /* ACKs are taken as soon as tcpip_thread is free, each one restarts output */
+        if (ack_cnt != 0U && acks[ack_head] <= t)
+        {
+            uint32_t wait = t - acks[ack_head];
+
+            r->ack_wait_us += wait;
+            r->acks++;
+            if (wait > r->max_ack_wait_us)
+            {
+                r->max_ack_wait_us = wait;
+            }
+            ack_head = (ack_head + 1U) % ACK_RING;
+            ack_cnt--;
+            waiting          = false;
+            tcpip_busy_until = t + COST_ACK;
+            continue;
+        }
+
+        if (waiting)
+        {
+            if ((t % FASTTMR_US) != 0U)
+            {
+                continue;
+            }
+            waiting = false;
+        }
+
+        /* tcp_output() of the next segment, the sender always has data */
+        if (flow_control)
+        {
+            /* wifi_wmm_tx_flow_paused() */
+            if (paused && wlan_tx_flow_can_resume(queued, POOL - queued, LOW_WM))
+            {
+                paused = false;
+            }
+            if (!paused && wlan_tx_flow_need_pause(queued, HIGH_WM))
+            {
+                paused = true;
+                r->pauses++;
+            }
+            if (!paused && queued == POOL)
+            {
+                /* no buffer: full pool or a peer in power save */
+                paused = true;
+                r->pauses++;
+            }
+            if (paused)
+            {
+                r->refused++;
+                waiting          = true;
+                tcpip_busy_until = t + COST_REFUSE;
+                continue;
+            }
+            queued++;
+        }
+        else if (queued == POOL)
+        {
+            retrying         = true;
+            retries          = RETRIES;
+            stall_start      = t;
+            tcpip_busy_until = t + (peer_asleep(s, t) ? COST_SLEEP : COST_SPIN);
+            r->in_driver_us += tcpip_busy_until - t;
+            continue;
+        }
+        else
+        {
+            queued++;
+        }
+        if (queued > r->max_queued)
+        {
+            r->max_queued = queued;
+        }
+        tcpip_busy_until = t + COST_SEND;
+    }
+}
+
+int main(void)
+{
+    static const scenario_t scenarios[] = {
+        {"1 Mbps radio", 12000U, 0U, 0U},
+        {"6 Mbps radio", 2000U, 0U, 0U},
+        {"6 Mbps, peer in PS", 2000U, 100000U, 30000U},
+        {"24 Mbps, peer in PS", 500U, 100000U, 30000U},
+    };
+    uint32_t i;
+
+    printf("%-20s %-6s %8s %8s %7s %7s %12s %11s %10s %10s\n", "scenario", "mode", "sent", "refused", "pauses",
+           "resumes", "in driver us", "max stall", "ack wait", "max ack");
+    for (i = 0U; i < sizeof(scenarios) / sizeof(scenarios[0]); i++)
+    {
+        sim_result_t old, fc;
+
+        sim_run(&scenarios[i], false, &old);
+        sim_run(&scenarios[i], true, &fc);
+        printf("%-20s %-6s %8u %8u %7u %7u %12llu %11u %10.1f %10u\n", scenarios[i].name, "retry", old.sent,
+               old.refused, old.pauses, old.resumes, (unsigned long long)old.in_driver_us, old.max_stall_us,
+               old.acks ? (double)old.ack_wait_us / old.acks : 0.0, old.max_ack_wait_us);
+        printf("%-20s %-6s %8u %8u %7u %7u %12llu %11u %10.1f %10u\n", "", "flow", fc.sent, fc.refused, fc.pauses,
+               fc.resumes, (unsigned long long)fc.in_driver_us, fc.max_stall_us,
+               fc.acks ? (double)fc.ack_wait_us / fc.acks : 0.0, fc.max_ack_wait_us);
+
+        /* tcpip_thread never waits in the driver */
+        CHECK(fc.in_driver_us == 0U);
+        CHECK(fc.max_stall_us == 0U);
+        /* The TX task resume, not tcp_fasttmr, restarts TCP: the radio stays busy */
+        CHECK(fc.sent * 100U >= old.sent * 98U);
+        /* ACKs are taken without the spin or sleep of the retry loop in front of them */
+        CHECK(fc.max_ack_wait_us <= COST_SEND + COST_ACK);
+        CHECK(fc.max_queued <= HIGH_WM);
+        CHECK(fc.resumes != 0U);
+    }
+
+    return host_test_result();
+}
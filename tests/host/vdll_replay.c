@@ -0,0 +1,202 @@
+/*
+ * vdll_replay.c
+ * Host replay of VDLL request traces through the block cache of
+ * wifi_vdll.c: requests served from RAM, prefetches used and wasted, and
+ * what is still read from flash while the firmware waits for it
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "wifi.h"
+
+#include "host_test.h"
+
+/* Firmware VDLL region of the traces */
+#define IMAGE_LEN 0x14000U
+
+#define TRACE_MAX_LINES 4096
+
+static t_u8 image[IMAGE_LEN];
+
+typedef struct
+{
+    t_u32 offset; /* of the block, or the command id */
+    t_u16 len;    /* of the block, 0 for a command */
+} trace_line_t;
+
+/* Trace: lines of "cmd <id>" for a host command sent, "req <offset> <len>"
+ * for a block requested by the firmware */
+static unsigned trace_load(const char *path, trace_line_t *lines)
+{
+    char line[80];
+    unsigned n = 0U;
+    FILE *f    = fopen(path, "r");
+
+    CHECK(f != NULL);
+    if (f == NULL)
+    {
+        return 0U;
+    }
+    while ((fgets(line, sizeof(line), f) != NULL) && (n < TRACE_MAX_LINES))
+    {
+        unsigned value, len;
+
+        if (sscanf(line, "cmd %x", &value) == 1)
+        {
+            lines[n].offset = value;
+            lines[n].len    = 0U;
+            n++;
+        }
+        else if (sscanf(line, "req %x %u", &value, &len) == 2)
+        {
+            CHECK((len != 0U) && (value + len <= IMAGE_LEN));
+            lines[n].offset = value;
+            lines[n].len    = (t_u16)len;
+            n++;
+        }
+    }
+    fclose(f);
+    return n;
+}
+
+/* As wlan_process_vdll_event() and wifi_wait_for_cmdresp() drive the cache */
+static void run_trace(const char *dir, const char *name)
+{
+    static trace_line_t lines[TRACE_MAX_LINES];
+    char path[256];
+    wifi_vdll_stats_t before, after;
+    unsigned n, i;
+    unsigned long bytes = 0UL, demand_bytes = 0UL;
+
+    snprintf(path, sizeof(path), "%s/%s.trace", dir, name);
+    n = trace_load(path, lines);
+    CHECK(n != 0U);
+
+    wifi_vdll_reset();
+    wifi_get_vdll_stats(&before);
+    for (i = 0U; i < n; i++)
+    {
+        const trace_line_t *l = &lines[i];
+        wifi_vdll_stats_t stats;
+        const t_u8 *data;
+        t_u32 hits;
+
+        if (l->len == 0U)
+        {
+            wifi_vdll_command((t_u16)l->offset, image, IMAGE_LEN);
+            continue;
+        }
+
+        wifi_get_vdll_stats(&stats);
+        hits = stats.hits;
+        data = wifi_vdll_block(image, IMAGE_LEN, l->offset, l->len);
+        CHECK(memcmp(data, image + l->offset, l->len) == 0);
+        wifi_get_vdll_stats(&stats);
+        bytes += l->len;
+        if (stats.hits == hits)
+        {
+            demand_bytes += l->len;
+        }
+        wifi_vdll_block_sent(image, IMAGE_LEN);
+    }
+    wifi_get_vdll_stats(&after);
+
+    after.requests -= before.requests;
+    after.hits -= before.hits;
+    after.prefetches -= before.prefetches;
+    after.prefetch_hits -= before.prefetch_hits;
+    printf("%-9s %8u %6u %9u %8u %6u %12lu %12lu\n", name, after.requests, after.hits, after.prefetches,
+           after.prefetch_hits, after.prefetches - after.prefetch_hits, bytes, demand_bytes);
+
+    CHECK(after.hits <= after.requests);
+    CHECK(after.prefetch_hits <= after.prefetches);
+    CHECK(after.prefetch_hits <= after.hits);
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    /* Half of the blocks at least come from RAM */
+    CHECK(2U * after.hits >= after.requests);
+#else
+    CHECK(after.hits == 0U);
+    CHECK(after.prefetches == 0U);
+    CHECK(demand_bytes == bytes);
+#endif
+}
+
+static void test_policy(void)
+{
+    wifi_vdll_stats_t before, after;
+    const t_u8 *data;
+
+    wifi_vdll_reset();
+    wifi_get_vdll_stats(&before);
+
+    /* A block too big for the cache is sent from the image */
+    data = wifi_vdll_block(image, IMAGE_LEN, 0x1000U, CONFIG_FW_VDLL_CACHE_BLOCK_SIZE + 1U);
+    CHECK(data == image + 0x1000U);
+
+    /* Command 0x00a4 is followed by block 0x2000, block 0x2000 by block 0x3000 */
+    wifi_vdll_command(0x00a4U, image, IMAGE_LEN);
+    data = wifi_vdll_block(image, IMAGE_LEN, 0x2000U, 512U);
+    CHECK(memcmp(data, image + 0x2000U, 512U) == 0);
+    wifi_vdll_block_sent(image, IMAGE_LEN);
+    data = wifi_vdll_block(image, IMAGE_LEN, 0x3000U, 256U);
+    CHECK(memcmp(data, image + 0x3000U, 256U) == 0);
+    wifi_vdll_block_sent(image, IMAGE_LEN);
+
+    /* Then the command prefetches the first, which prefetches the second */
+    wifi_vdll_command(0x00a4U, image, IMAGE_LEN);
+    wifi_vdll_block(image, IMAGE_LEN, 0x2000U, 512U);
+    wifi_vdll_block_sent(image, IMAGE_LEN);
+    wifi_vdll_block(image, IMAGE_LEN, 0x3000U, 256U);
+    wifi_get_vdll_stats(&after);
+    CHECK(after.requests - before.requests == 5U);
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    CHECK(after.hits - before.hits == 2U);
+    /* both were still cached, nothing needed prefetching */
+    CHECK(after.prefetches == before.prefetches);
+#endif
+
+    /* Firmware image changed: nothing cached nor learnt any more */
+    wifi_vdll_reset();
+    image[0x2000U]++;
+    wifi_get_vdll_stats(&before);
+    wifi_vdll_command(0x00a4U, image, IMAGE_LEN);
+    data = wifi_vdll_block(image, IMAGE_LEN, 0x2000U, 512U);
+    CHECK(memcmp(data, image + 0x2000U, 512U) == 0);
+    wifi_get_vdll_stats(&after);
+    CHECK(after.hits == before.hits);
+    CHECK(after.prefetches == before.prefetches);
+
+    wifi_vdll_stall(12U);
+    wifi_vdll_stall(3U);
+    wifi_get_vdll_stats(&after);
+    CHECK((after.stalls == 2U) && (after.stall_ms_total == 15U) && (after.stall_ms_max == 12U));
+}
+
+int main(int argc, char *argv[])
+{
+    const char *dir = (argc > 1) ? argv[1] : "vdll";
+    t_u32 seed      = 1U;
+    unsigned i;
+
+    for (i = 0U; i < IMAGE_LEN; i++)
+    {
+        seed     = seed * 1103515245U + 12345U;
+        image[i] = (t_u8)(seed >> 16);
+    }
+
+    wifi_vdll_init();
+    test_policy();
+
+    printf("CONFIG_FW_VDLL_CACHE_BLOCKS %u of %u B, CONFIG_FW_VDLL_PREFETCH_ENTRIES %u\n",
+           (unsigned)CONFIG_FW_VDLL_CACHE_BLOCKS, (unsigned)CONFIG_FW_VDLL_CACHE_BLOCK_SIZE,
+           (unsigned)CONFIG_FW_VDLL_PREFETCH_ENTRIES);
+    printf("%-9s %8s %6s %9s %8s %6s %12s %12s\n", "trace", "requests", "hits", "prefetch", "pf hits", "wasted",
+           "bytes", "flash, wait");
+    run_trace(dir, "station");
+    run_trace(dir, "roaming");
+
+    return host_test_result();
+}
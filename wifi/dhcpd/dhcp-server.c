@@ -67,7 +67,10 @@ static int ac_add(uint8_t *chaddr, uint32_t client_ip)
 static uint32_t ac_lookup_mac(uint8_t *chaddr)
 {
     /* returns ip address, if mac address is present in cache */
+    uint32_t client_ip = CLIENT_IP_NOT_FOUND;
     int i;
+    PERF_START;
+
     for (i = 0; i < dhcps.count_clients && i < MAC_IP_CACHE_SIZE; i++)
     {
         if ((dhcps.ip_mac_mapping[i].client_mac[0] == chaddr[0]) &&
@@ -77,10 +80,13 @@ static uint32_t ac_lookup_mac(uint8_t *chaddr)
             (dhcps.ip_mac_mapping[i].client_mac[4] == chaddr[4]) &&
             (dhcps.ip_mac_mapping[i].client_mac[5] == chaddr[5]))
         {
-            return dhcps.ip_mac_mapping[i].client_ip;
+            client_ip = dhcps.ip_mac_mapping[i].client_ip;
+            break;
         }
     }
-    return CLIENT_IP_NOT_FOUND;
+
+    PERF_STOP("dhcps_lease_lookup");
+    return client_ip;
 }
 
 static uint8_t *ac_lookup_ip(uint32_t client_ip)
@@ -267,6 +267,53 @@ int net_dhcp_hostname_set(char *hostname);
  */
 void net_stop_dhcp_timer(void);
 
+#if LWIP_DHCP_INIT_REBOOT
+/** DHCP lease of the station interface, addresses in network byte order */
+typedef struct
+{
+    uint32_t address;
+    uint32_t netmask;
+    uint32_t gw;
+    /** DHCP server which granted the lease */
+    uint32_t server;
+    /** Lease period in seconds */
+    uint32_t lease_time;
+} net_dhcp_lease_t;
+
+/** Set the lease the station confirms at its next DHCP start
+ *
+ * The next DHCP start of the station interface requests the leased address
+ * (INIT-REBOOT) instead of discovering a server, and uses it while the server
+ * confirms it. The lease is replaced whenever the station gets bound, so
+ * reconnections to the same network reuse the last lease.
+ *
+ * \param[in] lease Lease of an earlier session on the network about to be
+ *                  joined, NULL to discover a new lease.
+ *
+ * \return WM_SUCCESS
+ */
+int net_dhcp_lease_set(const net_dhcp_lease_t *lease);
+
+/** Get the last lease the station was bound to
+ *
+ * \param[out] lease The lease.
+ *
+ * \return WM_SUCCESS or -WM_FAIL if there is none.
+ */
+int net_dhcp_lease_get(net_dhcp_lease_t *lease);
+
+/** Register the function told when the station is bound to a new lease
+ *
+ * It is called from the TCP/IP thread whenever the lease returned by
+ * net_dhcp_lease_get() changes: a lease confirmed or granted by the server, or
+ * a new address after the server refused the kept one. Renewals of the same
+ * lease are not reported.
+ *
+ * \param[in] cb The function, NULL to unregister.
+ */
+void net_dhcp_lease_set_callback(void (*cb)(void));
+#endif
+
 /** Set socket blocking option as on or off
  *
  * \param[in] sock socket number to be set for blocking option.
@@ -430,6 +477,22 @@ static inline void *net_stack_buffer_get_payload(void *buf)
 #endif
 }
 
+#if defined(SDK_OS_FREE_RTOS)
+/** Get the data payload of a stack buffer if the packet is not split.
+ *
+ * \param[in] buf input stack buffer.
+ * \param[in] len length of the packet.
+ *
+ * \return the payload pointer, NULL if the packet spans several buffers.
+ */
+static inline void *net_stack_buffer_get_contiguous(void *buf, uint16_t len)
+{
+    struct pbuf *p = (struct pbuf *)buf;
+
+    return (p->len >= len) ? p->payload : NULL;
+}
+#endif
+
 #if CONFIG_WIFI_PKT_FWD
 /** Send packet from Wi-Fi driver
  *
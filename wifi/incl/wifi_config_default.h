@@ -130,6 +130,123 @@
 #endif
 #endif
 
+/** If define CONFIG_TX_FLOW_CONTROL 1, an access category whose WMM TX queue
+ *  is full, or which gets no buffer because its peer is in power save, is
+ *  paused: the network interface refuses its packets at once instead of
+ *  retrying and never waits for the driver, TCP keeps the refused segments
+ *  queued and is resumed when the driver TX task has drained the queue to
+ *  the low watermark.
+ *  Watermarks are in packets of the shared pool of MAX_WMM_BUF_NUM buffers.
+ */
+#if !defined CONFIG_TX_FLOW_CONTROL
+#define CONFIG_TX_FLOW_CONTROL CONFIG_WMM
+#endif
+
+#if !CONFIG_WMM
+#undef CONFIG_TX_FLOW_CONTROL
+#define CONFIG_TX_FLOW_CONTROL 0
+#endif
+
+#if !defined CONFIG_TX_FLOW_HIGH_WM
+#define CONFIG_TX_FLOW_HIGH_WM 12
+#endif
+
+#if !defined CONFIG_TX_FLOW_LOW_WM
+#define CONFIG_TX_FLOW_LOW_WM 4
+#endif
+
+/** If define CONFIG_WMM_CLASSIFIER 1, the access category of an IP packet is
+ *  taken from the first matching rule of a table of DSCP, IP protocol and
+ *  port rules, see wifi_wmm_set_class_rules(). Packets matching no rule keep
+ *  the IP precedence mapping.
+ */
+#if !defined CONFIG_WMM_CLASSIFIER
+#if defined(SDK_OS_FREE_RTOS)
+#define CONFIG_WMM_CLASSIFIER CONFIG_WMM
+#else
+#define CONFIG_WMM_CLASSIFIER 0
+#endif
+#endif
+
+#if !CONFIG_WMM
+#undef CONFIG_WMM_CLASSIFIER
+#define CONFIG_WMM_CLASSIFIER 0
+#endif
+
+/** Maximum number of WMM classifier rules */
+#if !defined CONFIG_WMM_CLASS_RULES_MAX
+#define CONFIG_WMM_CLASS_RULES_MAX 8
+#endif
+
+/** If define CONFIG_WMM_AIRTIME_FAIRNESS 1, the uAP shares the airtime of each
+ *  access category between the associated stations: RA lists are served by
+ *  deficit round robin on the estimated transmit time of their packets, from
+ *  packet size and the last data rate received from the station, instead of
+ *  sending every RA list until it is empty. AC priority order is kept.
+ */
+#if !defined CONFIG_WMM_AIRTIME_FAIRNESS
+#define CONFIG_WMM_AIRTIME_FAIRNESS CONFIG_WMM
+#endif
+
+#if !CONFIG_WMM
+#undef CONFIG_WMM_AIRTIME_FAIRNESS
+#define CONFIG_WMM_AIRTIME_FAIRNESS 0
+#endif
+
+/** Airtime credit given to each backlogged station per round, in us */
+#if !defined CONFIG_WMM_AIRTIME_QUANTUM_US
+#define CONFIG_WMM_AIRTIME_QUANTUM_US 1000
+#endif
+
+/** Firmware events of up to CONFIG_EVENTBUF_SMALL_SIZE bytes (link quality,
+ *  power save, BA stream...) are copied into one of CONFIG_EVENTBUF_SMALL_NUM
+ *  static buffers, only larger events (scan, reports) take a 2560 byte buffer.
+ *  0 disables the small buffers.
+ */
+#if !defined CONFIG_EVENTBUF_SMALL_NUM
+#define CONFIG_EVENTBUF_SMALL_NUM 8
+#endif
+
+#if !defined CONFIG_EVENTBUF_SMALL_SIZE
+#define CONFIG_EVENTBUF_SMALL_SIZE 128
+#endif
+
+/** If define CONFIG_WIFI_LINK_QUALITY 1, the driver keeps a smoothed link
+ *  quality estimate (RSSI, data rate, TX loss, expected throughput) per peer
+ *  from the received data packets and sampled firmware TX status, see
+ *  wifi_get_link_quality().
+ */
+#if !defined CONFIG_WIFI_LINK_QUALITY
+#define CONFIG_WIFI_LINK_QUALITY 1
+#endif
+
+/** Peers tracked, the AP of the station interface and the uAP stations */
+#if !defined CONFIG_WIFI_LQ_MAX_PEERS
+#define CONFIG_WIFI_LQ_MAX_PEERS 4
+#endif
+
+/** Firmware TX status is requested for one data packet out of this many
+ *  sent to a peer, 0 disables the TX loss estimate.
+ */
+#if !defined CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+#define CONFIG_WIFI_LQ_TX_STATUS_INTERVAL 32
+#endif
+
+/** Sampled packets whose TX status can be pending at once */
+#if !defined CONFIG_WIFI_LQ_TX_TOKENS
+#define CONFIG_WIFI_LQ_TX_TOKENS 8
+#endif
+
+/** Smoothing, each sample weighs 1 / 2^CONFIG_WIFI_LQ_EWMA_SHIFT */
+#if !defined CONFIG_WIFI_LQ_EWMA_SHIFT
+#define CONFIG_WIFI_LQ_EWMA_SHIFT 3
+#endif
+
+/** Share of the PHY rate available as throughput, in percent */
+#if !defined CONFIG_WIFI_LQ_MAC_EFFICIENCY
+#define CONFIG_WIFI_LQ_MAC_EFFICIENCY 60
+#endif
+
 #if !defined CONFIG_SDIO_MULTI_PORT_RX_AGGR
 #if defined(SD8978) || defined(SD8987) || defined(SD8801) || defined(SD9177) || defined(IW610)
 #define CONFIG_SDIO_MULTI_PORT_RX_AGGR 1
@@ -690,6 +807,23 @@
 #endif
 #endif
 
+/** VDLL blocks kept in RAM, so the firmware blocks requested again or
+ *  prefetched are not read from flash when needed. 0 disables the cache.
+ */
+#if !defined CONFIG_FW_VDLL_CACHE_BLOCKS
+#define CONFIG_FW_VDLL_CACHE_BLOCKS 4
+#endif
+
+/** Largest VDLL block cached, larger ones are sent from flash */
+#if !defined CONFIG_FW_VDLL_CACHE_BLOCK_SIZE
+#define CONFIG_FW_VDLL_CACHE_BLOCK_SIZE 2048
+#endif
+
+/** Host commands and blocks whose following block is remembered for prefetch */
+#if !defined CONFIG_FW_VDLL_PREFETCH_ENTRIES
+#define CONFIG_FW_VDLL_PREFETCH_ENTRIES 16
+#endif
+
 /*
  * Config options for wpa supplicant
  */
@@ -998,6 +1132,32 @@
 #endif
 #endif
 
+/** If define CONFIG_AMSDU_RX_ZERO_COPY 1, received A-MSDUs are kept in one
+ *  contiguous lwIP buffer and each subframe is delivered as a PBUF_REF pbuf
+ *  pointing into it, please make sure
+ *  #define LWIP_SUPPORT_CUSTOM_PBUF 1
+ *  in lwipopts.h
+ */
+#if !defined CONFIG_AMSDU_RX_ZERO_COPY
+#if defined(SDK_OS_FREE_RTOS) && !(CONFIG_TX_RX_ZERO_COPY) && !(FSL_USDHC_ENABLE_SCATTER_GATHER_TRANSFER)
+#define CONFIG_AMSDU_RX_ZERO_COPY 1
+#else
+#define CONFIG_AMSDU_RX_ZERO_COPY 0
+#endif
+#endif
+
+/** Number of whole A-MSDUs (4 KB each, not taken from the lwIP heap) which can
+ *  be held by the stack at the same time, A-MSDUs beyond that are copied */
+#if !defined CONFIG_AMSDU_RX_BUFS
+#define CONFIG_AMSDU_RX_BUFS 2
+#endif
+
+/** Number of A-MSDU subframes which can be held by the stack at the same time,
+ *  subframes beyond that are copied */
+#if !defined CONFIG_AMSDU_RX_REF_PBUFS
+#define CONFIG_AMSDU_RX_REF_PBUFS 16
+#endif
+
 #if !defined CONFIG_WIFI_CLOCKSYNC
 #if defined(RW610)
 #define CONFIG_WIFI_CLOCKSYNC 1
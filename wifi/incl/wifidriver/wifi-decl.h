@@ -581,6 +581,27 @@ typedef PACK_START struct _wifi_ds_rate
     } param;
 } PACK_END wifi_ds_rate;
 
+/** Link quality estimate of a peer */
+typedef struct _wifi_link_quality_t
+{
+    /** Peer MAC address */
+    t_u8 mac[MLAN_MAC_ADDR_LENGTH];
+    /** Smoothed RSSI of the received data packets, dBm */
+    t_s16 rssi;
+    /** Smoothed data rate of the received data packets, kbps */
+    t_u32 phy_rate_kbps;
+    /** Smoothed loss of the sampled transmitted packets, percent */
+    t_u8 loss_pct;
+    /** Expected throughput from data rate and loss, kbps */
+    t_u32 tput_kbps;
+    /** Sampled transmitted packets acknowledged by the peer */
+    t_u32 tx_status_ok;
+    /** Sampled transmitted packets the firmware failed to deliver */
+    t_u32 tx_status_fail;
+    /** Time since the last packet from the peer, ms */
+    t_u32 age_ms;
+} wifi_link_quality_t;
+
 /** Type definition of wifi_ed_mac_ctrl_t */
 typedef PACK_START struct _wifi_ed_mac_ctrl_t
 {
@@ -286,6 +286,51 @@ int wifi_register_amsdu_data_input_callback(void (*amsdu_data_input_callback)(ui
 /** Deregister Data callback function from Wi-Fi Driver */
 void wifi_deregister_amsdu_data_input_callback(void);
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+/**
+ * Register callback function with Wi-Fi Driver to receive AMSDU
+ * subframes without copy.
+ *
+ * The subframe is located inside the stack buffer holding the whole
+ * AMSDU. The callback takes its own reference on the stack buffer if it
+ * keeps the subframe; the driver drops its reference once all subframes
+ * are delivered. Without this callback subframes are copied and passed to
+ * the AMSDU DATA callback.
+ *
+ * @param[in] amsdu_ref_input_callback Function that needs to be called
+ *
+ * @return WM_SUCESS
+ *
+ */
+int wifi_register_amsdu_ref_input_callback(void (*amsdu_ref_input_callback)(uint8_t interface,
+                                                                            void *stack_buffer,
+                                                                            uint8_t *buffer,
+                                                                            uint16_t len));
+
+/** Deregister AMSDU subframe reference callback function from Wi-Fi Driver */
+void wifi_deregister_amsdu_ref_input_callback(void);
+#endif
+
+#if CONFIG_TX_FLOW_CONTROL
+/**
+ * Register callback function with Wi-Fi Driver to be told when a
+ * TX flow controlled access category takes packets again.
+ *
+ * Called from the driver TX task once the queue of a paused access
+ * category is drained to CONFIG_TX_FLOW_LOW_WM, the stack should then
+ * retry the packets refused meanwhile.
+ *
+ * @param[in] tx_resume_callback Function that needs to be called
+ *
+ * @return WM_SUCESS
+ *
+ */
+int wifi_register_tx_resume_callback(void (*tx_resume_callback)(uint8_t interface));
+
+/** Deregister TX resume callback function from Wi-Fi Driver */
+void wifi_deregister_tx_resume_callback(void);
+#endif
+
 int wifi_register_deliver_packet_above_callback(void (*deliver_packet_above_callback)(void *rxpd,
                                                                                       uint8_t interface,
                                                                                       void *lwip_pbuf));
@@ -1080,6 +1125,48 @@ int wifi_set_packet_filters(wifi_flt_cfg_t *flt_cfg);
 
 int wifi_get_data_rate(wifi_ds_rate *ds_rate, mlan_bss_type bss_type);
 
+#if CONFIG_FW_VDLL
+/** Firmware VDLL download statistics */
+typedef struct
+{
+    /** Blocks requested by the firmware */
+    t_u32 requests;
+    /** Requests served from the RAM cache */
+    t_u32 hits;
+    /** Blocks prefetched into the cache */
+    t_u32 prefetches;
+    /** Requests served by a prefetched block */
+    t_u32 prefetch_hits;
+    /** Commands delayed by a VDLL download in progress */
+    t_u32 stalls;
+    /** Total delay of those commands, ms */
+    t_u32 stall_ms_total;
+    /** Longest delay of a command, ms */
+    t_u32 stall_ms_max;
+} wifi_vdll_stats_t;
+
+/**
+ * Get the firmware VDLL download statistics.
+ *
+ * \param[out] stats Counters since boot.
+ */
+void wifi_get_vdll_stats(wifi_vdll_stats_t *stats);
+#endif
+
+#if CONFIG_WIFI_LINK_QUALITY
+/**
+ * Get the link quality estimate of a peer, without any firmware command.
+ *
+ * \param[in] bss_type MLAN_BSS_TYPE_STA or MLAN_BSS_TYPE_UAP.
+ * \param[in] mac Peer MAC address, NULL for the most recently heard peer
+ *                (the AP on the station interface).
+ * \param[out] lq Link quality estimate.
+ *
+ * \return WM_SUCCESS, -WM_FAIL if nothing was received from the peer.
+ */
+int wifi_get_link_quality(mlan_bss_type bss_type, const t_u8 *mac, wifi_link_quality_t *lq);
+#endif
+
 #if CONFIG_WIFI_RTS_THRESHOLD
 int wifi_set_rts(int rts, mlan_bss_type bss_type);
 #endif
@@ -1240,10 +1327,17 @@ int wifi_set_btwt_cfg(const wifi_btwt_config_t *btwt_config);
  *
  * \param[in] twt_setup TWT Setup parameters to be sent to Firmware
  *
- * \return WM_SUCCESS if successful otherwise failure.
+ * \return WM_SUCCESS if successful, -WM_FAIL if the command failed or the
+ *         setup was rejected.
  */
 int wifi_set_twt_setup_cfg(const wifi_twt_setup_config_t *twt_setup);
 
+/** Check if individual TWT can be negotiated with the connected AP
+ *
+ * \return true if both the AP and the firmware support TWT.
+ */
+bool wifi_is_twt_supported(void);
+
 /** Set twt teardown config params
  *
  * \param[in] teardown_config TWT Teardown parameters to be sent to Firmware
@@ -1387,6 +1481,47 @@ void wifi_register_fw_dump_cb(int (*wifi_usb_mount_cb)(),
 #if CONFIG_WMM
 void wifi_wmm_init();
 t_u32 wifi_wmm_get_pkt_prio(void *buf, t_u8 *tid);
+#if CONFIG_WMM_CLASSIFIER
+/** Match any DSCP in a \ref wifi_wmm_class_rule_t */
+#define WIFI_WMM_DSCP_ANY 0xFFU
+
+/** WMM classifier rule, fields set to any match every packet */
+typedef struct
+{
+    /** DSCP 0-63 or WIFI_WMM_DSCP_ANY */
+    uint8_t dscp;
+    /** IP protocol (IPv6 next header) or 0 for any */
+    uint8_t proto;
+    /** TCP or UDP source or destination port, 0 for any */
+    uint16_t port;
+    /** Access category, WMM_AC_BK to WMM_AC_VO */
+    uint8_t ac;
+} wifi_wmm_class_rule_t;
+
+/**
+ * Replace the WMM classifier rules.
+ *
+ * The first rule matching a packet gives its access category, packets
+ * matching no rule are classified by their IP precedence. May be called
+ * at any time, the new table applies to the next packet sent.
+ *
+ * \param[in] rules Rules in order of precedence.
+ * \param[in] count Number of rules, at most CONFIG_WMM_CLASS_RULES_MAX.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid rules.
+ */
+int wifi_wmm_set_class_rules(const wifi_wmm_class_rule_t *rules, uint8_t count);
+
+/**
+ * Get the WMM classifier rules.
+ *
+ * \param[out] rules Buffer for the rules.
+ * \param[in] max Number of rules the buffer can hold.
+ *
+ * \return Number of rules copied.
+ */
+uint8_t wifi_wmm_get_class_rules(wifi_wmm_class_rule_t *rules, uint8_t max);
+#endif
 t_u8 wifi_wmm_get_packet_cnt(void);
 /* handle EVENT_TX_DATA_PAUSE */
 void wifi_handle_event_data_pause(void *data);
@@ -1395,6 +1530,32 @@ void wifi_wmm_tx_stats_dump(int bss_type);
 
 int wifi_set_rssi_low_threshold(uint8_t *low_rssi);
 
+/** Firmware event buffer usage, see CONFIG_EVENTBUF_SMALL_NUM */
+typedef struct
+{
+    /** Small buffers in use */
+    t_u32 small_in_use;
+    /** Most small buffers in use at once */
+    t_u32 small_peak;
+    /** Large buffers in use */
+    t_u32 large_in_use;
+    /** Most large buffers in use at once */
+    t_u32 large_peak;
+    /** Small events given a large buffer, all small ones being in use */
+    t_u32 small_overflow;
+    /** Events dropped for lack of any buffer */
+    t_u32 alloc_fail;
+    /** Largest event received */
+    t_u32 max_size;
+} wifi_eventbuf_stats_t;
+
+/**
+ * Get the firmware event buffer usage.
+ *
+ * \param[out] stats Usage counters and peaks since boot.
+ */
+void wifi_get_eventbuf_stats(wifi_eventbuf_stats_t *stats);
+
 #if CONFIG_HEAP_DEBUG
 /**
  * Show os mem alloc and free info.
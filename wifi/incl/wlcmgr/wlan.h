@@ -1431,6 +1431,12 @@ typedef wifi_cloud_keep_alive_t wlan_cloud_keep_alive_t;
  * \ref wifi_ds_rate
  */
 typedef wifi_ds_rate wlan_ds_rate;
+#if CONFIG_WIFI_LINK_QUALITY
+/** Link quality estimate of a peer from
+ * \ref wifi_link_quality_t
+ */
+typedef wifi_link_quality_t wlan_link_quality_t;
+#endif
 /** Configuration for ED MAC Control parameters from
  * \ref wifi_ed_mac_ctrl_t
  */
@@ -3816,6 +3822,24 @@ uint8_t wlan_get_dtim_period(void);
  */
 int wlan_get_data_rate(wlan_ds_rate *ds_rate, mlan_bss_type bss_type);
 
+#if CONFIG_WIFI_LINK_QUALITY
+/**
+ * Use this API to get the host side link quality estimate of a peer:
+ * smoothed RSSI and data rate of the received data packets, loss of the
+ * sampled transmitted packets and the throughput to expect from them.
+ * No firmware command is sent, the call is cheap enough for periodic use.
+ *
+ * \param[in] bss_type: 0: STA, 1: uAP
+ * \param[in] mac: Peer MAC address, NULL for the most recently heard peer
+ *                 (the AP on the station interface).
+ * \param[out] lq: Link quality estimate.
+ *
+ * \return WM_SUCCESS if operation is successful.
+ * \return -WM_FAIL if nothing was received from the peer.
+ */
+int wlan_get_link_quality(mlan_bss_type bss_type, const uint8_t *mac, wlan_link_quality_t *lq);
+#endif
+
 /**
  * Use this API to get the management frame protection parameters for sta.
  *
@@ -5906,10 +5930,18 @@ wlan_btwt_config_t *wlan_get_btwt_cfg(void);
  *
  * \param[in] twt_setup: TWT setup parameters to be sent to firmware.
  *
- * \return WM_SUCCESS if successful otherwise return -WM_FAIL.
+ * \return WM_SUCCESS if successful otherwise return -WM_FAIL (also when the
+ *         AP rejected the setup).
  */
 int wlan_set_twt_setup_cfg(const wlan_twt_setup_config_t *twt_setup);
 
+/** Check if individual TWT can be negotiated on the current station connection
+ *
+ * \return true if the station is connected and both the AP and the firmware
+ *         support TWT, false otherwise.
+ */
+bool wlan_is_twt_supported(void);
+
 /** Get TWT setup configuration parameters
  *
  * \return TWT setup parameters default array.
@@ -6087,6 +6119,31 @@ int wlan_rx_mgmt_indication(const enum wlan_bss_type bss_type,
 void wlan_wmm_tx_stats_dump(int bss_type);
 #endif
 
+#if CONFIG_WMM_CLASSIFIER
+/** WMM classifier rule, see \ref wifi_wmm_class_rule_t */
+typedef wifi_wmm_class_rule_t wlan_wmm_class_rule_t;
+
+/** Replace the WMM classifier rules mapping DSCP, IP protocol and port
+ * to an access category. The first matching rule applies, packets matching
+ * no rule are classified by their IP precedence.
+ *
+ * \param[in] rules Rules in order of precedence.
+ * \param[in] count Number of rules, at most CONFIG_WMM_CLASS_RULES_MAX.
+ *
+ * \return WM_SUCCESS on success or -WM_E_INVAL on invalid rules.
+ */
+int wlan_wmm_set_class_rules(const wlan_wmm_class_rule_t *rules, uint8_t count);
+
+/** Get the WMM classifier rules.
+ *
+ * \param[out] rules Buffer for the rules.
+ * \param[in] max Number of rules the buffer can hold.
+ *
+ * \return Number of rules copied.
+ */
+uint8_t wlan_wmm_get_class_rules(wlan_wmm_class_rule_t *rules, uint8_t max);
+#endif
+
 #if CONFIG_SCAN_CHANNEL_GAP
 /**
  * Set scan channel gap.
@@ -0,0 +1,108 @@
+/*
+ * amsdu_rx.h
+ * Received A-MSDUs kept whole, with their subframes delivered as references
+ * into them, see CONFIG_AMSDU_RX_ZERO_COPY. Declares the memory pools, so it
+ * is included by wifi_netif.c only.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _AMSDU_RX_H_
+#define _AMSDU_RX_H_
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "lwip/memp.h"
+#include "lwip/pbuf.h"
+
+#if !LWIP_SUPPORT_CUSTOM_PBUF
+#error "CONFIG_AMSDU_RX_ZERO_COPY needs LWIP_SUPPORT_CUSTOM_PBUF"
+#endif
+
+/* Largest A-MSDU payload, as the amsdu_inbuf of the copy path */
+#define AMSDU_RX_BUF_SIZE 4096U
+
+/* A-MSDU kept whole so that its subframes can point into it. These come from
+ * a pool of their own: a subframe held by an application pins the whole
+ * A-MSDU, which must not starve the lwIP heap used for TX. */
+typedef struct
+{
+    struct pbuf_custom pc;
+    u8_t data[AMSDU_RX_BUF_SIZE];
+} amsdu_buf_t;
+
+/* A-MSDU subframe delivered to the stack, references the A-MSDU pbuf */
+typedef struct
+{
+    struct pbuf_custom pc;
+    struct pbuf *amsdu;
+} amsdu_subframe_t;
+
+LWIP_MEMPOOL_DECLARE(AMSDU_RX, CONFIG_AMSDU_RX_BUFS, sizeof(amsdu_buf_t), "AMSDU RX");
+LWIP_MEMPOOL_DECLARE(AMSDU_SUBFRAME, CONFIG_AMSDU_RX_REF_PBUFS, sizeof(amsdu_subframe_t), "AMSDU subframe");
+static bool amsdu_pools_init;
+
+static void amsdu_buf_free(struct pbuf *p)
+{
+    LWIP_MEMPOOL_FREE(AMSDU_RX, (amsdu_buf_t *)(void *)p);
+}
+
+static void amsdu_subframe_free(struct pbuf *p)
+{
+    amsdu_subframe_t *subframe = (amsdu_subframe_t *)(void *)p;
+    struct pbuf *amsdu         = subframe->amsdu;
+
+    LWIP_MEMPOOL_FREE(AMSDU_SUBFRAME, subframe);
+    (void)pbuf_free(amsdu);
+}
+
+/* A-MSDU copied into a buffer of its own, NULL if all of them are held by the stack */
+static inline struct pbuf *amsdu_rx_alloc(const u8_t *payload, u16_t datalen)
+{
+    amsdu_buf_t *buf;
+    struct pbuf *p;
+
+    /* Only called from the driver RX path */
+    if (!amsdu_pools_init)
+    {
+        LWIP_MEMPOOL_INIT(AMSDU_RX);
+        LWIP_MEMPOOL_INIT(AMSDU_SUBFRAME);
+        amsdu_pools_init = true;
+    }
+
+    if (datalen > AMSDU_RX_BUF_SIZE)
+    {
+        return NULL;
+    }
+    buf = (amsdu_buf_t *)LWIP_MEMPOOL_ALLOC(AMSDU_RX);
+    if (buf == NULL)
+    {
+        return NULL;
+    }
+
+    buf->pc.custom_free_function = amsdu_buf_free;
+    p = pbuf_alloced_custom(PBUF_RAW, datalen, PBUF_REF, &buf->pc, buf->data, AMSDU_RX_BUF_SIZE);
+    (void)memcpy(p->payload, payload, datalen);
+    return p;
+}
+
+/* Subframe at data inside the A-MSDU pbuf, holding a reference on it.
+ * NULL if all subframe references are in use. */
+static inline struct pbuf *amsdu_rx_subframe(struct pbuf *amsdu, u8_t *data, u16_t len)
+{
+    amsdu_subframe_t *subframe = (amsdu_subframe_t *)LWIP_MEMPOOL_ALLOC(AMSDU_SUBFRAME);
+
+    if (subframe == NULL)
+    {
+        return NULL;
+    }
+
+    subframe->pc.custom_free_function = amsdu_subframe_free;
+    subframe->amsdu                   = amsdu;
+    pbuf_ref(amsdu);
+
+    return pbuf_alloced_custom(PBUF_RAW, len, PBUF_REF, &subframe->pc, data, len);
+}
+
+#endif /* _AMSDU_RX_H_ */
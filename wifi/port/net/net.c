@@ -89,6 +89,12 @@ void *wifi_get_rxbuf_desc(t_u16 rx_len);
 #endif
 void handle_data_packet(const t_u8 interface, const t_u8 *rcvdata, const t_u16 datalen);
 void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+void handle_amsdu_ref_packet(t_u8 interface, t_void *stack_buffer, t_u8 *rcvdata, t_u16 datalen);
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+void handle_tx_resume(t_u8 interface);
+#endif
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf);
 bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer);
 
@@ -198,6 +204,112 @@ int net_dhcp_hostname_set(char *hostname)
     return WM_SUCCESS;
 }
 
+#if LWIP_DHCP_INIT_REBOOT
+/* Lease the station confirms at its next DHCP start, replaced when it gets
+ * bound. Accessed with the TCP/IP core locked. */
+static struct dhcp_lease sta_lease;
+/* sys_now() when sta_lease was set */
+static u32_t sta_lease_ms;
+/* Told when the station is bound to a new or changed lease */
+static void (*sta_lease_cb)(void);
+
+void net_dhcp_lease_set_callback(void (*cb)(void))
+{
+    LOCK_TCPIP_CORE();
+    sta_lease_cb = cb;
+    UNLOCK_TCPIP_CORE();
+}
+
+/* Keep the lease the station got bound to, renewals of the same lease only
+ * restart its age */
+static void net_sta_lease_bound(struct netif *netif)
+{
+    struct dhcp_lease lease;
+
+    if (dhcp_get_lease(netif, &lease) != ERR_OK)
+    {
+        return;
+    }
+
+    sta_lease_ms = sys_now();
+    if (memcmp(&lease, &sta_lease, sizeof(lease)) != 0)
+    {
+        sta_lease = lease;
+        if (sta_lease_cb != NULL)
+        {
+            sta_lease_cb();
+        }
+    }
+}
+
+int net_dhcp_lease_set(const net_dhcp_lease_t *lease)
+{
+    LOCK_TCPIP_CORE();
+    (void)memset(&sta_lease, 0, sizeof(sta_lease));
+    if (lease != NULL)
+    {
+        ip4_addr_set_u32(&sta_lease.ip_addr, lease->address);
+        ip4_addr_set_u32(&sta_lease.sn_mask, lease->netmask);
+        ip4_addr_set_u32(&sta_lease.gw_addr, lease->gw);
+        ip4_addr_set_u32(&sta_lease.server_ip_addr, lease->server);
+        sta_lease.lease_time = lease->lease_time;
+        /* the age of a lease kept across a reset is not known, the server decides */
+        sta_lease_ms = sys_now();
+    }
+    UNLOCK_TCPIP_CORE();
+    return WM_SUCCESS;
+}
+
+int net_dhcp_lease_get(net_dhcp_lease_t *lease)
+{
+    int ret = -WM_FAIL;
+
+    LOCK_TCPIP_CORE();
+    if (!ip4_addr_isany_val(sta_lease.ip_addr))
+    {
+        lease->address    = ip4_addr_get_u32(&sta_lease.ip_addr);
+        lease->netmask    = ip4_addr_get_u32(&sta_lease.sn_mask);
+        lease->gw         = ip4_addr_get_u32(&sta_lease.gw_addr);
+        lease->server     = ip4_addr_get_u32(&sta_lease.server_ip_addr);
+        lease->lease_time = sta_lease.lease_time;
+        ret               = WM_SUCCESS;
+    }
+    UNLOCK_TCPIP_CORE();
+    return ret;
+}
+
+/* Start DHCP on the station, confirming the kept lease unless it expired */
+static void net_sta_dhcp_start(struct netif *netif)
+{
+    LOCK_TCPIP_CORE();
+    if ((sta_lease.lease_time != 0xffffffffU) && (((sys_now() - sta_lease_ms) / 1000U) >= sta_lease.lease_time))
+    {
+        (void)memset(&sta_lease, 0, sizeof(sta_lease));
+    }
+    (void)dhcp_start_reboot(netif, &sta_lease);
+    UNLOCK_TCPIP_CORE();
+}
+
+/* The kept lease is used while the server confirms it. It is reported once
+ * wlcmgr waits for the DHCP result, a NAK is reported later as a lost
+ * address, the new lease as a new one. */
+static void net_sta_report_kept_lease(struct netif *netif)
+{
+    struct dhcp *dhcp;
+    bool confirming;
+
+    LOCK_TCPIP_CORE();
+    dhcp       = netif_dhcp_data(netif);
+    confirming = (dhcp != NULL) && (dhcp->state == DHCP_STATE_REBOOTING) && !ip4_addr_isany_val(*netif_ip4_addr(netif));
+    UNLOCK_TCPIP_CORE();
+
+    if (confirming)
+    {
+        (void)wlan_wlcmgr_send_msg(WIFI_EVENT_NET_DHCP_CONFIG, WIFI_EVENT_REASON_SUCCESS, NULL);
+    }
+}
+#endif
+
 #if !CONFIG_NO_WIFI_TCPIP_INIT
 static void tcpip_init_done_cb(void *arg)
 {
@@ -279,6 +391,12 @@ int net_wlan_init(void)
 #ifdef RW610
     (void)wifi_register_data_input_callback(&handle_data_packet);
     (void)wifi_register_amsdu_data_input_callback(&handle_amsdu_data_packet);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+    (void)wifi_register_amsdu_ref_input_callback(&handle_amsdu_ref_packet);
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+    (void)wifi_register_tx_resume_callback(&handle_tx_resume);
+#endif
     (void)wifi_register_deliver_packet_above_callback(&handle_deliver_packet_above);
     (void)wifi_register_wrapper_net_is_ip_or_ipv6_callback(&wrapper_net_is_ip_or_ipv6);
 #endif
@@ -299,6 +417,12 @@ int net_wlan_init(void)
 #endif
         (void)wifi_register_data_input_callback(&handle_data_packet);
         (void)wifi_register_amsdu_data_input_callback(&handle_amsdu_data_packet);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+        (void)wifi_register_amsdu_ref_input_callback(&handle_amsdu_ref_packet);
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+        (void)wifi_register_tx_resume_callback(&handle_tx_resume);
+#endif
         (void)wifi_register_deliver_packet_above_callback(&handle_deliver_packet_above);
         (void)wifi_register_wrapper_net_is_ip_or_ipv6_callback(&wrapper_net_is_ip_or_ipv6);
 #endif
@@ -495,12 +619,23 @@ static void wm_netif_status_callback(struct netif *n)
     {
         /* If a valid non-default dhcp address is provided */
         event_flag_dhcp_connection = DHCP_SUCCESS;
+#if LWIP_DHCP_INIT_REBOOT
+        /* Kept for the next connection */
+        net_sta_lease_bound(n);
+#endif
     }
     else if (is_dhcp_address)
     {
         /* If the supplied dhcp address is the default address */
         event_flag_dhcp_connection = DHCP_FAILED;
     }
+#if LWIP_DHCP_INIT_REBOOT
+    else if ((netif_dhcp_data(n)->state == DHCP_STATE_REBOOTING) && !(is_default_dhcp_address))
+    {
+        /* The kept lease being confirmed, reported by net_configure_address()
+         * after WIFI_EVENT_NET_STA_ADDR_CONFIG */
+    }
+#endif
     else if (!dhcp_supplied_address(n))
     {
         /* If no ip address is supplied */
@@ -745,7 +880,16 @@ int net_configure_address(struct net_ip_config *addr, void *intrfc_handle)
             (void)netifapi_netif_set_up(&if_handle->netif);
             (void)OSA_TimerActivate((osa_timer_handle_t)dhcp_timer);
             wm_netif_status_callback_ptr = wm_netif_status_callback;
-            (void)netifapi_dhcp_start(&if_handle->netif);
+#if LWIP_DHCP_INIT_REBOOT
+            if (if_handle == &g_mlan)
+            {
+                net_sta_dhcp_start(&if_handle->netif);
+            }
+            else
+#endif
+            {
+                (void)netifapi_dhcp_start(&if_handle->netif);
+            }
             break;
         case NET_ADDR_TYPE_LLA:
             /* For dhcp, instead of netifapi_netif_set_up, a
@@ -763,6 +907,12 @@ int net_configure_address(struct net_ip_config *addr, void *intrfc_handle)
     if (if_handle == &g_mlan)
     {
         (void)wlan_wlcmgr_send_msg(WIFI_EVENT_NET_STA_ADDR_CONFIG, WIFI_EVENT_REASON_SUCCESS, NULL);
+#if LWIP_DHCP_INIT_REBOOT
+        if (addr->ipv4.addr_type == NET_ADDR_TYPE_DHCP)
+        {
+            net_sta_report_kept_lease(&if_handle->netif);
+        }
+#endif
 
         /* XXX For DHCP, the above event will only indicate that the
          * DHCP address obtaining process has started. Once the DHCP
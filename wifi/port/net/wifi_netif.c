@@ -41,6 +41,10 @@
 
 /*------------------------------------------------------*/
 #include <netif_decl.h>
+#if CONFIG_TX_FLOW_CONTROL
+#include "lwip/tcpip.h"
+#include "lwip/priv/tcp_priv.h"
+#endif
 /*------------------------------------------------------*/
 
 #if FSL_USDHC_ENABLE_SCATTER_GATHER_TRANSFER
@@ -87,9 +91,19 @@ err_t lwip_netif_uap_init(struct netif *netif);
 err_t lwip_netif_init(struct netif *netif);
 void handle_data_packet(const t_u8 interface, const t_u8 *rcvdata, const t_u16 datalen);
 void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+void handle_amsdu_ref_packet(t_u8 interface, t_void *stack_buffer, t_u8 *rcvdata, t_u16 datalen);
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+void handle_tx_resume(t_u8 interface);
+#endif
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf);
 bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer);
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+#include "amsdu_rx.h"
+#endif
+
 #if MGMT_RX
 static int (*rx_mgmt_callback)(const enum wlan_bss_type bss_type, const wifi_mgmt_frame_t *frame, const size_t len);
 void rx_mgmt_register_callback(int (*rx_mgmt_cb_fn)(const enum wlan_bss_type bss_type,
@@ -338,6 +352,21 @@ retry:
     return p;
 }
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+/* Keep the A-MSDU in one buffer so that its subframes can point into it */
+static struct pbuf *gen_amsdu_pbuf_from_data(t_u8 *payload, t_u16 datalen)
+{
+    struct pbuf *p = amsdu_rx_alloc(payload, datalen);
+
+    if (p == NULL)
+    {
+        /* All A-MSDU buffers held by the stack, subframes will be copied out of the pool chain */
+        return gen_pbuf_from_data(payload, datalen);
+    }
+    return p;
+}
+#endif
+
 static void process_data_packet(const t_u8 *rcvdata,
                                 const t_u16 datalen
 #if FSL_USDHC_ENABLE_SCATTER_GATHER_TRANSFER
@@ -439,7 +468,16 @@ static void process_data_packet(const t_u8 *rcvdata,
 #endif
 #endif
 #else
-    p = gen_pbuf_from_data(payload, payload_len);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+    if (rxpd->rx_pkt_type == PKT_TYPE_AMSDU)
+    {
+        p = gen_amsdu_pbuf_from_data(payload, payload_len);
+    }
+    else
+#endif
+    {
+        p = gen_pbuf_from_data(payload, payload_len);
+    }
 #endif
 
     /* If there are no more buffers, we do nothing, so the data is
@@ -729,6 +767,21 @@ void handle_amsdu_data_packet(t_u8 interface, t_u8 *rcvdata, t_u16 datalen)
     deliver_packet_above(p, interface);
 }
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+void handle_amsdu_ref_packet(t_u8 interface, t_void *stack_buffer, t_u8 *rcvdata, t_u16 datalen)
+{
+    struct pbuf *p = amsdu_rx_subframe((struct pbuf *)stack_buffer, rcvdata, datalen);
+
+    if (p == NULL)
+    {
+        /* All references in use, fall back to a copy */
+        handle_amsdu_data_packet(interface, rcvdata, datalen);
+        return;
+    }
+    deliver_packet_above(p, interface);
+}
+#endif
+
 void handle_deliver_packet_above(t_void *rxpd, t_u8 interface, t_void *lwip_pbuf)
 {
     struct pbuf *p = (struct pbuf *)lwip_pbuf;
@@ -742,6 +795,24 @@ bool wrapper_net_is_ip_or_ipv6(const t_u8 *buffer)
     return net_is_ip_or_ipv6(buffer);
 }
 
+#if CONFIG_TX_FLOW_CONTROL
+static void tx_resume_tcp(void *ctx)
+{
+    (void)ctx;
+#if LWIP_TCP
+    /* Segments refused by low_level_output() are flagged TF_NAGLEMEMERR */
+    tcp_txnow();
+#endif
+}
+
+void handle_tx_resume(t_u8 interface)
+{
+    (void)interface;
+    /* If the mailbox is full, tcp_fasttmr retries the flagged segments */
+    (void)tcpip_try_callback(tx_resume_tcp, NULL);
+}
+#endif
+
 /**
  * Should be called at the beginning of the program to set up the
  * In this function, the hardware should be initialized.
@@ -821,8 +892,10 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 #endif
 
 #if CONFIG_WMM
-    t_u8 tid                      = 0;
-    int retry                     = 0;
+    t_u8 tid = 0;
+#if !CONFIG_TX_FLOW_CONTROL
+    int retry = 0;
+#endif
     t_u8 ra[MLAN_MAC_ADDR_LENGTH] = {0};
     bool is_tx_pause              = false;
 
@@ -852,6 +925,28 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
 
     wifi_wmm_da_to_ra(p->payload, ra);
 
+#if CONFIG_TX_FLOW_CONTROL
+    /* Never wait for the driver here: a paused AC, or one without a buffer
+     * because it is full or its peer is in power save, refuses the packet.
+     * TCP keeps the segment queued and retries on handle_tx_resume() */
+    if (wifi_wmm_tx_flow_paused(interface, (mlan_wmm_ac_e)pkt_prio) == false)
+    {
+        wmm_outbuf = wifi_wmm_get_outbuf_enh(&outbuf_len, (mlan_wmm_ac_e)pkt_prio, interface, ra, &is_tx_pause);
+        if (wmm_outbuf == NULL)
+        {
+            wifi_wmm_tx_flow_pause(interface, (mlan_wmm_ac_e)pkt_prio);
+            wifi_wmm_drop_retried_drop(interface);
+        }
+    }
+
+    if (wmm_outbuf == NULL)
+    {
+        /* The TX task drains the queue and resumes the AC */
+        send_wifi_driver_tx_data_event(interface);
+        mlan_adap->priv[interface]->tx_overrun_cnt++;
+        return ERR_MEM;
+    }
+#else
     do
     {
         if (retry != 0)
@@ -896,6 +991,7 @@ static err_t low_level_output(struct netif *netif, struct pbuf *p)
         mlan_adap->priv[interface]->tx_overrun_cnt++;
         return ERR_MEM;
     }
+#endif /* CONFIG_TX_FLOW_CONTROL */
 #else
     wmm_outbuf = wifi_get_outbuf((uint32_t *)(&outbuf_len));
 
@@ -283,6 +283,9 @@ typedef t_u8 mlan_802_11_mac_addr[MLAN_MAC_ADDR_LENGTH];
 /** Buffer flag for bridge packet */
 #define MLAN_BUF_FLAG_BRIDGE_BUF MBIT(3)
 
+/** Buffer flag for A-MSDU deaggregated in place, pdesc points to the frame in the stack buffer */
+#define MLAN_BUF_FLAG_AMSDU_REF MBIT(4)
+
 /** Buffer flag for TX_STATUS */
 #define MLAN_BUF_FLAG_TX_STATUS MBIT(10)
 
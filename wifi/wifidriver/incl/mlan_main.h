@@ -888,6 +888,10 @@ struct _raListTbl
     /** drop packet count  */
     t_u16 drop_count;
 #endif
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+    /** airtime deficit in us */
+    t_s32 airtime_deficit;
+#endif
 };
 
 /** TID table */
@@ -922,6 +926,10 @@ typedef struct _wmm_desc
 
     /** AC status */
     WmmAcStatus_t ac_status[MAX_AC_QUEUES];
+#if CONFIG_TX_FLOW_CONTROL
+    /** AC paused by TX flow control */
+    t_u8 tx_flow_paused[MAX_AC_QUEUES];
+#endif
     /** AC downgraded values */
     mlan_wmm_ac_e ac_down_graded_vals[MAX_AC_QUEUES];
 
@@ -1182,6 +1190,7 @@ typedef struct
     t_u16 tx_wmm_retried_drop;
     t_u16 tx_wmm_pause_drop;
     t_u16 tx_wmm_pause_replaced;
+    t_u16 tx_flow_pause;
     t_u16 rx_reorder_drop;
 } wlan_pkt_stat_t;
 #endif
@@ -1640,6 +1649,14 @@ struct _TxBAStreamTbl
     t_u8 ampdu_supported[MAX_NUM_TID];
     /** last rx_seq */
     t_u16 rx_seq[MAX_NUM_TID];
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+    /** last rx rate index of the station */
+    t_u8 rx_rate;
+    /** last rx rate info of the station */
+    t_u8 rx_rate_info;
+    /** data rate used for airtime estimates, 500 kbps units */
+    t_u16 airtime_rate;
+#endif
 };
 
 /** RX reorder table */
@@ -3299,7 +3316,7 @@ mlan_status wlan_cmd_hs_wakeup_reason(pmlan_private pmpriv, HostCmd_DS_COMMAND *
 mlan_status wlan_ret_hs_wakeup_reason(pmlan_private pmpriv, HostCmd_DS_COMMAND *resp, mlan_ioctl_req *pioctl_buf);
 
 #if CONFIG_FW_VDLL
-mlan_status wlan_download_vdll_block(mlan_adapter *pmadapter, t_u8 *block, t_u16 block_len);
+mlan_status wlan_download_vdll_block(mlan_adapter *pmadapter, const t_u8 *block, t_u16 block_len);
 mlan_status wlan_process_vdll_event(pmlan_private pmpriv, t_u8 *pevent);
 #endif
 
@@ -0,0 +1,26 @@
+/*
+ * mlan_tx_flow.h
+ * Watermark decisions of the WMM TX flow control, see CONFIG_TX_FLOW_CONTROL
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef _MLAN_TX_FLOW_H_
+#define _MLAN_TX_FLOW_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* ac queue reached the high watermark, stop taking packets for it */
+static inline bool wlan_tx_flow_need_pause(uint32_t queued, uint32_t high_wm)
+{
+    return queued >= high_wm;
+}
+
+/* paused ac can take packets again: drained to low watermark and pool not empty */
+static inline bool wlan_tx_flow_can_resume(uint32_t queued, uint32_t pool_free, uint32_t low_wm)
+{
+    return (queued <= low_wm) && (pool_free != 0U);
+}
+
+#endif /* _MLAN_TX_FLOW_H_ */
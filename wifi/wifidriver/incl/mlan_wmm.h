@@ -252,6 +252,20 @@ void wifi_wmm_buf_put(outbuf_t *buf);
 int wifi_wmm_buf_pool_init(uint8_t *pool);
 void wifi_wmm_buf_pool_deinit(void);
 
+#if CONFIG_TX_FLOW_CONTROL
+/* wmm enhance tx flow control */
+bool wifi_wmm_tx_flow_paused(const uint8_t interface, mlan_wmm_ac_e queue);
+void wifi_wmm_tx_flow_pause(const uint8_t interface, mlan_wmm_ac_e queue);
+bool wifi_wmm_tx_flow_resume(const uint8_t interface);
+#endif
+
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+/* wmm enhance airtime fairness */
+void wlan_wmm_airtime_update_rate(mlan_private *priv, TxBAStreamTbl *ptx_tbl, const RxPD *prx_pd);
+t_u32 wlan_wmm_airtime_us(mlan_private *priv, raListTbl *ra_list, t_u32 len);
+t_u8 wlan_wmm_airtime_refill(mlan_private *priv, t_u8 ac);
+#endif
+
 /* wmm enhance ralist operation */
 void wlan_ralist_add_enh(mlan_private *priv, t_u8 *ra);
 int wlan_ralist_update_enh(mlan_private *priv, t_u8 *old_ra, t_u8 *new_ra);
@@ -87,7 +87,17 @@ mlan_status wlan_11n_deaggregate_pkt(mlan_private *priv, pmlan_buffer pmbuf)
 
     ENTER();
 
-    data          = (t_u8 *)(pmbuf->pbuf + pmbuf->data_offset);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+    if ((pmbuf->flags & MLAN_BUF_FLAG_AMSDU_REF) != 0U)
+    {
+        /* Frame in the stack buffer, see wlan_11n_dispatch_amsdu_pkt() */
+        data = (t_u8 *)pmbuf->pdesc;
+    }
+    else
+#endif
+    {
+        data = (t_u8 *)(pmbuf->pbuf + pmbuf->data_offset);
+    }
     total_pkt_len = (t_s32)pmbuf->data_len;
 
     /* Sanity test */
@@ -52,6 +52,30 @@ static mlan_status wlan_11n_dispatch_amsdu_pkt(mlan_private *priv, pmlan_buffer
         pmbuf->data_len = prx_pd->rx_pkt_length;
         pmbuf->data_offset += prx_pd->rx_pkt_offset;
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+        pmbuf->pdesc = net_stack_buffer_get_contiguous(pmbuf->lwip_pbuf, prx_pd->rx_pkt_length);
+        if (pmbuf->pdesc != MNULL)
+        {
+            /* Deaggregate in place, each subframe keeps a reference on the stack buffer */
+            pmbuf->flags |= MLAN_BUF_FLAG_AMSDU_REF;
+            (void)wlan_11n_deaggregate_pkt(priv, pmbuf);
+
+            /* Returned to the stack when the last subframe is freed */
+            net_stack_buffer_free(pmbuf->lwip_pbuf);
+#if !CONFIG_MEM_POOLS
+            OSA_MemoryFree(pmbuf->pbuf);
+            OSA_MemoryFree(pmbuf);
+#else
+            OSA_MemoryPoolFree(buf_128_MemoryPool, pmbuf->pbuf);
+            OSA_MemoryPoolFree(buf_128_MemoryPool, pmbuf);
+#endif
+            LEAVE();
+            return MLAN_STATUS_SUCCESS;
+        }
+        /* Split over several stack buffers, deaggregate from a copy */
+        pmbuf->flags &= ~MLAN_BUF_FLAG_AMSDU_REF;
+#endif
+
         (void)__memcpy(priv->adapter, amsdu_inbuf, pmbuf->pbuf, sizeof(RxPD));
 #if defined(SDK_OS_FREE_RTOS)
         net_stack_buffer_copy_partial(pmbuf->lwip_pbuf, amsdu_inbuf + pmbuf->data_offset, prx_pd->rx_pkt_length, 0);
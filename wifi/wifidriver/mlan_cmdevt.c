@@ -2026,7 +2026,7 @@ extern unsigned int wlan_fw_bin_len;
  *
  *  @return             MLAN_STATUS_SUCCESS
  */
-mlan_status wlan_download_vdll_block(mlan_adapter *pmadapter, t_u8 *block, t_u16 block_len)
+mlan_status wlan_download_vdll_block(mlan_adapter *pmadapter, const t_u8 *block, t_u16 block_len)
 {
     mlan_status status   = MLAN_STATUS_FAILURE;
     int ret              = -WM_FAIL;
@@ -2090,6 +2090,7 @@ static mlan_status wlan_get_vdll_image(pmlan_adapter pmadapter, t_u32 vdll_len)
         ctrl->vdll_mem = (t_u8 *)(pmadapter->fw_start_addr + (wlan_fw_bin_len - vdll_len));
         ctrl->vdll_len = vdll_len;
         ctrl->cmd_buf  = (t_u8 *)wifi_get_vdllcommand_buffer();
+        wifi_vdll_reset();
     }
     LEAVE();
     return MLAN_STATUS_SUCCESS;
@@ -2127,11 +2128,17 @@ mlan_status wlan_process_vdll_event(pmlan_private pmpriv, t_u8 *pevent)
             if (offset <= ctrl->vdll_len)
             {
                 block_len = MIN(block_len, ctrl->vdll_len - offset);
-                status    = wlan_download_vdll_block(pmadapter, ctrl->vdll_mem + offset, block_len);
+                status    = wlan_download_vdll_block(
+                    pmadapter, wifi_vdll_block(ctrl->vdll_mem, ctrl->vdll_len, offset, block_len), block_len);
                 if (status)
                 {
                     wevt_d("Fail to download VDLL block");
                 }
+                else
+                {
+                    /* firmware is busy with the block, read the next one from flash meanwhile */
+                    wifi_vdll_block_sent(ctrl->vdll_mem, ctrl->vdll_len);
+                }
                 if (pmadapter->vdll_in_progress == MFALSE)
                 {
                     (void)pmadapter->callbacks.moal_start_timer(pmadapter->pmoal_handle, pmadapter->vdll_timer, MFALSE,
@@ -2168,6 +2175,12 @@ mlan_status wlan_process_vdll_event(pmlan_private pmpriv, t_u8 *pevent)
             break;
         case VDLL_IND_TYPE_COMPLETE:
             wevt_d("VDLL_IND (ID COMPLETE).");
+            /* commands waiting for the download need not wait for the timer */
+            if (pmadapter->vdll_in_progress == MTRUE)
+            {
+                (void)pmadapter->callbacks.moal_stop_timer(pmadapter->pmoal_handle, pmadapter->vdll_timer);
+                pmadapter->vdll_in_progress = MFALSE;
+            }
             break;
 #elif defined(SD8978) || defined(SD8987) || defined(SD8997)
         case VDLL_IND_TYPE_INTF_RESET:
@@ -185,6 +185,14 @@ void wrapper_deliver_amsdu_subframe(pmlan_buffer amsdu_pmbuf, t_u8 *data, t_u16
 {
     RxPD *prx_pd = (RxPD *)(void *)amsdu_pmbuf->pbuf;
     w_pkt_d("[amsdu] [push]: BSS Type: %d L: %d", prx_pd->bss_type, pkt_len);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+    if (((amsdu_pmbuf->flags & MLAN_BUF_FLAG_AMSDU_REF) != 0U) && (wm_wifi.amsdu_ref_input_callback != NULL))
+    {
+        /* Subframe stays in the stack buffer of the A-MSDU */
+        wm_wifi.amsdu_ref_input_callback(prx_pd->bss_type, amsdu_pmbuf->lwip_pbuf, data, pkt_len);
+        return;
+    }
+#endif
     wm_wifi.amsdu_data_input_callback(prx_pd->bss_type, data, pkt_len);
 }
 
@@ -4840,7 +4848,7 @@ void wifi_handle_event_data_pause(void *data)
 
 static void wifi_handle_event_tx_status_report(Event_Ext_t *evt)
 {
-#if CONFIG_WPA_SUPP
+#if CONFIG_WPA_SUPP || (CONFIG_WIFI_LINK_QUALITY && CONFIG_WIFI_LQ_TX_STATUS_INTERVAL)
     tx_status_event *tx_status = MNULL;
     unsigned int bss_type      = (unsigned int)evt->bss_type;
 
@@ -4848,12 +4856,20 @@ static void wifi_handle_event_tx_status_report(Event_Ext_t *evt)
 
     if (tx_status->packet_type == 0xe5)
     {
+#if CONFIG_WPA_SUPP
         if (tx_status->status == 0U)
         {
             (void)wifi_event_completion(WIFI_EVENT_MGMT_TX_STATUS, WIFI_EVENT_REASON_SUCCESS, (void *)bss_type);
         }
+#else
+        (void)bss_type;
+#endif
         return;
     }
+#if CONFIG_WIFI_LINK_QUALITY && CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+    /* sampled data packet, see wifi_lq_tx_token() */
+    wifi_lq_tx_status(tx_status->tx_token_id, tx_status->status == 0U);
+#endif
 #endif
 }
 
@@ -7247,6 +7263,8 @@ int wifi_set_twt_setup_cfg(const wifi_twt_setup_config_t *twt_setup)
         if (wm_wifi.cmd_resp_status != WM_SUCCESS)
         {
             wifi_e("TWT setup error. State code=%d", twt_cfg.param.twt_setup.twt_setup_state);
+            /* Rejected by the AP or firmware, let the caller fall back */
+            ret = -WM_FAIL;
         }
         else
         {
@@ -7254,7 +7272,19 @@ int wifi_set_twt_setup_cfg(const wifi_twt_setup_config_t *twt_setup)
                          twt_cfg.param.twt_setup.flow_identifier);
         }
     }
-    return WM_SUCCESS;
+    return ret;
+}
+
+bool wifi_is_twt_supported(void)
+{
+    mlan_private *pmpriv = (mlan_private *)mlan_adap->priv[0];
+
+    if (pmpriv->media_connected != MTRUE)
+    {
+        return false;
+    }
+
+    return wlan_check_11ax_twt_supported(pmpriv, &pmpriv->curr_bss_params.bss_descriptor) == MTRUE;
 }
 
 int wifi_set_twt_teardown_cfg(const wifi_twt_teardown_config_t *teardown_config)
@@ -7401,6 +7431,7 @@ void wifi_wmm_tx_stats_dump(int bss_type)
     wifi_w("    tx_wmm_retried_drop[%hu]", priv->driver_error_cnt.tx_wmm_retried_drop);
     wifi_w("    tx_wmm_pause_drop[%hu]", priv->driver_error_cnt.tx_wmm_pause_drop);
     wifi_w("    tx_wmm_pause_replaced[%hu]", priv->driver_error_cnt.tx_wmm_pause_replaced);
+    wifi_w("    tx_flow_pause[%hu]", priv->driver_error_cnt.tx_flow_pause);
     wifi_w("    rx_reorder_drop[%hu]", priv->driver_error_cnt.rx_reorder_drop);
 
     int free_cnt_real   = 0;
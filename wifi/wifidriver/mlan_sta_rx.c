@@ -17,6 +17,8 @@ Change log:
 /* Additional WMSDK header files */
 #include <wmerrno.h>
 #include <osa.h>
+#include "lwip/opt.h"
+#include "lwip/def.h" /* PERF_START/PERF_STOP */
 
 /* Always keep this include at the end of all include files */
 #include <mlan_remap_mem_operations.h>
@@ -235,7 +237,25 @@ mlan_status wlan_ops_process_rx_packet(IN t_void *adapter, IN pmlan_buffer pmbuf
     {
         /* txbastream table also is used as connected STAs data base */
         ptx_tbl = wlan_11n_get_txbastream_tbl(priv, prx_pkt->eth803_hdr.src_addr);
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+        if (ptx_tbl != MNULL)
+        {
+            wlan_wmm_airtime_update_rate(priv, ptx_tbl, prx_pd);
+        }
+#endif
+#if CONFIG_WIFI_LINK_QUALITY
+        if (ptx_tbl != MNULL)
+        {
+            wifi_lq_rx(priv, prx_pkt->eth803_hdr.src_addr, prx_pd);
+        }
+#endif
     }
+#if CONFIG_WIFI_LINK_QUALITY
+    else if (priv->media_connected == MTRUE)
+    {
+        wifi_lq_rx(priv, priv->curr_bss_params.bss_descriptor.mac_address, prx_pd);
+    }
+#endif
 
     /*
      * If 11n isn't enabled, or if the packet is not an unicast packet for STA case,
@@ -269,9 +289,13 @@ mlan_status wlan_ops_process_rx_packet(IN t_void *adapter, IN pmlan_buffer pmbuf
     }
 
     /* Reorder and send to OS */
-    if ((ret = mlan_11n_rxreorder_pkt(priv, prx_pd->seq_num, prx_pd->priority, ta, (t_u8)prx_pd->rx_pkt_type,
-                                      (void *)pmbuf)) ||
-        (rx_pkt_type == PKT_TYPE_BAR))
+    {
+        PERF_START;
+        ret = mlan_11n_rxreorder_pkt(priv, prx_pd->seq_num, prx_pd->priority, ta, (t_u8)prx_pd->rx_pkt_type,
+                                     (void *)pmbuf);
+        PERF_STOP("mlan_rxreorder");
+    }
+    if ((ret != MLAN_STATUS_SUCCESS) || (rx_pkt_type == PKT_TYPE_BAR))
     {
         wlan_free_mlan_buffer(pmadapter, pmbuf);
     }
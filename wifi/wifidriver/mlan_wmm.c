@@ -21,6 +21,11 @@ Change log:
 #if CONFIG_TX_RX_ZERO_COPY
 #include <wm_net.h>
 #endif
+#if CONFIG_TX_FLOW_CONTROL
+#include <mlan_tx_flow.h>
+#endif
+#include "lwip/opt.h"
+#include "lwip/def.h" /* PERF_START/PERF_STOP */
 /* Always keep this include at the end of all include files */
 #include <mlan_remap_mem_operations.h>
 /********************************************************
@@ -755,7 +760,11 @@ int wlan_wmm_add_buf_txqueue_enh(const uint8_t interface, const uint8_t *buffer,
 #endif
     mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[pkt_prio].ra_list.plock);
 
-    ralist = wlan_wmm_get_queue_raptr_enh(priv, pkt_prio, ra);
+    {
+        PERF_START;
+        ralist = wlan_wmm_get_queue_raptr_enh(priv, pkt_prio, ra);
+        PERF_STOP("mlan_ralist_lookup");
+    }
     if (ralist == MNULL)
     {
         /* drop for unknown ra when enqueue */
@@ -858,6 +867,186 @@ void wifi_wmm_buf_pool_deinit(void)
     __memset(mlan_adap, &mlan_adap->outbuf_pool, 0x00, sizeof(outbuf_pool_t));
 }
 
+#if CONFIG_TX_FLOW_CONTROL
+#if (CONFIG_TX_FLOW_LOW_WM >= CONFIG_TX_FLOW_HIGH_WM) || (CONFIG_TX_FLOW_HIGH_WM > MAX_WMM_BUF_NUM)
+#error "CONFIG_TX_FLOW_LOW_WM must be below CONFIG_TX_FLOW_HIGH_WM, which must not exceed MAX_WMM_BUF_NUM"
+#endif
+
+/*
+ *  tx_flow_paused[] is set from the netif output (tcpip_thread) and cleared
+ *  from there or from the tx task, it is changed inside the wmm tid_tbl_ptr
+ *  ra_list lock of the ac, which also guards pkts_queued of the ac
+ */
+
+static t_u8 wifi_wmm_tx_flow_can_resume(mlan_private *priv, t_u8 queue)
+{
+    return wlan_tx_flow_can_resume(priv->wmm.pkts_queued[queue], mlan_adap->outbuf_pool.free_cnt,
+                                   CONFIG_TX_FLOW_LOW_WM) ?
+               MTRUE :
+               MFALSE;
+}
+
+/* should be called inside wmm tid_tbl_ptr ra_list lock */
+static void wifi_wmm_tx_flow_pause_locked(mlan_private *priv, t_u8 queue)
+{
+    if (priv->wmm.tx_flow_paused[queue] == MFALSE)
+    {
+        priv->wmm.tx_flow_paused[queue] = MTRUE;
+        priv->driver_error_cnt.tx_flow_pause++;
+    }
+}
+
+/*
+ *  tx flow control check before taking a buffer for ac queue,
+ *  pause the ac when its queue reached the high watermark,
+ *  a paused ac is resumed here as well if the tx task resume was missed
+ */
+bool wifi_wmm_tx_flow_paused(const uint8_t interface, mlan_wmm_ac_e queue)
+{
+    mlan_private *priv = MNULL;
+    bool paused        = false;
+
+    CHECK_BSS_TYPE(interface, false);
+    priv = mlan_adap->priv[interface];
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[queue].ra_list.plock);
+
+    if (priv->wmm.tx_flow_paused[queue] == MTRUE)
+    {
+        if (wifi_wmm_tx_flow_can_resume(priv, queue) == MFALSE)
+            paused = true;
+        else
+            priv->wmm.tx_flow_paused[queue] = MFALSE;
+    }
+
+    if (paused == false && wlan_tx_flow_need_pause(priv->wmm.pkts_queued[queue], CONFIG_TX_FLOW_HIGH_WM))
+    {
+        wifi_wmm_tx_flow_pause_locked(priv, queue);
+        paused = true;
+    }
+
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[queue].ra_list.plock);
+
+    return paused;
+}
+
+/* pause ac queue, no free buffer for it */
+void wifi_wmm_tx_flow_pause(const uint8_t interface, mlan_wmm_ac_e queue)
+{
+    mlan_private *priv = MNULL;
+
+    CHECK_BSS_TYPE_RET_VOID(interface);
+    priv = mlan_adap->priv[interface];
+
+    mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[queue].ra_list.plock);
+    wifi_wmm_tx_flow_pause_locked(priv, queue);
+    mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[queue].ra_list.plock);
+}
+
+/*
+ *  resume paused ac queues which are drained to low watermark,
+ *  called by tx task after dequeue, return true if any ac is resumed
+ */
+bool wifi_wmm_tx_flow_resume(const uint8_t interface)
+{
+    mlan_private *priv = MNULL;
+    bool resumed       = false;
+    t_u8 i;
+
+    CHECK_BSS_TYPE(interface, false);
+    priv = mlan_adap->priv[interface];
+
+    for (i = 0; i < MAX_AC_QUEUES; i++)
+    {
+        /* unlocked peek, most passes of the tx task find nothing paused */
+        if (priv->wmm.tx_flow_paused[i] == MFALSE)
+            continue;
+
+        mlan_adap->callbacks.moal_semaphore_get(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[i].ra_list.plock);
+        if (priv->wmm.tx_flow_paused[i] == MTRUE && wifi_wmm_tx_flow_can_resume(priv, i) == MTRUE)
+        {
+            priv->wmm.tx_flow_paused[i] = MFALSE;
+            resumed                     = true;
+        }
+        mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &priv->wmm.tid_tbl_ptr[i].ra_list.plock);
+    }
+
+    return resumed;
+}
+#endif
+
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+/* per packet overhead of a transmission (preamble, ack), amortized over an aggregate */
+#define WMM_AIRTIME_OVERHEAD_US 20U
+/* rate for stations not heard yet and broadcast, 6 Mbps in 500 kbps units */
+#define WMM_AIRTIME_DEFAULT_RATE 12U
+
+/* remember the rate a station is received at, as estimate of its tx rate */
+void wlan_wmm_airtime_update_rate(mlan_private *priv, TxBAStreamTbl *ptx_tbl, const RxPD *prx_pd)
+{
+#ifdef SD8801
+    t_u8 rate_info = prx_pd->ht_info;
+#else
+    t_u8 rate_info = prx_pd->rate_info;
+#endif
+
+    if ((ptx_tbl->airtime_rate != 0U) && (ptx_tbl->rx_rate == prx_pd->rx_rate) && (ptx_tbl->rx_rate_info == rate_info))
+        return;
+
+    ptx_tbl->rx_rate      = prx_pd->rx_rate;
+    ptx_tbl->rx_rate_info = rate_info;
+    ptx_tbl->airtime_rate = (t_u16)wlan_index_to_data_rate(priv->adapter, prx_pd->rx_rate, rate_info
+#if CONFIG_11AX
+                                                           ,
+                                                           0
+#endif
+    );
+}
+
+/* estimated airtime of len bytes to the station of ra_list */
+t_u32 wlan_wmm_airtime_us(mlan_private *priv, raListTbl *ra_list, t_u32 len)
+{
+    TxBAStreamTbl *ptx_tbl = wlan_11n_get_txbastream_tbl(priv, ra_list->ra);
+    t_u32 rate             = WMM_AIRTIME_DEFAULT_RATE;
+
+    if ((ptx_tbl != MNULL) && (ptx_tbl->airtime_rate != 0U))
+        rate = ptx_tbl->airtime_rate;
+
+    /* 500 kbps units: 16 us per byte at rate 1 */
+    return WMM_AIRTIME_OVERHEAD_US + (len * 16U) / rate;
+}
+
+/*
+ *  start a new deficit round robin round in ac queue,
+ *  credit every backlogged station, idle stations don't keep credit,
+ *  return MTRUE if a backlogged station can be served
+ *  should be called inside wmm tid_tbl_ptr ra_list lock
+ */
+t_u8 wlan_wmm_airtime_refill(mlan_private *priv, t_u8 ac)
+{
+    raListTbl *ra_list_head = (raListTbl *)&priv->wmm.tid_tbl_ptr[ac].ra_list;
+    raListTbl *ra_list      = ra_list_head->pnext;
+    t_u8 backlogged         = MFALSE;
+
+    while (ra_list && ra_list != ra_list_head)
+    {
+        if (ra_list->total_pkts == 0)
+        {
+            if (ra_list->airtime_deficit > 0)
+                ra_list->airtime_deficit = 0;
+        }
+        else if (ra_list->tx_pause == MFALSE)
+        {
+            ra_list->airtime_deficit += CONFIG_WMM_AIRTIME_QUANTUM_US;
+            backlogged = MTRUE;
+        }
+        ra_list = ra_list->pnext;
+    }
+
+    return backlogged;
+}
+#endif
+
 /* wmm enhance ralist operation */
 /* should be called inside wmm tid_tbl_ptr ra_list lock */
 void wlan_ralist_pkts_free_enh(mlan_private *priv, raListTbl *ra_list, t_u8 ac)
@@ -929,6 +1118,9 @@ static raListTbl *wlan_ralist_alloc_enh(pmlan_adapter pmadapter, t_u8 *ra)
     ra_list->total_pkts = 0;
     ra_list->tx_pause   = 0;
     ra_list->drop_count = 0;
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+    ra_list->airtime_deficit = 0;
+#endif
 
     wifi_d("RAList: Allocating buffers for TID %p\n", ra_list);
 
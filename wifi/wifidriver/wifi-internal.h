@@ -100,6 +100,12 @@ typedef struct
     void *(*wifi_get_rxbuf_desc)(t_u16 rx_len);
 #endif
     void (*amsdu_data_input_callback)(uint8_t interface, uint8_t *buffer, uint16_t len);
+#if CONFIG_AMSDU_RX_ZERO_COPY
+    void (*amsdu_ref_input_callback)(uint8_t interface, void *stack_buffer, uint8_t *buffer, uint16_t len);
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+    void (*tx_resume_callback)(uint8_t interface);
+#endif
     void (*deliver_packet_above_callback)(void *rxpd, t_u8 interface, t_void *lwip_pbuf);
     bool (*wrapper_net_is_ip_or_ipv6_callback)(const t_u8 *buffer);
 #ifdef SD9177
@@ -285,6 +291,16 @@ typedef MLAN_PACK_START struct _nxp_wifi_acl_info
  */
 int wifi_handle_fw_event(struct bus_message *msg);
 
+#if CONFIG_WIFI_LINK_QUALITY
+/* link quality estimator feed, wifi_lq.c */
+void wifi_lq_rx(mlan_private *priv, const t_u8 *mac, const RxPD *prx_pd);
+#if CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+/* token to request the TX status of a packet to mac with, 0 for none */
+t_u8 wifi_lq_tx_token(mlan_private *priv, const t_u8 *mac);
+void wifi_lq_tx_status(t_u8 token, bool success);
+#endif
+#endif
+
 /**
  * This function is used to send events to the upper layer through the
  * message queue registered by the upper layer.
@@ -312,6 +328,19 @@ int wifi_wait_for_cmdresp(void *cmd_resp_priv);
  * Waits for Command processing to complete and waits for command response for VDLL
  */
 int wifi_wait_for_vdllcmdresp(void *cmd_resp_priv);
+
+/* VDLL block cache, wifi_vdll.c */
+void wifi_vdll_init(void);
+/* firmware image changed */
+void wifi_vdll_reset(void);
+/* block the firmware requests, from the cache when possible */
+const t_u8 *wifi_vdll_block(const t_u8 *image, t_u32 image_len, t_u32 offset, t_u16 len);
+/* block downloaded, prefetch the one which usually follows */
+void wifi_vdll_block_sent(const t_u8 *image, t_u32 image_len);
+/* command about to be sent, prefetch the block it usually needs */
+void wifi_vdll_command(t_u16 command, const t_u8 *image, t_u32 image_len);
+/* a command waited for a VDLL download to complete */
+void wifi_vdll_stall(t_u32 stall_ms);
 #endif
 /**
  * Register an event queue
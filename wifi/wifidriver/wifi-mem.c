@@ -29,7 +29,55 @@ void *wifi_mem_malloc_cmdrespbuf(void)
     return buffhuge;
 }
 
-void *wifi_malloc_eventbuf(size_t size)
+#if CONFIG_EVENTBUF_SMALL_NUM > 32
+#error "CONFIG_EVENTBUF_SMALL_NUM is limited to 32"
+#endif
+
+#if CONFIG_EVENTBUF_SMALL_NUM
+/* Small event buffers, t_u32 for alignment */
+static t_u32 eventbuf_small[CONFIG_EVENTBUF_SMALL_NUM][(CONFIG_EVENTBUF_SMALL_SIZE + 3) / 4];
+static t_u32 eventbuf_small_used; /* bit per buffer */
+#endif
+static wifi_eventbuf_stats_t eventbuf_stats;
+
+#if CONFIG_EVENTBUF_SMALL_NUM
+static void *wifi_malloc_eventbuf_small(void)
+{
+    void *ptr = NULL;
+    int i;
+
+    for (i = 0; i < CONFIG_EVENTBUF_SMALL_NUM; i++)
+    {
+        if ((eventbuf_small_used & (1U << i)) == 0U)
+        {
+            eventbuf_small_used |= (1U << i);
+            ptr = eventbuf_small[i];
+            break;
+        }
+    }
+
+    return ptr;
+}
+
+static bool wifi_free_eventbuf_small(void *buffer)
+{
+    t_u8 *p     = (t_u8 *)buffer;
+    t_u8 *first = (t_u8 *)eventbuf_small;
+    int i;
+
+    if ((p < first) || (p >= first + sizeof(eventbuf_small)))
+    {
+        return false;
+    }
+
+    i = (int)((size_t)(p - first) / sizeof(eventbuf_small[0]));
+    eventbuf_small_used &= ~(1U << i);
+
+    return true;
+}
+#endif
+
+static void *wifi_malloc_eventbuf_large(size_t size)
 {
 #if !CONFIG_MEM_POOLS
     void *ptr = OSA_MemoryAllocate(size);
@@ -49,14 +97,95 @@ void *wifi_malloc_eventbuf(size_t size)
     return ptr;
 }
 
+void *wifi_malloc_eventbuf(size_t size)
+{
+    void *ptr = NULL;
+    OSA_SR_ALLOC();
+
+#if CONFIG_EVENTBUF_SMALL_NUM
+    if (size <= CONFIG_EVENTBUF_SMALL_SIZE)
+    {
+        OSA_ENTER_CRITICAL();
+        ptr = wifi_malloc_eventbuf_small();
+        if (ptr != NULL)
+        {
+            eventbuf_stats.small_in_use++;
+            if (eventbuf_stats.small_in_use > eventbuf_stats.small_peak)
+            {
+                eventbuf_stats.small_peak = eventbuf_stats.small_in_use;
+            }
+        }
+        else
+        {
+            eventbuf_stats.small_overflow++;
+        }
+        OSA_EXIT_CRITICAL();
+    }
+#endif
+
+    if (ptr == NULL)
+    {
+        ptr = wifi_malloc_eventbuf_large(size);
+        OSA_ENTER_CRITICAL();
+        if (ptr != NULL)
+        {
+            eventbuf_stats.large_in_use++;
+            if (eventbuf_stats.large_in_use > eventbuf_stats.large_peak)
+            {
+                eventbuf_stats.large_peak = eventbuf_stats.large_in_use;
+            }
+        }
+        else
+        {
+            eventbuf_stats.alloc_fail++;
+        }
+        OSA_EXIT_CRITICAL();
+    }
+
+    OSA_ENTER_CRITICAL();
+    if (size > eventbuf_stats.max_size)
+    {
+        eventbuf_stats.max_size = (t_u32)size;
+    }
+    OSA_EXIT_CRITICAL();
+
+    return ptr;
+}
+
 void wifi_free_eventbuf(void *buffer)
 {
+    OSA_SR_ALLOC();
+
+#if CONFIG_EVENTBUF_SMALL_NUM
+    OSA_ENTER_CRITICAL();
+    if (wifi_free_eventbuf_small(buffer))
+    {
+        eventbuf_stats.small_in_use--;
+        OSA_EXIT_CRITICAL();
+        return;
+    }
+    OSA_EXIT_CRITICAL();
+#endif
+
 #if !CONFIG_MEM_POOLS
     w_mem_d("[evtbuf] Free: A: %p\n\r", buffer);
     OSA_MemoryFree(buffer);
 #else
     OSA_MemoryPoolFree(buf_2560_MemoryPool, buffer);
 #endif
+
+    OSA_ENTER_CRITICAL();
+    eventbuf_stats.large_in_use--;
+    OSA_EXIT_CRITICAL();
+}
+
+void wifi_get_eventbuf_stats(wifi_eventbuf_stats_t *stats)
+{
+    OSA_SR_ALLOC();
+
+    OSA_ENTER_CRITICAL();
+    *stats = eventbuf_stats;
+    OSA_EXIT_CRITICAL();
 }
 
 mlan_status wrapper_moal_malloc(IN t_void *pmoal_handle, IN t_u32 size, IN t_u32 flag, OUT t_u8 **ppbuf)
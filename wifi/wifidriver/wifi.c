@@ -1236,10 +1236,17 @@ start:
 #endif
 
 #if CONFIG_FW_VDLL
-    while (pmadapter->vdll_in_progress == MTRUE)
+    if (pmadapter->vdll_in_progress == MTRUE)
     {
-        OSA_TimeDelay(50);
+        t_u32 stall_start = OSA_TimeGetMsec();
+
+        while (pmadapter->vdll_in_progress == MTRUE)
+        {
+            OSA_TimeDelay(5);
+        }
+        wifi_vdll_stall(OSA_TimeGetMsec() - stall_start);
     }
+    wifi_vdll_command(cmd->command, pmadapter->vdll_ctrl.vdll_mem, pmadapter->vdll_ctrl.vdll_len);
 #endif
 
     if (cmd->size > WIFI_FW_CMDBUF_SIZE)
@@ -2253,6 +2260,7 @@ static int wifi_core_init(void)
 #if CONFIG_FW_VDLL
     (void)mlan_adap->callbacks.moal_init_timer(mlan_adap->pmoal_handle, &mlan_adap->vdll_timer, wlan_vdll_complete,
                                                NULL);
+    wifi_vdll_init();
 #endif
 
     wm_wifi.wifi_core_init_done = 1;
@@ -2844,6 +2852,47 @@ void wifi_deregister_amsdu_data_input_callback(void)
     wm_wifi.amsdu_data_input_callback = NULL;
 }
 
+#if CONFIG_AMSDU_RX_ZERO_COPY
+int wifi_register_amsdu_ref_input_callback(void (*amsdu_ref_input_callback)(uint8_t interface,
+                                                                            void *stack_buffer,
+                                                                            uint8_t *buffer,
+                                                                            uint16_t len))
+{
+    if (wm_wifi.amsdu_ref_input_callback != NULL)
+    {
+        return -WM_FAIL;
+    }
+
+    wm_wifi.amsdu_ref_input_callback = amsdu_ref_input_callback;
+
+    return WM_SUCCESS;
+}
+
+void wifi_deregister_amsdu_ref_input_callback(void)
+{
+    wm_wifi.amsdu_ref_input_callback = NULL;
+}
+#endif
+
+#if CONFIG_TX_FLOW_CONTROL
+int wifi_register_tx_resume_callback(void (*tx_resume_callback)(uint8_t interface))
+{
+    if (wm_wifi.tx_resume_callback != NULL)
+    {
+        return -WM_FAIL;
+    }
+
+    wm_wifi.tx_resume_callback = tx_resume_callback;
+
+    return WM_SUCCESS;
+}
+
+void wifi_deregister_tx_resume_callback(void)
+{
+    wm_wifi.tx_resume_callback = NULL;
+}
+#endif
+
 int wifi_register_deliver_packet_above_callback(void (*deliver_packet_above_callback)(void *rxpd,
                                                                                       uint8_t interface,
                                                                                       void *lwip_pbuf))
@@ -3592,6 +3641,29 @@ void wifi_tx_card_awake_unlock(void)
 #define WMM_PACKET_TOS_IPV6_02   0xf
 #define TOS_MASK_IPV6            0x0ff0 /* 0000111111110000 */
 
+#if CONFIG_WMM_CLASSIFIER
+#define WMM_PACKET_IP_HDR    0xe
+#define IPV4_HDR_LEN         20
+#define IPV4_PROTO_POS       9
+#define IPV4_FRAG_POS        6
+#define IPV4_FRAG_OFFSET_MSK 0x1fff
+#define IPV6_HDR_LEN         40
+#define IPV6_NEXT_HDR_POS    6
+#define WMM_IPPROTO_TCP      6
+#define WMM_IPPROTO_UDP      17
+
+/* default rules: expedited forwarding and DHCP on voice, DNS on video */
+static wifi_wmm_class_rule_t wmm_class_rules[CONFIG_WMM_CLASS_RULES_MAX] = {
+    {46, 0, 0, WMM_AC_VO},
+    {WIFI_WMM_DSCP_ANY, WMM_IPPROTO_UDP, 67, WMM_AC_VO},
+    {WIFI_WMM_DSCP_ANY, WMM_IPPROTO_UDP, 53, WMM_AC_VI},
+};
+static t_u8 wmm_class_rule_cnt = 3;
+
+/* TID used for the access category given by a classifier rule */
+static const t_u8 wmm_ac_to_tid[MAX_AC_QUEUES] = {1, 0, 5, 6};
+#endif
+
 void wifi_wmm_init()
 {
     mlan_private *pmpriv    = (mlan_private *)mlan_adap->priv[0];
@@ -3606,13 +3678,131 @@ void wifi_wmm_init()
     }
 }
 
+#if CONFIG_WMM_CLASSIFIER
+int wifi_wmm_set_class_rules(const wifi_wmm_class_rule_t *rules, uint8_t count)
+{
+    t_u8 i;
+
+    OSA_SR_ALLOC();
+
+    if ((count > CONFIG_WMM_CLASS_RULES_MAX) || ((count != 0U) && (rules == NULL)))
+    {
+        return -WM_E_INVAL;
+    }
+
+    for (i = 0; i < count; i++)
+    {
+        if ((rules[i].ac > WMM_AC_VO) || ((rules[i].dscp > 63U) && (rules[i].dscp != WIFI_WMM_DSCP_ANY)))
+        {
+            return -WM_E_INVAL;
+        }
+    }
+
+    /* classification runs in the network stack context */
+    OSA_ENTER_CRITICAL();
+    (void)memcpy(wmm_class_rules, rules, count * sizeof(wifi_wmm_class_rule_t));
+    wmm_class_rule_cnt = count;
+    OSA_EXIT_CRITICAL();
+
+    return WM_SUCCESS;
+}
+
+uint8_t wifi_wmm_get_class_rules(wifi_wmm_class_rule_t *rules, uint8_t max)
+{
+    t_u8 count;
+
+    OSA_SR_ALLOC();
+
+    if (rules == NULL)
+    {
+        return 0;
+    }
+
+    OSA_ENTER_CRITICAL();
+    count = MIN(wmm_class_rule_cnt, max);
+    (void)memcpy(rules, wmm_class_rules, count * sizeof(wifi_wmm_class_rule_t));
+    OSA_EXIT_CRITICAL();
+
+    return count;
+}
+
+/* access category of the first matching classifier rule, -1 if none */
+static int wifi_wmm_classify(void *buf, t_u8 dscp, bool ipv6)
+{
+    t_u8 hdr[IPV4_HDR_LEN];
+    t_u8 proto     = 0;
+    t_u16 l4_pos   = 0;
+    t_u16 src_port = 0;
+    t_u16 dst_port = 0;
+    int ac         = -1;
+    t_u8 i;
+
+    OSA_SR_ALLOC();
+
+    if (wmm_class_rule_cnt == 0U)
+    {
+        return -1;
+    }
+
+    if (ipv6)
+    {
+        if (net_stack_buffer_copy_partial(buf, hdr, IPV6_NEXT_HDR_POS + 1, WMM_PACKET_IP_HDR) ==
+            IPV6_NEXT_HDR_POS + 1)
+        {
+            /* extension headers are not followed */
+            proto  = hdr[IPV6_NEXT_HDR_POS];
+            l4_pos = WMM_PACKET_IP_HDR + IPV6_HDR_LEN;
+        }
+    }
+    else if (net_stack_buffer_copy_partial(buf, hdr, IPV4_HDR_LEN, WMM_PACKET_IP_HDR) == IPV4_HDR_LEN)
+    {
+        proto = hdr[IPV4_PROTO_POS];
+        /* only the first fragment holds the ports */
+        if (((((t_u16)hdr[IPV4_FRAG_POS] << 8) | hdr[IPV4_FRAG_POS + 1]) & IPV4_FRAG_OFFSET_MSK) == 0U)
+        {
+            l4_pos = WMM_PACKET_IP_HDR + (t_u16)((hdr[0] & 0xfU) * 4U);
+        }
+    }
+
+    if ((l4_pos != 0U) && ((proto == WMM_IPPROTO_TCP) || (proto == WMM_IPPROTO_UDP)) &&
+        (net_stack_buffer_copy_partial(buf, hdr, 4, l4_pos) == 4))
+    {
+        src_port = ((t_u16)hdr[0] << 8) | hdr[1];
+        dst_port = ((t_u16)hdr[2] << 8) | hdr[3];
+    }
+
+    OSA_ENTER_CRITICAL();
+    for (i = 0; i < wmm_class_rule_cnt; i++)
+    {
+        const wifi_wmm_class_rule_t *rule = &wmm_class_rules[i];
+
+        if (((rule->dscp == WIFI_WMM_DSCP_ANY) || (rule->dscp == dscp)) &&
+            ((rule->proto == 0U) || (rule->proto == proto)) &&
+            ((rule->port == 0U) || (rule->port == src_port) || (rule->port == dst_port)))
+        {
+            ac = rule->ac;
+            break;
+        }
+    }
+    OSA_EXIT_CRITICAL();
+
+    return ac;
+}
+#endif
+
 /* Packet priority is 16th byte of payload.
  * Provided that the packet is IPV4 type
  * Since value comes between the range of 0-255, coversion is expected between 0-7 to map to TIDs.
+ * With CONFIG_WMM_CLASSIFIER the classifier rules take precedence.
  * */
 t_u32 wifi_wmm_get_pkt_prio(void *buf, t_u8 *tid)
 {
     bool ip_hdr = 0;
+#if CONFIG_WMM_CLASSIFIER
+    bool ipv6 = false;
+    t_u8 dscp = 0;
+    int ac;
+#endif
 
     if (buf == NULL)
         return -WM_FAIL;
@@ -3623,6 +3813,9 @@ t_u32 wifi_wmm_get_pkt_prio(void *buf, t_u8 *tid)
         t_u8 *id = net_stack_buffer_skip(buf, WMM_PACKET_TOS_IV4);
         *tid     = *id / PRIORITY_COMPENSATOR;
         ip_hdr   = 1;
+#if CONFIG_WMM_CLASSIFIER
+        dscp = *id >> 2;
+#endif
     }
     else if (*type_01 == ETHER_TYPE_IPV6_VALUE_01 && *type_02 == ETHER_TYPE_IPV6_VALUE_02)
     {
@@ -3631,9 +3824,21 @@ t_u32 wifi_wmm_get_pkt_prio(void *buf, t_u8 *tid)
         t_u16 ipv6_tos = (*tos1 << 8) | (*tos2);
         *tid           = (t_u8)(((ipv6_tos & TOS_MASK_IPV6) >> 4) / PRIORITY_COMPENSATOR);
         ip_hdr         = 1;
+#if CONFIG_WMM_CLASSIFIER
+        dscp = (t_u8)((ipv6_tos & TOS_MASK_IPV6) >> 6);
+        ipv6 = true;
+#endif
     }
     if (ip_hdr)
     {
+#if CONFIG_WMM_CLASSIFIER
+        ac = wifi_wmm_classify(buf, dscp, ipv6);
+        if (ac >= 0)
+        {
+            *tid = wmm_ac_to_tid[ac];
+            return (t_u32)ac;
+        }
+#endif
         switch (*tid)
         {
             case 0:
@@ -3670,7 +3875,7 @@ t_u32 g_wifi_xmit_schedule_end = 0;
 
 #if CONFIG_AMSDU_IN_AMPDU
 /* aggregate one amsdu packet and xmit */
-static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist)
+static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist, t_u32 *tx_len)
 {
     outbuf_t *buf                = MNULL;
     t_u32 max_amsdu_size         = MIN(priv->max_amsdu, priv->adapter->tx_buffer_size);
@@ -3739,6 +3944,7 @@ static mlan_status wifi_xmit_amsdu_pkts(mlan_private *priv, t_u8 ac, raListTbl *
          */
         if (amsdu_buf_available_size < 0 || ralist->total_pkts == 0)
         {
+            *tx_len = amsdu_offset - last_pad_len - sizeof(TxPD) - INTF_HEADER_LEN;
             return wlan_xmit_wmm_amsdu_pkt((mlan_wmm_ac_e)ac, priv->bss_index, amsdu_offset - last_pad_len,
                                            wifi_get_amsdu_outbuf(0), amsdu_cnt);
         }
@@ -3766,7 +3972,7 @@ static inline t_u8 wifi_is_max_tx_cnt(t_u8 pkt_cnt)
 }
 
 /* dequeue and xmit one packet */
-static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist)
+static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist, t_u32 *tx_len)
 {
     mlan_status ret;
     outbuf_t *buf = MNULL;
@@ -3777,6 +3983,14 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
     mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &ralist->buf_head.plock);
     ASSERT(buf != MNULL);
 
+#if CONFIG_WIFI_LINK_QUALITY && CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+    buf->tx_pd.tx_token_id = wifi_lq_tx_token(priv, ralist->ra);
+    if (buf->tx_pd.tx_token_id != 0U)
+    {
+        buf->tx_pd.flags |= MRVDRV_TxPD_FLAGS_TX_PACKET_STATUS;
+    }
+#endif
+
     /* TODO: this may go wrong for TxPD->tx_pkt_type 0xe5 */
     /* this will get card port lock and probably sleep */
 #if CONFIG_TX_RX_ZERO_COPY
@@ -3798,14 +4012,24 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
 #endif
     }
 
+    *tx_len = buf->tx_pd.tx_pkt_length;
     wifi_wmm_buf_put(buf);
     priv->wmm.pkts_queued[ac]--;
 
     return MLAN_STATUS_SUCCESS;
 }
 
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+/* uAP stations share the airtime, a station connection has a single RA */
+static inline t_u8 wifi_wmm_airtime_enabled(mlan_private *priv)
+{
+    return (GET_BSS_ROLE(priv) == MLAN_BSS_ROLE_UAP) ? MTRUE : MFALSE;
+}
+#endif
+
 /*
- *  xmit all buffers under this ralist
+ *  xmit all buffers under this ralist,
+ *  with airtime fairness only as long as the ralist has airtime credit
  *  should be called inside wmm tid_tbl_ptr ra_list lock,
  *  return MLAN_STATUS_SUCESS to continue looping ralists,
  *  return MLAN_STATUS_RESOURCE to break looping ralists
@@ -3813,6 +4037,10 @@ static mlan_status wifi_xmit_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist
 static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl *ralist, t_u8 *pkt_cnt)
 {
     mlan_status ret;
+    t_u32 tx_len = 0;
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+    t_u8 airtime = wifi_wmm_airtime_enabled(priv);
+#endif
 
     if (ralist->tx_pause == MTRUE)
     {
@@ -3821,25 +4049,40 @@ static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl
 
     while (ralist->total_pkts > 0)
     {
-        if ((wifi_txbuf_available() == MFALSE) || (WIFI_DATA_RUNNING != wifi_tx_status))
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+        if (airtime == MTRUE && ralist->airtime_deficit <= 0)
         {
             break;
         }
+#endif
+        if ((wifi_txbuf_available() == MFALSE) || (WIFI_DATA_RUNNING != wifi_tx_status))
+        {
+            return MLAN_STATUS_RESOURCE;
+        }
 
 #if CONFIG_AMSDU_IN_AMPDU
         if (wlan_is_amsdu_allowed(priv, priv->bss_index, ralist->total_pkts, ac))
         {
-            ret = wifi_xmit_amsdu_pkts(priv, ac, ralist);
+            ret = wifi_xmit_amsdu_pkts(priv, ac, ralist, &tx_len);
         }
         else
 #endif
-            ret = wifi_xmit_pkts(priv, ac, ralist);
+            ret = wifi_xmit_pkts(priv, ac, ralist, &tx_len);
 
         if (ret != MLAN_STATUS_SUCCESS)
         {
             return ret;
         }
 
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+        if (airtime == MTRUE)
+        {
+            ralist->airtime_deficit -= (t_s32)wlan_wmm_airtime_us(priv, ralist, tx_len);
+        }
+#else
+        (void)tx_len;
+#endif
+
         /*
          * in amsdu case,
          * multiple packets aggregated as one amsdu packet, are counted as one imu packet
@@ -3858,7 +4101,8 @@ static mlan_status wifi_xmit_ralist_pkts(mlan_private *priv, t_u8 ac, raListTbl
  *  dequeue and xmit all buffers under ac queue
  *  loop each ac queue
  *  loop each ralist
- *  dequeue all buffers from buf_head list and xmit
+ *  dequeue all buffers from buf_head list and xmit,
+ *  with airtime fairness loop ralists in rounds until the ac queue is served
  */
 static int wifi_xmit_wmm_ac_pkts_enh(mlan_private *priv)
 {
@@ -3896,6 +4140,14 @@ static int wifi_xmit_wmm_ac_pkts_enh(mlan_private *priv)
                 goto RET;
             }
             ralist = ralist->pnext;
+#if CONFIG_WMM_AIRTIME_FAIRNESS
+            if ((ralist == (raListTbl *)&tid_ptr->ra_list) && (wifi_wmm_airtime_enabled(priv) == MTRUE) &&
+                (priv->wmm.pkts_queued[ac] != 0) && (wlan_wmm_airtime_refill(priv, ac) == MTRUE))
+            {
+                /* next round, stations out of credit have been credited */
+                ralist = ralist->pnext;
+            }
+#endif
         }
         mlan_adap->callbacks.moal_semaphore_put(mlan_adap->pmoal_handle, &tid_ptr->ra_list.plock);
     }
@@ -4051,6 +4303,22 @@ int send_wifi_driver_bypass_data_event(t_u8 interface)
     return 0;
 }
 
+#if CONFIG_TX_FLOW_CONTROL
+/* let the stack send again on ac queues drained to the low watermark */
+static void wifi_tx_flow_resume(void)
+{
+    t_u8 i;
+
+    for (i = 0; i < MLAN_MAX_BSS_NUM; i++)
+    {
+        if (wifi_wmm_tx_flow_resume(i) && (wm_wifi.tx_resume_callback != NULL))
+        {
+            wm_wifi.tx_resume_callback(i);
+        }
+    }
+}
+#endif
+
 static void wifi_drv_tx_task(osa_task_param_t arg)
 {
     mlan_private *pmpriv    = (mlan_private *)mlan_adap->priv[0];
@@ -4219,6 +4487,9 @@ static void wifi_drv_tx_task(osa_task_param_t arg)
                     wifi_tx_card_awake_unlock();
                 }
             }
+#endif
+#if CONFIG_TX_FLOW_CONTROL
+            wifi_tx_flow_resume();
 #endif
         }
 #if CONFIG_HOST_SLEEP
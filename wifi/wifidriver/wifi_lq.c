@@ -0,0 +1,260 @@
+/** @file wifi_lq.c
+ *
+ *  @brief This file provides the host side link quality estimator.
+ *
+ *  RSSI and data rate are taken from every received data packet, transmit
+ *  loss from the firmware TX status of one data packet out of
+ *  CONFIG_WIFI_LQ_TX_STATUS_INTERVAL sent to the peer. All of them are
+ *  smoothed per peer, the expected throughput derives from them.
+ *
+ *  SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <mlan_api.h>
+
+#include <wmerrno.h>
+#include <osa.h>
+#include <wifi.h>
+
+#include "wifi-internal.h"
+
+#if CONFIG_WIFI_LINK_QUALITY
+
+/* Loss in 1/256 units */
+#define LQ_LOSS_ONE 256U
+
+typedef struct
+{
+    t_u8 in_use;
+    t_u8 bss_type;
+    t_u8 mac[MLAN_MAC_ADDR_LENGTH];
+    /* last RX rate index and info, and the rate they stand for (kbps) */
+    t_u8 rx_rate;
+    t_u8 rx_rate_info;
+    t_u32 rate_kbps;
+    /* smoothed values, 1/16 units */
+    t_s32 rssi_x16;
+    t_u32 rate_x16;
+    /* smoothed TX loss, 1/256 units */
+    t_u32 loss;
+    t_u32 tx_sent;
+    t_u32 tx_status_ok;
+    t_u32 tx_status_fail;
+    t_u32 last_ms;
+} wifi_lq_peer_t;
+
+typedef struct
+{
+    t_u8 peer; /* index in lq_peers + 1, 0 unused */
+} wifi_lq_token_t;
+
+static wifi_lq_peer_t lq_peers[CONFIG_WIFI_LQ_MAX_PEERS];
+#if CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+/* tokens 1..CONFIG_WIFI_LQ_TX_TOKENS of the sampled packets in flight */
+static wifi_lq_token_t lq_tokens[CONFIG_WIFI_LQ_TX_TOKENS];
+static t_u8 lq_next_token;
+#endif
+
+/* v += (sample - v) / 2^CONFIG_WIFI_LQ_EWMA_SHIFT */
+static inline t_s32 wifi_lq_ewma(t_s32 v, t_s32 sample)
+{
+    return v + ((sample - v) >> CONFIG_WIFI_LQ_EWMA_SHIFT);
+}
+
+static wifi_lq_peer_t *wifi_lq_find(t_u8 bss_type, const t_u8 *mac)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_WIFI_LQ_MAX_PEERS; i++)
+    {
+        if ((lq_peers[i].in_use != 0U) && (lq_peers[i].bss_type == bss_type) &&
+            (memcmp(lq_peers[i].mac, mac, MLAN_MAC_ADDR_LENGTH) == 0))
+        {
+            return &lq_peers[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* find the peer, or take the free or least recently heard entry */
+static wifi_lq_peer_t *wifi_lq_get(t_u8 bss_type, const t_u8 *mac)
+{
+    wifi_lq_peer_t *peer = wifi_lq_find(bss_type, mac);
+    t_u32 now;
+    int i;
+
+    if (peer != NULL)
+    {
+        return peer;
+    }
+
+    now  = OSA_TimeGetMsec();
+    peer = &lq_peers[0];
+    for (i = 0; i < CONFIG_WIFI_LQ_MAX_PEERS; i++)
+    {
+        if (lq_peers[i].in_use == 0U)
+        {
+            peer = &lq_peers[i];
+            break;
+        }
+        if ((now - lq_peers[i].last_ms) > (now - peer->last_ms))
+        {
+            peer = &lq_peers[i];
+        }
+    }
+
+    (void)memset(peer, 0, sizeof(*peer));
+    peer->in_use   = 1U;
+    peer->bss_type = bss_type;
+    (void)memcpy(peer->mac, mac, MLAN_MAC_ADDR_LENGTH);
+    peer->last_ms = now;
+
+    return peer;
+}
+
+void wifi_lq_rx(mlan_private *priv, const t_u8 *mac, const RxPD *prx_pd)
+{
+    wifi_lq_peer_t *peer;
+#ifdef SD8801
+    t_u8 rate_info = prx_pd->ht_info;
+#else
+    t_u8 rate_info = prx_pd->rate_info;
+#endif
+    t_s32 rssi = (t_s32)prx_pd->snr - (t_s32)prx_pd->nf;
+    OSA_SR_ALLOC();
+
+    OSA_ENTER_CRITICAL();
+    peer = wifi_lq_get(priv->bss_type, mac);
+
+    if ((peer->rate_kbps == 0U) || (peer->rx_rate != prx_pd->rx_rate) || (peer->rx_rate_info != rate_info))
+    {
+        peer->rx_rate      = prx_pd->rx_rate;
+        peer->rx_rate_info = rate_info;
+        /* 500 kbps units */
+        peer->rate_kbps = 500U * wlan_index_to_data_rate(priv->adapter, prx_pd->rx_rate, rate_info
+#if CONFIG_11AX
+                                                         ,
+                                                         0
+#endif
+                                                     );
+    }
+
+    if (peer->rate_x16 == 0U)
+    {
+        /* first sample */
+        peer->rssi_x16 = rssi * 16;
+        peer->rate_x16 = peer->rate_kbps * 16U;
+    }
+    else
+    {
+        peer->rssi_x16 = wifi_lq_ewma(peer->rssi_x16, rssi * 16);
+        peer->rate_x16 = (t_u32)wifi_lq_ewma((t_s32)peer->rate_x16, (t_s32)(peer->rate_kbps * 16U));
+    }
+    peer->last_ms = OSA_TimeGetMsec();
+    OSA_EXIT_CRITICAL();
+}
+
+#if CONFIG_WIFI_LQ_TX_STATUS_INTERVAL
+t_u8 wifi_lq_tx_token(mlan_private *priv, const t_u8 *mac)
+{
+    wifi_lq_peer_t *peer;
+    t_u8 token = 0U;
+    OSA_SR_ALLOC();
+
+    OSA_ENTER_CRITICAL();
+    peer = wifi_lq_find(priv->bss_type, mac);
+    if ((peer != NULL) && ((peer->tx_sent++ % CONFIG_WIFI_LQ_TX_STATUS_INTERVAL) == 0U))
+    {
+        lq_tokens[lq_next_token].peer = (t_u8)(peer - lq_peers) + 1U;
+        token                         = lq_next_token + 1U;
+        lq_next_token                 = (lq_next_token + 1U) % CONFIG_WIFI_LQ_TX_TOKENS;
+    }
+    OSA_EXIT_CRITICAL();
+
+    return token;
+}
+
+void wifi_lq_tx_status(t_u8 token, bool success)
+{
+    wifi_lq_peer_t *peer;
+    OSA_SR_ALLOC();
+
+    if ((token == 0U) || (token > CONFIG_WIFI_LQ_TX_TOKENS))
+    {
+        return;
+    }
+
+    OSA_ENTER_CRITICAL();
+    if (lq_tokens[token - 1U].peer != 0U)
+    {
+        peer                       = &lq_peers[lq_tokens[token - 1U].peer - 1U];
+        lq_tokens[token - 1U].peer = 0U;
+        if (success)
+        {
+            peer->tx_status_ok++;
+        }
+        else
+        {
+            peer->tx_status_fail++;
+        }
+        peer->loss = (t_u32)wifi_lq_ewma((t_s32)peer->loss, success ? 0 : (t_s32)LQ_LOSS_ONE);
+    }
+    OSA_EXIT_CRITICAL();
+}
+#endif
+
+static void wifi_lq_fill(const wifi_lq_peer_t *peer, wifi_link_quality_t *lq)
+{
+    t_u32 rate_kbps = peer->rate_x16 / 16U;
+
+    (void)memcpy(lq->mac, peer->mac, MLAN_MAC_ADDR_LENGTH);
+    lq->rssi           = (t_s16)(peer->rssi_x16 / 16);
+    lq->phy_rate_kbps  = rate_kbps;
+    lq->loss_pct       = (t_u8)((peer->loss * 100U + LQ_LOSS_ONE / 2U) / LQ_LOSS_ONE);
+    lq->tput_kbps      = (t_u32)(((t_u64)rate_kbps * (LQ_LOSS_ONE - peer->loss) * CONFIG_WIFI_LQ_MAC_EFFICIENCY) /
+                            (LQ_LOSS_ONE * 100U));
+    lq->tx_status_ok   = peer->tx_status_ok;
+    lq->tx_status_fail = peer->tx_status_fail;
+    lq->age_ms         = OSA_TimeGetMsec() - peer->last_ms;
+}
+
+int wifi_get_link_quality(mlan_bss_type bss_type, const t_u8 *mac, wifi_link_quality_t *lq)
+{
+    const wifi_lq_peer_t *peer = NULL;
+    int i;
+    OSA_SR_ALLOC();
+
+    if (lq == NULL)
+    {
+        return -WM_E_INVAL;
+    }
+
+    OSA_ENTER_CRITICAL();
+    if (mac != NULL)
+    {
+        peer = wifi_lq_find((t_u8)bss_type, mac);
+    }
+    else
+    {
+        /* most recently heard peer */
+        for (i = 0; i < CONFIG_WIFI_LQ_MAX_PEERS; i++)
+        {
+            if ((lq_peers[i].in_use != 0U) && (lq_peers[i].bss_type == (t_u8)bss_type) &&
+                ((peer == NULL) || ((t_s32)(lq_peers[i].last_ms - peer->last_ms) > 0)))
+            {
+                peer = &lq_peers[i];
+            }
+        }
+    }
+    if (peer != NULL)
+    {
+        wifi_lq_fill(peer, lq);
+    }
+    OSA_EXIT_CRITICAL();
+
+    return (peer != NULL) ? WM_SUCCESS : -WM_FAIL;
+}
+
+#endif /* CONFIG_WIFI_LINK_QUALITY */
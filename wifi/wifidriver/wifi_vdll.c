@@ -0,0 +1,284 @@
+/** @file wifi_vdll.c
+ *
+ *  @brief This file provides the cache of the firmware VDLL blocks.
+ *
+ *  Blocks requested by the firmware are kept in RAM, least recently used
+ *  replaced first, so a block requested again is not read from flash. The
+ *  block requested after a host command or after another block is learnt;
+ *  it is prefetched into the cache when the command is sent or the block
+ *  is downloaded, while the firmware is busy with them.
+ *
+ *  The policy only copies memory, the firmware image is given by the caller,
+ *  so recorded VDLL request traces can be replayed on a host.
+ *
+ *  SPDX-License-Identifier: BSD-3-Clause
+ *
+ */
+
+#include <mlan_api.h>
+
+#include <osa.h>
+#include <wifi.h>
+
+#if CONFIG_FW_VDLL
+
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+/* Trigger of a host command, otherwise the offset of a block */
+#define VDLL_TRIGGER_CMD  0x80000000U
+#define VDLL_TRIGGER_NONE 0xFFFFFFFFU
+
+typedef struct
+{
+    t_u32 offset;
+    t_u32 stamp; /* last use */
+    t_u16 len;
+    t_u8 valid;
+    t_u8 prefetched; /* not requested since prefetch */
+    t_u8 data[CONFIG_FW_VDLL_CACHE_BLOCK_SIZE];
+} vdll_cache_block_t;
+
+typedef struct
+{
+    t_u32 trigger;
+    t_u32 offset;
+    t_u32 stamp; /* last use */
+    t_u16 len;
+} vdll_successor_t;
+
+static vdll_cache_block_t vdll_cache[CONFIG_FW_VDLL_CACHE_BLOCKS];
+static vdll_successor_t vdll_next[CONFIG_FW_VDLL_PREFETCH_ENTRIES];
+static t_u32 vdll_clock;
+static t_u32 vdll_trigger = VDLL_TRIGGER_NONE;
+/* The command path and the event path both use the cache */
+static OSA_MUTEX_HANDLE_DEFINE(vdll_lock);
+static bool vdll_lock_ready;
+#endif
+
+static wifi_vdll_stats_t vdll_stats;
+
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+static vdll_cache_block_t *wifi_vdll_find(t_u32 offset, t_u16 len)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_FW_VDLL_CACHE_BLOCKS; i++)
+    {
+        if ((vdll_cache[i].valid != 0U) && (vdll_cache[i].offset == offset) && (vdll_cache[i].len >= len))
+        {
+            return &vdll_cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+static vdll_cache_block_t *wifi_vdll_load(const t_u8 *image, t_u32 offset, t_u16 len)
+{
+    vdll_cache_block_t *block = &vdll_cache[0];
+    int i;
+
+    for (i = 0; i < CONFIG_FW_VDLL_CACHE_BLOCKS; i++)
+    {
+        if (vdll_cache[i].valid == 0U)
+        {
+            block = &vdll_cache[i];
+            break;
+        }
+        if ((t_s32)(vdll_cache[i].stamp - block->stamp) < 0)
+        {
+            block = &vdll_cache[i];
+        }
+    }
+
+    (void)memcpy(block->data, image + offset, len);
+    block->offset     = offset;
+    block->len        = len;
+    block->valid      = 1U;
+    block->prefetched = 0U;
+    block->stamp      = ++vdll_clock;
+
+    return block;
+}
+
+static vdll_successor_t *wifi_vdll_successor(t_u32 trigger)
+{
+    int i;
+
+    for (i = 0; i < CONFIG_FW_VDLL_PREFETCH_ENTRIES; i++)
+    {
+        if ((vdll_next[i].len != 0U) && (vdll_next[i].trigger == trigger))
+        {
+            return &vdll_next[i];
+        }
+    }
+
+    return NULL;
+}
+
+/* remember the block requested after the trigger */
+static void wifi_vdll_learn(t_u32 trigger, t_u32 offset, t_u16 len)
+{
+    vdll_successor_t *next = wifi_vdll_successor(trigger);
+    int i;
+
+    if (next == NULL)
+    {
+        next = &vdll_next[0];
+        for (i = 0; i < CONFIG_FW_VDLL_PREFETCH_ENTRIES; i++)
+        {
+            if (vdll_next[i].len == 0U)
+            {
+                next = &vdll_next[i];
+                break;
+            }
+            if ((t_s32)(vdll_next[i].stamp - next->stamp) < 0)
+            {
+                next = &vdll_next[i];
+            }
+        }
+        next->trigger = trigger;
+    }
+
+    next->offset = offset;
+    next->len    = len;
+    next->stamp  = ++vdll_clock;
+}
+
+static void wifi_vdll_lock(void)
+{
+    if (vdll_lock_ready)
+    {
+        (void)OSA_MutexLock((osa_mutex_handle_t)vdll_lock, osaWaitForever_c);
+    }
+}
+
+static void wifi_vdll_unlock(void)
+{
+    if (vdll_lock_ready)
+    {
+        (void)OSA_MutexUnlock((osa_mutex_handle_t)vdll_lock);
+    }
+}
+
+/* load the block learnt to follow the current trigger */
+static void wifi_vdll_prefetch(const t_u8 *image, t_u32 image_len)
+{
+    vdll_successor_t *next = wifi_vdll_successor(vdll_trigger);
+
+    if ((image == NULL) || (next == NULL) || (next->len > CONFIG_FW_VDLL_CACHE_BLOCK_SIZE) ||
+        (next->offset > image_len) || (next->len > image_len - next->offset) ||
+        (wifi_vdll_find(next->offset, next->len) != NULL))
+    {
+        return;
+    }
+
+    wifi_vdll_load(image, next->offset, next->len)->prefetched = 1U;
+    vdll_stats.prefetches++;
+}
+#endif /* CONFIG_FW_VDLL_CACHE_BLOCKS */
+
+void wifi_vdll_init(void)
+{
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    if (!vdll_lock_ready)
+    {
+        vdll_lock_ready = (OSA_MutexCreate((osa_mutex_handle_t)vdll_lock) == KOSA_StatusSuccess);
+    }
+#endif
+}
+
+void wifi_vdll_reset(void)
+{
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    wifi_vdll_lock();
+    (void)memset(vdll_cache, 0, sizeof(vdll_cache));
+    (void)memset(vdll_next, 0, sizeof(vdll_next));
+    vdll_trigger = VDLL_TRIGGER_NONE;
+    wifi_vdll_unlock();
+#endif
+}
+
+const t_u8 *wifi_vdll_block(const t_u8 *image, t_u32 image_len, t_u32 offset, t_u16 len)
+{
+    const t_u8 *data = image + offset;
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    vdll_cache_block_t *block;
+
+    wifi_vdll_lock();
+    vdll_stats.requests++;
+    if (vdll_trigger != VDLL_TRIGGER_NONE)
+    {
+        wifi_vdll_learn(vdll_trigger, offset, len);
+    }
+    vdll_trigger = offset;
+
+    if (len <= CONFIG_FW_VDLL_CACHE_BLOCK_SIZE)
+    {
+        block = wifi_vdll_find(offset, len);
+        if (block != NULL)
+        {
+            vdll_stats.hits++;
+            if (block->prefetched != 0U)
+            {
+                vdll_stats.prefetch_hits++;
+                block->prefetched = 0U;
+            }
+            block->stamp = ++vdll_clock;
+        }
+        else
+        {
+            block = wifi_vdll_load(image, offset, len);
+        }
+        data = block->data;
+    }
+    wifi_vdll_unlock();
+#else
+    (void)image_len;
+    vdll_stats.requests++;
+#endif
+
+    return data;
+}
+
+void wifi_vdll_block_sent(const t_u8 *image, t_u32 image_len)
+{
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    wifi_vdll_lock();
+    wifi_vdll_prefetch(image, image_len);
+    wifi_vdll_unlock();
+#else
+    (void)image;
+    (void)image_len;
+#endif
+}
+
+void wifi_vdll_command(t_u16 command, const t_u8 *image, t_u32 image_len)
+{
+#if CONFIG_FW_VDLL_CACHE_BLOCKS
+    wifi_vdll_lock();
+    vdll_trigger = VDLL_TRIGGER_CMD | command;
+    wifi_vdll_prefetch(image, image_len);
+    wifi_vdll_unlock();
+#else
+    (void)command;
+    (void)image;
+    (void)image_len;
+#endif
+}
+
+void wifi_vdll_stall(t_u32 stall_ms)
+{
+    vdll_stats.stalls++;
+    vdll_stats.stall_ms_total += stall_ms;
+    if (stall_ms > vdll_stats.stall_ms_max)
+    {
+        vdll_stats.stall_ms_max = stall_ms;
+    }
+}
+
+void wifi_get_vdll_stats(wifi_vdll_stats_t *stats)
+{
+    *stats = vdll_stats;
+}
+
+#endif /* CONFIG_FW_VDLL */
@@ -205,7 +205,9 @@ OSA_SEMAPHORE_HANDLE_DEFINE(uapsd_sem);
 #define CPU_LOADING_TASK_NUM           20
 #define CPU_LOADING_KEEPING            -1
 
+#if !CONFIG_CPU_LOADING_STACK_SIZE
 #define CONFIG_CPU_LOADING_STACK_SIZE (2048)
+#endif
 
 static void cpu_loading_task(osa_task_param_t arg);
 
@@ -400,7 +402,9 @@ static struct wifi_scan_params_t g_wifi_scan_params = {NULL,
                                                        60,
                                                        250};
 
+#if !CONFIG_WLCMGR_STACK_SIZE
 #define CONFIG_WLCMGR_STACK_SIZE (5120)
+#endif
 
 static void wlcmgr_task(osa_task_param_t arg);
 
@@ -409,7 +413,9 @@ static OSA_TASK_DEFINE(wlcmgr_task, WLAN_TASK_PRI_HIGH, 1, CONFIG_WLCMGR_STACK_S
 
 #if CONFIG_FW_DNLD_ASYNC
 
+#if !CONFIG_WLCMGR_NB_STACK_SIZE
 #define CONFIG_WLCMGR_NB_STACK_SIZE (2048)
+#endif
 
 static void wlcmgr_nb_task(osa_task_param_t arg);
 
@@ -418,7 +424,9 @@ static OSA_TASK_DEFINE(wlcmgr_nb_task, WLAN_TASK_PRI_LOW, 1, CONFIG_WLCMGR_NB_ST
 #endif
 
 #if CONFIG_WPS2
+#if !CONFIG_WPS_STACK_SIZE
 #define CONFIG_WPS_STACK_SIZE (5120)
+#endif
 
 static void wps_task(osa_task_param_t arg);
 
@@ -473,7 +481,9 @@ static struct wps_config wps_conf = {
 #endif /* CONFIG_WPS2 */
 #ifdef RW610
 
+#if !CONFIG_WLCMGR_MON_STACK_SIZE
 #define CONFIG_WLCMGR_MON_STACK_SIZE (2048)
+#endif
 
 static void wlcmgr_mon_task(osa_task_param_t arg);
 
@@ -12163,6 +12173,13 @@ int wlan_get_data_rate(wlan_ds_rate *ds_rate, mlan_bss_type bss_type)
     return wifi_get_data_rate(ds_rate, bss_type);
 }
 
+#if CONFIG_WIFI_LINK_QUALITY
+int wlan_get_link_quality(mlan_bss_type bss_type, const uint8_t *mac, wlan_link_quality_t *lq)
+{
+    return wifi_get_link_quality(bss_type, mac, lq);
+}
+#endif
+
 static int wlan_set_pmfcfg(uint8_t mfpc, uint8_t mfpr)
 {
     if (!mfpc && mfpr)
@@ -13371,6 +13388,18 @@ void wlan_wmm_tx_stats_dump(int bss_type)
 }
 #endif
 
+#if CONFIG_WMM_CLASSIFIER
+int wlan_wmm_set_class_rules(const wlan_wmm_class_rule_t *rules, uint8_t count)
+{
+    return wifi_wmm_set_class_rules(rules, count);
+}
+
+uint8_t wlan_wmm_get_class_rules(wlan_wmm_class_rule_t *rules, uint8_t max)
+{
+    return wifi_wmm_get_class_rules(rules, max);
+}
+#endif
+
 int wlan_send_hostcmd(
     const void *cmd_buf, uint32_t cmd_buf_len, void *host_resp_buf, uint32_t resp_buf_len, uint32_t *reqd_resp_len)
 {
@@ -13620,6 +13649,15 @@ wlan_twt_setup_config_t * wlan_get_twt_setup_cfg(void)
     return g_twt_setup_cfg_default;
 }
 
+bool wlan_is_twt_supported(void)
+{
+    if (!is_sta_connected())
+    {
+        return false;
+    }
+    return wifi_is_twt_supported();
+}
+
 static wlan_twt_teardown_config_t g_twt_teardown_cfg_default[] = {
     {0x00, 0x00, 0x00}};
 